@@ -0,0 +1,17 @@
+# qt5_generate_json_converters(outfiles header ... )
+# Runs qjsonserializergen on each header and appends the generated sources to outfiles. The target that
+# compiles them must link against Qt5::JsonSerializer
+function(QT5_GENERATE_JSON_CONVERTERS outfiles)
+    foreach(it ${ARGN})
+        get_filename_component(infile ${it} ABSOLUTE)
+        get_filename_component(outfilename ${it} NAME_WE)
+        set(outfile ${CMAKE_CURRENT_BINARY_DIR}/${outfilename}_jsonconverter.cpp)
+        add_custom_command(OUTPUT ${outfile}
+                           COMMAND Qt5::qjsonserializergen
+                           ARGS ${infile} --include ${infile} -o ${outfile}
+                           DEPENDS ${infile} Qt5::qjsonserializergen
+                           VERBATIM)
+        list(APPEND ${outfiles} ${outfile})
+    endforeach()
+    set(${outfiles} ${${outfiles}} PARENT_SCOPE)
+endfunction()
@@ -2,11 +2,32 @@ TARGET = QtJsonSerializer
 
 QT = core
 
+qtConfig(system-zlib): QMAKE_USE_PRIVATE += zlib
+else: QT_PRIVATE += zlib-private
+
 SOURCES += \
 	qjsonserializerexception.cpp \
 	qjsonserializer.cpp \
 	qjsontypeconverter.cpp \
-	qjsonexceptioncontext.cpp
+	qjsonexceptioncontext.cpp \
+	qjsonmsgpack.cpp \
+	qjsonvalueproducer.cpp \
+	qjsoncolumnreader.cpp \
+	qjsoncompressiondevice.cpp \
+	qjsontextreader.cpp \
+	qjsontextwriter.cpp \
+	qjsonasync.cpp \
+	qjsonwritejob.cpp \
+	qjsonfieldselector.cpp \
+	qjsonlazy.cpp \
+	qjsonreferencecontext.cpp \
+	qjsonattachment.cpp \
+	qjsonstringpool.cpp \
+	qjsongeneratedconverter.cpp \
+	qjsonserializertracer.cpp \
+	qjsonparallel.cpp \
+	qjsonreadpipeline.cpp \
+	qjsonserializeroptions.cpp
 
 HEADERS += \
 	qjsonserializerexception.h \
@@ -16,13 +37,42 @@ HEADERS += \
 	qjsonserializer_helpertypes.h \
 	qjsontypeconverter.h \
 	qjsonexceptioncontext_p.h \
-	qjsonserializerexception_p.h
+	qjsonserializerexception_p.h \
+	qjsonmsgpack_p.h \
+	qjsonvalueproducer_p.h \
+	qjsoncolumnreader_p.h \
+	qjsoncompressiondevice_p.h \
+	qjsontextreader_p.h \
+	qjsontextwriter_p.h \
+	qjsonasync_p.h \
+	qjsonwritejob.h \
+	qjsonwritejob_p.h \
+	qjsonfieldselector.h \
+	qjsonfieldselector_p.h \
+	qjsonlazy.h \
+	qjsonlazy_p.h \
+	qjsonreferencecontext_p.h \
+	qjsonattachment_p.h \
+	qjsonstringpool_p.h \
+	qjsongeneratedconverter.h \
+	qjsonserializertracer.h \
+	qjsonserializertracer_p.h \
+	qjsonparallel_p.h \
+	qjsonreadpipeline.h \
+	qjsonreadpipeline_p.h \
+	qjsonserializeroptions.h \
+	qjsonserializeroptions_p.h
 
 include(typeconverters/typeconverters.pri)
 include(typesplit.pri)
 
 load(qt_module)
 
+# the code generator integration for qmake projects
+features.files = $$PWD/../../mkspecs/features/qjsonserializergen.prf
+features.path = $$[QT_HOST_DATA]/mkspecs/features
+INSTALLS += features
+
 win32 {
 	QMAKE_TARGET_COMPANY = "Skycoder42"
 	QMAKE_TARGET_PRODUCT = "QtJsonSerializer"
@@ -32,4 +82,6 @@ win32 {
 }
 
 DISTFILES += \
-	typesplit.pri
+	typesplit.pri \
+	Qt5JsonSerializerConfigExtras.cmake.in \
+	Qt5JsonSerializerMacros.cmake
@@ -0,0 +1,120 @@
+#include "qjsonasync_p.h"
+
+#include <limits>
+
+namespace {
+
+// the progress of a future is an int
+int progressValue(qint64 bytes)
+{
+	return static_cast<int>(qMin<qint64>(bytes, std::numeric_limits<int>::max()));
+}
+
+}
+
+QThreadStorage<QJsonAsyncContext::ContextRef> QJsonAsyncContext::contextStore;
+QAtomicInt QJsonAsyncContext::activeJobs;
+
+QJsonAsyncContext::QJsonAsyncContext(QFutureInterfaceBase *futureInterface, bool serializing) :
+	_interface{futureInterface},
+	_serializing{serializing}
+{
+	auto &ref = contextStore.localData();
+	_previous = ref.context;
+	ref.context = this;
+	activeJobs.ref();
+}
+
+QJsonAsyncContext::~QJsonAsyncContext()
+{
+	activeJobs.deref();
+	contextStore.localData().context = _previous;
+}
+
+void QJsonAsyncContext::setTotalBytes(qint64 bytes)
+{
+	const auto context = contextStore.localData().context;
+	if(context)
+		context->_interface->setProgressRange(0, progressValue(bytes));
+}
+
+void QJsonAsyncContext::moveToThread(const QVariant &value, QThread *thread)
+{
+	const auto flags = QMetaType::typeFlags(value.userType());
+	if(flags.testFlag(QMetaType::PointerToQObject) ||
+	   flags.testFlag(QMetaType::SharedPointerToQObject) ||
+	   flags.testFlag(QMetaType::TrackingPointerToQObject)) {
+		const auto object = value.value<QObject*>();
+		// children are moved together with their parent
+		if(object && !object->parent() && object->thread() != thread)
+			object->moveToThread(thread);
+	} else if(value.userType() == QMetaType::QString ||
+			  value.userType() == QMetaType::QByteArray ||
+			  value.userType() == QMetaType::QStringList) {
+		return;
+	} else if(value.canConvert<QVariantList>()) {
+		for(const auto &element : value.value<QSequentialIterable>())
+			moveToThread(element, thread);
+	} else if(value.canConvert<QVariantMap>() || value.canConvert<QVariantHash>()) {
+		const auto iterable = value.value<QAssociativeIterable>();
+		for(auto it = iterable.begin(); it != iterable.end(); ++it)
+			moveToThread(it.value(), thread);
+	}
+}
+
+void QJsonAsyncContext::checkpointImpl()
+{
+	const auto context = contextStore.localData().context;
+	if(!context)
+		return;
+
+	if(context->_interface->isCanceled()) {
+		if(context->_serializing)
+			throw QJsonSerializationException("The serialization was canceled");
+		else
+			throw QJsonDeserializationException("The deserialization was canceled");
+	}
+}
+
+void QJsonAsyncContext::reportBytesImpl(qint64 bytes)
+{
+	const auto context = contextStore.localData().context;
+	if(context)
+		context->_interface->setProgressValue(progressValue(bytes));
+}
+
+
+
+QJsonAsyncGuard::Lock::Lock(QJsonAsyncGuard *guard, bool serializing) :
+	_guard{guard}
+{
+	if(!_guard)
+		return;
+	QMutexLocker lock{&_guard->_mutex};
+	if(_guard->_destroyed) {
+		if(serializing)
+			throw QJsonSerializationException("The serializer was destroyed before the serialization started");
+		else
+			throw QJsonDeserializationException("The serializer was destroyed before the deserialization started");
+	}
+	++_guard->_running;
+}
+
+QJsonAsyncGuard::Lock::~Lock()
+{
+	if(!_guard)
+		return;
+	QMutexLocker lock{&_guard->_mutex};
+	if(--_guard->_running == 0)
+		_guard->_condition.wakeAll();
+}
+
+QJsonAsyncGuard::QJsonAsyncGuard() = default;
+
+void QJsonAsyncGuard::destroy()
+{
+	QMutexLocker lock{&_mutex};
+	_destroyed = true;
+	while(_running > 0)
+		_condition.wait(&_mutex);
+}
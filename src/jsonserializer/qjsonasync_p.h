@@ -0,0 +1,142 @@
+#ifndef QJSONASYNC_P_H
+#define QJSONASYNC_P_H
+
+#include "qtjsonserializer_global.h"
+#include "qjsonserializerexception.h"
+
+#include <functional>
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QFutureInterface>
+#include <QtCore/QMutex>
+#include <QtCore/QRunnable>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QVariant>
+#include <QtCore/QWaitCondition>
+
+// Active while a value is de/serialized by an asynchronous job. Reports the bytes of json text read or written
+// as progress of the job and aborts the operation at the next property once the job was canceled
+class Q_JSONSERIALIZER_EXPORT QJsonAsyncContext
+{
+	Q_DISABLE_COPY(QJsonAsyncContext)
+
+public:
+	QJsonAsyncContext(QFutureInterfaceBase *futureInterface, bool serializing);
+	~QJsonAsyncContext();
+
+	// called for every property - cheap as long as no job is running at all
+	static inline void checkpoint() {
+		if(Q_UNLIKELY(activeJobs.load() > 0))
+			checkpointImpl();
+	}
+	// called for every chunk of json text that was read or written, with the bytes processed so far
+	static inline void reportBytes(qint64 bytes) {
+		if(Q_UNLIKELY(activeJobs.load() > 0))
+			reportBytesImpl(bytes);
+	}
+	// the size of the text to be read, if known in advance
+	static void setTotalBytes(qint64 bytes);
+
+	// moves all parentless QObjects within value (directly or as list/map elements) to the given thread
+	static void moveToThread(const QVariant &value, QThread *thread);
+
+private:
+	struct ContextRef {
+		QJsonAsyncContext *context = nullptr;
+	};
+	static QThreadStorage<ContextRef> contextStore;
+	static QAtomicInt activeJobs;
+
+	QJsonAsyncContext *_previous;
+	QFutureInterfaceBase *_interface;
+	bool _serializing;
+
+	static void checkpointImpl();
+	static void reportBytesImpl(qint64 bytes);
+};
+
+// Tracks the jobs of a serializer. When the serializer is destroyed, it waits for the running jobs to finish,
+// and jobs that have not started yet fail instead of using the destroyed serializer
+class Q_JSONSERIALIZER_EXPORT QJsonAsyncGuard
+{
+	Q_DISABLE_COPY(QJsonAsyncGuard)
+
+public:
+	// held while a job runs - throws if the serializer was destroyed already
+	class Q_JSONSERIALIZER_EXPORT Lock
+	{
+		Q_DISABLE_COPY(Lock)
+
+	public:
+		Lock(QJsonAsyncGuard *guard, bool serializing);
+		~Lock();
+
+	private:
+		QJsonAsyncGuard *_guard;
+	};
+
+	QJsonAsyncGuard();
+
+	// called by the serializer when it is destroyed
+	void destroy();
+
+private:
+	QMutex _mutex;
+	QWaitCondition _condition;
+	int _running = 0;
+	bool _destroyed = false;
+};
+
+template <typename T>
+class QJsonAsyncJob : public QRunnable
+{
+	Q_DISABLE_COPY(QJsonAsyncJob)
+
+public:
+	QJsonAsyncJob(bool serializing, QSharedPointer<QJsonAsyncGuard> guard, std::function<T()> job) :
+		_serializing{serializing},
+		_guard{std::move(guard)},
+		_job{std::move(job)}
+	{}
+
+	QFuture<T> start(QThreadPool *threadPool) {
+		if(!threadPool)
+			threadPool = QThreadPool::globalInstance();
+		_interface.setRunnable(this);
+		_interface.setThreadPool(threadPool);
+		_interface.reportStarted();
+		auto future = _interface.future();
+		threadPool->start(this);
+		return future;
+	}
+
+	void run() override {
+		if(!_interface.isCanceled()) {
+			try {
+				QJsonAsyncGuard::Lock lock{_guard.data(), _serializing};
+				QJsonAsyncContext context{&_interface, _serializing};
+				const auto result = _job();
+				if(!_interface.isCanceled())
+					_interface.reportResult(result);
+			} catch(QException &e) {
+				if(!_interface.isCanceled())
+					_interface.reportException(e);
+			} catch(...) {
+				if(!_interface.isCanceled())
+					_interface.reportException(QUnhandledException{});
+			}
+		}
+		_interface.reportFinished();
+	}
+
+private:
+	const bool _serializing;
+	const QSharedPointer<QJsonAsyncGuard> _guard;
+	const std::function<T()> _job;
+	QFutureInterface<T> _interface;
+};
+
+#endif // QJSONASYNC_P_H
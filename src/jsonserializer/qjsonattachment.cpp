@@ -0,0 +1,199 @@
+#include "qjsonattachment_p.h"
+#include "qjsonserializerexception.h"
+
+#include <limits>
+
+#include <QtCore/QtEndian>
+#include <QtCore/QVector>
+
+namespace {
+
+const char ContainerMagic[] = "QJSA";
+const int ContainerMagicSize = 4;
+
+const QLatin1String MarkerKey{"@attachment"};
+const QLatin1String OffsetKey{"offset"};
+const QLatin1String LengthKey{"length"};
+
+void writeData(QIODevice *device, const char *data, qint64 size)
+{
+	if(device->write(data, size) != size)
+		throw QJsonSerializationException("Failed to write attachment container to device with error: " + device->errorString().toUtf8());
+}
+
+void writeSize(QIODevice *device, quint32 size)
+{
+	const auto value = qToBigEndian(size);
+	writeData(device, reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// sequential devices get this long to deliver the rest of the container
+const int ReadTimeout = 30000;
+// sizes read from sequential devices cannot be checked in advance, so their data is read in chunks of this size
+const int ReadChunkSize = 64 * 1024;
+
+// reads directly into the target buffer, so attachments are not copied after being read
+void readData(QIODevice *device, char *data, qint64 size)
+{
+	qint64 pos = 0;
+	while(pos < size) {
+		const auto read = device->read(data + pos, size - pos);
+		if(read < 0 ||
+		   (read == 0 && (!device->isSequential() || !device->waitForReadyRead(ReadTimeout))))
+			throw QJsonDeserializationException("Unexpected end of attachment container data");
+		pos += read;
+	}
+}
+
+// the sizes in the container are not trusted: data that cannot be there is never allocated
+void checkAvailable(QIODevice *device, qint64 size)
+{
+	if(!device->isSequential() && size > device->bytesAvailable())
+		throw QJsonDeserializationException("Unexpected end of attachment container data");
+}
+
+quint32 readSize(QIODevice *device)
+{
+	quint32 value;
+	readData(device, reinterpret_cast<char*>(&value), sizeof(value));
+	value = qFromBigEndian(value);
+	if(value > static_cast<quint32>(std::numeric_limits<int>::max()))
+		throw QJsonDeserializationException("Attachment container element exceeds the maximum supported size");
+	return value;
+}
+
+QByteArray readBlock(QIODevice *device, quint32 size)
+{
+	checkAvailable(device, size);
+	if(!device->isSequential() || size <= static_cast<quint32>(ReadChunkSize)) {
+		QByteArray block{static_cast<int>(size), Qt::Uninitialized};
+		readData(device, block.data(), size);
+		return block;
+	}
+
+	// the block only grows as far as the data actually arrives
+	QByteArray block;
+	while(block.size() < static_cast<int>(size)) {
+		const auto pos = block.size();
+		const auto chunk = qMin(ReadChunkSize, static_cast<int>(size) - pos);
+		block.resize(pos + chunk);
+		readData(device, block.data() + pos, chunk);
+	}
+	return block;
+}
+
+}
+
+
+
+QThreadStorage<QJsonAttachmentContext::ContextRef> QJsonAttachmentContext::contextStore;
+
+QJsonAttachmentContext::QJsonAttachmentContext(int threshold) :
+	_threshold{qMax(threshold, 0)}
+{
+	push();
+}
+
+QJsonAttachmentContext::QJsonAttachmentContext(const QByteArrayList &attachments) :
+	_attachments{attachments}
+{
+	_offsets.reserve(_attachments.size());
+	for(const auto &attachment : _attachments) {
+		_offsets.append(_offset);
+		_offset += attachment.size();
+	}
+	push();
+}
+
+QJsonAttachmentContext::~QJsonAttachmentContext()
+{
+	contextStore.localData().context = _previous;
+}
+
+QJsonAttachmentContext *QJsonAttachmentContext::current()
+{
+	return contextStore.hasLocalData() ?
+				contextStore.localData().context :
+				nullptr;
+}
+
+const QByteArrayList &QJsonAttachmentContext::attachments() const
+{
+	return _attachments;
+}
+
+bool QJsonAttachmentContext::store(const QByteArray &data, QJsonValue &json)
+{
+	if(_threshold < 0 || data.size() < _threshold)
+		return false;
+
+	// the byte array is shared, not copied
+	_attachments.append(data);
+	json = QJsonObject {
+		{MarkerKey, _attachments.size() - 1},
+		{OffsetKey, static_cast<double>(_offset)},
+		{LengthKey, data.size()}
+	};
+	_offset += data.size();
+	return true;
+}
+
+QByteArray QJsonAttachmentContext::find(const QJsonObject &marker) const
+{
+	const auto index = marker.value(MarkerKey).toInt(-1);
+	if(index < 0 || index >= _attachments.size())
+		throw QJsonDeserializationException("Json references attachment " + QByteArray::number(index) + ", which does not exist");
+	const auto &attachment = _attachments[index];
+	if(marker.value(LengthKey).toInt(attachment.size()) != attachment.size())
+		throw QJsonDeserializationException("Length of attachment " + QByteArray::number(index) + " does not match the length in the json");
+	// the offset is redundant to the sizes of the previous attachments, which detects reordered or missing attachments
+	const auto offset = marker.value(OffsetKey);
+	if(!offset.isUndefined() && offset.toDouble(-1) != static_cast<double>(_offsets[index]))
+		throw QJsonDeserializationException("Offset of attachment " + QByteArray::number(index) + " does not match the offset in the json");
+	return attachment;
+}
+
+void QJsonAttachmentContext::writeContainer(QIODevice *device, const QByteArray &json, const QByteArrayList &attachments)
+{
+	writeData(device, ContainerMagic, ContainerMagicSize);
+	writeSize(device, static_cast<quint32>(json.size()));
+	writeData(device, json.constData(), json.size());
+	writeSize(device, static_cast<quint32>(attachments.size()));
+	for(const auto &attachment : attachments)
+		writeSize(device, static_cast<quint32>(attachment.size()));
+	for(const auto &attachment : attachments)
+		writeData(device, attachment.constData(), attachment.size());
+}
+
+QByteArray QJsonAttachmentContext::readContainer(QIODevice *device, QByteArrayList &attachments)
+{
+	char magic[ContainerMagicSize];
+	readData(device, magic, ContainerMagicSize);
+	if(qstrncmp(magic, ContainerMagic, ContainerMagicSize) != 0)
+		throw QJsonDeserializationException("Data is not an attachment container");
+
+	const auto json = readBlock(device, readSize(device));
+	const auto count = readSize(device);
+	checkAvailable(device, static_cast<qint64>(count) * static_cast<qint64>(sizeof(quint32)));
+	QVector<quint32> sizes;
+	sizes.reserve(static_cast<int>(qMin<quint32>(count, 1024)));
+	qint64 total = 0;
+	for(quint32 i = 0; i < count; ++i) {
+		sizes.append(readSize(device));
+		total += sizes.last();
+	}
+	checkAvailable(device, total);
+
+	attachments.clear();
+	attachments.reserve(sizes.size());
+	for(const auto size : sizes)
+		attachments.append(readBlock(device, size));
+	return json;
+}
+
+void QJsonAttachmentContext::push()
+{
+	auto &ref = contextStore.localData();
+	_previous = ref.context;
+	ref.context = this;
+}
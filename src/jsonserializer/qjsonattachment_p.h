@@ -0,0 +1,57 @@
+#ifndef QJSONATTACHMENT_P_H
+#define QJSONATTACHMENT_P_H
+
+#include "qtjsonserializer_global.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayList>
+#include <QtCore/QJsonValue>
+#include <QtCore/QJsonObject>
+#include <QtCore/QIODevice>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QVector>
+
+// Active while a value is de/serialized with attachments. Byte arrays of at least the threshold size are not
+// base64 encoded into the json, but stored as raw attachments and referenced from the json tree by a marker
+// object {"@attachment": index, "offset": offset, "length": length}
+class Q_JSONSERIALIZER_EXPORT QJsonAttachmentContext
+{
+	Q_DISABLE_COPY(QJsonAttachmentContext)
+
+public:
+	// serialization: collects attachments
+	QJsonAttachmentContext(int threshold);
+	// deserialization: resolves markers to the given attachments
+	QJsonAttachmentContext(const QByteArrayList &attachments);
+	~QJsonAttachmentContext();
+
+	static QJsonAttachmentContext *current();
+
+	const QByteArrayList &attachments() const;
+
+	// replaces the data by a marker, if it is large enough
+	bool store(const QByteArray &data, QJsonValue &json);
+	// returns the attachment referenced by the marker
+	QByteArray find(const QJsonObject &marker) const;
+
+	// container format: "QJSA", json size, json, attachment count, attachment sizes, raw attachment data
+	static void writeContainer(QIODevice *device, const QByteArray &json, const QByteArrayList &attachments);
+	static QByteArray readContainer(QIODevice *device, QByteArrayList &attachments);
+
+private:
+	struct ContextRef {
+		QJsonAttachmentContext *context = nullptr;
+	};
+	static QThreadStorage<ContextRef> contextStore;
+
+	QJsonAttachmentContext *_previous;
+	int _threshold = -1;
+	qint64 _offset = 0;
+	QByteArrayList _attachments;
+	// deserialization: the offset of each attachment, relative to the first one
+	QVector<qint64> _offsets;
+
+	void push();
+};
+
+#endif // QJSONATTACHMENT_P_H
@@ -0,0 +1,84 @@
+#include "qjsoncolumnreader_p.h"
+#include "qjsonserializer_p.h"
+#include "qjsonserializeroptions_p.h"
+#include "qjsonfieldselector_p.h"
+
+#include <algorithm>
+
+QJsonColumnReader::QJsonColumnReader() = default;
+
+QJsonColumnReader::~QJsonColumnReader() = default;
+
+QJsonColumnReader *QJsonColumnReader::create(int propertyType, const QStringList &columns, const QJsonTypeConverter::SerializationHelper *helper)
+{
+	// only the serializer of the running call can look up the converter - any other helper gets json objects
+	const auto context = QJsonSerializerPrivate::context(helper);
+	if(!context)
+		return nullptr;
+
+	// selections and traces work on the elements as they are deserialized by deserializeSubtype
+	if(context->tracer() || QJsonFieldSelectorContext::hasSelection())
+		return nullptr;
+
+	// the converter that would deserialize each row, i.e. including the custom ones with a higher priority
+	const auto converter = context->serializer()->d->findConverter(propertyType, QJsonValue::Object);
+	const auto columnConverter = dynamic_cast<const QJsonColumnConverter*>(converter.data());
+	if(!columnConverter)
+		return nullptr;
+	return columnConverter->createColumnReader(propertyType, columns, helper);
+}
+
+
+
+QJsonColumnWriter *QJsonColumnWriter::create(int propertyType, const QJsonTypeConverter::SerializationHelper *helper)
+{
+	// the same restrictions as for reading the rows
+	const auto context = QJsonSerializerPrivate::context(helper);
+	if(!context)
+		return nullptr;
+	if(context->tracer() || QJsonFieldSelectorContext::hasSelection())
+		return nullptr;
+
+	// the converter is kept, as it is used for all rows
+	auto converter = context->serializer()->d->findConverter(propertyType);
+	const auto columnConverter = dynamic_cast<const QJsonColumnConverter*>(converter.data());
+	if(!columnConverter)
+		return nullptr;
+	QVector<QMetaProperty> properties;
+	if(!columnConverter->columnProperties(propertyType, helper, properties))
+		return nullptr;
+
+	// the same order the keys of the json object of each element would have
+	std::sort(properties.begin(), properties.end(), [](const QMetaProperty &lhs, const QMetaProperty &rhs) {
+		return qstrcmp(lhs.name(), rhs.name()) < 0;
+	});
+	return new QJsonColumnWriter{converter, propertyType, properties, helper};
+}
+
+QStringList QJsonColumnWriter::columns() const
+{
+	QStringList columns;
+	columns.reserve(_properties.size());
+	for(const auto &property : _properties)
+		columns.append(QString::fromUtf8(property.name()));
+	return columns;
+}
+
+bool QJsonColumnWriter::write(const QVariant &element, QJsonValue &row) const
+{
+	return _columnConverter->writeRow(_propertyType, element, _properties, _helper, row);
+}
+
+QJsonColumnWriter::QJsonColumnWriter(const QSharedPointer<QJsonTypeConverter> &converter, int propertyType, const QVector<QMetaProperty> &properties, const QJsonTypeConverter::SerializationHelper *helper) :
+	_converter{converter},
+	_columnConverter{dynamic_cast<const QJsonColumnConverter*>(converter.data())},
+	_propertyType{propertyType},
+	_properties{properties},
+	_helper{helper}
+{}
+
+
+
+QJsonColumnConverter::QJsonColumnConverter() = default;
+
+QJsonColumnConverter::~QJsonColumnConverter() = default;
@@ -0,0 +1,77 @@
+#ifndef QJSONCOLUMNREADER_P_H
+#define QJSONCOLUMNREADER_P_H
+
+#include "qtjsonserializer_global.h"
+#include "qjsontypeconverter.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QStringList>
+#include <QtCore/QMetaProperty>
+#include <QtCore/QVector>
+#include <QtCore/QSharedPointer>
+
+// Deserializes the rows of a columnar list without creating a json object per element. The columns are
+// resolved to the properties of the element type once, when the reader is created
+class Q_JSONSERIALIZER_EXPORT QJsonColumnReader
+{
+	Q_DISABLE_COPY(QJsonColumnReader)
+
+public:
+	QJsonColumnReader();
+	virtual ~QJsonColumnReader();
+
+	// returns nullptr if the rows have to be deserialized as json objects, e.g. because a custom converter
+	// was registered for the element type or the elements are traced
+	static QJsonColumnReader *create(int propertyType, const QStringList &columns, const QJsonTypeConverter::SerializationHelper *helper);
+
+	// creates the element of a row that is not null and has one value per column
+	virtual QVariant read(const QJsonArray &row, QObject *parent) const = 0;
+};
+
+class QJsonColumnConverter;
+// Serializes the elements of a columnar list straight into rows, without creating a json object per element.
+// The columns are the stored properties of the element type, resolved once when the writer is created
+class Q_JSONSERIALIZER_EXPORT QJsonColumnWriter
+{
+	Q_DISABLE_COPY(QJsonColumnWriter)
+
+public:
+	// returns nullptr if the elements have to be serialized as json objects, for the same reasons as QJsonColumnReader::create
+	static QJsonColumnWriter *create(int propertyType, const QJsonTypeConverter::SerializationHelper *helper);
+
+	// the keys of the columns, in the order the keys of a json object have
+	QStringList columns() const;
+	// writes the values of an element, or null for null elements. Returns false if the element does not fit the
+	// columns, e.g. because it is polymorphic
+	bool write(const QVariant &element, QJsonValue &row) const;
+
+private:
+	QJsonColumnWriter(const QSharedPointer<QJsonTypeConverter> &converter, int propertyType, const QVector<QMetaProperty> &properties, const QJsonTypeConverter::SerializationHelper *helper);
+
+	const QSharedPointer<QJsonTypeConverter> _converter;
+	const QJsonColumnConverter * const _columnConverter;
+	const int _propertyType;
+	const QVector<QMetaProperty> _properties;
+	const QJsonTypeConverter::SerializationHelper * const _helper;
+};
+
+// Implemented by the built-in converters of the types columnar lists can contain
+class Q_JSONSERIALIZER_EXPORT QJsonColumnConverter
+{
+	Q_DISABLE_COPY(QJsonColumnConverter)
+
+public:
+	QJsonColumnConverter();
+	virtual ~QJsonColumnConverter();
+
+	// returns nullptr for columns that need the object of each row, like "@class" or "$ref"
+	virtual QJsonColumnReader *createColumnReader(int propertyType, const QStringList &columns, const QJsonTypeConverter::SerializationHelper *helper) const = 0;
+
+	// the properties every element writes, in any order - returns false if the elements need more than their
+	// properties, like "@class" or "$id"
+	virtual bool columnProperties(int propertyType, const QJsonTypeConverter::SerializationHelper *helper, QVector<QMetaProperty> &properties) const = 0;
+	// writes the values of the properties of an element as row, see QJsonColumnWriter::write
+	virtual bool writeRow(int propertyType, const QVariant &value, const QVector<QMetaProperty> &properties, const QJsonTypeConverter::SerializationHelper *helper, QJsonValue &row) const = 0;
+};
+
+#endif // QJSONCOLUMNREADER_P_H
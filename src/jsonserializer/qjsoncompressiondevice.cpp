@@ -0,0 +1,203 @@
+#include "qjsoncompressiondevice_p.h"
+
+namespace {
+
+// window bits of zlib: +16 writes a gzip wrapper, +32 detects zlib or gzip automatically when reading
+const int WindowBits = MAX_WBITS;
+const int GzipWindowBits = MAX_WBITS + 16;
+const int DetectWindowBits = MAX_WBITS + 32;
+
+}
+
+QJsonCompressionDevice::QJsonCompressionDevice(QIODevice *device, QJsonSerializer::Compression compression, int level) :
+	QIODevice{},
+	_device{device},
+	_compression{compression},
+	_level{qBound(-1, level, 9)},
+	_stream{}
+{}
+
+QJsonCompressionDevice::~QJsonCompressionDevice()
+{
+	endStream();
+}
+
+bool QJsonCompressionDevice::isSequential() const
+{
+	return true;
+}
+
+bool QJsonCompressionDevice::open(QIODevice::OpenMode mode)
+{
+	if(!_device) {
+		setErrorString(QStringLiteral("No device to read from or write to"));
+		return false;
+	}
+
+	_stream = z_stream{};
+	_streamEnd = false;
+	_sourceFinished = false;
+	_failed = false;
+	auto result = Z_OK;
+	if(mode.testFlag(QIODevice::ReadOnly) == mode.testFlag(QIODevice::WriteOnly)) {
+		setErrorString(QStringLiteral("Compression devices can only be opened either for reading or writing"));
+		return false;
+	} else if(mode.testFlag(QIODevice::WriteOnly)) {
+		if(!_device->isWritable()) {
+			setErrorString(QStringLiteral("The target device is not writable"));
+			return false;
+		}
+		result = deflateInit2(&_stream,
+							  _level,
+							  Z_DEFLATED,
+							  _compression == QJsonSerializer::Compression::Gzip ? GzipWindowBits : WindowBits,
+							  8,
+							  Z_DEFAULT_STRATEGY);
+	} else {
+		if(!_device->isReadable()) {
+			setErrorString(QStringLiteral("The source device is not readable"));
+			return false;
+		}
+		result = inflateInit2(&_stream, DetectWindowBits);
+		// sequential sources only tell via this signal that no more data will follow
+		connect(_device, &QIODevice::readChannelFinished,
+				this, [this]() {
+			_sourceFinished = true;
+		});
+	}
+
+	if(result != Z_OK) {
+		setErrorString(QStringLiteral("Failed to initialize zlib with error code %1").arg(result));
+		return false;
+	}
+	_streamActive = true;
+	_buffer.resize(ChunkSize);
+	return QIODevice::open(mode | QIODevice::Unbuffered);
+}
+
+void QJsonCompressionDevice::close()
+{
+	if(isWritable() && _streamActive && !_failed)
+		deflateChunks(Z_FINISH);
+	endStream();
+	_buffer.clear();
+	if(_device)
+		_device->disconnect(this);
+	QIODevice::close();
+}
+
+bool QJsonCompressionDevice::waitForReadyRead(int msecs)
+{
+	if(!isReadable() || _streamEnd || _failed)
+		return false;
+	return _device->bytesAvailable() > 0 || _device->waitForReadyRead(msecs);
+}
+
+bool QJsonCompressionDevice::hasFailed() const
+{
+	return _failed;
+}
+
+bool QJsonCompressionDevice::atStreamEnd() const
+{
+	return _streamEnd;
+}
+
+qint64 QJsonCompressionDevice::readData(char *data, qint64 maxlen)
+{
+	if(_failed)
+		return -1;
+	if(_streamEnd || !_streamActive)
+		return 0;
+
+	_stream.next_out = reinterpret_cast<Bytef*>(data);
+	_stream.avail_out = static_cast<uInt>(qMin<qint64>(maxlen, std::numeric_limits<uInt>::max()));
+	while(_stream.avail_out > 0) {
+		if(_stream.avail_in == 0) {
+			const auto read = _device->read(_buffer.data(), _buffer.size());
+			if(read < 0) {
+				fail(QStringLiteral("Failed to read compressed data with error: ") + _device->errorString());
+				return -1;
+			} else if(read == 0) {
+				// not an error yet, if a sequential source simply has no more data available at the moment
+				if(_device->isSequential() ?
+					   (_sourceFinished || !_device->isOpen()) :
+					   _device->atEnd()) {
+					fail(QStringLiteral("Unexpected end of compressed data"));
+					return -1;
+				}
+				break;
+			}
+			_stream.next_in = reinterpret_cast<Bytef*>(_buffer.data());
+			_stream.avail_in = static_cast<uInt>(read);
+		}
+
+		const auto result = inflate(&_stream, Z_NO_FLUSH);
+		if(result == Z_STREAM_END) {
+			_streamEnd = true;
+			break;
+		} else if(result != Z_OK) {
+			fail(QStringLiteral("Failed to decompress data with error: ") +
+				 QString::fromUtf8(_stream.msg ? _stream.msg : "unknown error"));
+			return -1;
+		}
+	}
+
+	return maxlen - _stream.avail_out;
+}
+
+qint64 QJsonCompressionDevice::writeData(const char *data, qint64 len)
+{
+	if(_failed || !_streamActive)
+		return -1;
+
+	auto remaining = len;
+	while(remaining > 0) {
+		const auto chunk = qMin<qint64>(remaining, std::numeric_limits<uInt>::max());
+		_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data + (len - remaining)));
+		_stream.avail_in = static_cast<uInt>(chunk);
+		if(!deflateChunks(Z_NO_FLUSH))
+			return -1;
+		remaining -= chunk;
+	}
+	return len;
+}
+
+bool QJsonCompressionDevice::deflateChunks(int flush)
+{
+	// compress all pending input and pass every completed chunk to the target device immediately
+	auto result = Z_OK;
+	do {
+		_stream.next_out = reinterpret_cast<Bytef*>(_buffer.data());
+		_stream.avail_out = static_cast<uInt>(_buffer.size());
+		result = deflate(&_stream, flush);
+		if(result == Z_STREAM_ERROR) {
+			fail(QStringLiteral("Failed to compress data"));
+			return false;
+		}
+
+		const auto size = _buffer.size() - static_cast<int>(_stream.avail_out);
+		if(size > 0 && _device->write(_buffer.constData(), size) != size) {
+			fail(QStringLiteral("Failed to write compressed data with error: ") + _device->errorString());
+			return false;
+		}
+	} while(_stream.avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+	return true;
+}
+
+void QJsonCompressionDevice::fail(const QString &message)
+{
+	_failed = true;
+	setErrorString(message);
+}
+
+void QJsonCompressionDevice::endStream()
+{
+	if(!_streamActive)
+		return;
+	if(openMode().testFlag(QIODevice::WriteOnly))
+		deflateEnd(&_stream);
+	else
+		inflateEnd(&_stream);
+	_streamActive = false;
+}
@@ -0,0 +1,60 @@
+#ifndef QJSONCOMPRESSIONDEVICE_P_H
+#define QJSONCOMPRESSIONDEVICE_P_H
+
+#include "qtjsonserializer_global.h"
+#include "qjsonserializer.h"
+
+#include <QtCore/QIODevice>
+#include <QtCore/QByteArray>
+
+#include <limits>
+
+#include <zlib.h>
+
+// Sequential device that compresses everything written to it into the wrapped device (WriteOnly), or
+// decompresses the wrapped device while being read (ReadOnly). Data is processed in chunks, so neither
+// the compressed nor the uncompressed data is ever held completely
+class Q_JSONSERIALIZER_EXPORT QJsonCompressionDevice : public QIODevice
+{
+	Q_DISABLE_COPY(QJsonCompressionDevice)
+
+public:
+	// the size of the chunks passed to zlib, and a good size for the chunks written to the device
+	static const int ChunkSize = 64 * 1024;
+
+	QJsonCompressionDevice(QIODevice *device,
+						   QJsonSerializer::Compression compression = QJsonSerializer::Compression::Gzip,
+						   int level = Z_DEFAULT_COMPRESSION);
+	~QJsonCompressionDevice() override;
+
+	bool isSequential() const override;
+	bool open(OpenMode mode) override;
+	void close() override;
+	// waits for more compressed data on the source device
+	bool waitForReadyRead(int msecs) override;
+
+	bool hasFailed() const;
+	// reading: whether the end of the compressed stream was reached
+	bool atStreamEnd() const;
+
+protected:
+	qint64 readData(char *data, qint64 maxlen) override;
+	qint64 writeData(const char *data, qint64 len) override;
+
+private:
+	QIODevice *_device;
+	QJsonSerializer::Compression _compression;
+	int _level;
+	z_stream _stream;
+	bool _streamActive = false;
+	bool _streamEnd = false;
+	bool _sourceFinished = false;
+	bool _failed = false;
+	QByteArray _buffer;
+
+	bool deflateChunks(int flush);
+	void fail(const QString &message);
+	void endStream();
+};
+
+#endif // QJSONCOMPRESSIONDEVICE_P_H
@@ -2,36 +2,89 @@
 
 #include <QtCore/qdebug.h>
 
-QThreadStorage<QJsonSerializationException::PropertyTrace> QJsonExceptionContext::contextStore;
+QThreadStorage<QVector<QJsonExceptionContext::Entry>> QJsonExceptionContext::contextStore;
 
 QJsonExceptionContext::QJsonExceptionContext(const QMetaProperty &property)
 {
-	contextStore.localData().push({
-									  property.name(),
-									  property.isEnumType() ?
-										 property.enumerator().name() :
-										 property.typeName()
-								  });
+	contextStore.localData().append(entry(property));
 }
 
 QJsonExceptionContext::QJsonExceptionContext(int propertyType, const QByteArray &hint)
 {
-	contextStore.localData().push({
-									  hint.isNull() ? QByteArray("<unnamed>") : hint,
-									  QMetaType::typeName(propertyType)
-								  });
+	contextStore.localData().append(entry(propertyType, hint));
+}
+
+QJsonExceptionContext::QJsonExceptionContext(const QVector<Entry> &entries) :
+	_count{entries.size()}
+{
+	if(_count > 0)
+		contextStore.localData().append(entries);
 }
 
 QJsonExceptionContext::~QJsonExceptionContext()
 {
+	if(_count == 0)
+		return;
 	auto &context = contextStore.localData();
-	if(context.isEmpty())
+	if(context.size() < _count)
 		qWarning() << "Corrupted context store";
 	else
-		context.pop();
+		context.resize(context.size() - _count);
+}
+
+QJsonExceptionContext::Entry QJsonExceptionContext::entry(const QMetaProperty &property)
+{
+	return {
+		property.name(),
+		property.isEnumType() ?
+			property.enumerator().name() :
+			property.typeName(),
+		nullptr,
+		QMetaType::UnknownType
+	};
+}
+
+QJsonExceptionContext::Entry QJsonExceptionContext::entry(int propertyType, const QByteArray &hint)
+{
+	return {
+		nullptr,
+		nullptr,
+		&hint,
+		propertyType
+	};
 }
 
 QJsonSerializationException::PropertyTrace QJsonExceptionContext::currentContext()
 {
-	return contextStore.localData();
+	QJsonSerializationException::PropertyTrace trace;
+	const auto &context = contextStore.localData();
+	trace.reserve(context.size());
+	for(const auto &entry : context) {
+		if(entry.hint) {
+			trace.push({
+						   entry.hint->isNull() ? QByteArray("<unnamed>") : *entry.hint,
+						   QMetaType::typeName(entry.propertyType)
+					   });
+		} else
+			trace.push({entry.name, entry.typeName});
+	}
+	return trace;
+}
+
+void QJsonExceptionContext::indexHint(QByteArray &hint, int index, char open, char close)
+{
+	char digits[16];
+	auto pos = static_cast<int>(sizeof(digits));
+	auto value = static_cast<uint>(qAbs(index));
+	do {
+		digits[--pos] = static_cast<char>('0' + value % 10);
+		value /= 10;
+	} while(value > 0);
+	if(index < 0)
+		digits[--pos] = '-';
+
+	hint.resize(0);
+	hint.append(open);
+	hint.append(digits + pos, static_cast<int>(sizeof(digits)) - pos);
+	hint.append(close);
 }
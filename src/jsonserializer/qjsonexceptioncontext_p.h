@@ -6,18 +6,39 @@
 
 #include <QtCore/QMetaProperty>
 #include <QtCore/QThreadStorage>
+#include <QtCore/QVector>
 
 class Q_JSONSERIALIZER_EXPORT QJsonExceptionContext
 {
+	Q_DISABLE_COPY(QJsonExceptionContext)
+
 public:
+	// only pointers are kept for every value, the trace is created when an exception needs it
+	struct Entry {
+		const char *name;
+		const char *typeName;
+		const QByteArray *hint;
+		int propertyType;
+	};
+
 	QJsonExceptionContext(const QMetaProperty &property);
+	// the hint is referenced, not copied, and must outlive the context
 	QJsonExceptionContext(int propertyType, const QByteArray &hint);
+	// enters the entries of values that are produced over several calls again, see QJsonValueProducer
+	QJsonExceptionContext(const QVector<Entry> &entries);
 	~QJsonExceptionContext();
 
+	static Entry entry(const QMetaProperty &property);
+	static Entry entry(int propertyType, const QByteArray &hint);
+
 	static QJsonSerializationException::PropertyTrace currentContext();
+	// writes "<open><index><close>" into hint, reusing its memory once it was reserved
+	static void indexHint(QByteArray &hint, int index, char open, char close);
 
 private:
-	static QThreadStorage<QJsonSerializationException::PropertyTrace> contextStore;
+	static QThreadStorage<QVector<Entry>> contextStore;
+
+	int _count = 1;
 };
 
 #endif // QJSONEXCEPTIONCONTEXT_P_H
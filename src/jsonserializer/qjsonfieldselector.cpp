@@ -0,0 +1,265 @@
+#include "qjsonfieldselector.h"
+#include "qjsonfieldselector_p.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+
+namespace {
+
+const QString Wildcard = QStringLiteral("*");
+
+}
+
+QJsonFieldSelector::QJsonFieldSelector() :
+	d{new QJsonFieldSelectorData{}}
+{}
+
+QJsonFieldSelector::QJsonFieldSelector(std::initializer_list<QString> paths) :
+	QJsonFieldSelector{}
+{
+	for(const auto &path : paths)
+		d->addPath(path);
+}
+
+QJsonFieldSelector::QJsonFieldSelector(const QStringList &paths) :
+	QJsonFieldSelector{}
+{
+	for(const auto &path : paths)
+		d->addPath(path);
+}
+
+QJsonFieldSelector::QJsonFieldSelector(const QJsonFieldSelector &other) = default;
+
+QJsonFieldSelector::QJsonFieldSelector(QJsonFieldSelector &&other) noexcept = default;
+
+QJsonFieldSelector::~QJsonFieldSelector() = default;
+
+QJsonFieldSelector &QJsonFieldSelector::operator=(const QJsonFieldSelector &other) = default;
+
+QJsonFieldSelector &QJsonFieldSelector::operator=(QJsonFieldSelector &&other) noexcept = default;
+
+QJsonFieldSelector &QJsonFieldSelector::addPath(const QString &path)
+{
+	d->addPath(path);
+	return *this;
+}
+
+bool QJsonFieldSelector::isEmpty() const
+{
+	return d->paths.isEmpty();
+}
+
+QStringList QJsonFieldSelector::paths() const
+{
+	return d->paths;
+}
+
+bool QJsonFieldSelector::isSelected(const QString &path) const
+{
+	const QJsonFieldSelectorData::Node *node = d->root.data();
+	if(!node)
+		return true;
+	for(const auto &key : QJsonFieldSelectorData::splitPath(path)) {
+		auto selected = true;
+		node = node->child(key, selected);
+		if(!selected)
+			return false;
+		else if(!node)
+			return true;
+	}
+	return true;
+}
+
+
+
+QJsonFieldSelectorData::QJsonFieldSelectorData(const QJsonFieldSelectorData &other) :
+	QSharedData{other}
+{
+	for(const auto &path : other.paths)
+		addPath(path);
+}
+
+const QJsonFieldSelectorData::Node *QJsonFieldSelectorData::Node::child(const QString &key, bool &selected) const
+{
+	if(all) {
+		selected = true;
+		return nullptr;
+	}
+
+	auto it = children.constFind(key);
+	if(it == children.constEnd())
+		it = children.constFind(Wildcard);
+	if(it == children.constEnd()) {
+		selected = false;
+		return nullptr;
+	}
+
+	selected = true;
+	return (*it)->all ? nullptr : it->data();
+}
+
+void QJsonFieldSelectorData::addPath(const QString &path)
+{
+	paths.append(path);
+	if(!root)
+		root.reset(new Node{});
+
+	auto node = root.data();
+	for(const auto &key : splitPath(path)) {
+		if(node->all)
+			return;
+		auto &child = node->children[key];
+		if(!child)
+			child.reset(new Node{});
+		node = child.data();
+	}
+	node->all = true;
+	node->children.clear();
+}
+
+QStringList QJsonFieldSelectorData::splitPath(const QString &path)
+{
+	// json pointer syntax: "/a/b", with "~1" for "/" and "~0" for "~" within keys
+	auto keys = path.split(QLatin1Char('/'), QString::SkipEmptyParts);
+	for(auto &key : keys) {
+		key.replace(QStringLiteral("~1"), QStringLiteral("/"));
+		key.replace(QStringLiteral("~0"), QStringLiteral("~"));
+	}
+	return keys;
+}
+
+
+
+QThreadStorage<QJsonFieldSelectorContext::State> QJsonFieldSelectorContext::stateStore;
+QAtomicInt QJsonFieldSelectorContext::activeSelectors;
+
+QJsonFieldSelectorContext::QJsonFieldSelectorContext(const QJsonFieldSelector &selector) :
+	_data{selector.d}
+{
+	auto &state = stateStore.localData();
+	_previous = state.node;
+	state.node = _data.constData()->root.data();
+	activeSelectors.ref();
+}
+
+QJsonFieldSelectorContext::~QJsonFieldSelectorContext()
+{
+	activeSelectors.deref();
+	stateStore.localData().node = _previous;
+}
+
+const QJsonFieldSelectorData::Node *QJsonFieldSelectorContext::current()
+{
+	if(Q_LIKELY(activeSelectors.load() == 0) || !stateStore.hasLocalData())
+		return nullptr;
+	return stateStore.localData().node;
+}
+
+bool QJsonFieldSelectorContext::isSelectedImpl(const QString &key)
+{
+	const auto node = stateStore.localData().node;
+	if(!node)
+		return true;
+	auto selected = true;
+	node->child(key, selected);
+	return selected;
+}
+
+bool QJsonFieldSelectorContext::hasSelectionImpl()
+{
+	return stateStore.localData().node != nullptr;
+}
+
+QJsonValue QJsonFieldSelectorContext::select(const QJsonValue &json)
+{
+	if(Q_LIKELY(activeSelectors.load() == 0))
+		return json;
+	return selectImpl(json, stateStore.localData().node);
+}
+
+QJsonValue QJsonFieldSelectorContext::selectImpl(const QJsonValue &json, const QJsonFieldSelectorData::Node *node)
+{
+	if(!node)
+		return json;
+
+	switch(json.type()) {
+	case QJsonValue::Object: {
+		const auto object = json.toObject();
+		QJsonObject result;
+		for(auto it = object.constBegin(); it != object.constEnd(); ++it) {
+			auto selected = true;
+			const auto child = node->child(it.key(), selected);
+			if(selected)
+				result.insert(it.key(), selectImpl(it.value(), child));
+		}
+		return result;
+	}
+	case QJsonValue::Array: {
+		const auto array = json.toArray();
+		QJsonArray result;
+		for(auto i = 0; i < array.size(); ++i) {
+			auto selected = true;
+			const auto child = node->child(QString::number(i), selected);
+			if(selected)
+				result.append(selectImpl(array.at(i), child));
+		}
+		return result;
+	}
+	default:
+		return json;
+	}
+}
+
+QJsonFieldSelectorContext::Step::Step(const QString &key)
+{
+	if(Q_UNLIKELY(activeSelectors.load() > 0))
+		enter(key);
+}
+
+QJsonFieldSelectorContext::Step::Step(const char *key)
+{
+	if(Q_UNLIKELY(activeSelectors.load() > 0))
+		enter(QString::fromUtf8(key));
+}
+
+QJsonFieldSelectorContext::Step::Step(int index)
+{
+	if(Q_UNLIKELY(activeSelectors.load() > 0))
+		enter(QString::number(index));
+}
+
+QJsonFieldSelectorContext::Step::~Step()
+{
+	if(_pushed)
+		stateStore.localData().node = _previous;
+}
+
+QJsonFieldSelectorContext::Position::Position(const QJsonFieldSelectorData::Node *node)
+{
+	if(Q_LIKELY(activeSelectors.load() == 0))
+		return;
+	auto &state = stateStore.localData();
+	_previous = state.node;
+	state.node = node;
+	_pushed = true;
+}
+
+QJsonFieldSelectorContext::Position::~Position()
+{
+	if(_pushed)
+		stateStore.localData().node = _previous;
+}
+
+void QJsonFieldSelectorContext::Step::enter(const QString &key)
+{
+	auto &state = stateStore.localData();
+	if(!state.node)
+		return;
+
+	_previous = state.node;
+	const auto child = state.node->child(key, _selected);
+	if(_selected) {
+		state.node = child;
+		_pushed = true;
+	}
+}
@@ -0,0 +1,49 @@
+#ifndef QJSONFIELDSELECTOR_H
+#define QJSONFIELDSELECTOR_H
+
+#include "QtJsonSerializer/qtjsonserializer_global.h"
+
+#include <initializer_list>
+
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qshareddata.h>
+
+class QJsonFieldSelectorData;
+//! A set of json paths that limits de/serialization to the selected fields
+class Q_JSONSERIALIZER_EXPORT QJsonFieldSelector
+{
+public:
+	//! Default constructor, selects everything
+	QJsonFieldSelector();
+	//! Constructor with a list of paths to select
+	QJsonFieldSelector(std::initializer_list<QString> paths);
+	//! Constructor with a list of paths to select
+	explicit QJsonFieldSelector(const QStringList &paths);
+	//! Copy constructor
+	QJsonFieldSelector(const QJsonFieldSelector &other);
+	//! Move constructor
+	QJsonFieldSelector(QJsonFieldSelector &&other) noexcept;
+	~QJsonFieldSelector();
+
+	//! Copy assignment operator
+	QJsonFieldSelector &operator=(const QJsonFieldSelector &other);
+	//! Move assignment operator
+	QJsonFieldSelector &operator=(QJsonFieldSelector &&other) noexcept;
+
+	//! Adds another path to the selection
+	QJsonFieldSelector &addPath(const QString &path);
+
+	//! Returns true, if no paths have been added
+	bool isEmpty() const;
+	//! Returns all paths that have been added
+	QStringList paths() const;
+	//! Checks whether the value at the given path would be de/serialized
+	bool isSelected(const QString &path) const;
+
+private:
+	friend class QJsonFieldSelectorContext;
+	QSharedDataPointer<QJsonFieldSelectorData> d;
+};
+
+#endif // QJSONFIELDSELECTOR_H
@@ -0,0 +1,117 @@
+#ifndef QJSONFIELDSELECTOR_P_H
+#define QJSONFIELDSELECTOR_P_H
+
+#include "qtjsonserializer_global.h"
+#include "qjsonfieldselector.h"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QHash>
+#include <QtCore/QJsonValue>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThreadStorage>
+
+class Q_JSONSERIALIZER_EXPORT QJsonFieldSelectorData : public QSharedData
+{
+public:
+	struct Node {
+		// the whole subtree below this node is selected
+		bool all = false;
+		QHash<QString, QSharedPointer<Node>> children;
+
+		const Node *child(const QString &key, bool &selected) const;
+	};
+
+	QJsonFieldSelectorData() = default;
+	// the node tree is rebuilt, so detached copies never modify the nodes of the original
+	QJsonFieldSelectorData(const QJsonFieldSelectorData &other);
+
+	QStringList paths;
+	QSharedPointer<Node> root;
+
+	void addPath(const QString &path);
+	static QStringList splitPath(const QString &path);
+};
+
+// Active while a value is de/serialized with a field selector. The converters of named fields (object and
+// gadget properties, map keys and list elements) create a step for each field, which decides whether the
+// field is de/serialized at all and selects the paths below the field while the step exists
+class Q_JSONSERIALIZER_EXPORT QJsonFieldSelectorContext
+{
+	Q_DISABLE_COPY(QJsonFieldSelectorContext)
+
+public:
+	class Q_JSONSERIALIZER_EXPORT Step
+	{
+		Q_DISABLE_COPY(Step)
+
+	public:
+		Step(const QString &key);
+		// only converts the key if a selector is active, for property names
+		Step(const char *key);
+		Step(int index);
+		~Step();
+
+		inline bool isSelected() const {
+			return _selected;
+		}
+
+	private:
+		bool _selected = true;
+		bool _pushed = false;
+		const QJsonFieldSelectorData::Node *_previous = nullptr;
+
+		void enter(const QString &key);
+	};
+
+	// Makes a selection returned by current() active again while it exists, for values that are produced
+	// over several calls (see QJsonValueProducer). The selector itself must still be active
+	class Q_JSONSERIALIZER_EXPORT Position
+	{
+		Q_DISABLE_COPY(Position)
+
+	public:
+		Position(const QJsonFieldSelectorData::Node *node);
+		~Position();
+
+	private:
+		const QJsonFieldSelectorData::Node *_previous = nullptr;
+		bool _pushed = false;
+	};
+
+	QJsonFieldSelectorContext(const QJsonFieldSelector &selector);
+	~QJsonFieldSelectorContext();
+
+	// the selection below the current value - nullptr if everything is selected
+	static const QJsonFieldSelectorData::Node *current();
+
+	// checks a field without entering it - cheap as long as no selector is used at all
+	static inline bool isSelected(const QString &key) {
+		return Q_LIKELY(activeSelectors.load() == 0) || isSelectedImpl(key);
+	}
+	static inline bool isSelected(const char *key) {
+		return Q_LIKELY(activeSelectors.load() == 0) || isSelectedImpl(QString::fromUtf8(key));
+	}
+	// true, if not everything below the current value is selected
+	static inline bool hasSelection() {
+		return Q_UNLIKELY(activeSelectors.load() > 0) && hasSelectionImpl();
+	}
+	// returns only the selected parts of json data below the current value, i.e. for raw values of lazies
+	static QJsonValue select(const QJsonValue &json);
+
+private:
+	struct State {
+		// nullptr: everything below the current value is selected
+		const QJsonFieldSelectorData::Node *node = nullptr;
+	};
+	static QThreadStorage<State> stateStore;
+	static QAtomicInt activeSelectors;
+
+	QSharedDataPointer<QJsonFieldSelectorData> _data;
+	const QJsonFieldSelectorData::Node *_previous;
+
+	static bool isSelectedImpl(const QString &key);
+	static bool hasSelectionImpl();
+	static QJsonValue selectImpl(const QJsonValue &json, const QJsonFieldSelectorData::Node *node);
+};
+
+#endif // QJSONFIELDSELECTOR_P_H
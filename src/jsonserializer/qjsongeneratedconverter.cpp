@@ -0,0 +1,63 @@
+#include "qjsongeneratedconverter.h"
+#include "qjsonserializer_p.h"
+#include "qjsonserializeroptions_p.h"
+#include "qjsonfieldselector_p.h"
+#include "qjsonstringpool_p.h"
+
+class QJsonGeneratedConverterStep : public QJsonFieldSelectorContext::Step
+{
+public:
+	using Step::Step;
+};
+
+QJsonGeneratedConverter::FieldStep::FieldStep(const QString &key)
+{
+	// steps only have an effect below a selection, so nothing is allocated without one
+	if(Q_UNLIKELY(QJsonFieldSelectorContext::hasSelection()))
+		d.reset(new QJsonGeneratedConverterStep{key});
+}
+
+QJsonGeneratedConverter::FieldStep::FieldStep(const char *name)
+{
+	if(Q_UNLIKELY(QJsonFieldSelectorContext::hasSelection()))
+		d.reset(new QJsonGeneratedConverterStep{name});
+}
+
+QJsonGeneratedConverter::FieldStep::~FieldStep() = default;
+
+bool QJsonGeneratedConverter::FieldStep::isSelected() const
+{
+	return !d || d->isSelected();
+}
+
+
+
+QJsonGeneratedConverter::QJsonGeneratedConverter() = default;
+
+bool QJsonGeneratedConverter::isSelected(const char *name)
+{
+	return QJsonFieldSelectorContext::isSelected(name);
+}
+
+QString QJsonGeneratedConverter::intern(const QString &string)
+{
+	return QJsonStringPool::intern(string);
+}
+
+QJsonSerializerOptions QJsonGeneratedConverter::options(const SerializationHelper *helper)
+{
+	return QJsonSerializerPrivate::callOptions(helper);
+}
+
+bool QJsonGeneratedConverter::canAccessDirectly(int metaTypeId, const SerializationHelper *helper)
+{
+	// only the serializer of the running call can be asked for its converters
+	const auto context = QJsonSerializerPrivate::context(helper);
+	if(!context)
+		return false;
+	// traces are written by the helper
+	if(context->tracer())
+		return false;
+	// the built-in conversion of scalars is only used if no converter was registered for the type
+	return !context->serializer()->d->findConverter(metaTypeId);
+}
@@ -0,0 +1,46 @@
+#ifndef QJSONGENERATEDCONVERTER_H
+#define QJSONGENERATEDCONVERTER_H
+
+#include "QtJsonSerializer/qtjsonserializer_global.h"
+#include "QtJsonSerializer/qjsontypeconverter.h"
+#include "QtJsonSerializer/qjsonserializeroptions.h"
+
+#include <QtCore/qstring.h>
+#include <QtCore/qscopedpointer.h>
+
+class QJsonGeneratedConverterStep;
+//! The base class of the converters created by qjsonserializergen
+class Q_JSONSERIALIZER_EXPORT QJsonGeneratedConverter : public QJsonTypeConverter
+{
+public:
+	//! Enters a field of the current value, as long as the step exists
+	class Q_JSONSERIALIZER_EXPORT FieldStep
+	{
+		Q_DISABLE_COPY(FieldStep)
+	public:
+		//! Constructor with the key of the field
+		explicit FieldStep(const QString &key);
+		//! Constructor with the name of the property of the field
+		explicit FieldStep(const char *name);
+		~FieldStep();
+
+		//! Checks whether the field is selected by the field selector of the running call
+		bool isSelected() const;
+
+	private:
+		QScopedPointer<QJsonGeneratedConverterStep> d;
+	};
+
+	QJsonGeneratedConverter();
+
+	//! Checks whether the property is selected, without entering it
+	static bool isSelected(const char *name);
+	//! Returns the pooled copy of a deserialized string, if the running call uses a string pool
+	static QString intern(const QString &string);
+	//! Returns the options of the running call
+	static QJsonSerializerOptions options(const SerializationHelper *helper);
+	//! Checks whether values of the given type can be converted without calling the helper
+	static bool canAccessDirectly(int metaTypeId, const SerializationHelper *helper);
+};
+
+#endif // QJSONGENERATEDCONVERTER_H
@@ -0,0 +1,108 @@
+#include "qjsonlazy.h"
+#include "qjsonlazy_p.h"
+#include "qjsonserializerexception.h"
+#include "qjsonserializer_p.h"
+#include "qjsonserializeroptions_p.h"
+
+QJsonLazyBase::QJsonLazyBase() = default;
+
+QJsonLazyBase::QJsonLazyBase(const QVariant &value) :
+	d{new QJsonLazyData{value}}
+{}
+
+QJsonLazyBase::QJsonLazyBase(int metaTypeId, const QJsonValue &json, QObject *parent, const QJsonTypeConverter::SerializationHelper *helper) :
+	d{new QJsonLazyData{metaTypeId, json, parent, helper}}
+{}
+
+QJsonLazyBase::QJsonLazyBase(const QJsonLazyBase &other) = default;
+
+QJsonLazyBase::QJsonLazyBase(QJsonLazyBase &&other) noexcept = default;
+
+QJsonLazyBase::~QJsonLazyBase() = default;
+
+QJsonLazyBase &QJsonLazyBase::operator=(const QJsonLazyBase &other) = default;
+
+QJsonLazyBase &QJsonLazyBase::operator=(QJsonLazyBase &&other) noexcept = default;
+
+bool QJsonLazyBase::isLoaded() const
+{
+	return !d || d->isLoaded();
+}
+
+QJsonValue QJsonLazyBase::json() const
+{
+	return d ? d->json() : QJsonValue{QJsonValue::Undefined};
+}
+
+QVariant QJsonLazyBase::variant() const
+{
+	return d ? d->load() : QVariant{};
+}
+
+
+
+QJsonLazyData::QJsonLazyData(const QVariant &value) :
+	_loaded{true},
+	_value{value}
+{}
+
+QJsonLazyData::QJsonLazyData(int metaTypeId, const QJsonValue &json, QObject *parent, const QJsonTypeConverter::SerializationHelper *helper) :
+	_loaded{false},
+	_metaTypeId{metaTypeId},
+	_json{json},
+	_parent{parent},
+	_hasParent{parent != nullptr},
+	_helper{helper}
+{
+	// the serializer only passes itself as helper while one of its calls is running, which is when its options are known
+	const auto context = QJsonSerializerPrivate::context(helper);
+	if(context) {
+		_serializer = context->serializer();
+		_options = context->options();
+		_tracer = context->tracerRef();
+		_helperObject = _serializer;
+	} else
+		_helperObject = dynamic_cast<const QObject*>(helper);
+	_helperTracked = !_helperObject.isNull();
+}
+
+bool QJsonLazyData::isLoaded() const
+{
+	QMutexLocker lock{&_mutex};
+	return _loaded;
+}
+
+QJsonValue QJsonLazyData::json() const
+{
+	QMutexLocker lock{&_mutex};
+	return _loaded ? QJsonValue{QJsonValue::Undefined} : _json;
+}
+
+QVariant QJsonLazyData::load()
+{
+	// other threads wait for the value instead of loading it a second time
+	QMutexLocker lock{&_mutex};
+	if(_loaded)
+		return _value;
+	if(!_helper || (_helperTracked && !_helperObject))
+		throw QJsonDeserializationException("The serializer of a lazy value was destroyed before the value was loaded");
+	// objects created without their parent would never be deleted
+	if(_hasParent && !_parent)
+		throw QJsonDeserializationException("The parent of a lazy value was destroyed before the value was loaded");
+
+	if(_serializer) {
+		QJsonOptionsContext options{_serializer, _options, _tracer};
+		_value = _helper->deserializeSubtype(_metaTypeId, _json, _parent, QByteArrayLiteral("lazy"));
+	} else
+		_value = _helper->deserializeSubtype(_metaTypeId, _json, _parent, QByteArrayLiteral("lazy"));
+	_loaded = true;
+	// the json slice is not needed anymore
+	_json = QJsonValue{};
+	_parent.clear();
+	_helper = nullptr;
+	_helperObject.clear();
+	_serializer = nullptr;
+	_options = QJsonSerializerOptions{};
+	_tracer.reset();
+	return _value;
+}
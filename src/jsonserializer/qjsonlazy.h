@@ -0,0 +1,75 @@
+#ifndef QJSONLAZY_H
+#define QJSONLAZY_H
+
+#include "QtJsonSerializer/qtjsonserializer_global.h"
+#include "QtJsonSerializer/qjsontypeconverter.h"
+
+#include <QtCore/qjsonvalue.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qsharedpointer.h>
+
+class QJsonLazyData;
+//! The type independent part of QJsonLazy, used by the serializer to handle all lazy types alike
+class Q_JSONSERIALIZER_EXPORT QJsonLazyBase
+{
+public:
+	//! Default constructor, creates a loaded, invalid value
+	QJsonLazyBase();
+	//! Constructor for an already loaded value
+	QJsonLazyBase(const QVariant &value);
+	//! Constructor for a value that is deserialized from json once it is accessed
+	QJsonLazyBase(int metaTypeId, const QJsonValue &json, QObject *parent, const QJsonTypeConverter::SerializationHelper *helper);
+	//! Copy constructor
+	QJsonLazyBase(const QJsonLazyBase &other);
+	//! Move constructor
+	QJsonLazyBase(QJsonLazyBase &&other) noexcept;
+	~QJsonLazyBase();
+
+	//! Copy assignment operator
+	QJsonLazyBase &operator=(const QJsonLazyBase &other);
+	//! Move assignment operator
+	QJsonLazyBase &operator=(QJsonLazyBase &&other) noexcept;
+
+	//! Returns true, if the value has already been deserialized
+	bool isLoaded() const;
+	//! Returns the json of the value, as long as it has not been loaded yet
+	QJsonValue json() const;
+	//! Returns the value, deserializing it first if necessary
+	QVariant variant() const;
+
+private:
+	QSharedPointer<QJsonLazyData> d;
+};
+
+//! A handle to a value that is only deserialized on first access
+template <typename T>
+class QJsonLazy : public QJsonLazyBase
+{
+public:
+	//! Default constructor, holds a default constructed T
+	inline QJsonLazy() :
+		QJsonLazyBase{QVariant::fromValue(T{})}
+	{}
+	//! Constructor for an already loaded value
+	inline QJsonLazy(const T &value) :
+		QJsonLazyBase{QVariant::fromValue(value)}
+	{}
+	//! Constructor from the type independent base
+	inline explicit QJsonLazy(const QJsonLazyBase &base) :
+		QJsonLazyBase{base}
+	{}
+
+	//! Returns the value, deserializing it first if necessary
+	inline T value() const {
+		return variant().template value<T>();
+	}
+	//! @copydoc QJsonLazy::value
+	inline T operator*() const {
+		return value();
+	}
+};
+
+Q_DECLARE_METATYPE(QJsonLazyBase)
+Q_DECLARE_METATYPE_TEMPLATE_1ARG(QJsonLazy)
+
+#endif // QJSONLAZY_H
@@ -0,0 +1,45 @@
+#ifndef QJSONLAZY_P_H
+#define QJSONLAZY_P_H
+
+#include "qtjsonserializer_global.h"
+#include "qjsonlazy.h"
+#include "qjsonserializeroptions.h"
+#include "qjsonserializertracer.h"
+
+#include <QtCore/QMutex>
+#include <QtCore/QPointer>
+
+class Q_JSONSERIALIZER_EXPORT QJsonLazyData
+{
+	Q_DISABLE_COPY(QJsonLazyData)
+
+public:
+	QJsonLazyData(const QVariant &value);
+	QJsonLazyData(int metaTypeId, const QJsonValue &json, QObject *parent, const QJsonTypeConverter::SerializationHelper *helper);
+
+	bool isLoaded() const;
+	QJsonValue json() const;
+	QVariant load();
+
+private:
+	// copies of the value can be accessed from different threads, so all members are guarded by the mutex
+	mutable QMutex _mutex;
+	bool _loaded;
+	QVariant _value;
+
+	// only valid as long as the value has not been loaded
+	int _metaTypeId = QMetaType::UnknownType;
+	QJsonValue _json;
+	QPointer<QObject> _parent;
+	bool _hasParent = false;
+	const QJsonTypeConverter::SerializationHelper *_helper = nullptr;
+	// tracks the lifetime of the helper, if it is an object (like the serializer itself)
+	QPointer<const QObject> _helperObject;
+	bool _helperTracked = false;
+	// the options of the call that read the json, if the helper is a serializer
+	const QJsonSerializer *_serializer = nullptr;
+	QJsonSerializerOptions _options;
+	QSharedPointer<QJsonSerializerTracer> _tracer;
+};
+
+#endif // QJSONLAZY_P_H
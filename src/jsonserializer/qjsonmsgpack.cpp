@@ -0,0 +1,530 @@
+#include "qjsonmsgpack_p.h"
+#include "qjsonserializerexception.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QtEndian>
+
+namespace {
+
+// integers up to 2^53 can be stored in a double without loosing precision
+const qint64 MaxSafeInteger = Q_INT64_C(9007199254740992);
+const int BufferSize = 64 * 1024;
+const quint32 MaxElementSize = std::numeric_limits<int>::max() / 2;
+const int MaxDepth = 1024;
+
+const QLatin1String MarkerPrefix{"@msgpack:"};
+
+enum MsgPackType : quint8 {
+	Nil = 0xc0,
+	False = 0xc2,
+	True = 0xc3,
+	Bin8 = 0xc4,
+	Bin16 = 0xc5,
+	Bin32 = 0xc6,
+	Float32 = 0xca,
+	Float64 = 0xcb,
+	UInt8 = 0xcc,
+	UInt16 = 0xcd,
+	UInt32 = 0xce,
+	UInt64 = 0xcf,
+	Int8 = 0xd0,
+	Int16 = 0xd1,
+	Int32 = 0xd2,
+	Int64 = 0xd3,
+	Str8 = 0xd9,
+	Str16 = 0xda,
+	Str32 = 0xdb,
+	Array16 = 0xdc,
+	Array32 = 0xdd,
+	Map16 = 0xde,
+	Map32 = 0xdf,
+
+	FixMap = 0x80,
+	FixArray = 0x90,
+	FixStr = 0xa0
+};
+
+}
+
+
+
+QThreadStorage<QJsonMsgPackContext::ContextRef> QJsonMsgPackContext::contextStore;
+
+QJsonMsgPackContext::QJsonMsgPackContext() :
+	_markerKey{MarkerPrefix + QString::number(QRandomGenerator::global()->generate64(), 16) + QString::number(QRandomGenerator::global()->generate64(), 16)}
+{
+	auto &ref = contextStore.localData();
+	_previous = ref.context;
+	ref.context = this;
+}
+
+QJsonMsgPackContext::~QJsonMsgPackContext()
+{
+	contextStore.localData().context = _previous;
+}
+
+QJsonMsgPackContext *QJsonMsgPackContext::current()
+{
+	return contextStore.hasLocalData() ?
+				contextStore.localData().context :
+				nullptr;
+}
+
+QJsonValue QJsonMsgPackContext::storeNative(const QVariant &value)
+{
+	_natives.append(value);
+	return QJsonObject {
+		{_markerKey, _natives.size() - 1}
+	};
+}
+
+bool QJsonMsgPackContext::findNative(const QJsonObject &object, QVariant &native) const
+{
+	if(object.size() != 1)
+		return false;
+	const auto it = object.constFind(_markerKey);
+	if(it == object.constEnd())
+		return false;
+	const auto index = it.value().toInt(-1);
+	if(index < 0 || index >= _natives.size())
+		return false;
+	native = _natives[index];
+	return true;
+}
+
+bool QJsonMsgPackContext::deserializeNative(int propertyType, const QJsonTypeConverter *converter, QJsonValue &value, QVariant &native) const
+{
+	if(_natives.isEmpty())
+		return false;
+
+	switch(propertyType) {
+	case QMetaType::QJsonValue:
+	case QMetaType::QJsonObject:
+	case QMetaType::QJsonArray:
+		value = toJson(value);
+		return false;
+	case QMetaType::QByteArray:
+	case QMetaType::LongLong:
+	case QMetaType::ULongLong:
+		// custom converters get the json they would have created
+		if(!QJsonValueSink::isNative(propertyType, converter)) {
+			value = toJson(value);
+			return false;
+		}
+		break;
+	default:
+		break;
+	}
+
+	if(!value.isObject() || !findNative(value.toObject(), native))
+		return false;
+	if(propertyType != QMetaType::UnknownType && propertyType != QMetaType::QVariant) {
+		const QByteArray typeName = native.typeName();
+		if(!native.convert(propertyType)) {
+			throw QJsonDeserializationException(QByteArray("Failed to convert MessagePack value of type ") +
+												typeName +
+												QByteArray(" to property type ") +
+												QMetaType::typeName(propertyType));
+		}
+	}
+	return true;
+}
+
+QJsonValue QJsonMsgPackContext::toJson(const QJsonValue &value) const
+{
+	// same representation the json serialization would create
+	switch(value.type()) {
+	case QJsonValue::Object: {
+		const auto object = value.toObject();
+		QVariant native;
+		if(findNative(object, native)) {
+			if(native.userType() == QMetaType::QByteArray)
+				return QString::fromUtf8(native.toByteArray().toBase64());
+			else
+				return native.toDouble();
+		}
+
+		QJsonObject result;
+		for(auto it = object.constBegin(); it != object.constEnd(); ++it)
+			result.insert(it.key(), toJson(it.value()));
+		return result;
+	}
+	case QJsonValue::Array: {
+		QJsonArray result;
+		for(const auto &element : value.toArray())
+			result.append(toJson(element));
+		return result;
+	}
+	default:
+		return value;
+	}
+}
+
+
+
+QJsonMsgPackWriter::QJsonMsgPackWriter(QIODevice *device) :
+	_device{device}
+{
+	_buffer.reserve(BufferSize);
+}
+
+void QJsonMsgPackWriter::beginObject(int size)
+{
+	writeHeader(static_cast<quint32>(size), FixMap, 15, 0, Map16, Map32);
+}
+
+void QJsonMsgPackWriter::writeKey(const QString &key)
+{
+	writeString(key);
+}
+
+void QJsonMsgPackWriter::endObject() {}
+
+void QJsonMsgPackWriter::beginArray(int size)
+{
+	writeHeader(static_cast<quint32>(size), FixArray, 15, 0, Array16, Array32);
+}
+
+void QJsonMsgPackWriter::endArray() {}
+
+void QJsonMsgPackWriter::writeValue(const QJsonValue &value)
+{
+	switch(value.type()) {
+	case QJsonValue::Null:
+	case QJsonValue::Undefined:
+		writeRaw("\xc0", 1);
+		break;
+	case QJsonValue::Bool:
+		writeRaw(value.toBool() ? "\xc3" : "\xc2", 1);
+		break;
+	case QJsonValue::Double:
+		writeDouble(value.toDouble());
+		break;
+	case QJsonValue::String:
+		writeString(value.toString());
+		break;
+	case QJsonValue::Array: {
+		const auto array = value.toArray();
+		beginArray(array.size());
+		for(const auto &element : array)
+			writeValue(element);
+		break;
+	}
+	case QJsonValue::Object: {
+		const auto object = value.toObject();
+		beginObject(object.size());
+		for(auto it = object.constBegin(); it != object.constEnd(); ++it) {
+			writeString(it.key());
+			writeValue(it.value());
+		}
+		break;
+	}
+	}
+}
+
+bool QJsonMsgPackWriter::hasNatives() const
+{
+	return true;
+}
+
+void QJsonMsgPackWriter::writeNative(const QVariant &native)
+{
+	switch(native.userType()) {
+	case QMetaType::QByteArray:
+		writeBinary(native.toByteArray());
+		break;
+	case QMetaType::LongLong:
+		writeInt(native.toLongLong());
+		break;
+	case QMetaType::ULongLong:
+		writeUInt(native.toULongLong());
+		break;
+	default:
+		throw QJsonSerializationException(QByteArray("Unable to write native value of type ") +
+										  native.typeName() +
+										  QByteArray(" as MessagePack"));
+	}
+}
+
+void QJsonMsgPackWriter::writeDouble(double value)
+{
+	// integral numbers are written as integers, using the smallest possible width
+	if(std::floor(value) == value && !(value == 0.0 && std::signbit(value))) {
+		if(value >= 0.0 && value < 18446744073709551616.0) {
+			writeUInt(static_cast<quint64>(value));
+			return;
+		} else if(value < 0.0 && value >= -9223372036854775808.0) {
+			writeInt(static_cast<qint64>(value));
+			return;
+		}
+	}
+
+	quint64 bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	writeBigEndian<quint64>(Float64, bits);
+}
+
+void QJsonMsgPackWriter::writeInt(qint64 value)
+{
+	if(value >= 0)
+		writeUInt(static_cast<quint64>(value));
+	else if(value >= -32) {
+		const auto byte = static_cast<char>(value);
+		writeRaw(&byte, 1);
+	} else if(value >= std::numeric_limits<qint8>::min())
+		writeBigEndian<quint8>(Int8, static_cast<quint8>(value));
+	else if(value >= std::numeric_limits<qint16>::min())
+		writeBigEndian<quint16>(Int16, static_cast<quint16>(value));
+	else if(value >= std::numeric_limits<qint32>::min())
+		writeBigEndian<quint32>(Int32, static_cast<quint32>(value));
+	else
+		writeBigEndian<quint64>(Int64, static_cast<quint64>(value));
+}
+
+void QJsonMsgPackWriter::writeUInt(quint64 value)
+{
+	if(value <= 0x7f) {
+		const auto byte = static_cast<char>(value);
+		writeRaw(&byte, 1);
+	} else if(value <= std::numeric_limits<quint8>::max())
+		writeBigEndian<quint8>(UInt8, static_cast<quint8>(value));
+	else if(value <= std::numeric_limits<quint16>::max())
+		writeBigEndian<quint16>(UInt16, static_cast<quint16>(value));
+	else if(value <= std::numeric_limits<quint32>::max())
+		writeBigEndian<quint32>(UInt32, static_cast<quint32>(value));
+	else
+		writeBigEndian<quint64>(UInt64, value);
+}
+
+void QJsonMsgPackWriter::writeString(const QString &value)
+{
+	const auto data = value.toUtf8();
+	writeHeader(static_cast<quint32>(data.size()), FixStr, 31, Str8, Str16, Str32);
+	writeRaw(data.constData(), data.size());
+}
+
+void QJsonMsgPackWriter::writeBinary(const QByteArray &value)
+{
+	writeHeader(static_cast<quint32>(value.size()), -1, 0, Bin8, Bin16, Bin32);
+	writeRaw(value.constData(), value.size());
+}
+
+void QJsonMsgPackWriter::writeHeader(quint32 size, int fixType, quint32 fixMax, quint8 type8, quint8 type16, quint8 type32)
+{
+	if(fixType >= 0 && size <= fixMax) {
+		const auto byte = static_cast<char>(fixType | static_cast<int>(size));
+		writeRaw(&byte, 1);
+	} else if(type8 != 0 && size <= std::numeric_limits<quint8>::max())
+		writeBigEndian<quint8>(type8, static_cast<quint8>(size));
+	else if(size <= std::numeric_limits<quint16>::max())
+		writeBigEndian<quint16>(type16, static_cast<quint16>(size));
+	else
+		writeBigEndian<quint32>(type32, size);
+}
+
+template <typename T>
+void QJsonMsgPackWriter::writeBigEndian(quint8 type, T value)
+{
+	char data[sizeof(T) + 1];
+	data[0] = static_cast<char>(type);
+	qToBigEndian<T>(value, data + 1);
+	writeRaw(data, sizeof(data));
+}
+
+void QJsonMsgPackWriter::writeRaw(const char *data, int size)
+{
+	if(_buffer.size() + size > BufferSize)
+		flush();
+	if(size >= BufferSize) {
+		// large blobs are passed to the device directly
+		if(_device->write(data, size) != size)
+			throw QJsonSerializationException("Failed to write MessagePack data to device with error: " + _device->errorString().toUtf8());
+	} else
+		_buffer.append(data, size);
+}
+
+void QJsonMsgPackWriter::flush()
+{
+	if(_buffer.isEmpty())
+		return;
+	if(_device->write(_buffer) != _buffer.size())
+		throw QJsonSerializationException("Failed to write MessagePack data to device with error: " + _device->errorString().toUtf8());
+	_buffer.resize(0);
+}
+
+
+
+QJsonMsgPackReader::QJsonMsgPackReader(QIODevice *device, QJsonMsgPackContext *context) :
+	_device{device},
+	_context{context}
+{}
+
+QJsonValue QJsonMsgPackReader::read()
+{
+	return readValue(0);
+}
+
+QJsonValue QJsonMsgPackReader::readValue(int depth)
+{
+	if(depth > MaxDepth)
+		throw QJsonDeserializationException("MessagePack data is nested too deeply");
+
+	const auto type = readBigEndian<quint8>();
+	if(type <= 0x7f)
+		return static_cast<double>(type);
+	else if(type >= 0xe0)
+		return static_cast<double>(static_cast<qint8>(type));
+	else if((type & 0xe0) == FixStr)
+		return readString(type & 0x1f);
+	else if((type & 0xf0) == FixArray)
+		return readArray(type & 0x0f, depth);
+	else if((type & 0xf0) == FixMap)
+		return readMap(type & 0x0f, depth);
+
+	switch(type) {
+	case Nil:
+		return QJsonValue::Null;
+	case False:
+		return false;
+	case True:
+		return true;
+	case Bin8:
+		return readBinary(readBigEndian<quint8>());
+	case Bin16:
+		return readBinary(readBigEndian<quint16>());
+	case Bin32:
+		return readBinary(readBigEndian<quint32>());
+	case Float32: {
+		const auto bits = readBigEndian<quint32>();
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return static_cast<double>(value);
+	}
+	case Float64: {
+		const auto bits = readBigEndian<quint64>();
+		double value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+	case UInt8:
+		return readUInt(readBigEndian<quint8>());
+	case UInt16:
+		return readUInt(readBigEndian<quint16>());
+	case UInt32:
+		return readUInt(readBigEndian<quint32>());
+	case UInt64:
+		return readUInt(readBigEndian<quint64>());
+	case Int8:
+		return readInt(static_cast<qint8>(readBigEndian<quint8>()));
+	case Int16:
+		return readInt(static_cast<qint16>(readBigEndian<quint16>()));
+	case Int32:
+		return readInt(static_cast<qint32>(readBigEndian<quint32>()));
+	case Int64:
+		return readInt(static_cast<qint64>(readBigEndian<quint64>()));
+	case Str8:
+		return readString(readBigEndian<quint8>());
+	case Str16:
+		return readString(readBigEndian<quint16>());
+	case Str32:
+		return readString(readBigEndian<quint32>());
+	case Array16:
+		return readArray(readBigEndian<quint16>(), depth);
+	case Array32:
+		return readArray(readBigEndian<quint32>(), depth);
+	case Map16:
+		return readMap(readBigEndian<quint16>(), depth);
+	case Map32:
+		return readMap(readBigEndian<quint32>(), depth);
+	default:
+		throw QJsonDeserializationException("Unsupported MessagePack type: 0x" + QByteArray::number(type, 16));
+	}
+}
+
+QJsonValue QJsonMsgPackReader::readInt(qint64 value)
+{
+	if(value >= -MaxSafeInteger && value <= MaxSafeInteger)
+		return static_cast<double>(value);
+	else if(_context)
+		return _context->storeNative(QVariant::fromValue<qlonglong>(value));
+	else
+		return static_cast<double>(value);
+}
+
+QJsonValue QJsonMsgPackReader::readUInt(quint64 value)
+{
+	if(value <= static_cast<quint64>(MaxSafeInteger))
+		return static_cast<double>(value);
+	else if(_context)
+		return _context->storeNative(QVariant::fromValue<qulonglong>(value));
+	else
+		return static_cast<double>(value);
+}
+
+QString QJsonMsgPackReader::readString(quint32 size)
+{
+	const auto data = require(size);
+	return QString::fromUtf8(data, static_cast<int>(size));
+}
+
+QJsonValue QJsonMsgPackReader::readBinary(quint32 size)
+{
+	QByteArray data{require(size), static_cast<int>(size)};
+	if(_context)
+		return _context->storeNative(data);
+	else
+		return QString::fromUtf8(data.toBase64());
+}
+
+QJsonValue QJsonMsgPackReader::readArray(quint32 size, int depth)
+{
+	QJsonArray array;
+	for(quint32 i = 0; i < size; ++i)
+		array.append(readValue(depth + 1));
+	return array;
+}
+
+QJsonValue QJsonMsgPackReader::readMap(quint32 size, int depth)
+{
+	QJsonObject object;
+	for(quint32 i = 0; i < size; ++i) {
+		const auto key = readValue(depth + 1);
+		if(!key.isString())
+			throw QJsonDeserializationException("MessagePack map keys must be strings");
+		object.insert(key.toString(), readValue(depth + 1));
+	}
+	return object;
+}
+
+template <typename T>
+T QJsonMsgPackReader::readBigEndian()
+{
+	return qFromBigEndian<T>(require(sizeof(T)));
+}
+
+const char *QJsonMsgPackReader::require(quint32 size)
+{
+	if(size > MaxElementSize)
+		throw QJsonDeserializationException("MessagePack element exceeds the maximum supported size");
+
+	if(static_cast<quint32>(_buffer.size() - _pos) < size) {
+		// drop what was already consumed, then read until enough data is available
+		_buffer.remove(0, _pos);
+		_pos = 0;
+		while(static_cast<quint32>(_buffer.size()) < size) {
+			const auto chunk = _device->read(qMax<qint64>(size - static_cast<quint32>(_buffer.size()), BufferSize));
+			if(chunk.isEmpty())
+				throw QJsonDeserializationException("Unexpected end of MessagePack data");
+			_buffer.append(chunk);
+		}
+	}
+
+	const auto data = _buffer.constData() + _pos;
+	_pos += static_cast<int>(size);
+	return data;
+}
@@ -0,0 +1,110 @@
+#ifndef QJSONMSGPACK_P_H
+#define QJSONMSGPACK_P_H
+
+#include "qtjsonserializer_global.h"
+#include "qjsonvalueproducer_p.h"
+
+#include <QtCore/QJsonValue>
+#include <QtCore/QJsonObject>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+#include <QtCore/QIODevice>
+#include <QtCore/QThreadStorage>
+
+// Active while a value is deserialized from the MessagePack format. Values json cannot represent losslessly
+// (binary data, 64 bit integers beyond the double precision) are kept as native values and referenced from
+// the json tree by a marker object {"@msgpack:<nonce>": index}. The nonce is random for every context, so
+// objects read from the data can never be mistaken for a marker
+class Q_JSONSERIALIZER_EXPORT QJsonMsgPackContext
+{
+	Q_DISABLE_COPY(QJsonMsgPackContext)
+
+public:
+	QJsonMsgPackContext();
+	~QJsonMsgPackContext();
+
+	static QJsonMsgPackContext *current();
+
+	QJsonValue storeNative(const QVariant &value);
+	bool findNative(const QJsonObject &object, QVariant &native) const;
+
+	// resolves markers for the given target type - either the native value is returned, or, for plain json
+	// targets and types with custom converters, all markers within value are replaced by their json representation
+	bool deserializeNative(int propertyType, const QJsonTypeConverter *converter, QJsonValue &value, QVariant &native) const;
+
+private:
+	struct ContextRef {
+		QJsonMsgPackContext *context = nullptr;
+	};
+	static QThreadStorage<ContextRef> contextStore;
+
+	QJsonMsgPackContext *_previous;
+	QString _markerKey;
+	QVector<QVariant> _natives;
+
+	QJsonValue toJson(const QJsonValue &value) const;
+};
+
+// Writes the values produced by a QJsonValueProducer, with binary data and 64 bit integers as native types
+class Q_JSONSERIALIZER_EXPORT QJsonMsgPackWriter : public QJsonValueSink
+{
+public:
+	QJsonMsgPackWriter(QIODevice *device);
+
+	void beginObject(int size) override;
+	void writeKey(const QString &key) override;
+	void endObject() override;
+	void beginArray(int size) override;
+	void endArray() override;
+	void writeValue(const QJsonValue &value) override;
+	bool hasNatives() const override;
+	void writeNative(const QVariant &native) override;
+
+	// writes what is left in the buffer to the device
+	void flush();
+
+private:
+	QIODevice *_device;
+	QByteArray _buffer;
+
+	void writeDouble(double value);
+	void writeInt(qint64 value);
+	void writeUInt(quint64 value);
+	void writeString(const QString &value);
+	void writeBinary(const QByteArray &value);
+	void writeHeader(quint32 size, int fixType, quint32 fixMax, quint8 type8, quint8 type16, quint8 type32);
+
+	template <typename T>
+	void writeBigEndian(quint8 type, T value);
+	void writeRaw(const char *data, int size);
+};
+
+class Q_JSONSERIALIZER_EXPORT QJsonMsgPackReader
+{
+	Q_DISABLE_COPY(QJsonMsgPackReader)
+
+public:
+	QJsonMsgPackReader(QIODevice *device, QJsonMsgPackContext *context);
+
+	QJsonValue read();
+
+private:
+	QIODevice *_device;
+	QJsonMsgPackContext *_context;
+	QByteArray _buffer;
+	int _pos = 0;
+
+	QJsonValue readValue(int depth);
+	QJsonValue readInt(qint64 value);
+	QJsonValue readUInt(quint64 value);
+	QString readString(quint32 size);
+	QJsonValue readBinary(quint32 size);
+	QJsonValue readArray(quint32 size, int depth);
+	QJsonValue readMap(quint32 size, int depth);
+
+	template <typename T>
+	T readBigEndian();
+	const char *require(quint32 size);
+};
+
+#endif // QJSONMSGPACK_P_H
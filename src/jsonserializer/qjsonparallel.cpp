@@ -0,0 +1,115 @@
+#include "qjsonparallel_p.h"
+#include "qjsonserializerexception.h"
+
+namespace {
+
+inline bool isJsonSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+}
+
+QJsonArrayIndex::QJsonArrayIndex(const QByteArray &data) :
+	_data{data}
+{
+	const auto raw = _data.constData();
+	const auto size = _data.size();
+
+	auto pos = 0;
+	while(pos < size && isJsonSpace(raw[pos]))
+		++pos;
+	if(pos == size || raw[pos] != '[')
+		throw QJsonDeserializationException("Parallel deserialization requires a json array as root element");
+	++pos;
+
+	auto depth = 0;
+	auto inString = false;
+	auto closed = false;
+	auto elementStart = -1;
+	auto elementEnd = -1;
+	for(; pos < size && !closed; ++pos) {
+		const auto c = raw[pos];
+		if(inString) {
+			if(c == '\\')
+				++pos;
+			else if(c == '"') {
+				inString = false;
+				elementEnd = pos + 1;
+			}
+			continue;
+		}
+
+		switch(c) {
+		case ' ':
+		case '\t':
+		case '\n':
+		case '\r':
+			continue;
+		case ',':
+			if(depth == 0) {
+				if(elementStart == -1)
+					throw QJsonDeserializationException("Empty element in json array at offset " + QByteArray::number(pos));
+				_elements.append({elementStart, elementEnd - elementStart});
+				elementStart = -1;
+				continue;
+			}
+			break;
+		case ']':
+			if(depth == 0) {
+				if(elementStart != -1)
+					_elements.append({elementStart, elementEnd - elementStart});
+				else if(!_elements.isEmpty())
+					throw QJsonDeserializationException("Empty element in json array at offset " + QByteArray::number(pos));
+				closed = true;
+				continue;
+			}
+			--depth;
+			break;
+		case '}':
+			if(depth == 0)
+				throw QJsonDeserializationException("Unbalanced brackets in json array at offset " + QByteArray::number(pos));
+			--depth;
+			break;
+		case '[':
+		case '{':
+			++depth;
+			break;
+		case '"':
+			inString = true;
+			break;
+		default:
+			break;
+		}
+
+		if(elementStart == -1)
+			elementStart = pos;
+		elementEnd = pos + 1;
+	}
+
+	if(!closed)
+		throw QJsonDeserializationException("Unterminated json array");
+	while(pos < size && isJsonSpace(raw[pos]))
+		++pos;
+	if(pos != size)
+		throw QJsonDeserializationException("Unexpected data after the json array at offset " + QByteArray::number(pos));
+}
+
+int QJsonArrayIndex::size() const
+{
+	return _elements.size();
+}
+
+QByteArray QJsonArrayIndex::chunk(int first, int last) const
+{
+	Q_ASSERT(first >= 0 && first < last && last <= _elements.size());
+	// the separators between the elements are copied as well
+	const auto begin = _elements[first].offset;
+	const auto end = _elements[last - 1].offset + _elements[last - 1].size;
+	QByteArray result;
+	result.reserve(end - begin + 2);
+	result.append('[');
+	result.append(_data.constData() + begin, end - begin);
+	result.append(']');
+	return result;
+}
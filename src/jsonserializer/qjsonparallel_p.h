@@ -0,0 +1,33 @@
+#ifndef QJSONPARALLEL_P_H
+#define QJSONPARALLEL_P_H
+
+#include "qtjsonserializer_global.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+
+// Locates the elements of a top level json array without parsing them, so consecutive ranges of
+// elements can be parsed independently. Only the array structure is checked, the elements themselves
+// are validated once a chunk is parsed
+class Q_JSONSERIALIZER_EXPORT QJsonArrayIndex
+{
+public:
+	struct Element {
+		int offset;
+		int size;
+	};
+
+	explicit QJsonArrayIndex(const QByteArray &data);
+
+	int size() const;
+	// the elements [first, last) as a json array of their own
+	QByteArray chunk(int first, int last) const;
+
+private:
+	const QByteArray _data;
+	QVector<Element> _elements;
+};
+
+Q_DECLARE_TYPEINFO(QJsonArrayIndex::Element, Q_PRIMITIVE_TYPE);
+
+#endif // QJSONPARALLEL_P_H
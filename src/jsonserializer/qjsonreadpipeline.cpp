@@ -0,0 +1,369 @@
+#include "qjsonreadpipeline.h"
+#include "qjsonreadpipeline_p.h"
+#include "qjsonserializerexception.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+namespace {
+
+class QJsonPipelineThread : public QThread
+{
+public:
+	QJsonPipelineThread(std::function<void()> &&function) :
+		_function{std::move(function)}
+	{}
+
+protected:
+	void run() override {
+		_function();
+	}
+
+private:
+	const std::function<void()> _function;
+};
+
+}
+
+QJsonReadPipeline::QJsonReadPipeline(QIODevice *device, Deserializer deserializer, QObject *parent) :
+	QObject{parent},
+	d{new QJsonReadPipelinePrivate{this, device, std::move(deserializer)}}
+{}
+
+QJsonReadPipeline::~QJsonReadPipeline()
+{
+	d->stop();
+}
+
+int QJsonReadPipeline::capacity() const
+{
+	return d->capacity;
+}
+
+int QJsonReadPipeline::parserCount() const
+{
+	return d->parserCount;
+}
+
+qint64 QJsonReadPipeline::recordCount() const
+{
+	return d->recordCount;
+}
+
+bool QJsonReadPipeline::isFinished() const
+{
+	return d->finished;
+}
+
+void QJsonReadPipeline::start()
+{
+	if(d->started)
+		return;
+	if(!d->device || !d->device->isReadable()) {
+		emit error(tr("The device is not open for reading"));
+		return;
+	}
+	// the device is used by the reader thread only, until all data has been read. Sequential devices are
+	// waited for on that thread, so they must be moved there, which Qt does not allow for child objects
+	if(d->device->isSequential() && d->device->parent()) {
+		emit error(tr("Sequential devices must not have a parent, as they are moved to the reader thread"));
+		return;
+	}
+	if(d->device->thread() != QThread::currentThread()) {
+		emit error(tr("The device must belong to the thread of the pipeline"));
+		return;
+	}
+
+	d->started = true;
+	d->running = true;
+	for(auto i = 0; i < d->parserCount; ++i) {
+		d->parseQueues.append(QSharedPointer<QJsonReadPipelinePrivate::Queue>::create(d->capacity));
+		d->resultQueues.append(QSharedPointer<QJsonReadPipelinePrivate::Queue>::create(d->capacity));
+	}
+
+	for(auto i = 0; i < d->parserCount; ++i) {
+		d->threads.append(new QJsonPipelineThread{[this, i]() {
+			d->parseRecords(i);
+		}});
+	}
+	const auto ownerThread = QThread::currentThread();
+	auto reader = new QJsonPipelineThread{[this, ownerThread]() {
+		d->readRecords(ownerThread);
+	}};
+	d->threads.append(reader);
+	d->deviceMoved = d->device->isSequential();
+	if(d->deviceMoved)
+		d->device->moveToThread(reader);
+
+	for(auto thread : qAsConst(d->threads))
+		thread->start();
+}
+
+void QJsonReadPipeline::abort()
+{
+	if(!d->running)
+		return;
+	d->stop();
+}
+
+void QJsonReadPipeline::setCapacity(int capacity)
+{
+	capacity = qMax(capacity, 1);
+	if(d->capacity == capacity)
+		return;
+
+	d->capacity = capacity;
+	emit capacityChanged(d->capacity);
+}
+
+void QJsonReadPipeline::setParserCount(int parserCount)
+{
+	parserCount = qMax(parserCount, 1);
+	if(d->parserCount == parserCount)
+		return;
+
+	d->parserCount = parserCount;
+	emit parserCountChanged(d->parserCount);
+}
+
+void QJsonReadPipeline::drain()
+{
+	// reset before popping, so results pushed from now on schedule another drain
+	d->drainPending.store(0);
+	auto delivered = false;
+	while(d->running) {
+		QJsonReadPipelinePrivate::Record record;
+		if(!d->resultQueues[d->nextResult]->tryPop(record))
+			break;
+		d->nextResult = (d->nextResult + 1) % d->resultQueues.size();
+
+		switch(record.type) {
+		case QJsonReadPipelinePrivate::Record::Data:
+			try {
+				const auto value = d->deserializer(record.json);
+				++d->recordCount;
+				delivered = true;
+				emit recordReady(value);
+			} catch(QJsonSerializerException &e) {
+				d->stop();
+				emit error(QString::fromUtf8(e.what()));
+				return;
+			}
+			break;
+		case QJsonReadPipelinePrivate::Record::Error:
+			d->stop();
+			emit error(record.errorString);
+			return;
+		case QJsonReadPipelinePrivate::Record::End:
+			// the reader ends every queue after the last record - reaching the first end means all records are done
+			d->stop();
+			d->finished = true;
+			if(delivered)
+				emit recordCountChanged(d->recordCount);
+			emit finished();
+			return;
+		default:
+			Q_UNREACHABLE();
+			break;
+		}
+	}
+
+	if(delivered)
+		emit recordCountChanged(d->recordCount);
+}
+
+
+
+QJsonReadPipelinePrivate::QJsonReadPipelinePrivate(QJsonReadPipeline *q, QIODevice *device, QJsonReadPipeline::Deserializer &&deserializer) :
+	q{q},
+	device{device},
+	deserializer{std::move(deserializer)},
+	// one thread each is taken by the reader and the consumer
+	parserCount{qMax(1, QThread::idealThreadCount() - 2)}
+{}
+
+void QJsonReadPipelinePrivate::readRecords(QThread *ownerThread)
+{
+	auto next = 0;
+	QJsonRecordSplitter splitter;
+	QByteArrayList records;
+	QString errorString;
+	const auto dev = device.data();
+	// a failed waitForReadyRead does not mean the data has ended, as many devices cannot wait at all. The end
+	// of a sequential device is only reached once it was closed or its read channel has finished
+	QAtomicInt channelFinished = 0;
+	const auto connection = QObject::connect(dev, &QIODevice::readChannelFinished, [&channelFinished]() {
+		channelFinished.store(1);
+	});
+	while(!aborted.load() && errorString.isEmpty()) {
+		const auto data = dev->read(ReadSize);
+		if(data.isEmpty()) {
+			if(!dev->isSequential() || !dev->isOpen() || channelFinished.load())
+				break;
+			// waitForReadyRead cannot be interrupted, so wait in slices to react to aborts. Devices that
+			// return before the slice has passed are polled, by sleeping for the rest of it
+			QElapsedTimer timer;
+			timer.start();
+			if(!dev->waitForReadyRead(WaitSlice) && dev->bytesAvailable() == 0) {
+				const auto remaining = WaitSlice - timer.elapsed();
+				if(remaining > 0)
+					QThread::msleep(static_cast<unsigned long>(remaining));
+			}
+			continue;
+		}
+
+		try {
+			splitter.feed(data, records);
+		} catch(QJsonSerializerException &e) {
+			errorString = QString::fromUtf8(e.what());
+		}
+		// the records before an error are still delivered
+		for(auto &record : records) {
+			if(!dispatch({Record::Data, std::move(record), {}, {}}, next))
+				break;
+		}
+		records.clear();
+	}
+	if(errorString.isEmpty() && !aborted.load() && !splitter.isEmpty())
+		errorString = QStringLiteral("The device ended within a json record");
+
+	QObject::disconnect(connection);
+
+	// the device is handed back before the consumer learns that reading is done
+	if(deviceMoved)
+		dev->moveToThread(ownerThread);
+	if(!errorString.isEmpty())
+		dispatch({Record::Error, {}, {}, errorString}, next);
+	for(const auto &queue : qAsConst(parseQueues))
+		queue->push({});
+}
+
+void QJsonReadPipelinePrivate::parseRecords(int index)
+{
+	const auto &input = parseQueues.at(index);
+	const auto &output = resultQueues.at(index);
+	Record record;
+	while(input->pop(record)) {
+		if(record.type == Record::Data) {
+			QJsonParseError error;
+			const auto doc = QJsonDocument::fromJson(record.data, &error);
+			record.data.clear();
+			if(error.error != QJsonParseError::NoError) {
+				record.type = Record::Error;
+				record.errorString = QStringLiteral("Failed to read record as JSON with error: ") + error.errorString();
+			} else if(doc.isArray())
+				record.json = doc.array();
+			else
+				record.json = doc.object();
+		}
+
+		const auto type = record.type;
+		if(!output->push(std::move(record)))
+			return;
+		notifyConsumer();
+		if(type == Record::End)
+			return;
+	}
+}
+
+bool QJsonReadPipelinePrivate::dispatch(Record &&record, int &next)
+{
+	const auto &queue = parseQueues.at(next);
+	next = (next + 1) % parseQueues.size();
+	return queue->push(std::move(record));
+}
+
+void QJsonReadPipelinePrivate::notifyConsumer()
+{
+	// at most one drain is queued at a time
+	if(drainPending.testAndSetOrdered(0, 1))
+		QMetaObject::invokeMethod(q, "drain", Qt::QueuedConnection);
+}
+
+void QJsonReadPipelinePrivate::stop()
+{
+	if(!running)
+		return;
+	running = false;
+	aborted.store(1);
+	for(const auto &queue : qAsConst(parseQueues))
+		queue->close();
+	for(const auto &queue : qAsConst(resultQueues))
+		queue->close();
+	for(auto thread : qAsConst(threads)) {
+		thread->wait();
+		delete thread;
+	}
+	threads.clear();
+}
+
+
+
+void QJsonRecordSplitter::feed(const QByteArray &data, QByteArrayList &records)
+{
+	const auto raw = data.constData();
+	const auto size = data.size();
+	auto start = _depth > 0 ? 0 : -1;
+	for(auto pos = 0; pos < size; ++pos) {
+		const auto c = raw[pos];
+		if(_depth == 0) {
+			switch(c) {
+			case ' ':
+			case '\t':
+			case '\n':
+			case '\r':
+				continue;
+			case '{':
+			case '[':
+				start = pos;
+				_depth = 1;
+				continue;
+			default:
+				throw QJsonDeserializationException("Records must be json objects or arrays, but found '" +
+													QByteArray{1, c} +
+													"' outside of a record");
+			}
+		}
+
+		if(_inString) {
+			if(_escaped)
+				_escaped = false;
+			else if(c == '\\')
+				_escaped = true;
+			else if(c == '"')
+				_inString = false;
+			continue;
+		}
+
+		switch(c) {
+		case '"':
+			_inString = true;
+			break;
+		case '{':
+		case '[':
+			++_depth;
+			break;
+		case '}':
+		case ']':
+			if(--_depth == 0) {
+				_current.append(raw + start, pos + 1 - start);
+				records.append(_current);
+				_current.clear();
+				start = -1;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	if(start != -1)
+		_current.append(raw + start, size - start);
+}
+
+bool QJsonRecordSplitter::isEmpty() const
+{
+	return _depth == 0;
+}
@@ -0,0 +1,79 @@
+#ifndef QJSONREADPIPELINE_H
+#define QJSONREADPIPELINE_H
+
+#include "QtJsonSerializer/qtjsonserializer_global.h"
+
+#include <functional>
+
+#include <QtCore/qobject.h>
+#include <QtCore/qjsonvalue.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qiodevice.h>
+#include <QtCore/qscopedpointer.h>
+
+class QJsonReadPipelinePrivate;
+//! A pipeline that reads a stream of json records from a device, with reading, parsing and deserialization running concurrently
+class Q_JSONSERIALIZER_EXPORT QJsonReadPipeline : public QObject
+{
+	Q_OBJECT
+
+	//! The maximum number of records waiting between two stages of the pipeline
+	Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged)
+	//! The number of threads that parse records concurrently
+	Q_PROPERTY(int parserCount READ parserCount WRITE setParserCount NOTIFY parserCountChanged)
+	//! The number of records deserialized so far
+	Q_PROPERTY(qint64 recordCount READ recordCount NOTIFY recordCountChanged)
+	//! Specifies whether all records of the device have been deserialized
+	Q_PROPERTY(bool finished READ isFinished NOTIFY finished)
+
+public:
+	//! The function that turns one parsed record into the deserialized value
+	using Deserializer = std::function<QVariant(const QJsonValue &)>;
+
+	//! Constructor with the device to read from and the function to deserialize the records with
+	QJsonReadPipeline(QIODevice *device, Deserializer deserializer, QObject *parent = nullptr);
+	~QJsonReadPipeline() override;
+
+	//! @readAcFn{QJsonReadPipeline::capacity}
+	int capacity() const;
+	//! @readAcFn{QJsonReadPipeline::parserCount}
+	int parserCount() const;
+	//! @readAcFn{QJsonReadPipeline::recordCount}
+	qint64 recordCount() const;
+	//! @readAcFn{QJsonReadPipeline::finished}
+	bool isFinished() const;
+
+public Q_SLOTS:
+	//! Starts reading from the device
+	void start();
+	//! Stops the pipeline, dropping all records that have not been deserialized yet
+	void abort();
+
+	//! @writeAcFn{QJsonReadPipeline::capacity}
+	void setCapacity(int capacity);
+	//! @writeAcFn{QJsonReadPipeline::parserCount}
+	void setParserCount(int parserCount);
+
+Q_SIGNALS:
+	//! Is emitted for every deserialized record, in the order they were read from the device
+	void recordReady(const QVariant &record);
+	//! Is emitted once all records of the device have been deserialized
+	void finished();
+	//! Is emitted if reading, parsing or deserializing a record failed. The pipeline is stopped afterwards
+	void error(const QString &errorString);
+
+	//! @notifyAcFn{QJsonReadPipeline::capacity}
+	void capacityChanged(int capacity);
+	//! @notifyAcFn{QJsonReadPipeline::parserCount}
+	void parserCountChanged(int parserCount);
+	//! @notifyAcFn{QJsonReadPipeline::recordCount}
+	void recordCountChanged(qint64 recordCount);
+
+private Q_SLOTS:
+	void drain();
+
+private:
+	QScopedPointer<QJsonReadPipelinePrivate> d;
+};
+
+#endif // QJSONREADPIPELINE_H
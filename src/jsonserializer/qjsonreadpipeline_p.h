@@ -0,0 +1,184 @@
+#ifndef QJSONREADPIPELINE_P_H
+#define QJSONREADPIPELINE_P_H
+
+#include "qtjsonserializer_global.h"
+#include "qjsonreadpipeline.h"
+
+#include <functional>
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QByteArrayList>
+#include <QtCore/QMutex>
+#include <QtCore/QPointer>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+
+// A bounded queue between exactly one producer and one consumer thread. Each side only ever writes its own
+// end of the ring, which is published as an atomic index, so handing over a record does not take a lock.
+// The mutex and wait condition are only used if a side has to wait, i.e. the producer while the queue is
+// full (backpressure) and the consumer while it is empty. Closing the queue wakes up and fails all pending
+// and future calls
+template <typename T>
+class QJsonPipelineQueue
+{
+	Q_DISABLE_COPY(QJsonPipelineQueue)
+
+public:
+	explicit QJsonPipelineQueue(int capacity) :
+		_slots{capacity}
+	{}
+
+	bool push(T value) {
+		const auto tail = _tail.load();
+		if(!wait([&]() { return count(_head.loadAcquire(), tail) < _slots.size(); }))
+			return false;
+		_slots[tail % _slots.size()] = std::move(value);
+		_tail.fetchAndStoreOrdered(next(tail));
+		wake();
+		return true;
+	}
+
+	bool pop(T &value) {
+		const auto head = _head.load();
+		if(!wait([&]() { return count(head, _tail.loadAcquire()) > 0; }))
+			return false;
+		take(head, value);
+		return true;
+	}
+
+	bool tryPop(T &value) {
+		const auto head = _head.load();
+		if(_closed.loadAcquire() || count(head, _tail.loadAcquire()) == 0)
+			return false;
+		take(head, value);
+		return true;
+	}
+
+	void close() {
+		_closed.fetchAndStoreOrdered(1);
+		QMutexLocker lock{&_mutex};
+		_condition.wakeAll();
+	}
+
+private:
+	QVector<T> _slots;
+	// both run over twice the capacity, to tell a full ring from an empty one
+	QAtomicInt _head = 0;
+	QAtomicInt _tail = 0;
+	QAtomicInt _closed = 0;
+	// only one side can wait at a time, as the queue cannot be full and empty at once
+	QAtomicInt _waiting = 0;
+	QMutex _mutex;
+	QWaitCondition _condition;
+
+	int next(int index) const {
+		return (index + 1) % (2 * _slots.size());
+	}
+
+	int count(int head, int tail) const {
+		return (tail - head + 2 * _slots.size()) % (2 * _slots.size());
+	}
+
+	void take(int head, T &value) {
+		auto &slot = _slots[head % _slots.size()];
+		value = std::move(slot);
+		slot = T{};
+		_head.fetchAndStoreOrdered(next(head));
+		wake();
+	}
+
+	// the flag is set before the condition is checked again, and the other side publishes its index before
+	// reading the flag - so either the condition is met, or the other side wakes up the waiting one
+	template <typename TCondition>
+	bool wait(const TCondition &isReady) {
+		if(Q_LIKELY(isReady()))
+			return !_closed.loadAcquire();
+		QMutexLocker lock{&_mutex};
+		_waiting.fetchAndStoreOrdered(1);
+		while(!isReady() && !_closed.loadAcquire())
+			_condition.wait(&_mutex);
+		_waiting.fetchAndStoreOrdered(0);
+		return !_closed.loadAcquire();
+	}
+
+	void wake() {
+		if(_waiting.fetchAndAddOrdered(0) != 0) {
+			QMutexLocker lock{&_mutex};
+			_condition.wakeAll();
+		}
+	}
+};
+
+// Splits a stream of concatenated json objects or arrays into the single records, without parsing them.
+// Records may be separated by whitespace, e.g. one per line
+class Q_JSONSERIALIZER_EXPORT QJsonRecordSplitter
+{
+public:
+	// appends all records completed by data to records
+	void feed(const QByteArray &data, QByteArrayList &records);
+	// true if no record has been started but not completed yet
+	bool isEmpty() const;
+
+private:
+	QByteArray _current;
+	int _depth = 0;
+	bool _inString = false;
+	bool _escaped = false;
+};
+
+class Q_JSONSERIALIZER_EXPORT QJsonReadPipelinePrivate
+{
+	Q_DISABLE_COPY(QJsonReadPipelinePrivate)
+
+public:
+	struct Record {
+		enum Type {
+			Data,
+			Error,
+			End
+		};
+
+		Type type = End;
+		QByteArray data;
+		QJsonValue json;
+		QString errorString;
+	};
+	using Queue = QJsonPipelineQueue<Record>;
+
+	static const int ReadSize = 64 * 1024;
+	// how long the reader waits for data at once, before checking for an abort
+	static const int WaitSlice = 100;
+
+	QJsonReadPipelinePrivate(QJsonReadPipeline *q, QIODevice *device, QJsonReadPipeline::Deserializer &&deserializer);
+
+	QJsonReadPipeline *q;
+	QPointer<QIODevice> device;
+	QJsonReadPipeline::Deserializer deserializer;
+	int capacity = 64;
+	int parserCount;
+	qint64 recordCount = 0;
+	bool started = false;
+	bool running = false;
+	// sequential devices are moved to the reader thread while it runs
+	bool deviceMoved = false;
+	bool finished = false;
+
+	// one queue from the reader to each parser and from each parser to the consumer. Records are handed
+	// out round robin, and collected in the same order, so they stay in the order of the device
+	QVector<QSharedPointer<Queue>> parseQueues;
+	QVector<QSharedPointer<Queue>> resultQueues;
+	QVector<QThread*> threads;
+	QAtomicInt aborted = 0;
+	QAtomicInt drainPending = 0;
+	int nextResult = 0;
+
+	void readRecords(QThread *ownerThread);
+	void parseRecords(int index);
+	bool dispatch(Record &&record, int &next);
+	void notifyConsumer();
+	void stop();
+};
+
+#endif // QJSONREADPIPELINE_P_H
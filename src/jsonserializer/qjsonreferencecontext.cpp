@@ -0,0 +1,118 @@
+#include "qjsonreferencecontext_p.h"
+#include "qjsonserializerexception.h"
+
+#include <QtCore/QJsonArray>
+
+QThreadStorage<QJsonReferenceContext::ContextRef> QJsonReferenceContext::contextStore;
+
+QJsonReferenceContext::QJsonReferenceContext(const QJsonValue &root, bool active) :
+	_active{active},
+	_root{root}
+{
+	if(_active) {
+		auto &ref = contextStore.localData();
+		_previous = ref.context;
+		ref.context = this;
+	}
+}
+
+QJsonReferenceContext::~QJsonReferenceContext()
+{
+	if(_active)
+		contextStore.localData().context = _previous;
+}
+
+QJsonReferenceContext *QJsonReferenceContext::current()
+{
+	return contextStore.hasLocalData() ?
+				contextStore.localData().context :
+				nullptr;
+}
+
+int QJsonReferenceContext::objectId(const QObject *object, bool &known)
+{
+	auto it = _ids.constFind(object);
+	known = it != _ids.constEnd();
+	if(known)
+		return *it;
+
+	// registered before the properties are written, so cycles become references
+	const auto id = _ids.size() + 1;
+	_ids.insert(object, id);
+	return id;
+}
+
+QObject *QJsonReferenceContext::object(int id) const
+{
+	return _objects.value(id, nullptr);
+}
+
+void QJsonReferenceContext::addObject(int id, QObject *object)
+{
+	if(_objects.contains(id))
+		throw QJsonDeserializationException("Duplicate object id " + QByteArray::number(id) + " found in json");
+	_objects.insert(id, object);
+}
+
+QObject *QJsonReferenceContext::resolve(int id, int propertyType, QObject *parent, const QJsonTypeConverter::SerializationHelper *helper)
+{
+	auto object = _objects.value(id, nullptr);
+	if(object)
+		return object;
+
+	// the json keys of objects are sorted, so references can come before the definition
+	if(!_indexed) {
+		indexDefinitions(_root);
+		_indexed = true;
+	}
+	const auto it = _definitions.constFind(id);
+	if(it == _definitions.constEnd())
+		throw QJsonDeserializationException("Unable to find the object with the id " + QByteArray::number(id) + " referenced by $ref");
+	helper->deserializeSubtype(propertyType, *it, parent, QByteArrayLiteral("$ref"));
+
+	object = _objects.value(id, nullptr);
+	if(!object)
+		throw QJsonDeserializationException("Failed to deserialize the object with the id " + QByteArray::number(id) + " referenced by $ref");
+	return object;
+}
+
+QSharedPointer<QObject> QJsonReferenceContext::sharedPointer(QObject *object)
+{
+	auto &pointer = _sharedPointers[object];
+	if(!pointer)
+		pointer.reset(object);
+	return pointer;
+}
+
+void QJsonReferenceContext::indexDefinitions(const QJsonValue &value)
+{
+	if(value.isObject()) {
+		const auto object = value.toObject();
+		const auto id = object.value(QStringLiteral("$id"));
+		if(id.isDouble())
+			_definitions.insert(id.toInt(), object);
+		for(const auto &child : object)
+			indexDefinitions(child);
+	} else if(value.isArray()) {
+		for(const auto &child : value.toArray())
+			indexDefinitions(child);
+	}
+}
+
+
+
+QJsonReferenceContext::Resume::Resume(QJsonReferenceContext *context)
+{
+	if(!context)
+		return;
+	auto &ref = contextStore.localData();
+	_previous = ref.context;
+	ref.context = context;
+	_active = true;
+}
+
+QJsonReferenceContext::Resume::~Resume()
+{
+	if(_active)
+		contextStore.localData().context = _previous;
+}
@@ -0,0 +1,84 @@
+#ifndef QJSONREFERENCECONTEXT_P_H
+#define QJSONREFERENCECONTEXT_P_H
+
+#include "qtjsonserializer_global.h"
+#include "qjsontypeconverter.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThreadStorage>
+
+// Tracks object identities during one serialization or deserialization call, so shared objects are written
+// once with an "$id" and referenced via "$ref" everywhere else
+class Q_JSONSERIALIZER_EXPORT QJsonReferenceContext
+{
+	Q_DISABLE_COPY(QJsonReferenceContext)
+
+public:
+	// Creates a context for the outermost (de)serialization call, if enabled. Nested calls join that context
+	class Q_JSONSERIALIZER_EXPORT Scope
+	{
+		Q_DISABLE_COPY(Scope)
+
+	public:
+		inline Scope(bool enabled, const QJsonValue &root = {}) {
+			if(Q_UNLIKELY(enabled) && !current())
+				_context.reset(new QJsonReferenceContext{root});
+		}
+
+	private:
+		QScopedPointer<QJsonReferenceContext> _context;
+	};
+
+	// Makes an inactive context current while it exists, for calls that are continued later (see QJsonValueProducer)
+	class Q_JSONSERIALIZER_EXPORT Resume
+	{
+		Q_DISABLE_COPY(Resume)
+
+	public:
+		Resume(QJsonReferenceContext *context);
+		~Resume();
+
+	private:
+		QJsonReferenceContext *_previous = nullptr;
+		bool _active = false;
+	};
+
+	// an inactive context only becomes current within a Resume scope
+	QJsonReferenceContext(const QJsonValue &root, bool active = true);
+	~QJsonReferenceContext();
+
+	static QJsonReferenceContext *current();
+
+	// serialization: returns the id of the object, and whether it has been written before
+	int objectId(const QObject *object, bool &known);
+
+	// deserialization
+	QObject *object(int id) const;
+	void addObject(int id, QObject *object);
+	// finds the object with the given id - if it is defined later in the json, it is deserialized now
+	QObject *resolve(int id, int propertyType, QObject *parent, const QJsonTypeConverter::SerializationHelper *helper);
+	// all shared pointers to one object must share the same reference count
+	QSharedPointer<QObject> sharedPointer(QObject *object);
+
+private:
+	struct ContextRef {
+		QJsonReferenceContext *context = nullptr;
+	};
+	static QThreadStorage<ContextRef> contextStore;
+
+	QJsonReferenceContext *_previous = nullptr;
+	bool _active;
+	QJsonValue _root;
+	QHash<const QObject*, int> _ids;
+	QHash<int, QObject*> _objects;
+	QHash<QObject*, QSharedPointer<QObject>> _sharedPointers;
+	QHash<int, QJsonObject> _definitions;
+	bool _indexed = false;
+
+	void indexDefinitions(const QJsonValue &value);
+};
+
+#endif // QJSONREFERENCECONTEXT_P_H
@@ -1,12 +1,28 @@
 #include "qjsonserializer.h"
 #include "qjsonserializer_p.h"
 #include "qjsonexceptioncontext_p.h"
+#include "qjsonmsgpack_p.h"
+#include "qjsonvalueproducer_p.h"
+#include "qjsoncompressiondevice_p.h"
+#include "qjsontextreader_p.h"
+#include "qjsontextwriter_p.h"
+#include "qjsonasync_p.h"
+#include "qjsonwritejob_p.h"
+#include "qjsonfieldselector_p.h"
+#include "qjsonreferencecontext_p.h"
+#include "qjsonattachment_p.h"
+#include "qjsonstringpool_p.h"
+#include "qjsonserializertracer_p.h"
+#include "qjsonparallel_p.h"
+#include "qjsonserializeroptions_p.h"
 
 #include <cmath>
 
 #include <QtCore/QDateTime>
 #include <QtCore/QBuffer>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QUrl>
+#include <QtCore/QUuid>
 
 #include "typeconverters/qjsonobjectconverter_p.h"
 #include "typeconverters/qjsongadgetconverter_p.h"
@@ -21,54 +37,105 @@
 #include "typeconverters/qjsonlocaleconverter_p.h"
 #include "typeconverters/qjsonregularexpressionconverter_p.h"
 #include "typeconverters/qjsonstdtupleconverter_p.h"
+#include "typeconverters/qjsondatetimeconverter_p.h"
+#include "typeconverters/qjsonlazyconverter_p.h"
 
 Q_COREAPP_STARTUP_FUNCTION(qtJsonSerializerRegisterTypes);
 
 QJsonSerializer::QJsonSerializer(QObject *parent) :
 	QObject{parent},
 	d{new QJsonSerializerPrivate{}}
-{}
+{
+	d->asyncGuard.reset(new QJsonAsyncGuard{});
+}
 
-QJsonSerializer::~QJsonSerializer() = default;
+QJsonSerializer::~QJsonSerializer()
+{
+	d->asyncGuard->destroy();
+}
 
 bool QJsonSerializer::allowDefaultNull() const
 {
-	return d->allowNull;
+	QReadLocker lock{&d->optionsLock};
+	return d->options.allowDefaultNull();
 }
 
 bool QJsonSerializer::keepObjectName() const
 {
-	return d->keepObjectName;
+	QReadLocker lock{&d->optionsLock};
+	return d->options.keepObjectName();
 }
 
 bool QJsonSerializer::enumAsString() const
 {
-	return d->enumAsString;
+	QReadLocker lock{&d->optionsLock};
+	return d->options.enumAsString();
 }
 
 bool QJsonSerializer::validateBase64() const
 {
-	return d->validateBase64;
+	QReadLocker lock{&d->optionsLock};
+	return d->options.validateBase64();
 }
 
 bool QJsonSerializer::useBcp47Locale() const
 {
-	return d->useBcp47Locale;
+	QReadLocker lock{&d->optionsLock};
+	return d->options.useBcp47Locale();
 }
 
 QJsonSerializer::ValidationFlags QJsonSerializer::validationFlags() const
 {
-	return d->validationFlags;
+	QReadLocker lock{&d->optionsLock};
+	return d->options.validationFlags();
 }
 
 QJsonSerializer::Polymorphing QJsonSerializer::polymorphing() const
 {
-	return d->polymorphing;
+	QReadLocker lock{&d->optionsLock};
+	return d->options.polymorphing();
 }
 
 QJsonSerializer::MultiMapMode QJsonSerializer::multiMapMode() const
 {
-	return d->multiMapMode;
+	QReadLocker lock{&d->optionsLock};
+	return d->options.multiMapMode();
+}
+
+bool QJsonSerializer::dateTimeAsEpoch() const
+{
+	QReadLocker lock{&d->optionsLock};
+	return d->options.dateTimeAsEpoch();
+}
+
+bool QJsonSerializer::geometryAsArray() const
+{
+	QReadLocker lock{&d->optionsLock};
+	return d->options.geometryAsArray();
+}
+
+bool QJsonSerializer::columnarLists() const
+{
+	QReadLocker lock{&d->optionsLock};
+	return d->options.columnarLists();
+}
+
+bool QJsonSerializer::objectReferences() const
+{
+	QReadLocker lock{&d->optionsLock};
+	return d->options.objectReferences();
+}
+
+int QJsonSerializer::attachmentThreshold() const
+{
+	QReadLocker lock{&d->optionsLock};
+	return d->options.attachmentThreshold();
+}
+
+int QJsonSerializer::stringPoolSize() const
+{
+	QReadLocker lock{&d->optionsLock};
+	return d->options.stringPoolSize();
 }
 
 QJsonValue QJsonSerializer::serialize(const QVariant &data) const
@@ -104,6 +171,74 @@ QByteArray QJsonSerializer::serializeTo(const QVariant &data, QJsonDocument::Jso
 	return serializeToImpl(data, format);
 }
 
+void QJsonSerializer::serializeToMsgPack(QIODevice *device, const QVariant &data) const
+{
+	// written while the data is serialized, without creating the json tree first
+	QJsonMsgPackWriter writer{device};
+	QJsonValueProducer{this, data, &writer}.finish();
+	writer.flush();
+}
+
+QByteArray QJsonSerializer::serializeToMsgPack(const QVariant &data) const
+{
+	QBuffer buffer;
+	buffer.open(QIODevice::WriteOnly);
+	serializeToMsgPack(&buffer, data);
+	buffer.close();
+	return buffer.data();
+}
+
+void QJsonSerializer::serializeWithAttachments(QIODevice *device, const QVariant &data) const
+{
+	QByteArrayList attachments;
+	const auto json = serializeWithAttachments(data, attachments);
+	QBuffer jsonBuffer;
+	jsonBuffer.open(QIODevice::WriteOnly);
+	writeToDevice(json, &jsonBuffer, QJsonDocument::Compact);
+	jsonBuffer.close();
+	QJsonAttachmentContext::writeContainer(device, jsonBuffer.data(), attachments);
+}
+
+QByteArray QJsonSerializer::serializeWithAttachments(const QVariant &data) const
+{
+	QBuffer buffer;
+	buffer.open(QIODevice::WriteOnly);
+	serializeWithAttachments(&buffer, data);
+	buffer.close();
+	return buffer.data();
+}
+
+QJsonValue QJsonSerializer::serializeWithAttachments(const QVariant &data, QByteArrayList &attachments) const
+{
+	QJsonOptionsContext options{this, d.data()};
+	QJsonAttachmentContext context{options->attachmentThreshold};
+	const auto json = serializeVariant(data.userType(), data);
+	attachments = context.attachments();
+	return json;
+}
+
+void QJsonSerializer::serializeToCompressed(QIODevice *device, const QVariant &data, Compression compression, int level, QJsonDocument::JsonFormat format) const
+{
+	QJsonCompressionDevice compressor{device, compression, level};
+	if(!compressor.open(QIODevice::WriteOnly))
+		throw QJsonSerializationException("Failed to start compression with error: " + compressor.errorString().toUtf8());
+
+	// the text is compressed chunk by chunk while the data is serialized, neither the json tree nor the text are created completely
+	QJsonTextWriter writer{format};
+	QJsonValueProducer producer{this, data, &writer};
+	while(!producer.atEnd()) {
+		producer.next();
+		if(writer.buffer.size() >= QJsonCompressionDevice::ChunkSize || producer.atEnd()) {
+			if(compressor.write(writer.buffer) != writer.buffer.size())
+				break;
+			writer.buffer.resize(0);
+		}
+	}
+	compressor.close();
+	if(compressor.hasFailed())
+		throw QJsonSerializationException(compressor.errorString().toUtf8());
+}
+
 QVariant QJsonSerializer::deserialize(const QJsonValue &json, int metaTypeId, QObject *parent) const
 {
 	return deserializeVariant(metaTypeId, json, parent);
@@ -123,13 +258,266 @@ QVariant QJsonSerializer::deserializeFrom(const QByteArray &data, int metaTypeId
 	return res;
 }
 
+QVariant QJsonSerializer::deserialize(const QJsonValue &json, int metaTypeId, const QJsonFieldSelector &selector, QObject *parent) const
+{
+	QJsonFieldSelectorContext context{selector};
+	return deserializeVariant(metaTypeId, json, parent);
+}
+
+QVariant QJsonSerializer::deserializeFrom(QIODevice *device, int metaTypeId, const QJsonFieldSelector &selector, QObject *parent) const
+{
+	return deserialize(readFromDevice(device), metaTypeId, selector, parent);
+}
+
+QVariant QJsonSerializer::deserializeFrom(const QByteArray &data, int metaTypeId, const QJsonFieldSelector &selector, QObject *parent) const
+{
+	QBuffer buffer(const_cast<QByteArray*>(&data));
+	buffer.open(QIODevice::ReadOnly);
+	auto res = deserializeFrom(&buffer, metaTypeId, selector, parent);
+	buffer.close();
+	return res;
+}
+
+QJsonValue QJsonSerializer::serialize(const QVariant &data, const QJsonFieldSelector &selector) const
+{
+	QJsonFieldSelectorContext context{selector};
+	return serializeImpl(data);
+}
+
+void QJsonSerializer::serializeTo(QIODevice *device, const QVariant &data, const QJsonFieldSelector &selector, QJsonDocument::JsonFormat format) const
+{
+	QJsonFieldSelectorContext context{selector};
+	serializeToImpl(device, data, format);
+}
+
+QByteArray QJsonSerializer::serializeTo(const QVariant &data, const QJsonFieldSelector &selector, QJsonDocument::JsonFormat format) const
+{
+	QJsonFieldSelectorContext context{selector};
+	return serializeToImpl(data, format);
+}
+
+QJsonValue QJsonSerializer::serialize(const QVariant &data, const QJsonSerializerOptions &options) const
+{
+	QJsonOptionsContext context{this, options};
+	return serializeImpl(data);
+}
+
+QVariant QJsonSerializer::deserialize(const QJsonValue &json, int metaTypeId, const QJsonSerializerOptions &options, QObject *parent) const
+{
+	QJsonOptionsContext context{this, options};
+	return deserializeVariant(metaTypeId, json, parent);
+}
+
+QVariant QJsonSerializer::deserializeFromMsgPack(QIODevice *device, int metaTypeId, QObject *parent) const
+{
+	QJsonMsgPackContext context;
+	const auto json = QJsonMsgPackReader{device, &context}.read();
+	return deserializeVariant(metaTypeId, json, parent);
+}
+
+QVariant QJsonSerializer::deserializeFromMsgPack(const QByteArray &data, int metaTypeId, QObject *parent) const
+{
+	QBuffer buffer(const_cast<QByteArray*>(&data));
+	buffer.open(QIODevice::ReadOnly);
+	auto res = deserializeFromMsgPack(&buffer, metaTypeId, parent);
+	buffer.close();
+	return res;
+}
+
+QVariant QJsonSerializer::deserializeWithAttachments(QIODevice *device, int metaTypeId, QObject *parent) const
+{
+	QByteArrayList attachments;
+	auto jsonData = QJsonAttachmentContext::readContainer(device, attachments);
+	QBuffer jsonBuffer{&jsonData};
+	jsonBuffer.open(QIODevice::ReadOnly);
+	const auto json = readFromDevice(&jsonBuffer);
+	jsonBuffer.close();
+	return deserializeWithAttachments(json, metaTypeId, attachments, parent);
+}
+
+QVariant QJsonSerializer::deserializeWithAttachments(const QByteArray &data, int metaTypeId, QObject *parent) const
+{
+	QBuffer buffer(const_cast<QByteArray*>(&data));
+	buffer.open(QIODevice::ReadOnly);
+	auto res = deserializeWithAttachments(&buffer, metaTypeId, parent);
+	buffer.close();
+	return res;
+}
+
+QVariant QJsonSerializer::deserializeWithAttachments(const QJsonValue &json, int metaTypeId, const QByteArrayList &attachments, QObject *parent) const
+{
+	QJsonAttachmentContext context{attachments};
+	return deserializeVariant(metaTypeId, json, parent);
+}
+
+QVariant QJsonSerializer::deserializeFromCompressed(QIODevice *device, int metaTypeId, QObject *parent) const
+{
+	QJsonCompressionDevice decompressor{device};
+	if(!decompressor.open(QIODevice::ReadOnly))
+		throw QJsonDeserializationException("Failed to start decompression with error: " + decompressor.errorString().toUtf8());
+	// the text is parsed while it is decompressed, without holding all of it
+	const auto json = QJsonTextReader{&decompressor}.read();
+	if(decompressor.hasFailed())
+		throw QJsonDeserializationException(decompressor.errorString().toUtf8());
+	if(!decompressor.atStreamEnd())
+		throw QJsonDeserializationException("Unexpected end of compressed data");
+	decompressor.close();
+	return deserializeVariant(metaTypeId, json, parent);
+}
+
+QJsonWriteJob *QJsonSerializer::createWriteJob(QIODevice *device, const QVariant &data, QObject *parent) const
+{
+	// the data is serialized while the job writes it - the root is produced right away, so invalid data fails here
+	QScopedPointer<QJsonWriteJobPrivate> job{new QJsonWriteJobPrivate{device}};
+	job->producer.reset(new QJsonValueProducer{this, data, &job->writer});
+	job->producer->next();
+	return new QJsonWriteJob{job.take(), parent};
+}
+
+QJsonReadPipeline *QJsonSerializer::createReadPipeline(QIODevice *device, int metaTypeId, QObject *parent) const
+{
+	// all records are deserialized with the settings the pipeline was created with
+	return new QJsonReadPipeline{device, [this, metaTypeId, snapshot = options()](const QJsonValue &json) {
+		QJsonOptionsContext options{this, snapshot};
+		return deserializeVariant(metaTypeId, json, nullptr);
+	}, parent};
+}
+
+QFuture<QByteArray> QJsonSerializer::serializeAsync(const QVariant &data, QJsonDocument::JsonFormat format, QThreadPool *threadPool) const
+{
+	auto job = new QJsonAsyncJob<QByteArray>{true, d->asyncGuard, [this, data, format, snapshot = options()]() {
+		QJsonOptionsContext options{this, snapshot};
+		QByteArray result;
+		QBuffer buffer{&result};
+		buffer.open(QIODevice::WriteOnly);
+		writeStream(&buffer, data, format);
+		buffer.close();
+		return result;
+	}};
+	return job->start(threadPool);
+}
+
+QFuture<qint64> QJsonSerializer::serializeAsync(const QVariant &data, QIODevice *device, QJsonDocument::JsonFormat format, QThreadPool *threadPool) const
+{
+	auto job = new QJsonAsyncJob<qint64>{true, d->asyncGuard, [this, data, device, format, snapshot = options()]() {
+		QJsonOptionsContext options{this, snapshot};
+		return writeStream(device, data, format);
+	}};
+	return job->start(threadPool);
+}
+
+QFuture<QVariant> QJsonSerializer::deserializeAsync(const QByteArray &data, int metaTypeId, QThread *targetThread, QThreadPool *threadPool) const
+{
+	if(!targetThread)
+		targetThread = QThread::currentThread();
+	auto job = new QJsonAsyncJob<QVariant>{false, d->asyncGuard, [this, data, metaTypeId, targetThread, snapshot = options()]() {
+		QJsonOptionsContext options{this, snapshot};
+		QBuffer buffer;
+		buffer.setData(data);
+		buffer.open(QIODevice::ReadOnly);
+		const auto result = readStream(&buffer, metaTypeId, targetThread);
+		buffer.close();
+		return result;
+	}};
+	return job->start(threadPool);
+}
+
+QFuture<QVariant> QJsonSerializer::deserializeAsync(QIODevice *device, int metaTypeId, QThread *targetThread, QThreadPool *threadPool) const
+{
+	if(!targetThread)
+		targetThread = QThread::currentThread();
+	auto job = new QJsonAsyncJob<QVariant>{false, d->asyncGuard, [this, device, metaTypeId, targetThread, snapshot = options()]() {
+		QJsonOptionsContext options{this, snapshot};
+		return readStream(device, metaTypeId, targetThread);
+	}};
+	return job->start(threadPool);
+}
+
+QVariantList QJsonSerializer::deserializeParallel(const QByteArray &data, int elementTypeId, QObject *parent, QThreadPool *threadPool) const
+{
+	const QJsonArrayIndex index{data};
+	if(index.size() == 0)
+		return {};
+
+	QJsonOptionsContext options{this, d.data()};
+	// references may point to any other element, so they can only be resolved within one document
+	if(options->objectReferences) {
+		QBuffer buffer(const_cast<QByteArray*>(&data));
+		buffer.open(QIODevice::ReadOnly);
+		const auto json = readFromDevice(&buffer);
+		buffer.close();
+		QJsonReferenceContext::Scope references{true, json};
+		QJsonStringPool::Scope strings{options->stringPoolSize};
+		const auto array = json.toArray();
+		QVariantList result;
+		result.reserve(array.size());
+		for(auto i = 0; i < array.size(); ++i)
+			result.append(deserializeSubtype(elementTypeId, array[i], parent, "[" + QByteArray::number(i) + "]"));
+		return result;
+	}
+
+	if(!threadPool)
+		threadPool = QThreadPool::globalInstance();
+	// a few chunks per thread, so threads that got cheap elements can pick up more work
+	const auto chunkCount = qMin(index.size(), qMax(1, threadPool->maxThreadCount()) * 4);
+	const auto targetThread = QThread::currentThread();
+	QList<QFuture<QVariantList>> futures;
+	futures.reserve(chunkCount);
+	for(auto i = 0; i < chunkCount; ++i) {
+		const auto first = static_cast<int>(static_cast<qint64>(index.size()) * i / chunkCount);
+		const auto last = static_cast<int>(static_cast<qint64>(index.size()) * (i + 1) / chunkCount);
+		// the index outlives all jobs, as every future is waited for below
+		auto job = new QJsonAsyncJob<QVariantList>{false, {}, [this, &index, first, last, elementTypeId, targetThread, snapshot = options.options()]() {
+			QJsonOptionsContext options{this, snapshot};
+			const auto chunk = deserializeChunk(index, first, last, elementTypeId);
+			for(const auto &element : chunk)
+				QJsonAsyncContext::moveToThread(element, targetThread);
+			return chunk;
+		}};
+		futures.append(job->start(threadPool));
+	}
+
+	QVariantList result;
+	result.reserve(index.size());
+	QScopedPointer<QException> error;
+	for(auto &future : futures) {
+		try {
+			result.append(future.result());
+		} catch(QException &e) {
+			if(!error)
+				error.reset(e.clone());
+		}
+	}
+
+	if(error) {
+		// the objects of the successful chunks are not returned, and thus must not be leaked
+		QJsonSerializerPrivate::deleteOrphans(result);
+		error->raise();
+	}
+
+	if(parent) {
+		for(const auto &element : qAsConst(result)) {
+			if(QMetaType::typeFlags(element.userType()).testFlag(QMetaType::PointerToQObject)) {
+				const auto object = element.value<QObject*>();
+				if(object && !object->parent())
+					object->setParent(parent);
+			}
+		}
+	}
+	return result;
+}
+
 void QJsonSerializer::addJsonTypeConverterFactory(const QSharedPointer<QJsonTypeConverterFactory> &factory)
 {
 	// call once to "initialize" the factory
 	Q_UNUSED(factory->priority());
 	// add to global list
-	QWriteLocker fLock{&QJsonSerializerPrivate::factoryLock};
-	QJsonSerializerPrivate::typeConverterFactories.append(factory);
+	{
+		QWriteLocker fLock{&QJsonSerializerPrivate::factoryLock};
+		QJsonSerializerPrivate::typeConverterFactories.append(factory);
+	}
+	// types without a converter so far might be handled by the new factory
+	QJsonSerializerPrivate::clearSharedConverterCache();
 }
 
 void QJsonSerializer::addJsonTypeConverter(QSharedPointer<QJsonTypeConverter> converter)
@@ -148,8 +536,7 @@ void QJsonSerializer::addJsonTypeConverter(QSharedPointer<QJsonTypeConverter> co
 	if(!inserted)
 		d->typeConverters.append(converter);
 
-	d->typeConverterSerCache.clear();
-	d->typeConverterDeserCache.clear();
+	d->typeConverterCache.clear();
 }
 
 void QJsonSerializer::addJsonTypeConverter(QJsonTypeConverter *converter)
@@ -157,115 +544,299 @@ void QJsonSerializer::addJsonTypeConverter(QJsonTypeConverter *converter)
 	addJsonTypeConverter(QSharedPointer<QJsonTypeConverter>(converter));
 }
 
-void QJsonSerializer::setAllowDefaultNull(bool allowDefaultNull)
+QJsonSerializerOptions QJsonSerializer::options() const
 {
-	if(d->allowNull == allowDefaultNull)
-		return;
+	return d->snapshot();
+}
 
-	d->allowNull = allowDefaultNull;
-	emit allowDefaultNullChanged(d->allowNull);
+void QJsonSerializer::setOptions(const QJsonSerializerOptions &options)
+{
+	QJsonSerializerOptions previous;
+	{
+		QWriteLocker lock{&d->optionsLock};
+		if(d->options == options)
+			return;
+		previous = d->options;
+		d->options = options;
+	}
+
+	if(previous.allowDefaultNull() != options.allowDefaultNull())
+		emit allowDefaultNullChanged(options.allowDefaultNull());
+	if(previous.keepObjectName() != options.keepObjectName())
+		emit keepObjectNameChanged(options.keepObjectName());
+	if(previous.enumAsString() != options.enumAsString())
+		emit enumAsStringChanged(options.enumAsString());
+	if(previous.validateBase64() != options.validateBase64())
+		emit validateBase64Changed(options.validateBase64());
+	if(previous.useBcp47Locale() != options.useBcp47Locale())
+		emit useBcp47LocaleChanged(options.useBcp47Locale());
+	if(previous.validationFlags() != options.validationFlags())
+		emit validationFlagsChanged(options.validationFlags());
+	if(previous.polymorphing() != options.polymorphing())
+		emit polymorphingChanged(options.polymorphing());
+	if(previous.multiMapMode() != options.multiMapMode())
+		emit multiMapModeChanged(options.multiMapMode());
+	if(previous.dateTimeAsEpoch() != options.dateTimeAsEpoch())
+		emit dateTimeAsEpochChanged(options.dateTimeAsEpoch());
+	if(previous.geometryAsArray() != options.geometryAsArray())
+		emit geometryAsArrayChanged(options.geometryAsArray());
+	if(previous.columnarLists() != options.columnarLists())
+		emit columnarListsChanged(options.columnarLists());
+	if(previous.objectReferences() != options.objectReferences())
+		emit objectReferencesChanged(options.objectReferences());
+	if(previous.attachmentThreshold() != options.attachmentThreshold())
+		emit attachmentThresholdChanged(options.attachmentThreshold());
+	if(previous.stringPoolSize() != options.stringPoolSize())
+		emit stringPoolSizeChanged(options.stringPoolSize());
 }
 
-void QJsonSerializer::setKeepObjectName(bool keepObjectName)
+QSharedPointer<QJsonSerializerTracer> QJsonSerializer::tracer() const
 {
-	if(d->keepObjectName == keepObjectName)
-		return;
+	QReadLocker lock{&d->optionsLock};
+	return d->tracer;
+}
 
-	d->keepObjectName = keepObjectName;
-	emit keepObjectNameChanged(d->keepObjectName);
+void QJsonSerializer::setTracer(const QSharedPointer<QJsonSerializerTracer> &tracer)
+{
+	QWriteLocker lock{&d->optionsLock};
+	d->tracer = tracer;
 }
 
-void QJsonSerializer::setEnumAsString(bool enumAsString)
+void QJsonSerializer::setAllowDefaultNull(bool allowDefaultNull)
 {
-	if(d->enumAsString == enumAsString)
-		return;
+	{
+		QWriteLocker lock{&d->optionsLock};
+		if(d->options.allowDefaultNull() == allowDefaultNull)
+			return;
+		d->options.setAllowDefaultNull(allowDefaultNull);
+	}
+	emit allowDefaultNullChanged(allowDefaultNull);
+}
 
-	d->enumAsString = enumAsString;
-	emit enumAsStringChanged(d->enumAsString);
+void QJsonSerializer::setKeepObjectName(bool keepObjectName)
+{
+	{
+		QWriteLocker lock{&d->optionsLock};
+		if(d->options.keepObjectName() == keepObjectName)
+			return;
+		d->options.setKeepObjectName(keepObjectName);
+	}
+	emit keepObjectNameChanged(keepObjectName);
 }
 
-void QJsonSerializer::setValidateBase64(bool validateBase64)
+void QJsonSerializer::setEnumAsString(bool enumAsString)
 {
-	if(d->validateBase64 == validateBase64)
-		return;
+	{
+		QWriteLocker lock{&d->optionsLock};
+		if(d->options.enumAsString() == enumAsString)
+			return;
+		d->options.setEnumAsString(enumAsString);
+	}
+	emit enumAsStringChanged(enumAsString);
+}
 
-	d->validateBase64 = validateBase64;
-	emit validateBase64Changed(d->validateBase64);
+void QJsonSerializer::setValidateBase64(bool validateBase64)
+{
+	{
+		QWriteLocker lock{&d->optionsLock};
+		if(d->options.validateBase64() == validateBase64)
+			return;
+		d->options.setValidateBase64(validateBase64);
+	}
+	emit validateBase64Changed(validateBase64);
 }
 
 void QJsonSerializer::setUseBcp47Locale(bool useBcp47Locale)
 {
-	if(d->useBcp47Locale == useBcp47Locale)
-		return;
-
-	d->useBcp47Locale = useBcp47Locale;
-	emit useBcp47LocaleChanged(d->useBcp47Locale);
+	{
+		QWriteLocker lock{&d->optionsLock};
+		if(d->options.useBcp47Locale() == useBcp47Locale)
+			return;
+		d->options.setUseBcp47Locale(useBcp47Locale);
+	}
+	emit useBcp47LocaleChanged(useBcp47Locale);
 }
 
 void QJsonSerializer::setValidationFlags(ValidationFlags validationFlags)
 {
-	if(d->validationFlags == validationFlags)
-		return;
-
-	d->validationFlags = validationFlags;
-	emit validationFlagsChanged(d->validationFlags);
+	{
+		QWriteLocker lock{&d->optionsLock};
+		if(d->options.validationFlags() == validationFlags)
+			return;
+		d->options.setValidationFlags(validationFlags);
+	}
+	emit validationFlagsChanged(validationFlags);
 }
 
 void QJsonSerializer::setPolymorphing(QJsonSerializer::Polymorphing polymorphing)
 {
-	if(d->polymorphing == polymorphing)
-		return;
-
-	d->polymorphing = polymorphing;
-	emit polymorphingChanged(d->polymorphing);
+	{
+		QWriteLocker lock{&d->optionsLock};
+		if(d->options.polymorphing() == polymorphing)
+			return;
+		d->options.setPolymorphing(polymorphing);
+	}
+	emit polymorphingChanged(polymorphing);
 }
 
 void QJsonSerializer::setMultiMapMode(QJsonSerializer::MultiMapMode multiMapMode)
 {
-	if(d->multiMapMode == multiMapMode)
-		return;
+	{
+		QWriteLocker lock{&d->optionsLock};
+		if(d->options.multiMapMode() == multiMapMode)
+			return;
+		d->options.setMultiMapMode(multiMapMode);
+	}
+	emit multiMapModeChanged(multiMapMode);
+}
+
+void QJsonSerializer::setDateTimeAsEpoch(bool dateTimeAsEpoch)
+{
+	{
+		QWriteLocker lock{&d->optionsLock};
+		if(d->options.dateTimeAsEpoch() == dateTimeAsEpoch)
+			return;
+		d->options.setDateTimeAsEpoch(dateTimeAsEpoch);
+	}
+	emit dateTimeAsEpochChanged(dateTimeAsEpoch);
+}
 
-	d->multiMapMode = multiMapMode;
-	emit multiMapModeChanged(d->multiMapMode);
+void QJsonSerializer::setGeometryAsArray(bool geometryAsArray)
+{
+	{
+		QWriteLocker lock{&d->optionsLock};
+		if(d->options.geometryAsArray() == geometryAsArray)
+			return;
+		d->options.setGeometryAsArray(geometryAsArray);
+	}
+	emit geometryAsArrayChanged(geometryAsArray);
+}
+
+void QJsonSerializer::setColumnarLists(bool columnarLists)
+{
+	{
+		QWriteLocker lock{&d->optionsLock};
+		if(d->options.columnarLists() == columnarLists)
+			return;
+		d->options.setColumnarLists(columnarLists);
+	}
+	emit columnarListsChanged(columnarLists);
+}
+
+void QJsonSerializer::setObjectReferences(bool objectReferences)
+{
+	{
+		QWriteLocker lock{&d->optionsLock};
+		if(d->options.objectReferences() == objectReferences)
+			return;
+		d->options.setObjectReferences(objectReferences);
+	}
+	emit objectReferencesChanged(objectReferences);
+}
+
+void QJsonSerializer::setAttachmentThreshold(int attachmentThreshold)
+{
+	{
+		QWriteLocker lock{&d->optionsLock};
+		if(d->options.attachmentThreshold() == attachmentThreshold)
+			return;
+		d->options.setAttachmentThreshold(attachmentThreshold);
+	}
+	emit attachmentThresholdChanged(attachmentThreshold);
+}
+
+void QJsonSerializer::setStringPoolSize(int stringPoolSize)
+{
+	{
+		QWriteLocker lock{&d->optionsLock};
+		if(d->options.stringPoolSize() == stringPoolSize)
+			return;
+		d->options.setStringPoolSize(stringPoolSize);
+	}
+	emit stringPoolSizeChanged(stringPoolSize);
 }
 
 QVariant QJsonSerializer::getProperty(const char *name) const
 {
-	return property(name);
+	// settings come from the options of the running call, anything else from the serializer itself
+	const auto options = QJsonOptionsContext::find(this);
+	const auto value = QJsonOptionsContext::property(options ? options->options() : d->snapshot(), name);
+	return value.isValid() ? value : property(name);
 }
 
 QJsonValue QJsonSerializer::serializeSubtype(QMetaProperty property, const QVariant &value) const
 {
+	const auto options = QJsonOptionsContext::find(this);
+	if(Q_UNLIKELY(!options)) {
+		// only if a converter is used with the serializer as helper, but outside of its calls
+		QJsonOptionsContext context{this, d.data()};
+		return serializeSubtype(property, value);
+	}
+
 	QJsonExceptionContext ctx(property);
+	QJsonAsyncContext::checkpoint();
+	QJsonTraceScope trace{options->tracer(), d.data(), QJsonSerializerTracer::Operation::Serialize, property.userType(), property.name(), property.isEnumType()};
 	if(property.isEnumType())
-		return serializeEnum(property.enumerator(), value);
+		return serializeEnum(property.enumerator(), value, *options);
 	else
-		return serializeVariant(property.userType(), value);
+		return serializeVariant(property.userType(), value, *options);
 }
 
 QVariant QJsonSerializer::deserializeSubtype(QMetaProperty property, const QJsonValue &value, QObject *parent) const
 {
+	const auto options = QJsonOptionsContext::find(this);
+	if(Q_UNLIKELY(!options)) {
+		QJsonOptionsContext context{this, d.data()};
+		return deserializeSubtype(property, value, parent);
+	}
+
 	QJsonExceptionContext ctx(property);
+	QJsonAsyncContext::checkpoint();
+	QJsonTraceScope trace{options->tracer(), d.data(), QJsonSerializerTracer::Operation::Deserialize, property.userType(), property.name(), property.isEnumType(), value.type()};
 	if(property.isEnumType())
 		return deserializeEnum(property.enumerator(), value);
 	else
-		return deserializeVariant(property.userType(), value, parent);
+		return deserializeVariant(property.userType(), value, parent, *options);
 }
 
 QJsonValue QJsonSerializer::serializeSubtype(int propertyType, const QVariant &value, const QByteArray &traceHint) const
 {
+	const auto options = QJsonOptionsContext::find(this);
+	if(Q_UNLIKELY(!options)) {
+		QJsonOptionsContext context{this, d.data()};
+		return serializeSubtype(propertyType, value, traceHint);
+	}
+
 	QJsonExceptionContext ctx(propertyType, traceHint);
-	return serializeVariant(propertyType, value);
+	QJsonAsyncContext::checkpoint();
+	QJsonTraceScope trace{options->tracer(), d.data(), QJsonSerializerTracer::Operation::Serialize, propertyType, traceHint.constData()};
+	return serializeVariant(propertyType, value, *options);
 }
 
 QVariant QJsonSerializer::deserializeSubtype(int propertyType, const QJsonValue &value, QObject *parent, const QByteArray &traceHint) const
 {
+	const auto options = QJsonOptionsContext::find(this);
+	if(Q_UNLIKELY(!options)) {
+		QJsonOptionsContext context{this, d.data()};
+		return deserializeSubtype(propertyType, value, parent, traceHint);
+	}
+
 	QJsonExceptionContext ctx(propertyType, traceHint);
-	return deserializeVariant(propertyType, value, parent);
+	QJsonAsyncContext::checkpoint();
+	QJsonTraceScope trace{options->tracer(), d.data(), QJsonSerializerTracer::Operation::Deserialize, propertyType, traceHint.constData(), false, value.type()};
+	return deserializeVariant(propertyType, value, parent, *options);
 }
 
 QJsonValue QJsonSerializer::serializeVariant(int propertyType, const QVariant &value) const
 {
+	QJsonOptionsContext options{this, d.data()};
+	return serializeVariant(propertyType, value, options);
+}
+
+QJsonValue QJsonSerializer::serializeVariant(int propertyType, const QVariant &value, const QJsonOptionsContext &options) const
+{
+	QJsonReferenceContext::Scope references{options->objectReferences};
+
 	auto converter = d->findConverter(propertyType);
 	if(!converter)// use fallback method
 		return serializeValue(propertyType, value);
@@ -275,24 +846,54 @@ QJsonValue QJsonSerializer::serializeVariant(int propertyType, const QVariant &v
 
 QVariant QJsonSerializer::deserializeVariant(int propertyType, const QJsonValue &value, QObject *parent) const
 {
-	auto converter = d->findConverter(propertyType, value.type());
+	QJsonOptionsContext options{this, d.data()};
+	return deserializeVariant(propertyType, value, parent, options);
+}
+
+QVariant QJsonSerializer::deserializeVariant(int propertyType, const QJsonValue &value, QObject *parent, const QJsonOptionsContext &options) const
+{
+	QJsonReferenceContext::Scope references{options->objectReferences, value};
+	QJsonStringPool::Scope strings{options->stringPoolSize};
+
+	// MessagePack: native values are referenced from within objects
+	if(value.isObject() || value.isArray()) {
+		const auto msgPack = QJsonMsgPackContext::current();
+		if(Q_UNLIKELY(msgPack)) {
+			auto json = value;
+			QVariant native;
+			if(msgPack->deserializeNative(propertyType, d->findConverter(propertyType).data(), json, native))
+				return native;
+			return deserializeJson(propertyType, json, parent, d->findConverter(propertyType, json.type()).data(), options);
+		}
+	}
+
+	return deserializeJson(propertyType, value, parent, d->findConverter(propertyType, value.type()).data(), options);
+}
+
+QVariant QJsonSerializer::deserializeJson(int propertyType, const QJsonValue &value, QObject *parent, const QJsonTypeConverter *converter, const QJsonOptionsContext &options) const
+{
 	QVariant variant;
-	if(!converter)// use fallback method
+	if(!converter) {// use fallback method
+		if(QJsonSerializerPrivate::deserializeScalar(propertyType, value, variant))
+			return variant;
 		variant = deserializeValue(propertyType, value);
-	else
+	} else
 		variant = converter->deserialize(propertyType, value, parent, this);
 
 	if(propertyType != QMetaType::UnknownType) {
-		auto vType = variant.typeName();
-
 		// exclude special values that can convert from null, but should not do so
 		auto allowConvert = true;
 		if(propertyType == QMetaType::QString && value.isNull())
 			allowConvert = false;
 
-		if(allowConvert && variant.canConvert(propertyType) && variant.convert(propertyType))
+		// most converters already return the property type - those values need no conversion
+		if(allowConvert && variant.userType() == propertyType)
 			return variant;
-		else if(d->allowNull && value.isNull())
+
+		auto vType = variant.typeName();
+		if(allowConvert && variant.convert(propertyType))
+			return variant;
+		else if(value.isNull() && options->allowDefaultNull)
 			return QVariant{propertyType, nullptr};
 		else {
 			throw QJsonDeserializationException(QByteArray("Failed to convert deserialized variant of type ") +
@@ -313,7 +914,11 @@ QJsonValue QJsonSerializer::serializeValue(int propertyType, const QVariant &val
 		if(value.userType() == QMetaType::QJsonValue)//value needs special treatment
 			return value.toJsonValue();
 
-		auto json = QJsonValue::fromVariant(value);
+		QJsonValue json;
+		if(QJsonSerializerPrivate::serializeScalar(value, json))
+			return json;
+
+		json = QJsonValue::fromVariant(value);
 		if(json.isNull()) { //special types where a null json is valid, and corresponds to a different
 			static const QHash<int, QJsonValue::Type> nullTypes = {
 				{QMetaType::Nullptr, QJsonValue::Null},
@@ -371,12 +976,14 @@ QVariant QJsonSerializer::deserializeValue(int propertyType, const QJsonValue &v
 		break;
 	}
 
+	if(value.isString())
+		return QJsonStringPool::intern(value.toString());
 	return value.toVariant();
 }
 
-QJsonValue QJsonSerializer::serializeEnum(const QMetaEnum &metaEnum, const QVariant &value) const
+QJsonValue QJsonSerializer::serializeEnum(const QMetaEnum &metaEnum, const QVariant &value, const QJsonOptionsContext &options) const
 {
-	if(d->enumAsString) {
+	if(options->enumAsString) {
 		if(metaEnum.isFlag())
 			return QString::fromUtf8(metaEnum.valueToKeys(value.toInt()));
 		else
@@ -427,6 +1034,36 @@ void QJsonSerializer::writeToDevice(const QJsonValue &data, QIODevice *device, Q
 	device->write(doc.toJson(format));
 }
 
+qint64 QJsonSerializer::writeStream(QIODevice *device, const QVariant &data, QJsonDocument::JsonFormat format) const
+{
+	// the text is written chunk by chunk while the data is serialized, so the written bytes are the progress
+	QJsonTextWriter writer{format};
+	QJsonValueProducer producer{this, data, &writer};
+	qint64 written = 0;
+	while(!producer.atEnd()) {
+		producer.next();
+		if(writer.buffer.size() >= QJsonCompressionDevice::ChunkSize || producer.atEnd()) {
+			if(device->write(writer.buffer) != writer.buffer.size())
+				throw QJsonSerializationException("Failed to write json with error: " + device->errorString().toUtf8());
+			written += writer.buffer.size();
+			writer.buffer.resize(0);
+			QJsonAsyncContext::reportBytes(written);
+		}
+	}
+	return written;
+}
+
+QVariant QJsonSerializer::readStream(QIODevice *device, int metaTypeId, QThread *targetThread) const
+{
+	// the reader reports the bytes it has read as progress
+	if(!device->isSequential())
+		QJsonAsyncContext::setTotalBytes(device->size() - device->pos());
+	const auto json = QJsonTextReader{device}.read();
+	const auto result = deserializeVariant(metaTypeId, json, nullptr);
+	QJsonAsyncContext::moveToThread(result, targetThread);
+	return result;
+}
+
 QJsonValue QJsonSerializer::readFromDevice(QIODevice *device) const
 {
 	QJsonParseError error;
@@ -439,11 +1076,80 @@ QJsonValue QJsonSerializer::readFromDevice(QIODevice *device) const
 		return doc.object();
 }
 
+QVariantList QJsonSerializer::deserializeChunk(const QJsonArrayIndex &index, int first, int last, int elementTypeId) const
+{
+	QJsonParseError error;
+	const auto doc = QJsonDocument::fromJson(index.chunk(first, last), &error);
+	if(error.error != QJsonParseError::NoError) {
+		throw QJsonDeserializationException("Failed to read elements " + QByteArray::number(first) +
+											" to " + QByteArray::number(last - 1) +
+											" as JSON with error: " + error.errorString().toUtf8());
+	}
+
+	// one pool per chunk - the pools are thread local anyways
+	QJsonOptionsContext options{this, d.data()};
+	QJsonStringPool::Scope strings{options->stringPoolSize};
+	const auto array = doc.array();
+	Q_ASSERT(array.size() == last - first);
+	QVariantList result;
+	result.reserve(array.size());
+	try {
+		for(auto i = 0; i < array.size(); ++i)
+			result.append(deserializeSubtype(elementTypeId, array[i], nullptr, "[" + QByteArray::number(first + i) + "]"));
+	} catch(...) {
+		// the elements before the failed one are never returned
+		QJsonSerializerPrivate::deleteOrphans(result);
+		throw;
+	}
+	return result;
+}
+
 QJsonValue QJsonSerializer::serializeImpl(const QVariant &data) const
 {
 	return serializeVariant(data.userType(), data);
 }
 
+QJsonValue QJsonSerializer::serializeTyped(int propertyType, const void *value, TypedSerializer serializer, VariantFactory toVariant) const
+{
+	// the scopes of serializeVariant, shared by both paths
+	QJsonOptionsContext options{this, d.data()};
+	QJsonReferenceContext::Scope references{options->objectReferences};
+
+	const auto converter = d->findConverter(propertyType);
+	QJsonValue json;
+	if(converter && serializer(converter.data(), value, this, json))
+		return json;
+
+	// variants of other types (i.e. QVariant itself) are serialized as the type they contain
+	const auto variant = toVariant(value);
+	if(variant.userType() != propertyType)
+		return serializeVariant(variant.userType(), variant, options);
+	else if(!converter)
+		return serializeValue(propertyType, variant);
+	else
+		return converter->serialize(propertyType, variant, this);
+}
+
+bool QJsonSerializer::deserializeTyped(int propertyType, const QJsonValue &json, QObject *parent, TypedDeserializer deserializer, void *value, QVariant &variant) const
+{
+	// the scopes of deserializeVariant, shared by both paths
+	QJsonOptionsContext options{this, d.data()};
+	QJsonReferenceContext::Scope references{options->objectReferences, json};
+	QJsonStringPool::Scope strings{options->stringPoolSize};
+
+	// MessagePack natives are only resolved by deserializeVariant
+	if(Q_UNLIKELY(QJsonMsgPackContext::current())) {
+		variant = deserializeVariant(propertyType, json, parent, options);
+		return false;
+	}
+
+	const auto converter = d->findConverter(propertyType, json.type());
+	if(converter && deserializer(converter.data(), json, parent, this, value))
+		return true;
+	variant = deserializeJson(propertyType, json, parent, converter.data(), options);
+	return false;
+}
+
 void QJsonSerializer::serializeToImpl(QIODevice *device, const QVariant &data) const
 {
 #ifndef QT_NO_DEBUG
@@ -478,8 +1184,12 @@ QByteArray QJsonSerializer::serializeToImpl(const QVariant &data, QJsonDocument:
 
 void QJsonSerializer::registerInverseTypedefImpl(int typeId, const char *normalizedTypeName)
 {
-	QWriteLocker lock{&QJsonSerializerPrivate::typedefLock};
-	QJsonSerializerPrivate::typedefMapping.insert(typeId, normalizedTypeName);
+	{
+		QWriteLocker lock{&QJsonSerializerPrivate::typedefLock};
+		QJsonSerializerPrivate::typedefMapping.insert(typeId, normalizedTypeName);
+	}
+	// converter matching depends on the canonical type names
+	QJsonSerializerPrivate::clearSharedConverterCache();
 }
 
 
@@ -492,6 +1202,7 @@ QList<QSharedPointer<QJsonTypeConverterFactory>> QJsonSerializerPrivate::typeCon
 	QSharedPointer<QJsonTypeConverterStandardFactory<QJsonGadgetConverter>>::create(),
 	QSharedPointer<QJsonTypeConverterStandardFactory<QJsonMapConverter>>::create(),
 	QSharedPointer<QJsonTypeConverterStandardFactory<QJsonMultiMapConverter>>::create(),
+	QSharedPointer<QJsonTypeConverterStandardFactory<QJsonColumnListConverter>>::create(),
 	QSharedPointer<QJsonTypeConverterStandardFactory<QJsonListConverter>>::create(),
 	QSharedPointer<QJsonTypeConverterStandardFactory<QJsonJsonValueConverter>>::create(),
 	QSharedPointer<QJsonTypeConverterStandardFactory<QJsonJsonObjectConverter>>::create(),
@@ -505,8 +1216,30 @@ QList<QSharedPointer<QJsonTypeConverterFactory>> QJsonSerializerPrivate::typeCon
 	QSharedPointer<QJsonTypeConverterStandardFactory<QJsonRectConverter>>::create(),
 	QSharedPointer<QJsonTypeConverterStandardFactory<QJsonLocaleConverter>>::create(),
 	QSharedPointer<QJsonTypeConverterStandardFactory<QJsonRegularExpressionConverter>>::create(),
-	QSharedPointer<QJsonTypeConverterStandardFactory<QJsonStdTupleConverter>>::create()
+	QSharedPointer<QJsonTypeConverterStandardFactory<QJsonStdTupleConverter>>::create(),
+	QSharedPointer<QJsonTypeConverterStandardFactory<QJsonDateTimeConverter>>::create(),
+	QSharedPointer<QJsonTypeConverterStandardFactory<QJsonLazyConverter>>::create()
 };
+QReadWriteLock QJsonSerializerPrivate::sharedConverterLock;
+QHash<const QJsonTypeConverterFactory*, QSharedPointer<QJsonTypeConverter>> QJsonSerializerPrivate::sharedConverters;
+QJsonSerializerPrivate::ConverterCache QJsonSerializerPrivate::sharedConverterCache;
+
+void QJsonSerializerPrivate::clearSharedConverterCache()
+{
+	QWriteLocker sLocker{&sharedConverterLock};
+	sharedConverterCache.clear();
+}
+
+void QJsonSerializerPrivate::deleteOrphans(const QVariantList &list)
+{
+	for(const auto &element : list) {
+		if(QMetaType::typeFlags(element.userType()).testFlag(QMetaType::PointerToQObject)) {
+			const auto object = element.value<QObject*>();
+			if(object && !object->parent())
+				delete object;
+		}
+	}
+}
 
 QByteArray QJsonSerializerPrivate::getTypeName(int propertyType)
 {
@@ -514,63 +1247,229 @@ QByteArray QJsonSerializerPrivate::getTypeName(int propertyType)
 	return typedefMapping.value(propertyType, QMetaType::typeName(propertyType));
 }
 
-QSharedPointer<QJsonTypeConverter> QJsonSerializerPrivate::findConverter(int propertyType, QJsonValue::Type valueType)
+QJsonSerializerOptions QJsonSerializerPrivate::snapshot() const
 {
-	const auto isSerialization = valueType == QJsonValue::Undefined;
-	QReadLocker tLocker{&typeConverterLock};
+	QReadLocker lock{&optionsLock};
+	return options;
+}
 
-	// first: check if already cached
-	QSharedPointer<QJsonTypeConverter> cachedConverter = nullptr; //in case json type did not match
-	if(isSerialization)
-		cachedConverter = typeConverterSerCache.value(propertyType);
-	else {
-		cachedConverter = typeConverterDeserCache.value(propertyType);
-		if(cachedConverter && !cachedConverter->jsonTypes().contains(valueType))
-			cachedConverter.clear();
-	}
-	if(cachedConverter)
-		return cachedConverter;
-
-	// second: check if the list of explicit converters has a matching one
-	for(const auto &converter : qAsConst(typeConverters)) {
-		if(converter &&
-		   (isSerialization || converter->jsonTypes().contains(valueType)) &&
-		   converter->canConvert(propertyType)) {
-			// elevate lock
-			tLocker.unlock();
-			QWriteLocker wtLocker{&typeConverterLock};
-			// add converter to cache
-			if(isSerialization)
-				typeConverterSerCache.insert(propertyType, converter);
-			else
-				typeConverterDeserCache.insert(propertyType, converter);
-			return converter;
+const QJsonOptionsContext *QJsonSerializerPrivate::context(const QJsonTypeConverter::SerializationHelper *helper)
+{
+	// the serializer passes itself as helper, within one of its calls
+	for(auto context = QJsonOptionsContext::current(); context; context = context->previous()) {
+		if(static_cast<const QJsonTypeConverter::SerializationHelper*>(context->serializer()) == helper)
+			return context;
+	}
+	return nullptr;
+}
+
+QJsonSerializerOptions QJsonSerializerPrivate::callOptions(const QJsonTypeConverter::SerializationHelper *helper)
+{
+	const auto context = QJsonSerializerPrivate::context(helper);
+	if(Q_LIKELY(context))
+		return context->options();
+
+	QJsonSerializerOptions options;
+	options.setAllowDefaultNull(helper->getProperty("allowDefaultNull").toBool())
+			.setKeepObjectName(helper->getProperty("keepObjectName").toBool())
+			.setEnumAsString(helper->getProperty("enumAsString").toBool())
+			.setValidateBase64(helper->getProperty("validateBase64").toBool())
+			.setUseBcp47Locale(helper->getProperty("useBcp47Locale").toBool())
+			.setValidationFlags(helper->getProperty("validationFlags").value<QJsonSerializer::ValidationFlags>())
+			.setPolymorphing(static_cast<QJsonSerializer::Polymorphing>(helper->getProperty("polymorphing").toInt()))
+			.setMultiMapMode(helper->getProperty("multiMapMode").value<QJsonSerializer::MultiMapMode>())
+			.setDateTimeAsEpoch(helper->getProperty("dateTimeAsEpoch").toBool())
+			.setGeometryAsArray(helper->getProperty("geometryAsArray").toBool())
+			.setColumnarLists(helper->getProperty("columnarLists").toBool())
+			.setObjectReferences(helper->getProperty("objectReferences").toBool())
+			.setAttachmentThreshold(helper->getProperty("attachmentThreshold").toInt())
+			.setStringPoolSize(helper->getProperty("stringPoolSize").toInt());
+	return options;
+}
+
+QSharedPointer<QJsonTypeConverter> QJsonSerializerPrivate::findConverter(int propertyType, QJsonValue::Type valueType)
+{
+	const ConverterCacheKey cacheKey{propertyType, valueType};
+
+	// first: check if the list of explicit converters has a matching one
+	{
+		QReadLocker tLocker{&typeConverterLock};
+		if(!typeConverters.isEmpty()) {
+			auto cIt = typeConverterCache.constFind(cacheKey);
+			if(cIt != typeConverterCache.constEnd()) {
+				if(*cIt)
+					return *cIt;
+			} else {
+				// elevate lock and search the list (only once per type)
+				tLocker.unlock();
+				QWriteLocker wtLocker{&typeConverterLock};
+				QSharedPointer<QJsonTypeConverter> match;
+				for(const auto &converter : qAsConst(typeConverters)) {
+					if(converterMatches(converter, propertyType, valueType)) {
+						match = converter;
+						break;
+					}
+				}
+				typeConverterCache.insert(cacheKey, match);
+				if(match)
+					return match;
+			}
 		}
 	}
 
-	// third: check in the list of global convert factories
+	// second: use the converters shared by all serializers
+	return findSharedConverter(propertyType, valueType);
+}
+
+bool QJsonSerializerPrivate::converterMatches(const QSharedPointer<QJsonTypeConverter> &converter, int propertyType, QJsonValue::Type valueType)
+{
+	return converter &&
+			(valueType == QJsonValue::Undefined || converter->jsonTypes().contains(valueType)) &&
+			converter->canConvert(propertyType);
+}
+
+QSharedPointer<QJsonTypeConverter> QJsonSerializerPrivate::findSharedConverter(int propertyType, QJsonValue::Type valueType)
+{
+	const ConverterCacheKey cacheKey{propertyType, valueType};
+
+	// first: check if already cached (including types without any converter)
+	{
+		QReadLocker sLocker{&sharedConverterLock};
+		auto cIt = sharedConverterCache.constFind(cacheKey);
+		if(cIt != sharedConverterCache.constEnd())
+			return *cIt;
+	}
+
+	// second: check in the list of global convert factories (keep locking order to prevent deadlocks)
+	QWriteLocker sLocker{&sharedConverterLock};
+	auto cIt = sharedConverterCache.constFind(cacheKey);
+	if(cIt != sharedConverterCache.constEnd())
+		return *cIt;
+
+	QSharedPointer<QJsonTypeConverter> match;
 	QReadLocker fLocker{&factoryLock};
 	for(const auto &factory : qAsConst(typeConverterFactories)) {
 		if(factory &&
-		   (isSerialization || factory->jsonTypes().contains(valueType)) &&
+		   (valueType == QJsonValue::Undefined || factory->jsonTypes().contains(valueType)) &&
 		   factory->canConvert(propertyType)) {
-			auto converter = factory->createConverter();
-			if(converter) {
-				// elevate lock (keep unlocking order to prevent deadlocks)
-				fLocker.unlock();
-				tLocker.unlock();
-				QWriteLocker wtLocker{&typeConverterLock};
-				// add converter to list and cache
-				typeConverters.append(converter);
-				if(isSerialization)
-					typeConverterSerCache.insert(propertyType, converter);
-				else
-					typeConverterDeserCache.insert(propertyType, converter);
-				return converter;
+			// each factory creates only one converter, which is then used by all serializers
+			auto converter = sharedConverters.value(factory.data());
+			if(!converter) {
+				converter = factory->createConverter();
+				if(!converter)
+					continue;
+				sharedConverters.insert(factory.data(), converter);
 			}
+			match = converter;
+			break;
 		}
 	}
+	fLocker.unlock();
 
-	// fourth: no converter found: return default converter
-	return nullptr;
+	// third: cache the result - a null converter means the default conversion is used
+	sharedConverterCache.insert(cacheKey, match);
+	return match;
+}
+
+bool QJsonSerializerPrivate::serializeScalar(const QVariant &value, QJsonValue &json)
+{
+	// produces exactly what QJsonValue::fromVariant would, but reads the stored value directly
+	const auto data = value.constData();
+	switch(value.userType()) {
+	case QMetaType::Bool:
+		json = *static_cast<const bool*>(data);
+		return true;
+	case QMetaType::Int:
+		json = *static_cast<const int*>(data);
+		return true;
+	case QMetaType::UInt:
+		json = static_cast<double>(*static_cast<const uint*>(data));
+		return true;
+	case QMetaType::LongLong:
+		json = static_cast<double>(*static_cast<const qlonglong*>(data));
+		return true;
+	case QMetaType::ULongLong:
+		json = static_cast<double>(*static_cast<const qulonglong*>(data));
+		return true;
+	case QMetaType::Float:
+		json = static_cast<double>(*static_cast<const float*>(data));
+		return true;
+	case QMetaType::Double:
+		json = *static_cast<const double*>(data);
+		return true;
+	case QMetaType::QString:
+		json = *static_cast<const QString*>(data);
+		return true;
+	case QMetaType::QChar:
+		json = QString{*static_cast<const QChar*>(data)};
+		return true;
+	case QMetaType::QUrl:
+		json = static_cast<const QUrl*>(data)->toString(QUrl::FullyEncoded);
+		return true;
+	case QMetaType::QUuid:
+		json = static_cast<const QUuid*>(data)->toString(QUuid::WithoutBraces);
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool QJsonSerializerPrivate::deserializeScalar(int propertyType, const QJsonValue &json, QVariant &value)
+{
+	// only handles the json type each scalar is serialized to - everything else (including null)
+	// goes through the generic conversion, which takes care of validation and allowNull
+	switch(json.type()) {
+	case QJsonValue::Bool:
+		if(propertyType != QMetaType::Bool)
+			return false;
+		value = json.toBool();
+		return true;
+	case QJsonValue::Double:
+		// integers are rounded the same way QVariant::convert does it
+		switch(propertyType) {
+		case QMetaType::Int:
+			value = static_cast<int>(qRound64(json.toDouble()));
+			return true;
+		case QMetaType::UInt:
+			value = static_cast<uint>(qRound64(json.toDouble()));
+			return true;
+		case QMetaType::LongLong:
+			value = static_cast<qlonglong>(qRound64(json.toDouble()));
+			return true;
+		case QMetaType::ULongLong:
+			value = static_cast<qulonglong>(qRound64(json.toDouble()));
+			return true;
+		case QMetaType::Float:
+			value = static_cast<float>(json.toDouble());
+			return true;
+		case QMetaType::Double:
+			value = json.toDouble();
+			return true;
+		default:
+			return false;
+		}
+	case QJsonValue::String:
+		switch(propertyType) {
+		case QMetaType::QString:
+			value = QJsonStringPool::intern(json.toString());
+			return true;
+		case QMetaType::QChar: {
+			const auto string = json.toString();
+			if(string.size() != 1)
+				return false;
+			value = string.at(0);
+			return true;
+		}
+		case QMetaType::QUrl:
+			value = QUrl{json.toString()};
+			return true;
+		case QMetaType::QUuid:
+			value = QVariant::fromValue(QUuid{json.toString()});
+			return true;
+		default:
+			return false;
+		}
+	default:
+		return false;
+	}
 }
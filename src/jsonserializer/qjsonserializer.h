@@ -7,6 +7,11 @@
 #include "QtJsonSerializer/qjsonserializerexception.h"
 #include "QtJsonSerializer/qjsonserializer_helpertypes.h"
 #include "QtJsonSerializer/qjsontypeconverter.h"
+#include "QtJsonSerializer/qjsonwritejob.h"
+#include "QtJsonSerializer/qjsonreadpipeline.h"
+#include "QtJsonSerializer/qjsonfieldselector.h"
+#include "QtJsonSerializer/qjsonlazy.h"
+#include "QtJsonSerializer/qjsonserializertracer.h"
 
 #include <QtCore/qjsonobject.h>
 #include <QtCore/qjsonarray.h>
@@ -14,6 +19,7 @@
 #include <QtCore/qmetaobject.h>
 #include <QtCore/qobject.h>
 #include <QtCore/qvariant.h>
+#include <QtCore/qbytearraylist.h>
 #include <QtCore/qdebug.h>
 #include <QtCore/qsharedpointer.h>
 #include <QtCore/qpointer.h>
@@ -23,8 +29,17 @@
 #include <QtCore/qset.h>
 #include <QtCore/qhash.h>
 #include <QtCore/qmap.h>
+#include <QtCore/qfuture.h>
+
+QT_BEGIN_NAMESPACE
+class QThread;
+class QThreadPool;
+QT_END_NAMESPACE
 
 class QJsonSerializerPrivate;
+class QJsonSerializerOptions;
+class QJsonOptionsContext;
+class QJsonArrayIndex;
 //! A class to serializer and deserializer c++ classes to and from JSON
 class Q_JSONSERIALIZER_EXPORT QJsonSerializer : public QObject, protected QJsonTypeConverter::SerializationHelper
 {
@@ -46,6 +61,18 @@ class Q_JSONSERIALIZER_EXPORT QJsonSerializer : public QObject, protected QJsonT
 	Q_PROPERTY(Polymorphing polymorphing READ polymorphing WRITE setPolymorphing NOTIFY polymorphingChanged)
 	//! Specify how multi maps and sets should be serialized
 	Q_PROPERTY(MultiMapMode multiMapMode READ multiMapMode WRITE setMultiMapMode NOTIFY multiMapModeChanged)
+	//! Specify whether QDateTime should be serialized as milliseconds since the epoch instead of an ISO string
+	Q_PROPERTY(bool dateTimeAsEpoch READ dateTimeAsEpoch WRITE setDateTimeAsEpoch NOTIFY dateTimeAsEpochChanged)
+	//! Specify whether geometry types like QPoint or QRect should be serialized as compact arrays instead of objects
+	Q_PROPERTY(bool geometryAsArray READ geometryAsArray WRITE setGeometryAsArray NOTIFY geometryAsArrayChanged)
+	//! Specify whether lists of gadgets or objects should be serialized in a compact columnar format
+	Q_PROPERTY(bool columnarLists READ columnarLists WRITE setColumnarLists NOTIFY columnarListsChanged)
+	//! Specifies, whether shared objects are serialized once and referenced by their id
+	Q_PROPERTY(bool objectReferences READ objectReferences WRITE setObjectReferences NOTIFY objectReferencesChanged)
+	//! The minimum size of byte arrays that are written as attachments
+	Q_PROPERTY(int attachmentThreshold READ attachmentThreshold WRITE setAttachmentThreshold NOTIFY attachmentThresholdChanged)
+	//! The maximum number of distinct strings shared per deserialization call
+	Q_PROPERTY(int stringPoolSize READ stringPoolSize WRITE setStringPoolSize NOTIFY stringPoolSizeChanged)
 
 public:
 	//! Flags to specify how strict the serializer should validate when deserializing
@@ -73,6 +100,13 @@ public:
 	};
 	Q_ENUM(MultiMapMode)
 
+	//! Enum to specify the format of compressed data
+	enum class Compression {
+		Deflate, //!< Compress the data with deflate, wrapped in the zlib format
+		Gzip //!< Compress the data with deflate, wrapped in the gzip format
+	};
+	Q_ENUM(Compression)
+
 	//! Constructor
 	explicit QJsonSerializer(QObject *parent = nullptr);
 	~QJsonSerializer() override;
@@ -113,6 +147,9 @@ public:
 	//! Registers a number of types for tuple conversion
 	template<typename... TArgs>
 	static inline bool registerTupleConverters(const char *originalTypeName = nullptr);
+	//! Registers a type for lazy deserialization via QJsonLazy
+	template<typename T>
+	static inline bool registerLazyConverters();
 
 	//! @readAcFn{QJsonSerializer::allowDefaultNull}
 	bool allowDefaultNull() const;
@@ -130,6 +167,18 @@ public:
 	Polymorphing polymorphing() const;
 	//! @readAcFn{QJsonSerializer::multiMapMode}
 	MultiMapMode multiMapMode() const;
+	//! @readAcFn{QJsonSerializer::dateTimeAsEpoch}
+	bool dateTimeAsEpoch() const;
+	//! @readAcFn{QJsonSerializer::geometryAsArray}
+	bool geometryAsArray() const;
+	//! @readAcFn{QJsonSerializer::columnarLists}
+	bool columnarLists() const;
+	//! @readAcFn{QJsonSerializer::objectReferences}
+	bool objectReferences() const;
+	//! @readAcFn{QJsonSerializer::attachmentThreshold}
+	int attachmentThreshold() const;
+	//! @readAcFn{QJsonSerializer::stringPoolSize}
+	int stringPoolSize() const;
 
 	//! Serializers a QVariant value to a QJsonValue
 	QJsonValue serialize(const QVariant &data) const;
@@ -152,6 +201,44 @@ public:
 	template <typename T>
 	QByteArray serializeTo(const T &data, QJsonDocument::JsonFormat format = QJsonDocument::Indented) const;
 
+	//! Serializers a QVariant value to a device, using the MessagePack format
+	void serializeToMsgPack(QIODevice *device, const QVariant &data) const;
+	//! Serializers a QVariant value to a byte array, using the MessagePack format
+	QByteArray serializeToMsgPack(const QVariant &data) const;
+	//! Serializers a QObject, Q_GADGET or a list of one of those to a device, using the MessagePack format
+	template <typename T>
+	void serializeToMsgPack(QIODevice *device, const T &data) const;
+	//! Serializers a QObject, Q_GADGET or a list of one of those to a byte array, using the MessagePack format
+	template <typename T>
+	QByteArray serializeToMsgPack(const T &data) const;
+
+	//! Serializers a QVariant value to a device, writing large byte arrays as raw attachments after the json
+	void serializeWithAttachments(QIODevice *device, const QVariant &data) const;
+	//! Serializers a QVariant value to a byte array, writing large byte arrays as raw attachments after the json
+	QByteArray serializeWithAttachments(const QVariant &data) const;
+	//! Serializers a QVariant value to json, passing large byte arrays to the given list instead of encoding them
+	QJsonValue serializeWithAttachments(const QVariant &data, QByteArrayList &attachments) const;
+	//! Serializers a QObject, Q_GADGET or a list of one of those to a device, writing large byte arrays as raw attachments after the json
+	template <typename T>
+	void serializeWithAttachments(QIODevice *device, const T &data) const;
+	//! Serializers a QObject, Q_GADGET or a list of one of those to a byte array, writing large byte arrays as raw attachments after the json
+	template <typename T>
+	QByteArray serializeWithAttachments(const T &data) const;
+
+	//! Serializers a QVariant value to a device, compressing the written json on the fly
+	void serializeToCompressed(QIODevice *device,
+							   const QVariant &data,
+							   Compression compression = Compression::Gzip,
+							   int level = -1,
+							   QJsonDocument::JsonFormat format = QJsonDocument::Compact) const;
+	//! Serializers a QObject, Q_GADGET or a list of one of those to a device, compressing the written json on the fly
+	template <typename T>
+	void serializeToCompressed(QIODevice *device,
+							   const T &data,
+							   Compression compression = Compression::Gzip,
+							   int level = -1,
+							   QJsonDocument::JsonFormat format = QJsonDocument::Compact) const;
+
 	//! Deserializes a QJsonValue to a QVariant value, based on the given type id
 	QVariant deserialize(const QJsonValue &json, int metaTypeId, QObject *parent = nullptr) const;
 	//! Deserializes data from a device to a QVariant value, based on the given type id
@@ -169,6 +256,129 @@ public:
 	template <typename T>
 	T deserializeFrom(const QByteArray &data, QObject *parent = nullptr) const;
 
+	//! Deserializes only the selected fields of a QJsonValue to a QVariant value, based on the given type id
+	QVariant deserialize(const QJsonValue &json, int metaTypeId, const QJsonFieldSelector &selector, QObject *parent = nullptr) const;
+	//! Deserializes only the selected fields of data from a device to a QVariant value, based on the given type id
+	QVariant deserializeFrom(QIODevice *device, int metaTypeId, const QJsonFieldSelector &selector, QObject *parent = nullptr) const;
+	//! Deserializes only the selected fields of data from a byte array to a QVariant value, based on the given type id
+	QVariant deserializeFrom(const QByteArray &data, int metaTypeId, const QJsonFieldSelector &selector, QObject *parent = nullptr) const;
+	//! Deserializes only the selected fields of a json to the given QObject type, Q_GADGET type or a list of one of those types
+	template <typename T>
+	T deserialize(const typename _qjsonserializer_helpertypes::json_type<T>::type &json, const QJsonFieldSelector &selector, QObject *parent = nullptr) const;
+	//! Deserializes only the selected fields of data from a device to the given QObject type, Q_GADGET type or a list of one of those types
+	template <typename T>
+	T deserializeFrom(QIODevice *device, const QJsonFieldSelector &selector, QObject *parent = nullptr) const;
+	//! Deserializes only the selected fields of data from a byte array to the given QObject type, Q_GADGET type or a list of one of those types
+	template <typename T>
+	T deserializeFrom(const QByteArray &data, const QJsonFieldSelector &selector, QObject *parent = nullptr) const;
+
+	//! Serializes only the selected fields of a QVariant value to a QJsonValue
+	QJsonValue serialize(const QVariant &data, const QJsonFieldSelector &selector) const;
+	//! Serializes only the selected fields of a QVariant value to a device
+	void serializeTo(QIODevice *device, const QVariant &data, const QJsonFieldSelector &selector, QJsonDocument::JsonFormat format = QJsonDocument::Indented) const;
+	//! Serializes only the selected fields of a QVariant value to a byte array
+	QByteArray serializeTo(const QVariant &data, const QJsonFieldSelector &selector, QJsonDocument::JsonFormat format = QJsonDocument::Indented) const;
+	//! Serializes only the selected fields of a QObject, Q_GADGET or a list of one of those to json
+	template <typename T>
+	typename _qjsonserializer_helpertypes::json_type<T>::type serialize(const T &data, const QJsonFieldSelector &selector) const;
+	//! Serializes only the selected fields of a QObject, Q_GADGET or a list of one of those to a device
+	template <typename T>
+	void serializeTo(QIODevice *device, const T &data, const QJsonFieldSelector &selector, QJsonDocument::JsonFormat format = QJsonDocument::Indented) const;
+	//! Serializes only the selected fields of a QObject, Q_GADGET or a list of one of those to a byte array
+	template <typename T>
+	QByteArray serializeTo(const T &data, const QJsonFieldSelector &selector, QJsonDocument::JsonFormat format = QJsonDocument::Indented) const;
+
+	//! Serializes a QVariant value to a QJsonValue, using the given options instead of the settings of the serializer
+	QJsonValue serialize(const QVariant &data, const QJsonSerializerOptions &options) const;
+	//! Serializes a QObject, Q_GADGET or a list of one of those to json, using the given options instead of the settings of the serializer
+	template <typename T>
+	typename _qjsonserializer_helpertypes::json_type<T>::type serialize(const T &data, const QJsonSerializerOptions &options) const;
+	//! Deserializes a QJsonValue to a QVariant value, based on the given type id, using the given options instead of the settings of the serializer
+	QVariant deserialize(const QJsonValue &json, int metaTypeId, const QJsonSerializerOptions &options, QObject *parent = nullptr) const;
+	//! Deserializes a json to the given QObject type, Q_GADGET type or a list of one of those types, using the given options instead of the settings of the serializer
+	template <typename T>
+	T deserialize(const typename _qjsonserializer_helpertypes::json_type<T>::type &json, const QJsonSerializerOptions &options, QObject *parent = nullptr) const;
+
+	//! Deserializes MessagePack data from a device to a QVariant value, based on the given type id
+	QVariant deserializeFromMsgPack(QIODevice *device, int metaTypeId, QObject *parent = nullptr) const;
+	//! Deserializes MessagePack data from a byte array to a QVariant value, based on the given type id
+	QVariant deserializeFromMsgPack(const QByteArray &data, int metaTypeId, QObject *parent = nullptr) const;
+	//! Deserializes MessagePack data from a device to the given QObject type, Q_GADGET type or a list of one of those types
+	template <typename T>
+	T deserializeFromMsgPack(QIODevice *device, QObject *parent = nullptr) const;
+	//! Deserializes MessagePack data from a byte array to the given QObject type, Q_GADGET type or a list of one of those types
+	template <typename T>
+	T deserializeFromMsgPack(const QByteArray &data, QObject *parent = nullptr) const;
+
+	//! Deserializes json with attachments from a device to a QVariant value, based on the given type id
+	QVariant deserializeWithAttachments(QIODevice *device, int metaTypeId, QObject *parent = nullptr) const;
+	//! Deserializes json with attachments from a byte array to a QVariant value, based on the given type id
+	QVariant deserializeWithAttachments(const QByteArray &data, int metaTypeId, QObject *parent = nullptr) const;
+	//! Deserializes a QJsonValue that references the given attachments to a QVariant value, based on the given type id
+	QVariant deserializeWithAttachments(const QJsonValue &json, int metaTypeId, const QByteArrayList &attachments, QObject *parent = nullptr) const;
+	//! Deserializes json with attachments from a device to the given QObject type, Q_GADGET type or a list of one of those types
+	template <typename T>
+	T deserializeWithAttachments(QIODevice *device, QObject *parent = nullptr) const;
+	//! Deserializes json with attachments from a byte array to the given QObject type, Q_GADGET type or a list of one of those types
+	template <typename T>
+	T deserializeWithAttachments(const QByteArray &data, QObject *parent = nullptr) const;
+
+	//! Deserializes compressed json data from a device to a QVariant value, based on the given type id
+	QVariant deserializeFromCompressed(QIODevice *device, int metaTypeId, QObject *parent = nullptr) const;
+	//! Deserializes compressed json data from a device to the given QObject type, Q_GADGET type or a list of one of those types
+	template <typename T>
+	T deserializeFromCompressed(QIODevice *device, QObject *parent = nullptr) const;
+
+	//! Creates a job that writes a QVariant value to a device in chunks, as fast as the device accepts them
+	QJsonWriteJob *createWriteJob(QIODevice *device, const QVariant &data, QObject *parent = nullptr) const;
+	//! Creates a job that writes a QObject, Q_GADGET or a list of one of those to a device in chunks, as fast as the device accepts them
+	template <typename T>
+	QJsonWriteJob *createWriteJob(QIODevice *device, const T &data, QObject *parent = nullptr) const;
+
+	//! Creates a pipeline that reads a stream of json records from a device and deserializes each to a QVariant value, based on the given type id
+	QJsonReadPipeline *createReadPipeline(QIODevice *device, int metaTypeId, QObject *parent = nullptr) const;
+
+	//! Serializes a QVariant value to a byte array on a thread pool
+	QFuture<QByteArray> serializeAsync(const QVariant &data,
+									   QJsonDocument::JsonFormat format = QJsonDocument::Compact,
+									   QThreadPool *threadPool = nullptr) const;
+	//! Serializes a QObject, Q_GADGET or a list of one of those to a byte array on a thread pool
+	template <typename T>
+	QFuture<QByteArray> serializeAsync(const T &data,
+									   QJsonDocument::JsonFormat format = QJsonDocument::Compact,
+									   QThreadPool *threadPool = nullptr) const;
+	//! Serializes a QVariant value to a device on a thread pool
+	QFuture<qint64> serializeAsync(const QVariant &data,
+								   QIODevice *device,
+								   QJsonDocument::JsonFormat format = QJsonDocument::Compact,
+								   QThreadPool *threadPool = nullptr) const;
+	//! Serializes a QObject, Q_GADGET or a list of one of those to a device on a thread pool
+	template <typename T>
+	QFuture<qint64> serializeAsync(const T &data,
+								   QIODevice *device,
+								   QJsonDocument::JsonFormat format = QJsonDocument::Compact,
+								   QThreadPool *threadPool = nullptr) const;
+	//! Deserializes data from a byte array to a QVariant value on a thread pool, based on the given type id
+	QFuture<QVariant> deserializeAsync(const QByteArray &data,
+									   int metaTypeId,
+									   QThread *targetThread = nullptr,
+									   QThreadPool *threadPool = nullptr) const;
+	//! Deserializes data from a device to a QVariant value on a thread pool, based on the given type id
+	QFuture<QVariant> deserializeAsync(QIODevice *device,
+									   int metaTypeId,
+									   QThread *targetThread = nullptr,
+									   QThreadPool *threadPool = nullptr) const;
+	//! Deserializes a json array from a byte array to a list of QVariant values, parsing and deserializing chunks of it in parallel
+	QVariantList deserializeParallel(const QByteArray &data,
+									 int elementTypeId,
+									 QObject *parent = nullptr,
+									 QThreadPool *threadPool = nullptr) const;
+	//! Deserializes a json array from a byte array to a list of QObjects or Q_GADGETs, parsing and deserializing chunks of it in parallel
+	template <typename T>
+	QList<T> deserializeParallel(const QByteArray &data,
+								 QObject *parent = nullptr,
+								 QThreadPool *threadPool = nullptr) const;
+
 	//! Globally registers a converter factory to provide converters for all QJsonSerializer instances
 	template <typename TConverter, int Priority = QJsonTypeConverter::Priority::Standard>
 	static void addJsonTypeConverterFactory();
@@ -183,6 +393,16 @@ public:
 	//! @private
 	QT_DEPRECATED void addJsonTypeConverter(QJsonTypeConverter *converter);
 
+	//! Returns a snapshot of all settings of the serializer
+	QJsonSerializerOptions options() const;
+	//! Replaces all settings of the serializer at once
+	void setOptions(const QJsonSerializerOptions &options);
+
+	//! Returns the tracer that observes the conversion of each property and subvalue
+	QSharedPointer<QJsonSerializerTracer> tracer() const;
+	//! Sets a tracer to observe the conversion of each property and subvalue, or nullptr to disable tracing
+	void setTracer(const QSharedPointer<QJsonSerializerTracer> &tracer);
+
 public Q_SLOTS:
 	//! @writeAcFn{QJsonSerializer::allowDefaultNull}
 	void setAllowDefaultNull(bool allowDefaultNull);
@@ -200,6 +420,18 @@ public Q_SLOTS:
 	void setPolymorphing(Polymorphing polymorphing);
 	//! @writeAcFn{QJsonSerializer::multiMapMode}
 	void setMultiMapMode(MultiMapMode multiMapMode);
+	//! @writeAcFn{QJsonSerializer::dateTimeAsEpoch}
+	void setDateTimeAsEpoch(bool dateTimeAsEpoch);
+	//! @writeAcFn{QJsonSerializer::geometryAsArray}
+	void setGeometryAsArray(bool geometryAsArray);
+	//! @writeAcFn{QJsonSerializer::columnarLists}
+	void setColumnarLists(bool columnarLists);
+	//! @writeAcFn{QJsonSerializer::objectReferences}
+	void setObjectReferences(bool objectReferences);
+	//! @writeAcFn{QJsonSerializer::attachmentThreshold}
+	void setAttachmentThreshold(int attachmentThreshold);
+	//! @writeAcFn{QJsonSerializer::stringPoolSize}
+	void setStringPoolSize(int stringPoolSize);
 
 Q_SIGNALS:
 	//! @notifyAcFn{QJsonSerializer::allowDefaultNull}
@@ -218,6 +450,18 @@ Q_SIGNALS:
 	void polymorphingChanged(Polymorphing polymorphing);
 	//! @notifyAcFn{QJsonSerializer::multiMapMode}
 	void multiMapModeChanged(MultiMapMode multiMapMode);
+	//! @notifyAcFn{QJsonSerializer::dateTimeAsEpoch}
+	void dateTimeAsEpochChanged(bool dateTimeAsEpoch);
+	//! @notifyAcFn{QJsonSerializer::geometryAsArray}
+	void geometryAsArrayChanged(bool geometryAsArray);
+	//! @notifyAcFn{QJsonSerializer::columnarLists}
+	void columnarListsChanged(bool columnarLists);
+	//! @notifyAcFn{QJsonSerializer::objectReferences}
+	void objectReferencesChanged(bool objectReferences);
+	//! @notifyAcFn{QJsonSerializer::attachmentThreshold}
+	void attachmentThresholdChanged(int attachmentThreshold);
+	//! @notifyAcFn{QJsonSerializer::stringPoolSize}
+	void stringPoolSizeChanged(int stringPoolSize);
 
 protected:
 	//protected implementation -> internal use for the type converters
@@ -229,21 +473,40 @@ protected:
 
 private:
 	friend class QJsonSerializerPrivate;
+	friend class QJsonValueProducer;
+	friend class QJsonColumnReader;
+	friend class QJsonColumnWriter;
+	friend class QJsonGeneratedConverter;
 	QScopedPointer<QJsonSerializerPrivate> d;
 
+	// the first ones enter the options of a call, the others are used for nested values within the call
 	QJsonValue serializeVariant(int propertyType, const QVariant &value) const;
+	QJsonValue serializeVariant(int propertyType, const QVariant &value, const QJsonOptionsContext &options) const;
 	QVariant deserializeVariant(int propertyType, const QJsonValue &value, QObject *parent) const;
+	QVariant deserializeVariant(int propertyType, const QJsonValue &value, QObject *parent, const QJsonOptionsContext &options) const;
+	QVariant deserializeJson(int propertyType, const QJsonValue &value, QObject *parent, const QJsonTypeConverter *converter, const QJsonOptionsContext &options) const;
 
 	QJsonValue serializeValue(int propertyType, const QVariant &value) const;
 	QVariant deserializeValue(int propertyType, const QJsonValue &value) const;
 
-	QJsonValue serializeEnum(const QMetaEnum &metaEnum, const QVariant &value) const;
+	QJsonValue serializeEnum(const QMetaEnum &metaEnum, const QVariant &value, const QJsonOptionsContext &options) const;
 	QVariant deserializeEnum(const QMetaEnum &metaEnum, const QJsonValue &value) const;
 
 	void writeToDevice(const QJsonValue &data, QIODevice *device, QJsonDocument::JsonFormat format) const;
 	QJsonValue readFromDevice(QIODevice *device) const;
+	qint64 writeStream(QIODevice *device, const QVariant &data, QJsonDocument::JsonFormat format) const;
+	QVariant readStream(QIODevice *device, int metaTypeId, QThread *targetThread) const;
+	QVariantList deserializeChunk(const QJsonArrayIndex &index, int first, int last, int elementTypeId) const;
 
 	QJsonValue serializeImpl(const QVariant &data) const;
+
+	// direct calls of QJsonTypedConverters, without a QVariant - the callbacks return false if the converter for the type is not typed,
+	// in which case the value is converted to or from a QVariant, within the same call
+	using TypedSerializer = bool(*)(const QJsonTypeConverter *converter, const void *value, const SerializationHelper *helper, QJsonValue &json);
+	using TypedDeserializer = bool(*)(const QJsonTypeConverter *converter, const QJsonValue &json, QObject *parent, const SerializationHelper *helper, void *value);
+	using VariantFactory = QVariant(*)(const void *value);
+	QJsonValue serializeTyped(int propertyType, const void *value, TypedSerializer serializer, VariantFactory toVariant) const;
+	bool deserializeTyped(int propertyType, const QJsonValue &json, QObject *parent, TypedDeserializer deserializer, void *value, QVariant &variant) const;
 	QT_DEPRECATED void serializeToImpl(QIODevice *device, const QVariant &data) const; //MAJOR remove
 	void serializeToImpl(QIODevice *device, const QVariant &data, QJsonDocument::JsonFormat format) const;
 	QT_DEPRECATED QByteArray serializeToImpl(const QVariant &data) const; //MAJOR remove
@@ -422,11 +685,31 @@ bool QJsonSerializer::registerTupleConverters(const char *originalTypeName)
 			QMetaType::registerConverter<QVariantList, std::tuple<TArgs...>>(&_qjsonserializer_helpertypes::listToTpl<TArgs...>);
 }
 
+template<typename T>
+bool QJsonSerializer::registerLazyConverters()
+{
+	return QMetaType::registerConverter<QJsonLazy<T>, QJsonLazyBase>([](const QJsonLazy<T> &lazy) -> QJsonLazyBase {
+		return lazy;
+	}) & QMetaType::registerConverter<QJsonLazyBase, QJsonLazy<T>>([](const QJsonLazyBase &lazy) -> QJsonLazy<T> {
+		return QJsonLazy<T>{lazy};
+	});
+}
+
 template<typename T>
 typename _qjsonserializer_helpertypes::json_type<T>::type QJsonSerializer::serialize(const T &data) const
 {
 	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be serialized");
-	return _qjsonserializer_helpertypes::json_type<T>::convert(serializeImpl(_qjsonserializer_helpertypes::variant_helper<T>::toVariant(data)));
+	const auto typedSerializer = [](const QJsonTypeConverter *converter, const void *value, const SerializationHelper *helper, QJsonValue &json) {
+		const auto typed = dynamic_cast<const QJsonTypedConverterBase<T>*>(converter);
+		if(!typed)
+			return false;
+		json = typed->serialize(*static_cast<const T*>(value), helper);
+		return true;
+	};
+	const auto variantFactory = [](const void *value) {
+		return _qjsonserializer_helpertypes::variant_helper<T>::toVariant(*static_cast<const T*>(value));
+	};
+	return _qjsonserializer_helpertypes::json_type<T>::convert(serializeTyped(qMetaTypeId<T>(), &data, typedSerializer, variantFactory));
 }
 
 template<typename T>
@@ -447,7 +730,18 @@ template<typename T>
 T QJsonSerializer::deserialize(const typename _qjsonserializer_helpertypes::json_type<T>::type &json, QObject *parent) const
 {
 	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be deserialized");
-	return _qjsonserializer_helpertypes::variant_helper<T>::fromVariant(deserialize(json, qMetaTypeId<T>(), parent));
+	const auto typedDeserializer = [](const QJsonTypeConverter *converter, const QJsonValue &json, QObject *parent, const SerializationHelper *helper, void *value) {
+		const auto typed = dynamic_cast<const QJsonTypedConverterBase<T>*>(converter);
+		if(!typed)
+			return false;
+		*static_cast<T*>(value) = typed->deserialize(json, parent, helper);
+		return true;
+	};
+	T value{};
+	QVariant variant;
+	if(deserializeTyped(qMetaTypeId<T>(), json, parent, typedDeserializer, &value, variant))
+		return value;
+	return _qjsonserializer_helpertypes::variant_helper<T>::fromVariant(variant);
 }
 
 template<typename T>
@@ -464,6 +758,165 @@ T QJsonSerializer::deserializeFrom(const QByteArray &data, QObject *parent) cons
 	return _qjsonserializer_helpertypes::variant_helper<T>::fromVariant(deserializeFrom(data, qMetaTypeId<T>(), parent));
 }
 
+template<typename T>
+T QJsonSerializer::deserialize(const typename _qjsonserializer_helpertypes::json_type<T>::type &json, const QJsonFieldSelector &selector, QObject *parent) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be deserialized");
+	return _qjsonserializer_helpertypes::variant_helper<T>::fromVariant(deserialize(json, qMetaTypeId<T>(), selector, parent));
+}
+
+template<typename T>
+typename _qjsonserializer_helpertypes::json_type<T>::type QJsonSerializer::serialize(const T &data, const QJsonFieldSelector &selector) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be serialized");
+	return _qjsonserializer_helpertypes::json_type<T>::convert(serialize(_qjsonserializer_helpertypes::variant_helper<T>::toVariant(data), selector));
+}
+
+template<typename T>
+void QJsonSerializer::serializeTo(QIODevice *device, const T &data, const QJsonFieldSelector &selector, QJsonDocument::JsonFormat format) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be serialized");
+	serializeTo(device, _qjsonserializer_helpertypes::variant_helper<T>::toVariant(data), selector, format);
+}
+
+template<typename T>
+QByteArray QJsonSerializer::serializeTo(const T &data, const QJsonFieldSelector &selector, QJsonDocument::JsonFormat format) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be serialized");
+	return serializeTo(_qjsonserializer_helpertypes::variant_helper<T>::toVariant(data), selector, format);
+}
+
+template<typename T>
+typename _qjsonserializer_helpertypes::json_type<T>::type QJsonSerializer::serialize(const T &data, const QJsonSerializerOptions &options) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be serialized");
+	return _qjsonserializer_helpertypes::json_type<T>::convert(serialize(_qjsonserializer_helpertypes::variant_helper<T>::toVariant(data), options));
+}
+
+template<typename T>
+T QJsonSerializer::deserialize(const typename _qjsonserializer_helpertypes::json_type<T>::type &json, const QJsonSerializerOptions &options, QObject *parent) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be deserialized");
+	return _qjsonserializer_helpertypes::variant_helper<T>::fromVariant(deserialize(json, qMetaTypeId<T>(), options, parent));
+}
+
+template<typename T>
+T QJsonSerializer::deserializeFrom(QIODevice *device, const QJsonFieldSelector &selector, QObject *parent) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be deserialized");
+	return _qjsonserializer_helpertypes::variant_helper<T>::fromVariant(deserializeFrom(device, qMetaTypeId<T>(), selector, parent));
+}
+
+template<typename T>
+T QJsonSerializer::deserializeFrom(const QByteArray &data, const QJsonFieldSelector &selector, QObject *parent) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be deserialized");
+	return _qjsonserializer_helpertypes::variant_helper<T>::fromVariant(deserializeFrom(data, qMetaTypeId<T>(), selector, parent));
+}
+
+template<typename T>
+void QJsonSerializer::serializeToMsgPack(QIODevice *device, const T &data) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be serialized");
+	serializeToMsgPack(device, _qjsonserializer_helpertypes::variant_helper<T>::toVariant(data));
+}
+
+template<typename T>
+QByteArray QJsonSerializer::serializeToMsgPack(const T &data) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be serialized");
+	return serializeToMsgPack(_qjsonserializer_helpertypes::variant_helper<T>::toVariant(data));
+}
+
+template<typename T>
+void QJsonSerializer::serializeWithAttachments(QIODevice *device, const T &data) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be serialized");
+	serializeWithAttachments(device, _qjsonserializer_helpertypes::variant_helper<T>::toVariant(data));
+}
+
+template<typename T>
+QByteArray QJsonSerializer::serializeWithAttachments(const T &data) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be serialized");
+	return serializeWithAttachments(_qjsonserializer_helpertypes::variant_helper<T>::toVariant(data));
+}
+
+template<typename T>
+void QJsonSerializer::serializeToCompressed(QIODevice *device, const T &data, Compression compression, int level, QJsonDocument::JsonFormat format) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be serialized");
+	serializeToCompressed(device, _qjsonserializer_helpertypes::variant_helper<T>::toVariant(data), compression, level, format);
+}
+
+template<typename T>
+T QJsonSerializer::deserializeFromMsgPack(QIODevice *device, QObject *parent) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be deserialized");
+	return _qjsonserializer_helpertypes::variant_helper<T>::fromVariant(deserializeFromMsgPack(device, qMetaTypeId<T>(), parent));
+}
+
+template<typename T>
+T QJsonSerializer::deserializeFromMsgPack(const QByteArray &data, QObject *parent) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be deserialized");
+	return _qjsonserializer_helpertypes::variant_helper<T>::fromVariant(deserializeFromMsgPack(data, qMetaTypeId<T>(), parent));
+}
+
+template<typename T>
+T QJsonSerializer::deserializeWithAttachments(QIODevice *device, QObject *parent) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be deserialized");
+	return _qjsonserializer_helpertypes::variant_helper<T>::fromVariant(deserializeWithAttachments(device, qMetaTypeId<T>(), parent));
+}
+
+template<typename T>
+T QJsonSerializer::deserializeWithAttachments(const QByteArray &data, QObject *parent) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be deserialized");
+	return _qjsonserializer_helpertypes::variant_helper<T>::fromVariant(deserializeWithAttachments(data, qMetaTypeId<T>(), parent));
+}
+
+template<typename T>
+QJsonWriteJob *QJsonSerializer::createWriteJob(QIODevice *device, const T &data, QObject *parent) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be serialized");
+	return createWriteJob(device, _qjsonserializer_helpertypes::variant_helper<T>::toVariant(data), parent);
+}
+
+template<typename T>
+QFuture<QByteArray> QJsonSerializer::serializeAsync(const T &data, QJsonDocument::JsonFormat format, QThreadPool *threadPool) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be serialized");
+	return serializeAsync(_qjsonserializer_helpertypes::variant_helper<T>::toVariant(data), format, threadPool);
+}
+
+template<typename T>
+QFuture<qint64> QJsonSerializer::serializeAsync(const T &data, QIODevice *device, QJsonDocument::JsonFormat format, QThreadPool *threadPool) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be serialized");
+	return serializeAsync(_qjsonserializer_helpertypes::variant_helper<T>::toVariant(data), device, format, threadPool);
+}
+
+template<typename T>
+QList<T> QJsonSerializer::deserializeParallel(const QByteArray &data, QObject *parent, QThreadPool *threadPool) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be deserialized");
+	const auto elements = deserializeParallel(data, qMetaTypeId<T>(), parent, threadPool);
+	QList<T> result;
+	result.reserve(elements.size());
+	for(const auto &element : elements)
+		result.append(_qjsonserializer_helpertypes::variant_helper<T>::fromVariant(element));
+	return result;
+}
+
+template<typename T>
+T QJsonSerializer::deserializeFromCompressed(QIODevice *device, QObject *parent) const
+{
+	static_assert(_qjsonserializer_helpertypes::is_serializable<T>::value, "T cannot be deserialized");
+	return _qjsonserializer_helpertypes::variant_helper<T>::fromVariant(deserializeFromCompressed(device, qMetaTypeId<T>(), parent));
+}
+
 template<typename TConverter, int Priority>
 void QJsonSerializer::addJsonTypeConverterFactory()
 {
@@ -3,9 +3,14 @@
 
 #include "qtjsonserializer_global.h"
 #include "qjsonserializer.h"
+#include "qjsonserializeroptions.h"
 
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QHash>
+#include <QtCore/QPair>
+
+class QJsonOptionsContext;
+class QJsonAsyncGuard;
 
 class Q_JSONSERIALIZER_EXPORT QJsonSerializerPrivate
 {
@@ -23,21 +28,47 @@ public:
 	static QReadWriteLock factoryLock;
 	static QList<QSharedPointer<QJsonTypeConverterFactory>> typeConverterFactories;
 
-	bool allowNull = false;
-	bool keepObjectName = false;
-	bool enumAsString = false;
-	bool validateBase64 = true;
-	bool useBcp47Locale = true;
-	QJsonSerializer::ValidationFlags validationFlags = QJsonSerializer::StandardValidation;
-	QJsonSerializer::Polymorphing polymorphing = QJsonSerializer::Enabled;
-	QJsonSerializer::MultiMapMode multiMapMode = QJsonSerializer::MultiMapMode::Map; //TODO which one is the better default?
+	// (propertyType, jsonType) -> converter, with QJsonValue::Undefined as json type for serialization
+	using ConverterCacheKey = QPair<int, int>;
+	using ConverterCache = QHash<ConverterCacheKey, QSharedPointer<QJsonTypeConverter>>;
+
+	static QReadWriteLock sharedConverterLock;
+	static QHash<const QJsonTypeConverterFactory*, QSharedPointer<QJsonTypeConverter>> sharedConverters;
+	static ConverterCache sharedConverterCache;
+
+	static void clearSharedConverterCache();
+	// deletes the QObjects of the list that have no parent, i.e. the results of a failed call
+	static void deleteOrphans(const QVariantList &list);
+
+	QJsonSerializerOptions snapshot() const;
+
+	// the running call of the serializer behind a helper passed to a converter - nullptr for other helpers
+	static const QJsonOptionsContext *context(const QJsonTypeConverter::SerializationHelper *helper);
+	// the options the built-in converters use - the ones of the running call, or the properties of any other helper
+	static QJsonSerializerOptions callOptions(const QJsonTypeConverter::SerializationHelper *helper);
+
+	// copy on write - calls keep the snapshot they took, even if the setters change the options meanwhile
+	mutable QReadWriteLock optionsLock;
+	QJsonSerializerOptions options;
+	// not a property, but guarded by the options lock as well - calls keep the tracer they started with
+	QSharedPointer<QJsonSerializerTracer> tracer;
+
+	// shared with the asynchronous jobs, which the serializer waits for when it is destroyed
+	QSharedPointer<QJsonAsyncGuard> asyncGuard;
 
 	QReadWriteLock typeConverterLock{};
 	QList<QSharedPointer<QJsonTypeConverter>> typeConverters;
-	QHash<int, QSharedPointer<QJsonTypeConverter>> typeConverterSerCache;
-	QHash<int, QSharedPointer<QJsonTypeConverter>> typeConverterDeserCache;
+	ConverterCache typeConverterCache;
 
 	QSharedPointer<QJsonTypeConverter> findConverter(int propertyType, QJsonValue::Type valueType = QJsonValue::Undefined);
+
+private:
+	static bool converterMatches(const QSharedPointer<QJsonTypeConverter> &converter, int propertyType, QJsonValue::Type valueType);
+	static QSharedPointer<QJsonTypeConverter> findSharedConverter(int propertyType, QJsonValue::Type valueType);
+
+	// direct conversions of scalar types, without QVariant::convert or QJsonValue::fromVariant
+	static bool serializeScalar(const QVariant &value, QJsonValue &json);
+	static bool deserializeScalar(int propertyType, const QJsonValue &json, QVariant &value);
 };
 
 #endif // QJSONSERIALIZER_P_H
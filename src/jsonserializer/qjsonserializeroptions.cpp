@@ -0,0 +1,302 @@
+#include "qjsonserializeroptions.h"
+#include "qjsonserializeroptions_p.h"
+#include "qjsonserializer_p.h"
+
+#include <QtCore/QHash>
+
+QJsonSerializerOptions::QJsonSerializerOptions() :
+	d{new QJsonSerializerOptionsData{}}
+{}
+
+QJsonSerializerOptions::QJsonSerializerOptions(const QJsonSerializerOptions &other) = default;
+
+QJsonSerializerOptions::QJsonSerializerOptions(QJsonSerializerOptions &&other) noexcept = default;
+
+QJsonSerializerOptions::~QJsonSerializerOptions() = default;
+
+QJsonSerializerOptions &QJsonSerializerOptions::operator=(const QJsonSerializerOptions &other) = default;
+
+QJsonSerializerOptions &QJsonSerializerOptions::operator=(QJsonSerializerOptions &&other) noexcept = default;
+
+bool QJsonSerializerOptions::operator==(const QJsonSerializerOptions &other) const
+{
+	return d == other.d ||
+			(d->allowDefaultNull == other.d->allowDefaultNull &&
+			 d->keepObjectName == other.d->keepObjectName &&
+			 d->enumAsString == other.d->enumAsString &&
+			 d->validateBase64 == other.d->validateBase64 &&
+			 d->useBcp47Locale == other.d->useBcp47Locale &&
+			 d->validationFlags == other.d->validationFlags &&
+			 d->polymorphing == other.d->polymorphing &&
+			 d->multiMapMode == other.d->multiMapMode &&
+			 d->dateTimeAsEpoch == other.d->dateTimeAsEpoch &&
+			 d->geometryAsArray == other.d->geometryAsArray &&
+			 d->columnarLists == other.d->columnarLists &&
+			 d->objectReferences == other.d->objectReferences &&
+			 d->attachmentThreshold == other.d->attachmentThreshold &&
+			 d->stringPoolSize == other.d->stringPoolSize);
+}
+
+bool QJsonSerializerOptions::operator!=(const QJsonSerializerOptions &other) const
+{
+	return !operator==(other);
+}
+
+bool QJsonSerializerOptions::allowDefaultNull() const
+{
+	return d->allowDefaultNull;
+}
+
+bool QJsonSerializerOptions::keepObjectName() const
+{
+	return d->keepObjectName;
+}
+
+bool QJsonSerializerOptions::enumAsString() const
+{
+	return d->enumAsString;
+}
+
+bool QJsonSerializerOptions::validateBase64() const
+{
+	return d->validateBase64;
+}
+
+bool QJsonSerializerOptions::useBcp47Locale() const
+{
+	return d->useBcp47Locale;
+}
+
+QJsonSerializer::ValidationFlags QJsonSerializerOptions::validationFlags() const
+{
+	return d->validationFlags;
+}
+
+QJsonSerializer::Polymorphing QJsonSerializerOptions::polymorphing() const
+{
+	return d->polymorphing;
+}
+
+QJsonSerializer::MultiMapMode QJsonSerializerOptions::multiMapMode() const
+{
+	return d->multiMapMode;
+}
+
+bool QJsonSerializerOptions::dateTimeAsEpoch() const
+{
+	return d->dateTimeAsEpoch;
+}
+
+bool QJsonSerializerOptions::geometryAsArray() const
+{
+	return d->geometryAsArray;
+}
+
+bool QJsonSerializerOptions::columnarLists() const
+{
+	return d->columnarLists;
+}
+
+bool QJsonSerializerOptions::objectReferences() const
+{
+	return d->objectReferences;
+}
+
+int QJsonSerializerOptions::attachmentThreshold() const
+{
+	return d->attachmentThreshold;
+}
+
+int QJsonSerializerOptions::stringPoolSize() const
+{
+	return d->stringPoolSize;
+}
+
+QJsonSerializerOptions &QJsonSerializerOptions::setAllowDefaultNull(bool allowDefaultNull)
+{
+	d->allowDefaultNull = allowDefaultNull;
+	return *this;
+}
+
+QJsonSerializerOptions &QJsonSerializerOptions::setKeepObjectName(bool keepObjectName)
+{
+	d->keepObjectName = keepObjectName;
+	return *this;
+}
+
+QJsonSerializerOptions &QJsonSerializerOptions::setEnumAsString(bool enumAsString)
+{
+	d->enumAsString = enumAsString;
+	return *this;
+}
+
+QJsonSerializerOptions &QJsonSerializerOptions::setValidateBase64(bool validateBase64)
+{
+	d->validateBase64 = validateBase64;
+	return *this;
+}
+
+QJsonSerializerOptions &QJsonSerializerOptions::setUseBcp47Locale(bool useBcp47Locale)
+{
+	d->useBcp47Locale = useBcp47Locale;
+	return *this;
+}
+
+QJsonSerializerOptions &QJsonSerializerOptions::setValidationFlags(QJsonSerializer::ValidationFlags validationFlags)
+{
+	d->validationFlags = validationFlags;
+	return *this;
+}
+
+QJsonSerializerOptions &QJsonSerializerOptions::setPolymorphing(QJsonSerializer::Polymorphing polymorphing)
+{
+	d->polymorphing = polymorphing;
+	return *this;
+}
+
+QJsonSerializerOptions &QJsonSerializerOptions::setMultiMapMode(QJsonSerializer::MultiMapMode multiMapMode)
+{
+	d->multiMapMode = multiMapMode;
+	return *this;
+}
+
+QJsonSerializerOptions &QJsonSerializerOptions::setDateTimeAsEpoch(bool dateTimeAsEpoch)
+{
+	d->dateTimeAsEpoch = dateTimeAsEpoch;
+	return *this;
+}
+
+QJsonSerializerOptions &QJsonSerializerOptions::setGeometryAsArray(bool geometryAsArray)
+{
+	d->geometryAsArray = geometryAsArray;
+	return *this;
+}
+
+QJsonSerializerOptions &QJsonSerializerOptions::setColumnarLists(bool columnarLists)
+{
+	d->columnarLists = columnarLists;
+	return *this;
+}
+
+QJsonSerializerOptions &QJsonSerializerOptions::setObjectReferences(bool objectReferences)
+{
+	d->objectReferences = objectReferences;
+	return *this;
+}
+
+QJsonSerializerOptions &QJsonSerializerOptions::setAttachmentThreshold(int attachmentThreshold)
+{
+	d->attachmentThreshold = attachmentThreshold;
+	return *this;
+}
+
+QJsonSerializerOptions &QJsonSerializerOptions::setStringPoolSize(int stringPoolSize)
+{
+	d->stringPoolSize = stringPoolSize;
+	return *this;
+}
+
+
+
+QThreadStorage<QJsonOptionsContext::ContextRef> QJsonOptionsContext::contextStore;
+
+QJsonOptionsContext::QJsonOptionsContext(const QJsonSerializer *serializer, const QJsonSerializerPrivate *d) :
+	_serializer{serializer}
+{
+	// converters may use other serializers for nested values, so the nearest context of this one is joined
+	const auto context = find(_serializer);
+	if(context) {
+		_options = context->_options;
+		_tracer = context->_tracer;
+		_joined = context->_joined ? context->_joined : context;
+		return;
+	}
+
+	{
+		QReadLocker lock{&d->optionsLock};
+		_snapshot = d->options;
+		_tracerRef = d->tracer;
+	}
+	_options = &_snapshot;
+	_tracer = _tracerRef.data();
+	activate();
+}
+
+QJsonOptionsContext::QJsonOptionsContext(const QJsonSerializer *serializer, const QJsonSerializerOptions &options) :
+	_serializer{serializer},
+	_snapshot{options},
+	_tracerRef{serializer->tracer()}
+{
+	_options = &_snapshot;
+	_tracer = _tracerRef.data();
+	activate();
+}
+
+QJsonOptionsContext::QJsonOptionsContext(const QJsonSerializer *serializer, const QJsonSerializerOptions &options, const QSharedPointer<QJsonSerializerTracer> &tracer) :
+	_serializer{serializer},
+	_snapshot{options},
+	_tracerRef{tracer}
+{
+	_options = &_snapshot;
+	_tracer = _tracerRef.data();
+	activate();
+}
+
+QJsonOptionsContext::~QJsonOptionsContext()
+{
+	if(_active)
+		contextStore.localData().context = _previous;
+}
+
+QSharedPointer<QJsonSerializerTracer> QJsonOptionsContext::tracerRef() const
+{
+	return _joined ? _joined->_tracerRef : _tracerRef;
+}
+
+QVariant QJsonOptionsContext::property(const QJsonSerializerOptions &options, const char *name)
+{
+	using Getter = QVariant(*)(const QJsonSerializerOptions &);
+	static const QHash<QByteArray, Getter> getters {
+		{"allowDefaultNull", [](const QJsonSerializerOptions &options) { return QVariant{options.allowDefaultNull()}; }},
+		{"keepObjectName", [](const QJsonSerializerOptions &options) { return QVariant{options.keepObjectName()}; }},
+		{"enumAsString", [](const QJsonSerializerOptions &options) { return QVariant{options.enumAsString()}; }},
+		{"validateBase64", [](const QJsonSerializerOptions &options) { return QVariant{options.validateBase64()}; }},
+		{"useBcp47Locale", [](const QJsonSerializerOptions &options) { return QVariant{options.useBcp47Locale()}; }},
+		{"validationFlags", [](const QJsonSerializerOptions &options) { return QVariant::fromValue(options.validationFlags()); }},
+		{"polymorphing", [](const QJsonSerializerOptions &options) { return QVariant::fromValue(options.polymorphing()); }},
+		{"multiMapMode", [](const QJsonSerializerOptions &options) { return QVariant::fromValue(options.multiMapMode()); }},
+		{"dateTimeAsEpoch", [](const QJsonSerializerOptions &options) { return QVariant{options.dateTimeAsEpoch()}; }},
+		{"geometryAsArray", [](const QJsonSerializerOptions &options) { return QVariant{options.geometryAsArray()}; }},
+		{"columnarLists", [](const QJsonSerializerOptions &options) { return QVariant{options.columnarLists()}; }},
+		{"objectReferences", [](const QJsonSerializerOptions &options) { return QVariant{options.objectReferences()}; }},
+		{"attachmentThreshold", [](const QJsonSerializerOptions &options) { return QVariant{options.attachmentThreshold()}; }},
+		{"stringPoolSize", [](const QJsonSerializerOptions &options) { return QVariant{options.stringPoolSize()}; }},
+	};
+
+	const auto getter = getters.value(QByteArray::fromRawData(name, static_cast<int>(qstrlen(name))));
+	return getter ? getter(options) : QVariant{};
+}
+
+const QJsonOptionsContext *QJsonOptionsContext::current()
+{
+	return contextStore.hasLocalData() ?
+				contextStore.localData().context :
+				nullptr;
+}
+
+void QJsonOptionsContext::activate()
+{
+	auto &ref = contextStore.localData();
+	_previous = ref.context;
+	ref.context = this;
+	_active = true;
+}
+
+const QJsonOptionsContext *QJsonOptionsContext::findOuter(const QJsonOptionsContext *context, const QJsonSerializer *serializer)
+{
+	for(; context; context = context->_previous) {
+		if(context->_serializer == serializer)
+			return context;
+	}
+	return nullptr;
+}
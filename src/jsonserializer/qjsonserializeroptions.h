@@ -0,0 +1,97 @@
+#ifndef QJSONSERIALIZEROPTIONS_H
+#define QJSONSERIALIZEROPTIONS_H
+
+#include "QtJsonSerializer/qtjsonserializer_global.h"
+#include "QtJsonSerializer/qjsonserializer.h"
+
+#include <QtCore/qshareddata.h>
+
+class QJsonSerializerOptionsData;
+//! A snapshot of all the settings of a QJsonSerializer, that can be passed to a single de/serialization call
+class Q_JSONSERIALIZER_EXPORT QJsonSerializerOptions
+{
+public:
+	//! Default constructor, with the defaults of a new QJsonSerializer
+	QJsonSerializerOptions();
+	//! Copy constructor
+	QJsonSerializerOptions(const QJsonSerializerOptions &other);
+	//! Move constructor
+	QJsonSerializerOptions(QJsonSerializerOptions &&other) noexcept;
+	~QJsonSerializerOptions();
+
+	//! Copy assignment operator
+	QJsonSerializerOptions &operator=(const QJsonSerializerOptions &other);
+	//! Move assignment operator
+	QJsonSerializerOptions &operator=(QJsonSerializerOptions &&other) noexcept;
+
+	//! Equality operator
+	bool operator==(const QJsonSerializerOptions &other) const;
+	//! Inequality operator
+	bool operator!=(const QJsonSerializerOptions &other) const;
+
+	//! @copybrief QJsonSerializer::allowDefaultNull
+	bool allowDefaultNull() const;
+	//! @copybrief QJsonSerializer::keepObjectName
+	bool keepObjectName() const;
+	//! @copybrief QJsonSerializer::enumAsString
+	bool enumAsString() const;
+	//! @copybrief QJsonSerializer::validateBase64
+	bool validateBase64() const;
+	//! @copybrief QJsonSerializer::useBcp47Locale
+	bool useBcp47Locale() const;
+	//! @copybrief QJsonSerializer::validationFlags
+	QJsonSerializer::ValidationFlags validationFlags() const;
+	//! @copybrief QJsonSerializer::polymorphing
+	QJsonSerializer::Polymorphing polymorphing() const;
+	//! @copybrief QJsonSerializer::multiMapMode
+	QJsonSerializer::MultiMapMode multiMapMode() const;
+	//! @copybrief QJsonSerializer::dateTimeAsEpoch
+	bool dateTimeAsEpoch() const;
+	//! @copybrief QJsonSerializer::geometryAsArray
+	bool geometryAsArray() const;
+	//! @copybrief QJsonSerializer::columnarLists
+	bool columnarLists() const;
+	//! @copybrief QJsonSerializer::objectReferences
+	bool objectReferences() const;
+	//! @copybrief QJsonSerializer::attachmentThreshold
+	int attachmentThreshold() const;
+	//! @copybrief QJsonSerializer::stringPoolSize
+	int stringPoolSize() const;
+
+	//! @copybrief QJsonSerializer::allowDefaultNull
+	QJsonSerializerOptions &setAllowDefaultNull(bool allowDefaultNull);
+	//! @copybrief QJsonSerializer::keepObjectName
+	QJsonSerializerOptions &setKeepObjectName(bool keepObjectName);
+	//! @copybrief QJsonSerializer::enumAsString
+	QJsonSerializerOptions &setEnumAsString(bool enumAsString);
+	//! @copybrief QJsonSerializer::validateBase64
+	QJsonSerializerOptions &setValidateBase64(bool validateBase64);
+	//! @copybrief QJsonSerializer::useBcp47Locale
+	QJsonSerializerOptions &setUseBcp47Locale(bool useBcp47Locale);
+	//! @copybrief QJsonSerializer::validationFlags
+	QJsonSerializerOptions &setValidationFlags(QJsonSerializer::ValidationFlags validationFlags);
+	//! @copybrief QJsonSerializer::polymorphing
+	QJsonSerializerOptions &setPolymorphing(QJsonSerializer::Polymorphing polymorphing);
+	//! @copybrief QJsonSerializer::multiMapMode
+	QJsonSerializerOptions &setMultiMapMode(QJsonSerializer::MultiMapMode multiMapMode);
+	//! @copybrief QJsonSerializer::dateTimeAsEpoch
+	QJsonSerializerOptions &setDateTimeAsEpoch(bool dateTimeAsEpoch);
+	//! @copybrief QJsonSerializer::geometryAsArray
+	QJsonSerializerOptions &setGeometryAsArray(bool geometryAsArray);
+	//! @copybrief QJsonSerializer::columnarLists
+	QJsonSerializerOptions &setColumnarLists(bool columnarLists);
+	//! @copybrief QJsonSerializer::objectReferences
+	QJsonSerializerOptions &setObjectReferences(bool objectReferences);
+	//! @copybrief QJsonSerializer::attachmentThreshold
+	QJsonSerializerOptions &setAttachmentThreshold(int attachmentThreshold);
+	//! @copybrief QJsonSerializer::stringPoolSize
+	QJsonSerializerOptions &setStringPoolSize(int stringPoolSize);
+
+private:
+	friend class QJsonOptionsContext;
+	QSharedDataPointer<QJsonSerializerOptionsData> d;
+};
+
+Q_DECLARE_METATYPE(QJsonSerializerOptions)
+
+#endif // QJSONSERIALIZEROPTIONS_H
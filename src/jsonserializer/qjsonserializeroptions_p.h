@@ -0,0 +1,101 @@
+#ifndef QJSONSERIALIZEROPTIONS_P_H
+#define QJSONSERIALIZEROPTIONS_P_H
+
+#include "qtjsonserializer_global.h"
+#include "qjsonserializeroptions.h"
+#include "qjsonserializertracer.h"
+
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThreadStorage>
+
+class Q_JSONSERIALIZER_EXPORT QJsonSerializerOptionsData : public QSharedData
+{
+public:
+	bool allowDefaultNull = false;
+	bool keepObjectName = false;
+	bool enumAsString = false;
+	bool validateBase64 = true;
+	bool useBcp47Locale = true;
+	QJsonSerializer::ValidationFlags validationFlags = QJsonSerializer::StandardValidation;
+	QJsonSerializer::Polymorphing polymorphing = QJsonSerializer::Enabled;
+	QJsonSerializer::MultiMapMode multiMapMode = QJsonSerializer::MultiMapMode::Map;
+	bool dateTimeAsEpoch = false;
+	bool geometryAsArray = false;
+	bool columnarLists = false;
+	bool objectReferences = false;
+	int attachmentThreshold = 1024;
+	int stringPoolSize = 0;
+};
+
+// The options of a running de/serialization call. Nested calls of the same serializer on the same thread
+// join the context of the outer call, so all values of one call see the same options, even if the
+// serializer is reconfigured concurrently
+class Q_JSONSERIALIZER_EXPORT QJsonOptionsContext
+{
+	Q_DISABLE_COPY(QJsonOptionsContext)
+
+public:
+	// joins the context of an outer call, or takes a snapshot of the current options of the serializer
+	QJsonOptionsContext(const QJsonSerializer *serializer, const QJsonSerializerPrivate *d);
+	// uses the given options for this call and all nested calls
+	QJsonOptionsContext(const QJsonSerializer *serializer, const QJsonSerializerOptions &options);
+	// same, but with the given tracer instead of the current one - for calls that are continued later
+	QJsonOptionsContext(const QJsonSerializer *serializer, const QJsonSerializerOptions &options, const QSharedPointer<QJsonSerializerTracer> &tracer);
+	~QJsonOptionsContext();
+
+	inline const QJsonSerializerOptions &options() const {
+		return *_options;
+	}
+	inline const QJsonSerializerOptionsData *operator->() const {
+		return _options->d.constData();
+	}
+	// the tracer that was set when the call started - kept alive until the call has finished
+	inline QJsonSerializerTracer *tracer() const {
+		return _tracer;
+	}
+	// the same tracer, as reference that keeps it alive beyond the call
+	QSharedPointer<QJsonSerializerTracer> tracerRef() const;
+
+	inline const QJsonSerializer *serializer() const {
+		return _serializer;
+	}
+	// the context of the call that was running when this one started
+	inline const QJsonOptionsContext *previous() const {
+		return _previous;
+	}
+
+	// the options as read via QJsonTypeConverter::SerializationHelper::getProperty - invalid for unknown names
+	static QVariant property(const QJsonSerializerOptions &options, const char *name);
+
+	// the context of the innermost running call on this thread, if any
+	static const QJsonOptionsContext *current();
+	// the context of the innermost running call of the serializer on this thread, if any. Nested values
+	// use this instead of creating a context, so the lookup is all they pay for the options
+	static inline const QJsonOptionsContext *find(const QJsonSerializer *serializer) {
+		const auto context = current();
+		if(Q_LIKELY(!context || context->_serializer == serializer))
+			return context;
+		return findOuter(context, serializer);
+	}
+
+private:
+	struct ContextRef {
+		QJsonOptionsContext *context = nullptr;
+	};
+	static QThreadStorage<ContextRef> contextStore;
+
+	const QJsonSerializer *_serializer;
+	const QJsonSerializerOptions *_options = nullptr;
+	QJsonSerializerOptions _snapshot;
+	QSharedPointer<QJsonSerializerTracer> _tracerRef;
+	QJsonSerializerTracer *_tracer = nullptr;
+	// the context that was joined - it owns the tracer reference
+	const QJsonOptionsContext *_joined = nullptr;
+	QJsonOptionsContext *_previous = nullptr;
+	bool _active = false;
+
+	void activate();
+	static const QJsonOptionsContext *findOuter(const QJsonOptionsContext *context, const QJsonSerializer *serializer);
+};
+
+#endif // QJSONSERIALIZEROPTIONS_P_H
@@ -0,0 +1,144 @@
+#include "qjsonserializertracer.h"
+#include "qjsonserializertracer_p.h"
+#include "qjsonserializer_p.h"
+
+#include <chrono>
+#include <typeinfo>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThread>
+
+namespace {
+
+QByteArray converterName(const QJsonTypeConverter *converter)
+{
+	const auto name = typeid(*converter).name();
+#ifdef __GNUG__
+	auto status = 0;
+	const auto demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+	if(status == 0 && demangled) {
+		QByteArray result{demangled};
+		std::free(demangled);
+		return result;
+	}
+#endif
+	return name;
+}
+
+}
+
+QJsonSerializerTracer::QJsonSerializerTracer() = default;
+
+QJsonSerializerTracer::~QJsonSerializerTracer() = default;
+
+
+
+QJsonChromeTraceSink::QJsonChromeTraceSink(const QString &fileName) :
+	d{new QJsonChromeTraceSinkPrivate{}}
+{
+	d->pid = QCoreApplication::applicationPid();
+	d->file.setFileName(fileName);
+	// the array format: viewers accept the file even if the closing bracket is missing after a crash
+	if(d->file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+		d->file.write("[\n");
+}
+
+QJsonChromeTraceSink::~QJsonChromeTraceSink()
+{
+	if(d->file.isOpen()) {
+		d->file.write("\n]\n");
+		d->file.close();
+	}
+}
+
+bool QJsonChromeTraceSink::isValid() const
+{
+	QMutexLocker locker{&d->lock};
+	return d->file.isOpen() && d->file.error() == QFileDevice::NoError;
+}
+
+QString QJsonChromeTraceSink::errorString() const
+{
+	QMutexLocker locker{&d->lock};
+	return d->file.errorString();
+}
+
+void QJsonChromeTraceSink::flush()
+{
+	QMutexLocker locker{&d->lock};
+	if(d->file.isOpen())
+		d->file.flush();
+}
+
+void QJsonChromeTraceSink::traceEvent(const QJsonSerializerTracer::Event &event)
+{
+	// complete events ("X") - nested conversions are stacked below their parents by the viewers
+	const QJsonObject json {
+		{QStringLiteral("name"), QString::fromUtf8(event.name)},
+		{QStringLiteral("cat"), event.operation == Operation::Serialize ?
+			 QStringLiteral("serialize") :
+			 QStringLiteral("deserialize")},
+		{QStringLiteral("ph"), QStringLiteral("X")},
+		{QStringLiteral("ts"), event.start / 1000.0},
+		{QStringLiteral("dur"), event.duration / 1000.0},
+		{QStringLiteral("pid"), d->pid},
+		{QStringLiteral("tid"), static_cast<double>(reinterpret_cast<quintptr>(QThread::currentThreadId()))},
+		{QStringLiteral("args"), QJsonObject {
+			 {QStringLiteral("type"), QString::fromUtf8(event.typeName)},
+			 {QStringLiteral("converter"), QString::fromUtf8(event.converter)}
+		 }}
+	};
+	const auto data = QJsonDocument{json}.toJson(QJsonDocument::Compact);
+
+	QMutexLocker locker{&d->lock};
+	if(!d->file.isOpen())
+		return;
+	if(d->first)
+		d->first = false;
+	else
+		d->file.write(",\n");
+	d->file.write(data);
+}
+
+
+
+qint64 QJsonTraceScope::now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void QJsonTraceScope::begin(QJsonSerializerPrivate *serializer, QJsonSerializerTracer::Operation operation, int propertyType, const char *name, bool isEnum, QJsonValue::Type valueType)
+{
+	_serializer = serializer;
+	_operation = operation;
+	_propertyType = propertyType;
+	// copied, as converters may reuse the buffer of the hint once the call returned
+	_name = name;
+	_isEnum = isEnum;
+	_valueType = valueType;
+	_start = now();
+}
+
+void QJsonTraceScope::end()
+{
+	QJsonSerializerTracer::Event event;
+	event.duration = now() - _start;
+	event.start = _start;
+	event.operation = _operation;
+	event.typeName = QJsonSerializerPrivate::getTypeName(_propertyType);
+	event.name = _name.isEmpty() ? event.typeName : _name;
+	if(_isEnum)
+		event.converter = "enum";
+	else {
+		// cached by the serializer - the lookup is only done while tracing
+		const auto converter = _serializer->findConverter(_propertyType, _valueType);
+		event.converter = converter ? converterName(converter.data()) : QByteArray{"default"};
+	}
+	_tracer->traceEvent(event);
+}
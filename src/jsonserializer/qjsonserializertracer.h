@@ -0,0 +1,69 @@
+#ifndef QJSONSERIALIZERTRACER_H
+#define QJSONSERIALIZERTRACER_H
+
+#include "QtJsonSerializer/qtjsonserializer_global.h"
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qstring.h>
+
+//! An interface to observe the de/serialization of each property and subvalue
+class Q_JSONSERIALIZER_EXPORT QJsonSerializerTracer
+{
+	Q_DISABLE_COPY(QJsonSerializerTracer)
+
+public:
+	//! The direction of a traced conversion
+	enum class Operation {
+		Serialize, //!< A value was serialized to json
+		Deserialize //!< A value was deserialized from json
+	};
+
+	//! A single traced conversion of one property or subvalue
+	struct Event {
+		//! The direction of the conversion
+		Operation operation;
+		//! The property name, or the trace hint passed by the converter (like a list index or map key)
+		QByteArray name;
+		//! The name of the type that was converted
+		QByteArray typeName;
+		//! The name of the converter used, or "enum" and "default" for values handled by the serializer itself
+		QByteArray converter;
+		//! The start time of the conversion, in nanoseconds of a monotonic clock
+		qint64 start;
+		//! The time the conversion took, in nanoseconds, including all nested conversions
+		qint64 duration;
+	};
+
+	//! Constructor
+	QJsonSerializerTracer();
+	//! Destructor
+	virtual ~QJsonSerializerTracer();
+
+	//! Called after each conversion, on the thread that performed it
+	virtual void traceEvent(const Event &event) = 0;
+};
+
+class QJsonChromeTraceSinkPrivate;
+//! A tracer that writes all events to a file in the Chrome trace event format
+class Q_JSONSERIALIZER_EXPORT QJsonChromeTraceSink : public QJsonSerializerTracer
+{
+public:
+	//! Constructor, with the path of the file to write the trace to
+	explicit QJsonChromeTraceSink(const QString &fileName);
+	~QJsonChromeTraceSink() override;
+
+	//! Returns true, if the file was opened and all events have been written so far
+	bool isValid() const;
+	//! Returns the error of the trace file, if writing failed
+	QString errorString() const;
+	//! Writes all buffered events to the file
+	void flush();
+
+	void traceEvent(const Event &event) override;
+
+private:
+	QScopedPointer<QJsonChromeTraceSinkPrivate> d;
+};
+
+#endif // QJSONSERIALIZERTRACER_H
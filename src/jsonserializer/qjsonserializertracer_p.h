@@ -0,0 +1,67 @@
+#ifndef QJSONSERIALIZERTRACER_P_H
+#define QJSONSERIALIZERTRACER_P_H
+
+#include "qtjsonserializer_global.h"
+#include "qjsonserializertracer.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QMutex>
+#include <QtCore/QJsonValue>
+
+class QJsonSerializerPrivate;
+
+class Q_JSONSERIALIZER_EXPORT QJsonChromeTraceSinkPrivate
+{
+public:
+	QMutex lock;
+	QFile file;
+	qint64 pid;
+	bool first = true;
+};
+
+// Measures one de/serializeSubtype call. Without a tracer, the scope does nothing besides checking the pointer
+class Q_JSONSERIALIZER_EXPORT QJsonTraceScope
+{
+	Q_DISABLE_COPY(QJsonTraceScope)
+
+public:
+	inline QJsonTraceScope(QJsonSerializerTracer *tracer,
+						   QJsonSerializerPrivate *serializer,
+						   QJsonSerializerTracer::Operation operation,
+						   int propertyType,
+						   const char *name,
+						   bool isEnum = false,
+						   QJsonValue::Type valueType = QJsonValue::Undefined) :
+		_tracer{tracer}
+	{
+		if(Q_UNLIKELY(_tracer))
+			begin(serializer, operation, propertyType, name, isEnum, valueType);
+	}
+
+	inline ~QJsonTraceScope() {
+		if(Q_UNLIKELY(_tracer))
+			end();
+	}
+
+	static qint64 now();
+
+private:
+	QJsonSerializerTracer *_tracer;
+	QJsonSerializerPrivate *_serializer = nullptr;
+	QJsonSerializerTracer::Operation _operation = QJsonSerializerTracer::Operation::Serialize;
+	int _propertyType = 0;
+	QByteArray _name;
+	bool _isEnum = false;
+	QJsonValue::Type _valueType = QJsonValue::Undefined;
+	qint64 _start = 0;
+
+	void begin(QJsonSerializerPrivate *serializer,
+			   QJsonSerializerTracer::Operation operation,
+			   int propertyType,
+			   const char *name,
+			   bool isEnum,
+			   QJsonValue::Type valueType);
+	void end();
+};
+
+#endif // QJSONSERIALIZERTRACER_P_H
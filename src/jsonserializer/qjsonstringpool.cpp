@@ -0,0 +1,35 @@
+#include "qjsonstringpool_p.h"
+
+QThreadStorage<QJsonStringPool::PoolRef> QJsonStringPool::poolStore;
+
+QJsonStringPool::QJsonStringPool(int size) :
+	_size{size}
+{
+	poolStore.localData().pool = this;
+}
+
+QJsonStringPool::~QJsonStringPool()
+{
+	poolStore.localData().pool = nullptr;
+}
+
+QJsonStringPool *QJsonStringPool::current()
+{
+	return poolStore.hasLocalData() ?
+				poolStore.localData().pool :
+				nullptr;
+}
+
+QString QJsonStringPool::lookup(const QString &string)
+{
+	// empty strings share the static null data anyways
+	if(string.isEmpty())
+		return string;
+
+	const auto it = _strings.constFind(string);
+	if(it != _strings.constEnd())
+		return *it;
+	if(_strings.size() < _size)
+		_strings.insert(string);
+	return string;
+}
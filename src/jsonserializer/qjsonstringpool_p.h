@@ -0,0 +1,56 @@
+#ifndef QJSONSTRINGPOOL_P_H
+#define QJSONSTRINGPOOL_P_H
+
+#include "qtjsonserializer_global.h"
+
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QThreadStorage>
+
+// Shares equal strings during one deserialization call, so repeated values all reference the same implicitly
+// shared QString. The pool only exists on the thread of the call, and stops growing once the size limit is reached
+class Q_JSONSERIALIZER_EXPORT QJsonStringPool
+{
+	Q_DISABLE_COPY(QJsonStringPool)
+
+public:
+	// Creates a pool for the outermost deserialization call, if a size is set. Nested calls join that pool
+	class Q_JSONSERIALIZER_EXPORT Scope
+	{
+		Q_DISABLE_COPY(Scope)
+
+	public:
+		inline Scope(int size) {
+			if(Q_UNLIKELY(size > 0) && !current())
+				_pool.reset(new QJsonStringPool{size});
+		}
+
+	private:
+		QScopedPointer<QJsonStringPool> _pool;
+	};
+
+	QJsonStringPool(int size);
+	~QJsonStringPool();
+
+	static QJsonStringPool *current();
+
+	// returns the pooled copy of the string, if there is a pool
+	static inline QString intern(const QString &string) {
+		const auto pool = current();
+		return Q_UNLIKELY(pool) ? pool->lookup(string) : string;
+	}
+
+	QString lookup(const QString &string);
+
+private:
+	struct PoolRef {
+		QJsonStringPool *pool = nullptr;
+	};
+	static QThreadStorage<PoolRef> poolStore;
+
+	int _size;
+	QSet<QString> _strings;
+};
+
+#endif // QJSONSTRINGPOOL_P_H
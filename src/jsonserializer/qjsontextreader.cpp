@@ -0,0 +1,318 @@
+#include "qjsontextreader_p.h"
+#include "qjsonserializerexception.h"
+#include "qjsonasync_p.h"
+
+#include <QtCore/qnumeric.h>
+
+namespace {
+
+const int BufferSize = 64 * 1024;
+const int MaxDepth = 1024;
+// sequential devices get this long to deliver the rest of the text
+const int ReadTimeout = 30000;
+
+inline bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+}
+
+QJsonTextReader::QJsonTextReader(QIODevice *device) :
+	_device{device}
+{}
+
+QJsonValue QJsonTextReader::read()
+{
+	QJsonValue value;
+	switch(skipWhitespace()) {
+	case '{':
+		value = readObject(0);
+		break;
+	case '[':
+		value = readArray(0);
+		break;
+	case '\0':
+		fail("Document is empty");
+	default:
+		fail("Document must be an object or an array");
+	}
+
+	skipWhitespace();
+	if(fill())
+		fail("Garbage at the end of the document");
+	return value;
+}
+
+QJsonValue QJsonTextReader::readValue(int depth)
+{
+	switch(skipWhitespace()) {
+	case '{':
+		return readObject(depth + 1);
+	case '[':
+		return readArray(depth + 1);
+	case '"':
+		return readString();
+	case 't':
+		readLiteral("true");
+		return true;
+	case 'f':
+		readLiteral("false");
+		return false;
+	case 'n':
+		readLiteral("null");
+		return QJsonValue::Null;
+	default:
+		return readNumber();
+	}
+}
+
+QJsonObject QJsonTextReader::readObject(int depth)
+{
+	if(depth > MaxDepth)
+		fail("Document is nested too deeply");
+	next(); // {
+
+	QJsonObject object;
+	if(skipWhitespace() == '}') {
+		next();
+		return object;
+	}
+	forever {
+		if(skipWhitespace() != '"')
+			fail("Expected a string as object key");
+		const auto key = readString();
+		if(skipWhitespace() != ':')
+			fail("Missing name separator");
+		next();
+		object.insert(key, readValue(depth));
+
+		switch(skipWhitespace()) {
+		case ',':
+			next();
+			break;
+		case '}':
+			next();
+			return object;
+		default:
+			fail("Missing value separator or end of object");
+		}
+	}
+}
+
+QJsonArray QJsonTextReader::readArray(int depth)
+{
+	if(depth > MaxDepth)
+		fail("Document is nested too deeply");
+	next(); // [
+
+	QJsonArray array;
+	if(skipWhitespace() == ']') {
+		next();
+		return array;
+	}
+	forever {
+		array.append(readValue(depth));
+
+		switch(skipWhitespace()) {
+		case ',':
+			next();
+			break;
+		case ']':
+			next();
+			return array;
+		default:
+			fail("Missing value separator or end of array");
+		}
+	}
+}
+
+QString QJsonTextReader::readString()
+{
+	next(); // "
+
+	// plain utf8 is collected in the token and converted in one go, escapes are appended directly
+	QString result;
+	_token.resize(0);
+	const auto flush = [&]() {
+		if(!_token.isEmpty()) {
+			result.append(QString::fromUtf8(_token));
+			_token.resize(0);
+		}
+	};
+
+	forever {
+		if(!fill())
+			fail("Unterminated string");
+		const auto c = next();
+		if(c == '"')
+			break;
+		else if(static_cast<uchar>(c) < 0x20)
+			fail("Unescaped control character in string");
+		else if(c != '\\') {
+			_token.append(c);
+			continue;
+		}
+
+		if(!fill())
+			fail("Unterminated string");
+		switch(next()) {
+		case '"':
+			_token.append('"');
+			break;
+		case '\\':
+			_token.append('\\');
+			break;
+		case '/':
+			_token.append('/');
+			break;
+		case 'b':
+			_token.append('\b');
+			break;
+		case 'f':
+			_token.append('\f');
+			break;
+		case 'n':
+			_token.append('\n');
+			break;
+		case 'r':
+			_token.append('\r');
+			break;
+		case 't':
+			_token.append('\t');
+			break;
+		case 'u':
+			flush();
+			result.append(QChar{static_cast<ushort>(readHex())});
+			break;
+		default:
+			fail("Invalid escape sequence in string");
+		}
+	}
+
+	flush();
+	return result;
+}
+
+double QJsonTextReader::readNumber()
+{
+	// -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+	_token.resize(0);
+	const auto digits = [this]() {
+		auto count = 0;
+		while(isDigit(peek())) {
+			_token.append(next());
+			++count;
+		}
+		return count;
+	};
+
+	if(peek() == '-')
+		_token.append(next());
+	if(peek() == '0')
+		_token.append(next());
+	else if(digits() == 0)
+		fail("Illegal value");
+	if(peek() == '.') {
+		_token.append(next());
+		if(digits() == 0)
+			fail("Illegal number");
+	}
+	if(peek() == 'e' || peek() == 'E') {
+		_token.append(next());
+		if(peek() == '+' || peek() == '-')
+			_token.append(next());
+		if(digits() == 0)
+			fail("Illegal number");
+	}
+
+	auto ok = false;
+	const auto number = _token.toDouble(&ok);
+	if(!ok || !qIsFinite(number))
+		fail("Illegal number");
+	return number;
+}
+
+void QJsonTextReader::readLiteral(const char *literal)
+{
+	for(auto c = literal; *c; ++c) {
+		if(peek() != *c)
+			fail("Illegal value");
+		next();
+	}
+}
+
+uint QJsonTextReader::readHex()
+{
+	uint code = 0;
+	for(auto i = 0; i < 4; ++i) {
+		if(!fill())
+			fail("Unterminated string");
+		const auto c = next();
+		code <<= 4;
+		if(isDigit(c))
+			code |= static_cast<uint>(c - '0');
+		else if(c >= 'a' && c <= 'f')
+			code |= static_cast<uint>(c - 'a' + 10);
+		else if(c >= 'A' && c <= 'F')
+			code |= static_cast<uint>(c - 'A' + 10);
+		else
+			fail("Invalid escape sequence in string");
+	}
+	return code;
+}
+
+bool QJsonTextReader::fill()
+{
+	if(_pos < _size)
+		return true;
+
+	if(_buffer.isEmpty())
+		_buffer.resize(BufferSize);
+	_offset += _size;
+	_pos = 0;
+	_size = 0;
+	forever {
+		const auto read = _device->read(_buffer.data(), _buffer.size());
+		if(read < 0)
+			fail("Failed to read from device: " + _device->errorString().toUtf8());
+		else if(read > 0) {
+			_size = static_cast<int>(read);
+			QJsonAsyncContext::reportBytes(_offset + _size);
+			return true;
+		} else if(!_device->isSequential() || !_device->waitForReadyRead(ReadTimeout))
+			return false;
+	}
+}
+
+char QJsonTextReader::peek()
+{
+	return fill() ? _buffer.constData()[_pos] : '\0';
+}
+
+char QJsonTextReader::next()
+{
+	return fill() ? _buffer.constData()[_pos++] : '\0';
+}
+
+char QJsonTextReader::skipWhitespace()
+{
+	forever {
+		switch(peek()) {
+		case ' ':
+		case '\t':
+		case '\n':
+		case '\r':
+			++_pos;
+			break;
+		default:
+			return peek();
+		}
+	}
+}
+
+void QJsonTextReader::fail(const QByteArray &message) const
+{
+	throw QJsonDeserializationException("Failed to read json at offset " + QByteArray::number(_offset + _pos) +
+										" with error: " + message);
+}
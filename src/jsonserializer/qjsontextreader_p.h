@@ -0,0 +1,45 @@
+#ifndef QJSONTEXTREADER_P_H
+#define QJSONTEXTREADER_P_H
+
+#include "qtjsonserializer_global.h"
+
+#include <QtCore/QJsonValue>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonArray>
+#include <QtCore/QIODevice>
+
+// Parses json text while reading it from a device in chunks, so the text is never held completely. Accepts
+// the same documents as QJsonDocument::fromJson, i.e. an object or an array surrounded by whitespace
+class Q_JSONSERIALIZER_EXPORT QJsonTextReader
+{
+	Q_DISABLE_COPY(QJsonTextReader)
+
+public:
+	QJsonTextReader(QIODevice *device);
+
+	QJsonValue read();
+
+private:
+	QIODevice *_device;
+	QByteArray _buffer;
+	int _size = 0;
+	int _pos = 0;
+	qint64 _offset = 0;
+	QByteArray _token;
+
+	QJsonValue readValue(int depth);
+	QJsonObject readObject(int depth);
+	QJsonArray readArray(int depth);
+	QString readString();
+	double readNumber();
+	void readLiteral(const char *literal);
+	uint readHex();
+
+	bool fill();
+	char peek();
+	char next();
+	char skipWhitespace();
+	Q_NORETURN void fail(const QByteArray &message) const;
+};
+
+#endif // QJSONTEXTREADER_P_H
@@ -0,0 +1,187 @@
+#include "qjsontextwriter_p.h"
+#include "qjsonserializerexception.h"
+
+#include <cmath>
+
+#include <QtCore/QLocale>
+#include <QtCore/qnumeric.h>
+
+QJsonTextWriter::QJsonTextWriter(QJsonDocument::JsonFormat format) :
+	_compact{format == QJsonDocument::Compact}
+{}
+
+void QJsonTextWriter::beginObject(int size)
+{
+	Q_UNUSED(size)
+	beginContainer('{');
+}
+
+void QJsonTextWriter::writeKey(const QString &key)
+{
+	beginMember();
+	writeString(key);
+	buffer.append(_compact ? ":" : ": ");
+	_afterKey = true;
+}
+
+void QJsonTextWriter::endObject()
+{
+	endContainer('}');
+}
+
+void QJsonTextWriter::beginArray(int size)
+{
+	Q_UNUSED(size)
+	beginContainer('[');
+}
+
+void QJsonTextWriter::endArray()
+{
+	endContainer(']');
+}
+
+void QJsonTextWriter::writeValue(const QJsonValue &value)
+{
+	if(_depth == 0)
+		throw QJsonSerializationException("Only objects or arrays can be written to a device!");
+	beginMember();
+
+	switch(value.type()) {
+	case QJsonValue::Null:
+	case QJsonValue::Undefined:
+		buffer.append("null");
+		break;
+	case QJsonValue::Bool:
+		buffer.append(value.toBool() ? "true" : "false");
+		break;
+	case QJsonValue::Double:
+		writeDouble(value.toDouble());
+		break;
+	case QJsonValue::String:
+		writeString(value.toString());
+		break;
+	default:
+		Q_UNREACHABLE();
+		break;
+	}
+}
+
+void QJsonTextWriter::beginMember()
+{
+	// the value of a key directly follows it
+	if(_afterKey) {
+		_afterKey = false;
+		return;
+	}
+	if(_depth == 0)
+		return;
+
+	if(!_first)
+		buffer.append(_compact ? "," : ",\n");
+	if(!_compact)
+		buffer.append(4 * _depth, ' ');
+	_first = false;
+}
+
+void QJsonTextWriter::beginContainer(char open)
+{
+	beginMember();
+	buffer.append(open);
+	if(!_compact)
+		buffer.append('\n');
+	++_depth;
+	_first = true;
+}
+
+void QJsonTextWriter::endContainer(char close)
+{
+	if(!_compact && !_first)
+		buffer.append('\n');
+	--_depth;
+	if(!_compact)
+		buffer.append(4 * _depth, ' ');
+	buffer.append(close);
+	_first = false;
+	// indented documents end with a newline
+	if(!_compact && _depth == 0)
+		buffer.append('\n');
+}
+
+void QJsonTextWriter::writeString(const QString &value)
+{
+	static const char hexDigits[] = "0123456789abcdef";
+	const auto appendEscaped = [this](uint code) {
+		buffer.append("\\u");
+		buffer.append(hexDigits[(code >> 12) & 0x0f]);
+		buffer.append(hexDigits[(code >> 8) & 0x0f]);
+		buffer.append(hexDigits[(code >> 4) & 0x0f]);
+		buffer.append(hexDigits[code & 0x0f]);
+	};
+
+	buffer.append('"');
+	const auto data = value.constData();
+	const auto size = value.size();
+	for(auto i = 0; i < size; ++i) {
+		const uint c = data[i].unicode();
+		if(c < 0x80) {
+			switch(c) {
+			case '"':
+				buffer.append("\\\"");
+				break;
+			case '\\':
+				buffer.append("\\\\");
+				break;
+			case '\b':
+				buffer.append("\\b");
+				break;
+			case '\f':
+				buffer.append("\\f");
+				break;
+			case '\n':
+				buffer.append("\\n");
+				break;
+			case '\r':
+				buffer.append("\\r");
+				break;
+			case '\t':
+				buffer.append("\\t");
+				break;
+			default:
+				if(c < 0x20)
+					appendEscaped(c);
+				else
+					buffer.append(static_cast<char>(c));
+				break;
+			}
+		} else if(c < 0x800) {
+			buffer.append(static_cast<char>(0xc0 | (c >> 6)));
+			buffer.append(static_cast<char>(0x80 | (c & 0x3f)));
+		} else if(QChar::isHighSurrogate(c) && i + 1 < size && data[i + 1].isLowSurrogate()) {
+			const auto code = QChar::surrogateToUcs4(static_cast<ushort>(c), data[++i].unicode());
+			buffer.append(static_cast<char>(0xf0 | (code >> 18)));
+			buffer.append(static_cast<char>(0x80 | ((code >> 12) & 0x3f)));
+			buffer.append(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+			buffer.append(static_cast<char>(0x80 | (code & 0x3f)));
+		} else if(QChar::isSurrogate(c)) {
+			// lone surrogates are no valid utf8 - QJsonDocument escapes them
+			appendEscaped(c);
+		} else {
+			buffer.append(static_cast<char>(0xe0 | (c >> 12)));
+			buffer.append(static_cast<char>(0x80 | ((c >> 6) & 0x3f)));
+			buffer.append(static_cast<char>(0x80 | (c & 0x3f)));
+		}
+	}
+	buffer.append('"');
+}
+
+void QJsonTextWriter::writeDouble(double value)
+{
+	// same format as QJsonDocument: integral numbers without exponent, as long as they fit 64 bits
+	if(!qIsFinite(value)) {
+		buffer.append("null");
+		return;
+	}
+	const auto abs = std::abs(value);
+	const auto isIntegral = abs < 18446744073709551616.0 && std::floor(abs) == abs;
+	buffer.append(QByteArray::number(value, isIntegral ? 'f' : 'g', QLocale::FloatingPointShortest));
+}
@@ -0,0 +1,39 @@
+#ifndef QJSONTEXTWRITER_P_H
+#define QJSONTEXTWRITER_P_H
+
+#include "qtjsonserializer_global.h"
+#include "qjsonvalueproducer_p.h"
+
+#include <QtCore/QJsonDocument>
+
+// Writes the values produced by a QJsonValueProducer as json text, byte for byte like QJsonDocument::toJson.
+// As a document, the text must be an object or an array
+class Q_JSONSERIALIZER_EXPORT QJsonTextWriter : public QJsonValueSink
+{
+public:
+	QJsonTextWriter(QJsonDocument::JsonFormat format = QJsonDocument::Compact);
+
+	// the text written so far - the owner removes what it has passed on
+	QByteArray buffer;
+
+	void beginObject(int size) override;
+	void writeKey(const QString &key) override;
+	void endObject() override;
+	void beginArray(int size) override;
+	void endArray() override;
+	void writeValue(const QJsonValue &value) override;
+
+private:
+	const bool _compact;
+	int _depth = 0;
+	bool _first = true;
+	bool _afterKey = false;
+
+	void beginMember();
+	void beginContainer(char open);
+	void endContainer(char close);
+	void writeString(const QString &value);
+	void writeDouble(double value);
+};
+
+#endif // QJSONTEXTWRITER_P_H
@@ -28,6 +28,15 @@ QByteArray QJsonTypeConverter::getCanonicalTypeName(int propertyType) const
 	return QJsonSerializerPrivate::getTypeName(propertyType);
 }
 
+QVariant QJsonTypeConverter::convertedValue(QVariant value, int targetType)
+{
+	// values that already have the target type are passed on as they are (convert() checks canConvert() itself)
+	if(value.userType() == targetType || value.convert(targetType))
+		return value;
+	else
+		return {};
+}
+
 
 
 QJsonTypeConverter::SerializationHelper::SerializationHelper() = default;
@@ -2,6 +2,7 @@
 #define QJSONTYPECONVERTER_H
 
 #include "QtJsonSerializer/qtjsonserializer_global.h"
+#include "QtJsonSerializer/qjsonserializerexception.h"
 
 #include <QtCore/qmetatype.h>
 #include <QtCore/qmetaobject.h>
@@ -70,11 +71,49 @@ public:
 protected:
 	//! Returns the actual original typename of the given type
 	QByteArray getCanonicalTypeName(int propertyType) const;
+	//! Returns the value converted to the given type, or an invalid variant if that is not possible
+	static QVariant convertedValue(QVariant value, int targetType);
 
 private:
 	QScopedPointer<QJsonTypeConverterPrivate> d;
 };
 
+//! The base class of QJsonTypedConverter, for converters of exactly one type that determine their json types at runtime
+template <typename T>
+class QJsonTypedConverterBase : public QJsonTypeConverter
+{
+public:
+	//! The type handled by this converter
+	using ValueType = T;
+
+	using QJsonTypeConverter::serialize;
+	using QJsonTypeConverter::deserialize;
+
+	//! @copydoc QJsonTypeConverter::canConvert
+	bool canConvert(int metaTypeId) const final;
+
+	//! @copydoc QJsonTypeConverter::serialize(int, const QVariant &, const SerializationHelper *) const
+	QJsonValue serialize(int propertyType, const QVariant &value, const SerializationHelper *helper) const final;
+	//! @copydoc QJsonTypeConverter::deserialize(int, const QJsonValue &, QObject *, const SerializationHelper *) const
+	QVariant deserialize(int propertyType, const QJsonValue &value, QObject *parent, const SerializationHelper *helper) const final;
+
+	//! Called by the serializer to serialize a value of the type
+	virtual QJsonValue serialize(const T &value, const SerializationHelper *helper) const = 0;
+	//! Called by the serializer to deserialize a value of the type
+	virtual T deserialize(const QJsonValue &value, QObject *parent, const SerializationHelper *helper) const = 0;
+};
+
+//! A type converter for exactly one type, that works with the type itself instead of QVariants
+template <typename T, QJsonValue::Type... TJsonTypes>
+class QJsonTypedConverter : public QJsonTypedConverterBase<T>
+{
+	static_assert(sizeof...(TJsonTypes) > 0, "At least one json type must be specified");
+
+public:
+	//! @copydoc QJsonTypeConverter::jsonTypes
+	QList<QJsonValue::Type> jsonTypes() const final;
+};
+
 //! A factory interface to create instances of QJsonTypeConverters
 class Q_JSONSERIALIZER_EXPORT QJsonTypeConverterFactory
 {
@@ -116,4 +155,32 @@ QSharedPointer<QJsonTypeConverter> QJsonTypeConverterStandardFactory<TConverter,
 	return converter;
 }
 
+template<typename T>
+bool QJsonTypedConverterBase<T>::canConvert(int metaTypeId) const
+{
+	return metaTypeId == qMetaTypeId<T>();
+}
+
+template<typename T>
+QJsonValue QJsonTypedConverterBase<T>::serialize(int propertyType, const QVariant &value, const SerializationHelper *helper) const
+{
+	const auto tValue = this->convertedValue(value, propertyType);
+	if(!tValue.isValid())
+		throw QJsonSerializationException(QByteArray("Data is not of the required type ") + QMetaType::typeName(propertyType));
+	return serialize(*reinterpret_cast<const T*>(tValue.constData()), helper);
+}
+
+template<typename T>
+QVariant QJsonTypedConverterBase<T>::deserialize(int propertyType, const QJsonValue &value, QObject *parent, const SerializationHelper *helper) const
+{
+	Q_UNUSED(propertyType)
+	return QVariant::fromValue<T>(deserialize(value, parent, helper));
+}
+
+template<typename T, QJsonValue::Type... TJsonTypes>
+QList<QJsonValue::Type> QJsonTypedConverter<T, TJsonTypes...>::jsonTypes() const
+{
+	return {TJsonTypes...};
+}
+
 #endif // QJSONTYPECONVERTER_H
@@ -0,0 +1,296 @@
+#include "qjsonvalueproducer_p.h"
+#include "qjsonserializer_p.h"
+#include "qjsonserializeroptions_p.h"
+#include "qjsonasync_p.h"
+
+#include "typeconverters/qjsonbytearrayconverter_p.h"
+
+class QJsonValueProducer::JsonObjectFrame : public QJsonValueProducer::Frame
+{
+public:
+	JsonObjectFrame(const QJsonObject &object) :
+		Frame{true, object.size()},
+		_object{object}
+	{}
+
+	void produce(QJsonValueProducer *producer, int index) override {
+		const auto it = _object.constBegin() + index;
+		producer->writeKey(it.key());
+		producer->writeJson(it.value());
+	}
+
+private:
+	const QJsonObject _object;
+};
+
+class QJsonValueProducer::JsonArrayFrame : public QJsonValueProducer::Frame
+{
+public:
+	JsonArrayFrame(const QJsonArray &array) :
+		Frame{false, array.size()},
+		_array{array}
+	{}
+
+	void produce(QJsonValueProducer *producer, int index) override {
+		producer->writeJson(_array.at(index));
+	}
+
+private:
+	const QJsonArray _array;
+};
+
+
+
+QJsonValueSink::QJsonValueSink() = default;
+
+QJsonValueSink::~QJsonValueSink() = default;
+
+bool QJsonValueSink::hasNatives() const
+{
+	return false;
+}
+
+void QJsonValueSink::writeNative(const QVariant &value)
+{
+	throw QJsonSerializationException(QByteArray("Unable to write native value of type ") + value.typeName());
+}
+
+bool QJsonValueSink::isNative(int metaTypeId, const QJsonTypeConverter *converter)
+{
+	switch(metaTypeId) {
+	case QMetaType::QByteArray:
+		return !converter || dynamic_cast<const QJsonBytearrayConverter*>(converter);
+	case QMetaType::LongLong:
+	case QMetaType::ULongLong:
+		return !converter;
+	default:
+		return false;
+	}
+}
+
+
+
+QJsonValueProducer::Frame::Frame(bool isObject, int size) :
+	_isObject{isObject},
+	_size{size}
+{}
+
+QJsonValueProducer::Frame::~Frame() = default;
+
+
+
+QJsonPropertyFrame::QJsonPropertyFrame(const QMetaObject *metaObject, const QMap<QString, Member> &members) :
+	Frame{true, members.size()},
+	_metaObject{metaObject},
+	_keys{members.keys()},
+	_members{members.values()}
+{}
+
+void QJsonPropertyFrame::produce(QJsonValueProducer *producer, int index)
+{
+	const auto &member = _members[index];
+	if(member.propertyIndex == -1) {
+		producer->writeKey(_keys[index]);
+		producer->writeJson(member.json);
+		return;
+	}
+
+	const auto property = _metaObject->property(member.propertyIndex);
+	QJsonFieldSelectorContext::Step step{property.name()};
+	producer->writeKey(_keys[index]);
+	producer->produceProperty(property, read(property));
+}
+
+
+
+QJsonValueProducer::QJsonValueProducer(const QJsonSerializer *serializer, const QVariant &value, QJsonValueSink *sink) :
+	_serializer{serializer},
+	_sink{sink},
+	_root{value}
+{
+	// all steps use the settings of the creating call, even if the serializer is reconfigured meanwhile
+	QJsonOptionsContext options{serializer, serializer->d.data()};
+	_options = options.options();
+	_tracer = options.tracerRef();
+
+	// nested producers join the references of the outer call, all others keep their own ones between the steps
+	_references = QJsonReferenceContext::current();
+	if(!_references && _options.objectReferences()) {
+		_ownReferences.reset(new QJsonReferenceContext{{}, false});
+		_references = _ownReferences.data();
+	}
+	_rootSelection = QJsonFieldSelectorContext::current();
+}
+
+QJsonValueProducer::QJsonValueProducer(const QJsonValue &json, QJsonValueSink *sink) :
+	_sink{sink},
+	_rootJson{json}
+{}
+
+QJsonValueProducer::~QJsonValueProducer() = default;
+
+bool QJsonValueProducer::atEnd() const
+{
+	return _rootProduced && _stack.isEmpty();
+}
+
+void QJsonValueProducer::next()
+{
+	Q_ASSERT_X(!atEnd(), Q_FUNC_INFO, "the value has already been produced completely");
+	if(!_rootProduced) {
+		_rootProduced = true;
+		if(_serializer) {
+			QJsonOptionsContext options{_serializer, _options, _tracer};
+			QJsonReferenceContext::Resume references{_references};
+			QJsonFieldSelectorContext::Position selection{_rootSelection};
+			if(!produceMembers(_root.userType(), _root, nullptr, nullptr))
+				writeJson(_serializer->serializeVariant(_root.userType(), _root));
+			_root = QVariant{};
+		} else {
+			writeJson(_rootJson);
+			_rootJson = QJsonValue{};
+		}
+		return;
+	}
+
+	const auto frame = _stack.last();
+	if(frame->_index == frame->_size) {
+		popFrame();
+		return;
+	}
+
+	if(_serializer) {
+		// restore the state of the call the innermost value was created in
+		QJsonOptionsContext options{_serializer, _options, _tracer};
+		QJsonReferenceContext::Resume references{_references};
+		QJsonFieldSelectorContext::Position selection{frame->_selection};
+		QJsonExceptionContext context{_entries};
+		frame->produce(this, frame->_index++);
+	} else
+		frame->produce(this, frame->_index++);
+}
+
+void QJsonValueProducer::finish()
+{
+	while(!atEnd())
+		next();
+}
+
+void QJsonValueProducer::writeKey(const QString &key)
+{
+	_sink->writeKey(key);
+}
+
+void QJsonValueProducer::writeJson(const QJsonValue &json)
+{
+	// json created by converters is passed on member by member as well
+	switch(json.type()) {
+	case QJsonValue::Object:
+		pushFrame(new JsonObjectFrame{json.toObject()}, QMetaType::UnknownType, nullptr, nullptr);
+		break;
+	case QJsonValue::Array:
+		pushFrame(new JsonArrayFrame{json.toArray()}, QMetaType::UnknownType, nullptr, nullptr);
+		break;
+	default:
+		_sink->writeValue(json);
+		break;
+	}
+}
+
+void QJsonValueProducer::produceProperty(const QMetaProperty &property, const QVariant &value)
+{
+	if(!property.isEnumType()) {
+		const auto entry = QJsonExceptionContext::entry(property);
+		QJsonExceptionContext context{property};
+		if(produceMembers(property.userType(), value, &entry, property.name()))
+			return;
+	}
+	writeJson(_serializer->serializeSubtype(property, value));
+}
+
+void QJsonValueProducer::produceSubtype(int propertyType, const QVariant &value, const QByteArray &hint)
+{
+	{
+		const auto entry = QJsonExceptionContext::entry(propertyType, hint);
+		QJsonExceptionContext context{propertyType, hint};
+		if(produceMembers(propertyType, value, &entry, hint.constData()))
+			return;
+	}
+	writeJson(_serializer->serializeSubtype(propertyType, value, hint));
+}
+
+bool QJsonValueProducer::produceMembers(int propertyType, const QVariant &value, const QJsonExceptionContext::Entry *entry, const char *name)
+{
+	QJsonAsyncContext::checkpoint();
+	const auto converter = _serializer->d->findConverter(propertyType);
+
+	// binary data and 64 bit integers are written as they are, unless a custom converter was registered for them.
+	// For QVariant properties, that is the converter of the type they contain
+	if(_sink->hasNatives() &&
+	   QJsonValueSink::isNative(value.userType(), value.userType() == propertyType ?
+									converter.data() :
+									_serializer->d->findConverter(value.userType()).data())) {
+		QJsonTraceScope trace{entry ? _tracer.data() : nullptr, _serializer->d.data(), QJsonSerializerTracer::Operation::Serialize, propertyType, name};
+		_sink->writeNative(value);
+		return true;
+	}
+
+	const auto memberConverter = dynamic_cast<const QJsonMemberConverter*>(converter.data());
+	if(!memberConverter)
+		return false;
+	const auto frame = memberConverter->createFrame(propertyType, value, _serializer);
+	if(!frame)
+		return false;
+	pushFrame(frame, propertyType, entry, name);
+	return true;
+}
+
+void QJsonValueProducer::pushFrame(Frame *frame, int propertyType, const QJsonExceptionContext::Entry *entry, const char *name)
+{
+	const QSharedPointer<Frame> frameRef{frame};
+	frame->_selection = QJsonFieldSelectorContext::current();
+	if(entry) {
+		// the hint is owned by the caller, so the frame keeps a copy for the following steps
+		frame->_entry = *entry;
+		if(entry->hint) {
+			frame->_hint = *entry->hint;
+			frame->_entry.hint = &frame->_hint;
+		}
+		frame->_hasEntry = true;
+		if(Q_UNLIKELY(_tracer)) {
+			frame->_trace.reset(new QJsonTraceScope{
+									_tracer.data(),
+									_serializer->d.data(),
+									QJsonSerializerTracer::Operation::Serialize,
+									propertyType,
+									name
+								});
+		}
+	}
+
+	if(frame->_isObject)
+		_sink->beginObject(frame->_size);
+	else
+		_sink->beginArray(frame->_size);
+	_stack.append(frameRef);
+	if(frame->_hasEntry)
+		_entries.append(frame->_entry);
+}
+
+void QJsonValueProducer::popFrame()
+{
+	// the trace of the value ends with the frame
+	const auto frame = _stack.takeLast();
+	if(frame->_hasEntry)
+		_entries.removeLast();
+	if(frame->_isObject)
+		_sink->endObject();
+	else
+		_sink->endArray();
+}
+
+
+
+QJsonMemberConverter::QJsonMemberConverter() = default;
+
+QJsonMemberConverter::~QJsonMemberConverter() = default;
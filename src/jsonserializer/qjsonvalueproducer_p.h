@@ -0,0 +1,159 @@
+#ifndef QJSONVALUEPRODUCER_P_H
+#define QJSONVALUEPRODUCER_P_H
+
+#include "qtjsonserializer_global.h"
+#include "qjsonserializer.h"
+#include "qjsonserializeroptions.h"
+#include "qjsonexceptioncontext_p.h"
+#include "qjsonfieldselector_p.h"
+#include "qjsonreferencecontext_p.h"
+#include "qjsonserializertracer_p.h"
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonArray>
+#include <QtCore/QMap>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QVector>
+
+// Receives the data of a value from a QJsonValueProducer. Objects and arrays are passed member by member,
+// writeValue is only called for the other json types
+class Q_JSONSERIALIZER_EXPORT QJsonValueSink
+{
+	Q_DISABLE_COPY(QJsonValueSink)
+
+public:
+	QJsonValueSink();
+	virtual ~QJsonValueSink();
+
+	virtual void beginObject(int size) = 0;
+	virtual void writeKey(const QString &key) = 0;
+	virtual void endObject() = 0;
+	virtual void beginArray(int size) = 0;
+	virtual void endArray() = 0;
+	virtual void writeValue(const QJsonValue &value) = 0;
+
+	// formats that store binary data and 64 bit integers natively, instead of their json representation
+	virtual bool hasNatives() const;
+	virtual void writeNative(const QVariant &value);
+
+	// such values are only handled natively if the built-in conversion would be used for them - the
+	// converter is the one found for the type, if any
+	static bool isNative(int metaTypeId, const QJsonTypeConverter *converter);
+};
+
+// Serializes a value to a sink in small steps, without creating the json of the whole value first. Objects,
+// gadgets, lists and maps handled by the built-in converters are produced one member per step, all other
+// values are serialized by their converters as usual and then passed on. The position within the value is
+// kept as an explicit stack, so producing can stop after any step and be continued later, even after the
+// call that created the producer has returned. The data must not be modified or destroyed meanwhile
+class Q_JSONSERIALIZER_EXPORT QJsonValueProducer
+{
+	Q_DISABLE_COPY(QJsonValueProducer)
+
+public:
+	// A value whose members are produced one per step. Created by the converters that implement QJsonMemberConverter
+	class Q_JSONSERIALIZER_EXPORT Frame
+	{
+		Q_DISABLE_COPY(Frame)
+		friend class QJsonValueProducer;
+
+	public:
+		Frame(bool isObject, int size);
+		virtual ~Frame();
+
+		// produces the member with the given index, i.e. via writeKey and produceProperty or produceSubtype
+		virtual void produce(QJsonValueProducer *producer, int index) = 0;
+
+	private:
+		const bool _isObject;
+		const int _size;
+		int _index = 0;
+
+		// the state of the value that is restored for every step
+		QJsonExceptionContext::Entry _entry;
+		bool _hasEntry = false;
+		QByteArray _hint;
+		const QJsonFieldSelectorData::Node *_selection = nullptr;
+		QScopedPointer<QJsonTraceScope> _trace;
+	};
+
+	// produces the given value, with the settings of the serializer at construction
+	QJsonValueProducer(const QJsonSerializer *serializer, const QVariant &value, QJsonValueSink *sink);
+	// produces plain json data
+	QJsonValueProducer(const QJsonValue &json, QJsonValueSink *sink);
+	~QJsonValueProducer();
+
+	bool atEnd() const;
+	// produces the next member of the innermost object or array - or the value itself on the first call
+	void next();
+	// produces everything that is left
+	void finish();
+
+	// for frames: the methods to produce the members
+	void writeKey(const QString &key);
+	void writeJson(const QJsonValue &json);
+	void produceProperty(const QMetaProperty &property, const QVariant &value);
+	void produceSubtype(int propertyType, const QVariant &value, const QByteArray &hint);
+
+private:
+	class JsonObjectFrame;
+	class JsonArrayFrame;
+
+	const QJsonSerializer *_serializer = nullptr;
+	QJsonValueSink *_sink;
+	QVariant _root;
+	QJsonValue _rootJson;
+	bool _rootProduced = false;
+
+	QJsonSerializerOptions _options;
+	QSharedPointer<QJsonSerializerTracer> _tracer;
+	QScopedPointer<QJsonReferenceContext> _ownReferences;
+	QJsonReferenceContext *_references = nullptr;
+	const QJsonFieldSelectorData::Node *_rootSelection = nullptr;
+
+	QVector<QSharedPointer<Frame>> _stack;
+	QVector<QJsonExceptionContext::Entry> _entries;
+
+	bool produceMembers(int propertyType, const QVariant &value, const QJsonExceptionContext::Entry *entry, const char *name);
+	void pushFrame(Frame *frame, int propertyType, const QJsonExceptionContext::Entry *entry, const char *name);
+	void popFrame();
+};
+
+// The properties of an object or gadget, in the order of the keys of a QJsonObject
+class Q_JSONSERIALIZER_EXPORT QJsonPropertyFrame : public QJsonValueProducer::Frame
+{
+public:
+	struct Member {
+		// -1 for members that are not a property, like "$id", which are written as json
+		int propertyIndex;
+		QJsonValue json;
+	};
+
+	QJsonPropertyFrame(const QMetaObject *metaObject, const QMap<QString, Member> &members);
+
+	void produce(QJsonValueProducer *producer, int index) final;
+
+protected:
+	virtual QVariant read(const QMetaProperty &property) const = 0;
+
+private:
+	const QMetaObject *_metaObject;
+	const QStringList _keys;
+	const QList<Member> _members;
+};
+
+// Implemented by the built-in converters of types with members, so those can be produced member by member
+class Q_JSONSERIALIZER_EXPORT QJsonMemberConverter
+{
+	Q_DISABLE_COPY(QJsonMemberConverter)
+
+public:
+	QJsonMemberConverter();
+	virtual ~QJsonMemberConverter();
+
+	// returns nullptr for values that have to be serialized as a whole, like null pointers or references
+	virtual QJsonValueProducer::Frame *createFrame(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const = 0;
+};
+
+#endif // QJSONVALUEPRODUCER_P_H
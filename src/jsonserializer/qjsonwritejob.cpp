@@ -0,0 +1,140 @@
+#include "qjsonwritejob.h"
+#include "qjsonwritejob_p.h"
+
+#include "qjsonserializerexception.h"
+
+QJsonWriteJob::QJsonWriteJob(const QJsonValue &json, QIODevice *device, QObject *parent) :
+	QObject{parent},
+	d{new QJsonWriteJobPrivate{device}}
+{
+	d->producer.reset(new QJsonValueProducer{json, &d->writer});
+}
+
+QJsonWriteJob::QJsonWriteJob(QJsonWriteJobPrivate *d, QObject *parent) :
+	QObject{parent},
+	d{d}
+{}
+
+QJsonWriteJob::~QJsonWriteJob() = default;
+
+qint64 QJsonWriteJob::watermark() const
+{
+	return d->watermark;
+}
+
+qint64 QJsonWriteJob::bytesGenerated() const
+{
+	return d->bytesGenerated;
+}
+
+bool QJsonWriteJob::isFinished() const
+{
+	return d->atEnd();
+}
+
+void QJsonWriteJob::start()
+{
+	if(d->running || isFinished())
+		return;
+	if(!d->device || !d->device->isWritable()) {
+		emit error(tr("The device is not open for writing"));
+		return;
+	}
+
+	d->running = true;
+	connect(d->device.data(), &QIODevice::bytesWritten,
+			this, &QJsonWriteJob::fill);
+	connect(d->device.data(), &QIODevice::aboutToClose,
+			this, [this]() {
+		abort();
+		emit error(tr("The device was closed before all data was written"));
+	});
+	connect(d->device.data(), &QObject::destroyed,
+			this, [this]() {
+		d->running = false;
+		emit error(tr("The device was destroyed before all data was written"));
+	});
+	fill();
+}
+
+void QJsonWriteJob::abort()
+{
+	if(!d->running)
+		return;
+	d->running = false;
+	if(d->device)
+		d->device->disconnect(this);
+}
+
+void QJsonWriteJob::setWatermark(qint64 watermark)
+{
+	watermark = qMax<qint64>(watermark, 1);
+	if(d->watermark == watermark)
+		return;
+
+	d->watermark = watermark;
+	emit watermarkChanged(d->watermark);
+}
+
+void QJsonWriteJob::fill()
+{
+	// devices may emit bytesWritten synchronously from within write
+	if(!d->running || d->filling || !d->device)
+		return;
+
+	d->filling = true;
+	const auto chunkSize = static_cast<int>(qMin<qint64>(d->watermark, 1024 * 1024));
+	auto written = false;
+	while(d->device->bytesToWrite() < d->watermark) {
+		if(d->writer.buffer.isEmpty()) {
+			if(d->producer->atEnd())
+				break;
+			try {
+				d->generate(chunkSize);
+			} catch(QJsonSerializerException &e) {
+				d->filling = false;
+				abort();
+				emit error(QString::fromUtf8(e.what()));
+				return;
+			}
+		}
+
+		const auto bytes = d->device->write(d->writer.buffer);
+		if(bytes < 0) {
+			d->filling = false;
+			abort();
+			emit error(d->device->errorString());
+			return;
+		} else if(bytes == 0)
+			break;
+		d->writer.buffer.remove(0, static_cast<int>(bytes));
+		d->bytesGenerated += bytes;
+		written = true;
+	}
+	d->filling = false;
+
+	if(written)
+		emit bytesGeneratedChanged(d->bytesGenerated);
+	if(isFinished()) {
+		abort();
+		emit finished();
+	}
+}
+
+
+
+QJsonWriteJobPrivate::QJsonWriteJobPrivate(QIODevice *device) :
+	device{device}
+{}
+
+bool QJsonWriteJobPrivate::atEnd() const
+{
+	return producer->atEnd() && writer.buffer.isEmpty();
+}
+
+void QJsonWriteJobPrivate::generate(int limit)
+{
+	writer.buffer.reserve(limit);
+	while(!producer->atEnd() && writer.buffer.size() < limit)
+		producer->next();
+}
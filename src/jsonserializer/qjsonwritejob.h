@@ -0,0 +1,66 @@
+#ifndef QJSONWRITEJOB_H
+#define QJSONWRITEJOB_H
+
+#include "QtJsonSerializer/qtjsonserializer_global.h"
+
+#include <QtCore/qobject.h>
+#include <QtCore/qjsonvalue.h>
+#include <QtCore/qiodevice.h>
+#include <QtCore/qscopedpointer.h>
+
+class QJsonWriteJobPrivate;
+//! A job that writes json to a device in chunks, as fast as the device accepts the data
+class Q_JSONSERIALIZER_EXPORT QJsonWriteJob : public QObject
+{
+	Q_OBJECT
+
+	//! The amount of pending data on the device below which the next chunk is generated
+	Q_PROPERTY(qint64 watermark READ watermark WRITE setWatermark NOTIFY watermarkChanged)
+	//! The number of bytes passed to the device so far
+	Q_PROPERTY(qint64 bytesGenerated READ bytesGenerated NOTIFY bytesGeneratedChanged)
+	//! Specifies whether all data has been passed to the device
+	Q_PROPERTY(bool finished READ isFinished NOTIFY finished)
+
+public:
+	//! Constructor with the json to be written and the device to write it to
+	QJsonWriteJob(const QJsonValue &json, QIODevice *device, QObject *parent = nullptr);
+	~QJsonWriteJob() override;
+
+	//! @readAcFn{QJsonWriteJob::watermark}
+	qint64 watermark() const;
+	//! @readAcFn{QJsonWriteJob::bytesGenerated}
+	qint64 bytesGenerated() const;
+	//! @readAcFn{QJsonWriteJob::finished}
+	bool isFinished() const;
+
+public Q_SLOTS:
+	//! Starts writing to the device
+	void start();
+	//! Stops writing to the device, without finishing the json
+	void abort();
+
+	//! @writeAcFn{QJsonWriteJob::watermark}
+	void setWatermark(qint64 watermark);
+
+Q_SIGNALS:
+	//! Is emitted once all data has been passed to the device
+	void finished();
+	//! Is emitted if writing to the device failed. The job is stopped afterwards
+	void error(const QString &errorString);
+
+	//! @notifyAcFn{QJsonWriteJob::watermark}
+	void watermarkChanged(qint64 watermark);
+	//! @notifyAcFn{QJsonWriteJob::bytesGenerated}
+	void bytesGeneratedChanged(qint64 bytesGenerated);
+
+private Q_SLOTS:
+	void fill();
+
+private:
+	friend class QJsonSerializer;
+	QScopedPointer<QJsonWriteJobPrivate> d;
+
+	QJsonWriteJob(QJsonWriteJobPrivate *d, QObject *parent);
+};
+
+#endif // QJSONWRITEJOB_H
@@ -0,0 +1,33 @@
+#ifndef QJSONWRITEJOB_P_H
+#define QJSONWRITEJOB_P_H
+
+#include "qtjsonserializer_global.h"
+#include "qjsonwritejob.h"
+#include "qjsonvalueproducer_p.h"
+#include "qjsontextwriter_p.h"
+
+#include <QtCore/QPointer>
+#include <QtCore/QScopedPointer>
+
+class Q_JSONSERIALIZER_EXPORT QJsonWriteJobPrivate
+{
+	Q_DISABLE_COPY(QJsonWriteJobPrivate)
+
+public:
+	QJsonWriteJobPrivate(QIODevice *device);
+
+	QJsonTextWriter writer;
+	// created after the writer, as it writes to it
+	QScopedPointer<QJsonValueProducer> producer;
+	QPointer<QIODevice> device;
+	qint64 watermark = 64 * 1024;
+	qint64 bytesGenerated = 0;
+	bool running = false;
+	bool filling = false;
+
+	bool atEnd() const;
+	// produces values until the buffer holds at least limit bytes, or everything was produced
+	void generate(int limit);
+};
+
+#endif // QJSONWRITEJOB_P_H
@@ -1,5 +1,7 @@
 #include "qjsonbytearrayconverter_p.h"
 #include "qjsonserializerexception.h"
+#include "qjsonserializer_p.h"
+#include "qjsonattachment_p.h"
 
 #include <QtCore/QByteArray>
 #include <QtCore/QRegularExpression>
@@ -11,7 +13,7 @@ bool QJsonBytearrayConverter::canConvert(int metaTypeId) const
 
 QList<QJsonValue::Type> QJsonBytearrayConverter::jsonTypes() const
 {
-	return {QJsonValue::String};
+	return {QJsonValue::String, QJsonValue::Object};
 }
 
 QJsonValue QJsonBytearrayConverter::serialize(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
@@ -19,7 +21,13 @@ QJsonValue QJsonBytearrayConverter::serialize(int propertyType, const QVariant &
 	Q_UNUSED(propertyType)
 	Q_UNUSED(helper)
 
-	return QString::fromUtf8(value.toByteArray().toBase64());
+	const auto data = value.toByteArray();
+	// large data is written as raw attachment, if serialized with attachments
+	const auto attachments = QJsonAttachmentContext::current();
+	QJsonValue json;
+	if(Q_UNLIKELY(attachments) && attachments->store(data, json))
+		return json;
+	return QString::fromUtf8(data.toBase64());
 }
 
 QVariant QJsonBytearrayConverter::deserialize(int propertyType, const QJsonValue &value, QObject *parent, const QJsonTypeConverter::SerializationHelper *helper) const
@@ -27,7 +35,14 @@ QVariant QJsonBytearrayConverter::deserialize(int propertyType, const QJsonValue
 	Q_UNUSED(propertyType)
 	Q_UNUSED(parent)
 
-	auto validateBase64 = helper->getProperty("validateBase64").toBool();
+	if(value.isObject()) {
+		const auto attachments = QJsonAttachmentContext::current();
+		if(!attachments)
+			throw QJsonDeserializationException("Found a reference to an attachment, but the data was not deserialized with attachments");
+		return attachments->find(value.toObject());
+	}
+
+	auto validateBase64 = QJsonSerializerPrivate::callOptions(helper).validateBase64();
 	auto strValue = value.toString();
 	if(validateBase64) {
 		if((strValue.size() % 4) != 0)
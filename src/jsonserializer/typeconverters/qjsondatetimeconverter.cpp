@@ -0,0 +1,266 @@
+#include "qjsondatetimeconverter_p.h"
+#include "qjsonserializerexception.h"
+#include "qjsonserializer_p.h"
+
+#include <QtCore/QDateTime>
+
+namespace {
+
+// The formatter and parser only handle the ISO subset Qt produces itself (yyyy-MM-ddTHH:mm:ss.zzz[Z|+HH:mm]).
+// Everything else is passed on to Qt, so the results are always identical to Qt::ISODate(WithMs)
+
+using Cursor = const QChar *;
+
+inline QChar *writeDigits(QChar *out, int value, int width)
+{
+	for(auto i = width - 1; i >= 0; --i) {
+		out[i] = QLatin1Char(static_cast<char>('0' + (value % 10)));
+		value /= 10;
+	}
+	return out + width;
+}
+
+inline QChar *writeDate(QChar *out, const QDate &date)
+{
+	out = writeDigits(out, date.year(), 4);
+	*out++ = QLatin1Char('-');
+	out = writeDigits(out, date.month(), 2);
+	*out++ = QLatin1Char('-');
+	return writeDigits(out, date.day(), 2);
+}
+
+inline QChar *writeTime(QChar *out, const QTime &time)
+{
+	out = writeDigits(out, time.hour(), 2);
+	*out++ = QLatin1Char(':');
+	out = writeDigits(out, time.minute(), 2);
+	*out++ = QLatin1Char(':');
+	out = writeDigits(out, time.second(), 2);
+	*out++ = QLatin1Char('.');
+	return writeDigits(out, time.msec(), 3);
+}
+
+inline QChar *writeOffset(QChar *out, int offsetSecs)
+{
+	*out++ = QLatin1Char(offsetSecs < 0 ? '-' : '+');
+	offsetSecs = qAbs(offsetSecs);
+	out = writeDigits(out, offsetSecs / 3600, 2);
+	*out++ = QLatin1Char(':');
+	return writeDigits(out, (offsetSecs % 3600) / 60, 2);
+}
+
+inline bool isIsoYear(int year)
+{
+	return year >= 0 && year <= 9999;
+}
+
+inline bool isDigit(Cursor pos, Cursor end)
+{
+	return pos != end && pos->unicode() >= '0' && pos->unicode() <= '9';
+}
+
+inline bool readChar(Cursor &pos, Cursor end, char c)
+{
+	if(pos == end || *pos != QLatin1Char(c))
+		return false;
+	++pos;
+	return true;
+}
+
+inline bool readDigits(Cursor &pos, Cursor end, int width, int &value)
+{
+	if(end - pos < width)
+		return false;
+	value = 0;
+	for(auto i = 0; i < width; ++i, ++pos) {
+		if(!isDigit(pos, end))
+			return false;
+		value = value * 10 + (pos->unicode() - '0');
+	}
+	return true;
+}
+
+bool readDate(Cursor &pos, Cursor end, QDate &date)
+{
+	auto year = 0, month = 0, day = 0;
+	if(!readDigits(pos, end, 4, year) ||
+	   !readChar(pos, end, '-') ||
+	   !readDigits(pos, end, 2, month) ||
+	   !readChar(pos, end, '-') ||
+	   !readDigits(pos, end, 2, day))
+		return false;
+	date = QDate{year, month, day};
+	return date.isValid();
+}
+
+bool readTime(Cursor &pos, Cursor end, QTime &time)
+{
+	auto hour = 0, minute = 0, second = 0, msec = 0;
+	if(!readDigits(pos, end, 2, hour) ||
+	   !readChar(pos, end, ':') ||
+	   !readDigits(pos, end, 2, minute))
+		return false;
+	if(readChar(pos, end, ':')) {
+		if(!readDigits(pos, end, 2, second))
+			return false;
+		if(readChar(pos, end, '.')) {
+			// up to millisecond precision, longer fractions are left to Qt
+			auto digits = 0;
+			for(; digits < 3 && isDigit(pos, end); ++digits, ++pos)
+				msec = msec * 10 + (pos->unicode() - '0');
+			if(digits == 0 || isDigit(pos, end))
+				return false;
+			for(; digits < 3; ++digits)
+				msec *= 10;
+		}
+	}
+	time = QTime{hour, minute, second, msec};
+	return time.isValid();
+}
+
+bool readOffset(Cursor &pos, Cursor end, Qt::TimeSpec &spec, int &offsetSecs)
+{
+	if(pos == end) {
+		spec = Qt::LocalTime;
+		return true;
+	} else if(readChar(pos, end, 'Z')) {
+		spec = Qt::UTC;
+		return pos == end;
+	}
+
+	const auto sign = *pos == QLatin1Char('-') ? -1 : 1;
+	auto hours = 0, minutes = 0;
+	if((!readChar(pos, end, '+') && !readChar(pos, end, '-')) ||
+	   !readDigits(pos, end, 2, hours) ||
+	   !readChar(pos, end, ':') ||
+	   !readDigits(pos, end, 2, minutes) ||
+	   minutes > 59 ||
+	   pos != end)
+		return false;
+	spec = Qt::OffsetFromUTC;
+	offsetSecs = sign * (hours * 60 + minutes) * 60;
+	return true;
+}
+
+}
+
+bool QJsonDateTimeConverter::canConvert(int metaTypeId) const
+{
+	return metaTypeId == QMetaType::QDate ||
+			metaTypeId == QMetaType::QTime ||
+			metaTypeId == QMetaType::QDateTime;
+}
+
+QList<QJsonValue::Type> QJsonDateTimeConverter::jsonTypes() const
+{
+	return {QJsonValue::String, QJsonValue::Double, QJsonValue::Null};
+}
+
+QJsonValue QJsonDateTimeConverter::serialize(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
+{
+	// yyyy-MM-ddTHH:mm:ss.zzz+HH:mm
+	QChar buffer[29];
+	auto end = buffer;
+
+	switch(propertyType) {
+	case QMetaType::QDate: {
+		const auto date = value.toDate();
+		if(!date.isValid())
+			return QString();
+		if(!isIsoYear(date.year()))
+			return date.toString(Qt::ISODate);
+		end = writeDate(end, date);
+		break;
+	}
+	case QMetaType::QTime: {
+		const auto time = value.toTime();
+		if(!time.isValid())
+			return QString();
+		end = writeTime(end, time);
+		break;
+	}
+	case QMetaType::QDateTime: {
+		const auto dateTime = value.toDateTime();
+		if(QJsonSerializerPrivate::callOptions(helper).dateTimeAsEpoch()) {
+			if(dateTime.isValid())
+				return static_cast<double>(dateTime.toMSecsSinceEpoch());
+			else
+				return QJsonValue::Null;
+		}
+
+		if(!dateTime.isValid())
+			return QString();
+		const auto date = dateTime.date();
+		if(!isIsoYear(date.year()))
+			return dateTime.toString(Qt::ISODateWithMs);
+		end = writeDate(end, date);
+		*end++ = QLatin1Char('T');
+		end = writeTime(end, dateTime.time());
+		switch(dateTime.timeSpec()) {
+		case Qt::LocalTime:
+			break;
+		case Qt::UTC:
+			*end++ = QLatin1Char('Z');
+			break;
+		case Qt::OffsetFromUTC:
+		case Qt::TimeZone:
+			end = writeOffset(end, dateTime.offsetFromUtc());
+			break;
+		}
+		break;
+	}
+	default:
+		throw QJsonSerializationException(QByteArray("Invalid metatype: ") + QMetaType::typeName(propertyType));
+	}
+
+	return QString{buffer, static_cast<int>(end - buffer)};
+}
+
+QVariant QJsonDateTimeConverter::deserialize(int propertyType, const QJsonValue &value, QObject *parent, const QJsonTypeConverter::SerializationHelper *helper) const
+{
+	Q_UNUSED(parent)
+	Q_UNUSED(helper)
+
+	// epoch milliseconds are always accepted for datetimes, independent of dateTimeAsEpoch
+	if(propertyType == QMetaType::QDateTime && value.isDouble())
+		return QDateTime::fromMSecsSinceEpoch(qRound64(value.toDouble()), Qt::UTC);
+
+	// empty strings and all other json types are considered invalid, but "correct" values
+	const auto string = value.toString();
+	auto pos = string.constData();
+	const auto end = pos + string.size();
+	switch(propertyType) {
+	case QMetaType::QDate: {
+		if(string.isEmpty())
+			return QDate();
+		QDate date;
+		if(readDate(pos, end, date) && pos == end)
+			return date;
+		return QDate::fromString(string, Qt::ISODate);
+	}
+	case QMetaType::QTime: {
+		if(string.isEmpty())
+			return QTime();
+		QTime time;
+		if(readTime(pos, end, time) && pos == end)
+			return time;
+		return QTime::fromString(string, Qt::ISODate);
+	}
+	case QMetaType::QDateTime: {
+		if(string.isEmpty())
+			return QDateTime();
+		QDate date;
+		QTime time;
+		auto spec = Qt::LocalTime;
+		auto offsetSecs = 0;
+		if(readDate(pos, end, date) &&
+		   readChar(pos, end, 'T') &&
+		   readTime(pos, end, time) &&
+		   readOffset(pos, end, spec, offsetSecs))
+			return QDateTime{date, time, spec, offsetSecs};
+		return QDateTime::fromString(string, Qt::ISODate);
+	}
+	default:
+		throw QJsonDeserializationException(QByteArray("Invalid metatype: ") + QMetaType::typeName(propertyType));
+	}
+}
@@ -0,0 +1,16 @@
+#ifndef QJSONDATETIMECONVERTER_P_H
+#define QJSONDATETIMECONVERTER_P_H
+
+#include "qtjsonserializer_global.h"
+#include "qjsontypeconverter.h"
+
+class Q_JSONSERIALIZER_EXPORT QJsonDateTimeConverter : public QJsonTypeConverter
+{
+public:
+	bool canConvert(int metaTypeId) const override;
+	QList<QJsonValue::Type> jsonTypes() const override;
+	QJsonValue serialize(int propertyType, const QVariant &value, const SerializationHelper *helper) const override;
+	QVariant deserialize(int propertyType, const QJsonValue &value, QObject *parent, const SerializationHelper *helper) const override;
+};
+
+#endif // QJSONDATETIMECONVERTER_P_H
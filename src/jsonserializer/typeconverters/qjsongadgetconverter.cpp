@@ -1,9 +1,102 @@
 #include "qjsongadgetconverter_p.h"
 #include "qjsonserializerexception.h"
 #include "qjsonserializer_p.h"
+#include "qjsonfieldselector_p.h"
 
 #include <QtCore/QMetaProperty>
 #include <QtCore/QSet>
+#include <QtCore/QVarLengthArray>
+#include <QtCore/QVector>
+
+namespace {
+
+const void *address(int propertyType, const QVariant &gValue)
+{
+	// with pointers, null gadgets are allowed
+	if(QMetaType::typeFlags(propertyType).testFlag(QMetaType::PointerToGadget))
+		return *reinterpret_cast<const void* const *>(gValue.constData());
+
+	const auto gadget = gValue.constData();
+	if(!gadget)
+		throw QJsonSerializationException(QByteArray("Unable to get address of gadget ") + QMetaType::typeName(propertyType));
+	return gadget;
+}
+
+// creates a default constructed gadget, or a pointer to a new one - gadgetPtr is set to the gadget itself
+QVariant create(int propertyType, const QMetaObject *metaObject, void *&gadgetPtr)
+{
+	QVariant gadget;
+	if(QMetaType::typeFlags(propertyType).testFlag(QMetaType::PointerToGadget)) {
+		const auto gadgetType = QMetaType::type(metaObject->className());
+		if(gadgetType == QMetaType::UnknownType)
+			throw QJsonDeserializationException(QByteArray("Unable to get type of gadget from gadget-pointer type") + QMetaType::typeName(propertyType));
+		gadgetPtr = QMetaType::create(gadgetType);
+		gadget = QVariant{propertyType, &gadgetPtr};
+	} else {
+		gadget = QVariant{propertyType, nullptr};
+		gadgetPtr = gadget.data();
+	}
+
+	if(!gadgetPtr) {
+		throw QJsonDeserializationException(QByteArray("Failed to construct gadget of type ") +
+											QMetaType::typeName(propertyType) +
+											QByteArray(". Does is have a default constructor?"));
+	}
+	return gadget;
+}
+
+// keeps a copy of the gadget (or its pointer) while its properties are produced
+class GadgetFrame : public QJsonPropertyFrame
+{
+public:
+	GadgetFrame(int propertyType, const QVariant &gValue, const QMetaObject *metaObject, const QMap<QString, Member> &members) :
+		QJsonPropertyFrame{metaObject, members},
+		_value{gValue},
+		_gadget{address(propertyType, _value)}
+	{}
+
+protected:
+	QVariant read(const QMetaProperty &property) const override {
+		return property.readOnGadget(_gadget);
+	}
+
+private:
+	const QVariant _value;
+	const void * const _gadget;
+};
+
+// writes the values of a row to the properties the columns were resolved to
+class GadgetColumnReader : public QJsonColumnReader
+{
+public:
+	GadgetColumnReader(int propertyType, const QMetaObject *metaObject, const QVector<QMetaProperty> &properties, const QJsonTypeConverter::SerializationHelper *helper) :
+		_propertyType{propertyType},
+		_metaObject{metaObject},
+		_properties{properties},
+		_helper{helper}
+	{}
+
+	QVariant read(const QJsonArray &row, QObject *parent) const override {
+		Q_UNUSED(parent)//gadgets neither have nor serve as parent
+		void *gadgetPtr = nullptr;
+		auto gadget = create(_propertyType, _metaObject, gadgetPtr);
+		for(auto i = 0; i < _properties.size(); ++i) {
+			const auto &property = _properties[i];
+			if(property.isValid())
+				property.writeOnGadget(gadgetPtr, _helper->deserializeSubtype(property, row[i], nullptr));
+		}
+		return gadget;
+	}
+
+private:
+	const int _propertyType;
+	const QMetaObject * const _metaObject;
+	// invalid for extra columns, which are ignored
+	const QVector<QMetaProperty> _properties;
+	const QJsonTypeConverter::SerializationHelper * const _helper;
+};
+
+}
 
 bool QJsonGadgetConverter::canConvert(int metaTypeId) const
 {
@@ -28,30 +121,21 @@ QList<QJsonValue::Type> QJsonGadgetConverter::jsonTypes() const
 
 QJsonValue QJsonGadgetConverter::serialize(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
 {
-	const auto metaObject = QMetaType::metaObjectForType(propertyType);
-	if(!metaObject)
-		throw QJsonSerializationException(QByteArray("Unable to get metaobject for type ") + QMetaType::typeName(propertyType));
-	const auto isPtr = QMetaType::typeFlags(propertyType).testFlag(QMetaType::PointerToGadget);
-
-	auto gValue = value;
-	if(!gValue.convert(propertyType))
-		throw QJsonSerializationException(QByteArray("Data is not of the required gadget type ") + QMetaType::typeName(propertyType));
-	const void *gadget = nullptr;
-	if(isPtr) {
-		// with pointers, null gadgets are allowed
-		gadget = *reinterpret_cast<const void* const *>(gValue.constData());
-		if(!gadget)
-			return QJsonValue::Null;
-	} else
-		gadget = gValue.constData();
+	const QMetaObject *metaObject = nullptr;
+	const auto gValue = prepare(propertyType, value, metaObject);
+	const auto gadget = address(propertyType, gValue);
 	if(!gadget)
-		throw QJsonSerializationException(QByteArray("Unable to get address of gadget ") + QMetaType::typeName(propertyType));
+		return QJsonValue::Null;
 
 	QJsonObject jsonObject;
 	//go through all properties and try to serialize them
 	for(auto i = 0; i < metaObject->propertyCount(); i++) {
 		auto property = metaObject->property(i);
-		if(property.isStored())
+		if(!property.isStored())
+			continue;
+		// unselected properties are not even read
+		QJsonFieldSelectorContext::Step step{property.name()};
+		if(step.isSelected())
 			jsonObject[QString::fromUtf8(property.name())] = helper->serializeSubtype(property, property.readOnGadget(gadget));
 	}
 
@@ -67,64 +151,166 @@ QVariant QJsonGadgetConverter::deserialize(int propertyType, const QJsonValue &v
 	if(!metaObject)
 		throw QJsonDeserializationException(QByteArray("Unable to get metaobject for gadget type") + QMetaType::typeName(propertyType));
 
-	QVariant gadget;
-	void *gadgetPtr = nullptr;
-	if(isPtr) {
-		if(value.isNull())
+	if(value.isNull()) {
+		if(isPtr)
 			return QVariant{propertyType, nullptr}; //initialize an empty (nullptr) variant
-		const auto gadgetType = QMetaType::type(metaObject->className());
-		if(gadgetType == QMetaType::UnknownType)
-			throw QJsonDeserializationException(QByteArray("Unable to get type of gadget from gadget-pointer type") + QMetaType::typeName(propertyType));
-		gadgetPtr = QMetaType::create(gadgetType);
-		gadget = QVariant{propertyType, &gadgetPtr};
-	} else {
-		if(value.isNull())
+		else
 			return QVariant{}; //will trigger a fail next stage as nullptr is not convertible to a gadget
-		gadget = QVariant{propertyType, nullptr};
-		gadgetPtr = gadget.data();
 	}
 
-	if(!gadgetPtr) {
-		throw QJsonDeserializationException(QByteArray("Failed to construct gadget of type ") +
-											QMetaType::typeName(propertyType) +
-											QByteArray(". Does is have a default constructor?"));
-	}
+	void *gadgetPtr = nullptr;
+	auto gadget = create(propertyType, metaObject, gadgetPtr);
 
 	auto jsonObject = value.toObject();
-	auto validationFlags = helper->getProperty("validationFlags").value<QJsonSerializer::ValidationFlags>();
+	auto validationFlags = QJsonSerializerPrivate::callOptions(helper).validationFlags();
 
-	//collect required properties, if set
-	QSet<QByteArray> reqProps;
+	//collect required properties, if set (flags by property index, to avoid allocations)
+	QVarLengthArray<bool, 64> reqProps;
 	if(validationFlags.testFlag(QJsonSerializer::AllProperties)) {
+		reqProps.resize(metaObject->propertyCount());
 		for(auto i = 0; i < metaObject->propertyCount(); i++) {
 			auto property = metaObject->property(i);
-			if(property.isStored())
-				reqProps.insert(property.name());
+			reqProps[i] = property.isStored() && QJsonFieldSelectorContext::isSelected(property.name());
 		}
 	}
 
 	//now deserialize all json properties
 	for(auto it = jsonObject.constBegin(); it != jsonObject.constEnd(); it++) {
-		auto propIndex = metaObject->indexOfProperty(qUtf8Printable(it.key()));
+		//skip fields that are not selected, without deserializing them
+		QJsonFieldSelectorContext::Step step{it.key()};
+		if(!step.isSelected())
+			continue;
+		const auto key = it.key().toUtf8();
+		auto propIndex = metaObject->indexOfProperty(key.constData());
 		if(propIndex != -1) {
 			auto property = metaObject->property(propIndex);
 			auto subValue = helper->deserializeSubtype(property, it.value(), nullptr);
 			property.writeOnGadget(gadgetPtr, subValue);
-			reqProps.remove(property.name());
+			if(propIndex < reqProps.size())
+				reqProps[propIndex] = false;
 		} else if(validationFlags.testFlag(QJsonSerializer::NoExtraProperties)) {
 			throw QJsonDeserializationException("Found extra property " +
-												it.key().toUtf8() +
+												key +
 												" but extra properties are not allowed");
 		}
 	}
 
 	//make shure all required properties have been read
-	if(validationFlags.testFlag(QJsonSerializer::AllProperties) && !reqProps.isEmpty()) {
-		throw QJsonDeserializationException(QByteArray("Not all properties for ") +
-											metaObject->className() +
-											QByteArray(" are present in the json object. Missing properties: ") +
-											reqProps.toList().join(", "));
+	if(validationFlags.testFlag(QJsonSerializer::AllProperties)) {
+		QByteArrayList missing;
+		for(auto i = 0; i < reqProps.size(); i++) {
+			if(reqProps[i])
+				missing.append(metaObject->property(i).name());
+		}
+		if(!missing.isEmpty()) {
+			throw QJsonDeserializationException(QByteArray("Not all properties for ") +
+												metaObject->className() +
+												QByteArray(" are present in the json object. Missing properties: ") +
+												missing.join(", "));
+		}
 	}
 
 	return gadget;
 }
+
+QJsonValueProducer::Frame *QJsonGadgetConverter::createFrame(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
+{
+	Q_UNUSED(helper)
+	const QMetaObject *metaObject = nullptr;
+	const auto gValue = prepare(propertyType, value, metaObject);
+	const auto gadget = address(propertyType, gValue);
+	if(!gadget)
+		return nullptr;
+
+	QMap<QString, QJsonPropertyFrame::Member> members;
+	for(auto i = 0; i < metaObject->propertyCount(); i++) {
+		auto property = metaObject->property(i);
+		if(property.isStored() && QJsonFieldSelectorContext::isSelected(property.name()))
+			members.insert(QString::fromUtf8(property.name()), {i, {}});
+	}
+	return new GadgetFrame{propertyType, gValue, metaObject, members};
+}
+
+QVariant QJsonGadgetConverter::prepare(int propertyType, const QVariant &value, const QMetaObject *&metaObject) const
+{
+	metaObject = QMetaType::metaObjectForType(propertyType);
+	if(!metaObject)
+		throw QJsonSerializationException(QByteArray("Unable to get metaobject for type ") + QMetaType::typeName(propertyType));
+
+	const auto gValue = convertedValue(value, propertyType);
+	if(!gValue.isValid())
+		throw QJsonSerializationException(QByteArray("Data is not of the required gadget type ") + QMetaType::typeName(propertyType));
+	return gValue;
+}
+
+QJsonColumnReader *QJsonGadgetConverter::createColumnReader(int propertyType, const QStringList &columns, const QJsonTypeConverter::SerializationHelper *helper) const
+{
+	auto metaObject = QMetaType::metaObjectForType(propertyType);
+	if(!metaObject)
+		return nullptr;
+	auto validationFlags = QJsonSerializerPrivate::callOptions(helper).validationFlags();
+
+	// the same validation as for each object, but only once for all rows
+	QVector<QMetaProperty> properties;
+	properties.reserve(columns.size());
+	for(const auto &column : columns) {
+		const auto key = column.toUtf8();
+		auto propIndex = metaObject->indexOfProperty(key.constData());
+		if(propIndex != -1)
+			properties.append(metaObject->property(propIndex));
+		else if(validationFlags.testFlag(QJsonSerializer::NoExtraProperties)) {
+			throw QJsonDeserializationException("Found extra property " +
+												key +
+												" but extra properties are not allowed");
+		} else
+			properties.append(QMetaProperty{});
+	}
+
+	if(validationFlags.testFlag(QJsonSerializer::AllProperties)) {
+		QByteArrayList missing;
+		for(auto i = 0; i < metaObject->propertyCount(); i++) {
+			auto property = metaObject->property(i);
+			if(property.isStored() && !columns.contains(QString::fromUtf8(property.name())))
+				missing.append(property.name());
+		}
+		if(!missing.isEmpty()) {
+			throw QJsonDeserializationException(QByteArray("Not all properties for ") +
+												metaObject->className() +
+												QByteArray(" are present in the json object. Missing properties: ") +
+												missing.join(", "));
+		}
+	}
+
+	return new GadgetColumnReader{propertyType, metaObject, properties, helper};
+}
+
+bool QJsonGadgetConverter::columnProperties(int propertyType, const QJsonTypeConverter::SerializationHelper *helper, QVector<QMetaProperty> &properties) const
+{
+	Q_UNUSED(helper)
+	auto metaObject = QMetaType::metaObjectForType(propertyType);
+	if(!metaObject)
+		return false;
+	for(auto i = 0; i < metaObject->propertyCount(); i++) {
+		auto property = metaObject->property(i);
+		if(property.isStored())
+			properties.append(property);
+	}
+	return true;
+}
+
+bool QJsonGadgetConverter::writeRow(int propertyType, const QVariant &value, const QVector<QMetaProperty> &properties, const QJsonTypeConverter::SerializationHelper *helper, QJsonValue &row) const
+{
+	const QMetaObject *metaObject = nullptr;
+	const auto gValue = prepare(propertyType, value, metaObject);
+	const auto gadget = address(propertyType, gValue);
+	if(!gadget) {
+		row = QJsonValue::Null;
+		return true;
+	}
+
+	QJsonArray values;
+	for(const auto &property : properties)
+		values.append(helper->serializeSubtype(property, property.readOnGadget(gadget)));
+	row = values;
+	return true;
+}
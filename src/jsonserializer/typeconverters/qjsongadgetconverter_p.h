@@ -3,14 +3,23 @@
 
 #include "qtjsonserializer_global.h"
 #include "qjsontypeconverter.h"
+#include "qjsonvalueproducer_p.h"
+#include "qjsoncolumnreader_p.h"
 
-class Q_JSONSERIALIZER_EXPORT QJsonGadgetConverter : public QJsonTypeConverter
+class Q_JSONSERIALIZER_EXPORT QJsonGadgetConverter : public QJsonTypeConverter, public QJsonMemberConverter, public QJsonColumnConverter
 {
 public:
 	bool canConvert(int metaTypeId) const override;
 	QList<QJsonValue::Type> jsonTypes() const override;
 	QJsonValue serialize(int propertyType, const QVariant &value, const SerializationHelper *helper) const override;
 	QVariant deserialize(int propertyType, const QJsonValue &value, QObject *parent, const SerializationHelper *helper) const override;
+	QJsonValueProducer::Frame *createFrame(int propertyType, const QVariant &value, const SerializationHelper *helper) const override;
+	QJsonColumnReader *createColumnReader(int propertyType, const QStringList &columns, const SerializationHelper *helper) const override;
+	bool columnProperties(int propertyType, const SerializationHelper *helper, QVector<QMetaProperty> &properties) const override;
+	bool writeRow(int propertyType, const QVariant &value, const QVector<QMetaProperty> &properties, const SerializationHelper *helper, QJsonValue &row) const override;
+
+private:
+	QVariant prepare(int propertyType, const QVariant &value, const QMetaObject *&metaObject) const;
 };
 
 #endif // QJSONGADGETCONVERTER_P_H
@@ -1,12 +1,52 @@
 #include "qjsongeomconverter_p.h"
 #include "qjsonserializerexception.h"
+#include "qjsonserializer_p.h"
 
 #include <QtCore/QJsonObject>
+#include <QtCore/QJsonArray>
 #include <QtCore/QSize>
 #include <QtCore/QPoint>
 #include <QtCore/QLine>
 #include <QtCore/QRect>
 
+namespace {
+
+// reads the two members of an object that must contain exactly those two keys, without allocating a key list
+bool readMembers(const QJsonObject &object, QLatin1String key1, QLatin1String key2, QJsonValue &value1, QJsonValue &value2)
+{
+	if(object.size() != 2)
+		return false;
+	const auto it1 = object.constFind(key1);
+	if(it1 == object.constEnd())
+		return false;
+	const auto it2 = object.constFind(key2);
+	if(it2 == object.constEnd())
+		return false;
+	value1 = it1.value();
+	value2 = it2.value();
+	return true;
+}
+
+// reads a positional array of exactly count numbers
+template <int count>
+void readNumbers(const QJsonArray &array, QJsonValue (&values)[count], const char *format)
+{
+	if(array.size() != count)
+		throw QJsonDeserializationException(QByteArray("Json array must have exactly ") + QByteArray::number(count) + QByteArray(" elements: ") + format);
+	for(auto i = 0; i < count; ++i) {
+		values[i] = array.at(i);
+		if(!values[i].isDouble())
+			throw QJsonDeserializationException(QByteArray("Json array elements must be numbers: ") + format);
+	}
+}
+
+inline bool asArray(const QJsonTypeConverter::SerializationHelper *helper)
+{
+	return QJsonSerializerPrivate::callOptions(helper).geometryAsArray();
+}
+
+}
+
 bool QJsonSizeConverter::canConvert(int metaTypeId) const
 {
 	return metaTypeId == QMetaType::QSize ||
@@ -15,13 +55,11 @@ bool QJsonSizeConverter::canConvert(int metaTypeId) const
 
 QList<QJsonValue::Type> QJsonSizeConverter::jsonTypes() const
 {
-	return {QJsonValue::Object};
+	return {QJsonValue::Object, QJsonValue::Array};
 }
 
 QJsonValue QJsonSizeConverter::serialize(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
 {
-	Q_UNUSED(helper)
-
 	QJsonValue w;
 	QJsonValue h;
 	if(propertyType == QMetaType::QSize) {
@@ -35,6 +73,9 @@ QJsonValue QJsonSizeConverter::serialize(int propertyType, const QVariant &value
 	} else
 		throw QJsonSerializationException(QByteArray("Invalid metatype: ") + QMetaType::typeName(propertyType));
 
+	if(asArray(helper))
+		return QJsonArray{w, h};
+
 	QJsonObject object;
 	object[QStringLiteral("width")] = w;
 	object[QStringLiteral("height")] = h;
@@ -46,16 +87,19 @@ QVariant QJsonSizeConverter::deserialize(int propertyType, const QJsonValue &val
 	Q_UNUSED(parent)
 	Q_UNUSED(helper)
 
-	auto object = value.toObject();
-	if(object.keys().size() != 2 ||
-	   !object.keys().contains(QStringLiteral("width")) ||
-	   !object.keys().contains(QStringLiteral("height")))
-		throw QJsonDeserializationException("Json object has no width or height properties or does have extra properties");
-
-	auto w = object.value(QStringLiteral("width"));
-	auto h = object.value(QStringLiteral("height"));
-	if(!w.isDouble() || !h.isDouble())
-		throw QJsonDeserializationException("Object properties width and height must be numbers");
+	QJsonValue w;
+	QJsonValue h;
+	if(value.isArray()) {
+		QJsonValue values[2];
+		readNumbers(value.toArray(), values, "[width, height]");
+		w = values[0];
+		h = values[1];
+	} else {
+		if(!readMembers(value.toObject(), QLatin1String("width"), QLatin1String("height"), w, h))
+			throw QJsonDeserializationException("Json object has no width or height properties or does have extra properties");
+		if(!w.isDouble() || !h.isDouble())
+			throw QJsonDeserializationException("Object properties width and height must be numbers");
+	}
 
 	if(propertyType == QMetaType::QSize)
 		return QSize(w.toInt(), h.toInt());
@@ -75,13 +119,11 @@ bool QJsonPointConverter::canConvert(int metaTypeId) const
 
 QList<QJsonValue::Type> QJsonPointConverter::jsonTypes() const
 {
-	return {QJsonValue::Object};
+	return {QJsonValue::Object, QJsonValue::Array};
 }
 
 QJsonValue QJsonPointConverter::serialize(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
 {
-	Q_UNUSED(helper)
-
 	QJsonValue x;
 	QJsonValue y;
 	if(propertyType == QMetaType::QPoint) {
@@ -95,6 +137,9 @@ QJsonValue QJsonPointConverter::serialize(int propertyType, const QVariant &valu
 	} else
 		throw QJsonSerializationException(QByteArray("Invalid metatype: ") + QMetaType::typeName(propertyType));
 
+	if(asArray(helper))
+		return QJsonArray{x, y};
+
 	QJsonObject object;
 	object[QStringLiteral("x")] = x;
 	object[QStringLiteral("y")] = y;
@@ -106,16 +151,19 @@ QVariant QJsonPointConverter::deserialize(int propertyType, const QJsonValue &va
 	Q_UNUSED(parent)
 	Q_UNUSED(helper)
 
-	auto object = value.toObject();
-	if(object.keys().size() != 2 ||
-	   !object.keys().contains(QStringLiteral("x")) ||
-	   !object.keys().contains(QStringLiteral("y")))
-		throw QJsonDeserializationException("Json object has no x or y properties or does have extra properties");
-
-	auto x = object.value(QStringLiteral("x"));
-	auto y = object.value(QStringLiteral("y"));
-	if(!x.isDouble() || !y.isDouble())
-		throw QJsonDeserializationException("Object properties x and y must be numbers");
+	QJsonValue x;
+	QJsonValue y;
+	if(value.isArray()) {
+		QJsonValue values[2];
+		readNumbers(value.toArray(), values, "[x, y]");
+		x = values[0];
+		y = values[1];
+	} else {
+		if(!readMembers(value.toObject(), QLatin1String("x"), QLatin1String("y"), x, y))
+			throw QJsonDeserializationException("Json object has no x or y properties or does have extra properties");
+		if(!x.isDouble() || !y.isDouble())
+			throw QJsonDeserializationException("Object properties x and y must be numbers");
+	}
 
 	if(propertyType == QMetaType::QPoint)
 		return QPoint(x.toInt(), y.toInt());
@@ -133,21 +181,33 @@ bool QJsonLineConverter::canConvert(int metaTypeId) const
 
 QList<QJsonValue::Type> QJsonLineConverter::jsonTypes() const
 {
-	return {QJsonValue::Object};
+	return {QJsonValue::Object, QJsonValue::Array};
 }
 
 QJsonValue QJsonLineConverter::serialize(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
 {
+	// array: [x1, y1, x2, y2] - the points are written directly, without going through the point converter
+	if(asArray(helper)) {
+		if(propertyType == QMetaType::QLine) {
+			auto line = value.toLine();
+			return QJsonArray{line.x1(), line.y1(), line.x2(), line.y2()};
+		} else if(propertyType == QMetaType::QLineF) {
+			auto line = value.toLineF();
+			return QJsonArray{line.x1(), line.y1(), line.x2(), line.y2()};
+		} else
+			throw QJsonSerializationException(QByteArray("Invalid metatype: ") + QMetaType::typeName(propertyType));
+	}
+
 	QJsonValue p1;
 	QJsonValue p2;
 	if(propertyType == QMetaType::QLine) {
 		auto line = value.toLine();
-		p1 = helper->serializeSubtype(QMetaType::QPoint, line.p1(), "p1");
-		p2 = helper->serializeSubtype(QMetaType::QPoint, line.p2(), "p2");
+		p1 = helper->serializeSubtype(QMetaType::QPoint, line.p1(), QByteArrayLiteral("p1"));
+		p2 = helper->serializeSubtype(QMetaType::QPoint, line.p2(), QByteArrayLiteral("p2"));
 	} else if(propertyType == QMetaType::QLineF) {
 		auto line = value.toLineF();
-		p1 = helper->serializeSubtype(QMetaType::QPointF, line.p1(), "p1");
-		p2 = helper->serializeSubtype(QMetaType::QPointF, line.p2(), "p2");
+		p1 = helper->serializeSubtype(QMetaType::QPointF, line.p1(), QByteArrayLiteral("p1"));
+		p2 = helper->serializeSubtype(QMetaType::QPointF, line.p2(), QByteArrayLiteral("p2"));
 	} else
 		throw QJsonSerializationException(QByteArray("Invalid metatype: ") + QMetaType::typeName(propertyType));
 
@@ -159,21 +219,29 @@ QJsonValue QJsonLineConverter::serialize(int propertyType, const QVariant &value
 
 QVariant QJsonLineConverter::deserialize(int propertyType, const QJsonValue &value, QObject *parent, const QJsonTypeConverter::SerializationHelper *helper) const
 {
-	auto object = value.toObject();
-	if(object.keys().size() != 2 ||
-	   !object.keys().contains(QStringLiteral("p1")) ||
-	   !object.keys().contains(QStringLiteral("p2")))
+	if(value.isArray()) {
+		QJsonValue values[4];
+		readNumbers(value.toArray(), values, "[x1, y1, x2, y2]");
+		if(propertyType == QMetaType::QLine)
+			return QLine(values[0].toInt(), values[1].toInt(), values[2].toInt(), values[3].toInt());
+		else if(propertyType == QMetaType::QLineF)
+			return QLineF(values[0].toDouble(), values[1].toDouble(), values[2].toDouble(), values[3].toDouble());
+		else
+			throw QJsonDeserializationException(QByteArray("Invalid metatype: ") + QMetaType::typeName(propertyType));
+	}
+
+	QJsonValue v1;
+	QJsonValue v2;
+	if(!readMembers(value.toObject(), QLatin1String("p1"), QLatin1String("p2"), v1, v2))
 		throw QJsonDeserializationException("Json object has no p1 or p2 properties or does have extra properties");
 
-	auto v1 = object.value(QStringLiteral("p1"));
-	auto v2 = object.value(QStringLiteral("p2"));
 	if(propertyType == QMetaType::QLine) {
-		auto p1 = helper->deserializeSubtype(QMetaType::QPoint, v1, parent, "p1");
-		auto p2 = helper->deserializeSubtype(QMetaType::QPoint, v2, parent, "p1");
+		auto p1 = helper->deserializeSubtype(QMetaType::QPoint, v1, parent, QByteArrayLiteral("p1"));
+		auto p2 = helper->deserializeSubtype(QMetaType::QPoint, v2, parent, QByteArrayLiteral("p2"));
 		return QLine(p1.toPoint(), p2.toPoint());
 	} else if(propertyType == QMetaType::QLineF) {
-		auto p1 = helper->deserializeSubtype(QMetaType::QPointF, v1, parent, "p1");
-		auto p2 = helper->deserializeSubtype(QMetaType::QPointF, v2, parent, "p1");
+		auto p1 = helper->deserializeSubtype(QMetaType::QPointF, v1, parent, QByteArrayLiteral("p1"));
+		auto p2 = helper->deserializeSubtype(QMetaType::QPointF, v2, parent, QByteArrayLiteral("p2"));
 		return QLineF(p1.toPointF(), p2.toPointF());
 	} else
 		throw QJsonDeserializationException(QByteArray("Invalid metatype: ") + QMetaType::typeName(propertyType));
@@ -187,21 +255,33 @@ bool QJsonRectConverter::canConvert(int metaTypeId) const
 
 QList<QJsonValue::Type> QJsonRectConverter::jsonTypes() const
 {
-	return {QJsonValue::Object};
+	return {QJsonValue::Object, QJsonValue::Array};
 }
 
 QJsonValue QJsonRectConverter::serialize(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
 {
+	// array: [x, y, width, height]
+	if(asArray(helper)) {
+		if(propertyType == QMetaType::QRect) {
+			auto rect = value.toRect();
+			return QJsonArray{rect.x(), rect.y(), rect.width(), rect.height()};
+		} else if(propertyType == QMetaType::QRectF) {
+			auto rect = value.toRectF();
+			return QJsonArray{rect.x(), rect.y(), rect.width(), rect.height()};
+		} else
+			throw QJsonSerializationException(QByteArray("Invalid metatype: ") + QMetaType::typeName(propertyType));
+	}
+
 	QJsonValue p1;
 	QJsonValue p2;
 	if(propertyType == QMetaType::QRect) {
 		auto rect = value.toRect();
-		p1 = helper->serializeSubtype(QMetaType::QPoint, rect.topLeft(), "topLeft");
-		p2 = helper->serializeSubtype(QMetaType::QPoint, rect.bottomRight(), "bottomRight");
+		p1 = helper->serializeSubtype(QMetaType::QPoint, rect.topLeft(), QByteArrayLiteral("topLeft"));
+		p2 = helper->serializeSubtype(QMetaType::QPoint, rect.bottomRight(), QByteArrayLiteral("bottomRight"));
 	} else if(propertyType == QMetaType::QRectF) {
 		auto rect = value.toRectF();
-		p1 = helper->serializeSubtype(QMetaType::QPointF, rect.topLeft(), "topLeft");
-		p2 = helper->serializeSubtype(QMetaType::QPointF, rect.bottomRight(), "bottomRight");
+		p1 = helper->serializeSubtype(QMetaType::QPointF, rect.topLeft(), QByteArrayLiteral("topLeft"));
+		p2 = helper->serializeSubtype(QMetaType::QPointF, rect.bottomRight(), QByteArrayLiteral("bottomRight"));
 	} else
 		throw QJsonSerializationException(QByteArray("Invalid metatype: ") + QMetaType::typeName(propertyType));
 
@@ -213,21 +293,29 @@ QJsonValue QJsonRectConverter::serialize(int propertyType, const QVariant &value
 
 QVariant QJsonRectConverter::deserialize(int propertyType, const QJsonValue &value, QObject *parent, const QJsonTypeConverter::SerializationHelper *helper) const
 {
-	auto object = value.toObject();
-	if(object.keys().size() != 2 ||
-	   !object.keys().contains(QStringLiteral("topLeft")) ||
-	   !object.keys().contains(QStringLiteral("bottomRight")))
+	if(value.isArray()) {
+		QJsonValue values[4];
+		readNumbers(value.toArray(), values, "[x, y, width, height]");
+		if(propertyType == QMetaType::QRect)
+			return QRect(values[0].toInt(), values[1].toInt(), values[2].toInt(), values[3].toInt());
+		else if(propertyType == QMetaType::QRectF)
+			return QRectF(values[0].toDouble(), values[1].toDouble(), values[2].toDouble(), values[3].toDouble());
+		else
+			throw QJsonDeserializationException(QByteArray("Invalid metatype: ") + QMetaType::typeName(propertyType));
+	}
+
+	QJsonValue v1;
+	QJsonValue v2;
+	if(!readMembers(value.toObject(), QLatin1String("topLeft"), QLatin1String("bottomRight"), v1, v2))
 		throw QJsonDeserializationException("Json object has no topLeft or bottomRight properties or does have extra properties");
 
-	auto v1 = object.value(QStringLiteral("topLeft"));
-	auto v2 = object.value(QStringLiteral("bottomRight"));
 	if(propertyType == QMetaType::QRect) {
-		auto topLeft = helper->deserializeSubtype(QMetaType::QPoint, v1, parent, "topLeft");
-		auto bottomRight = helper->deserializeSubtype(QMetaType::QPoint, v2, parent, "bottomRight");
+		auto topLeft = helper->deserializeSubtype(QMetaType::QPoint, v1, parent, QByteArrayLiteral("topLeft"));
+		auto bottomRight = helper->deserializeSubtype(QMetaType::QPoint, v2, parent, QByteArrayLiteral("bottomRight"));
 		return QRect(topLeft.toPoint(), bottomRight.toPoint());
 	} else if(propertyType == QMetaType::QRectF) {
-		auto topLeft = helper->deserializeSubtype(QMetaType::QPointF, v1, parent, "topLeft");
-		auto bottomRight = helper->deserializeSubtype(QMetaType::QPointF, v2, parent, "bottomRight");
+		auto topLeft = helper->deserializeSubtype(QMetaType::QPointF, v1, parent, QByteArrayLiteral("topLeft"));
+		auto bottomRight = helper->deserializeSubtype(QMetaType::QPointF, v2, parent, QByteArrayLiteral("bottomRight"));
 		return QRectF(topLeft.toPointF(), bottomRight.toPointF());
 	} else
 		throw QJsonDeserializationException(QByteArray("Invalid metatype: ") + QMetaType::typeName(propertyType));
@@ -0,0 +1,83 @@
+#include "qjsonlazyconverter_p.h"
+#include "qjsonserializerexception.h"
+#include "qjsonlazy.h"
+#include "qjsonmsgpack_p.h"
+#include "qjsonfieldselector_p.h"
+#include "qjsonreferencecontext_p.h"
+#include "qjsonattachment_p.h"
+
+const QRegularExpression QJsonLazyConverter::lazyTypeRegex(QStringLiteral(R"__(^QJsonLazy<\s*(.*?)\s*>$)__"));
+
+bool QJsonLazyConverter::canConvert(int metaTypeId) const
+{
+	return lazyTypeRegex.match(QString::fromUtf8(getCanonicalTypeName(metaTypeId))).hasMatch();
+}
+
+QList<QJsonValue::Type> QJsonLazyConverter::jsonTypes() const
+{
+	// the value type decides which json it accepts, so any json is kept until the value is loaded
+	return {
+		QJsonValue::Null,
+		QJsonValue::Bool,
+		QJsonValue::Double,
+		QJsonValue::String,
+		QJsonValue::Array,
+		QJsonValue::Object
+	};
+}
+
+QJsonValue QJsonLazyConverter::serialize(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
+{
+	const auto cValue = convertedValue(value, qMetaTypeId<QJsonLazyBase>());
+	if(!cValue.isValid()) {
+		throw QJsonSerializationException(QByteArray("Failed to convert type ") +
+										  QMetaType::typeName(propertyType) +
+										  QByteArray(" to QJsonLazyBase. Make shure to register lazy types via QJsonSerializer::registerLazyConverters"));
+	}
+
+	const auto lazy = cValue.value<QJsonLazyBase>();
+	// values that were never accessed are written back as they were read
+	if(!lazy.isLoaded())
+		return QJsonFieldSelectorContext::select(lazy.json());
+	const auto variant = lazy.variant();
+	if(!variant.isValid())
+		return QJsonValue::Null;
+	return helper->serializeSubtype(getValueType(propertyType), variant, QByteArrayLiteral("lazy"));
+}
+
+QVariant QJsonLazyConverter::deserialize(int propertyType, const QJsonValue &value, QObject *parent, const QJsonTypeConverter::SerializationHelper *helper) const
+{
+	const auto valueType = getValueType(propertyType);
+	if(valueType == QMetaType::UnknownType) {
+		throw QJsonDeserializationException(QByteArray("Unable to find the value type of ") +
+											QMetaType::typeName(propertyType));
+	}
+
+	// MessagePack natives, attachments, field selections and object references only exist during this call, so
+	// such values are loaded directly
+	QJsonLazyBase lazy;
+	if(QJsonMsgPackContext::current() ||
+	   QJsonAttachmentContext::current() ||
+	   QJsonFieldSelectorContext::hasSelection() ||
+	   QJsonReferenceContext::current())
+		lazy = QJsonLazyBase{helper->deserializeSubtype(valueType, value, parent, QByteArrayLiteral("lazy"))};
+	else
+		lazy = QJsonLazyBase{valueType, value, parent, helper};
+
+	auto result = QVariant::fromValue(lazy);
+	if(!result.convert(propertyType)) {
+		throw QJsonDeserializationException(QByteArray("Failed to convert QJsonLazyBase to type ") +
+											QMetaType::typeName(propertyType) +
+											QByteArray(". Make shure to register lazy types via QJsonSerializer::registerLazyConverters"));
+	}
+	return result;
+}
+
+int QJsonLazyConverter::getValueType(int metaType) const
+{
+	auto match = lazyTypeRegex.match(QString::fromUtf8(getCanonicalTypeName(metaType)));
+	if(match.hasMatch())
+		return QMetaType::type(match.captured(1).toUtf8().trimmed());
+	else
+		return QMetaType::UnknownType;
+}
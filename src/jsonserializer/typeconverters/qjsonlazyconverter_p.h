@@ -0,0 +1,23 @@
+#ifndef QJSONLAZYCONVERTER_P_H
+#define QJSONLAZYCONVERTER_P_H
+
+#include "qtjsonserializer_global.h"
+#include "qjsontypeconverter.h"
+
+#include <QtCore/QRegularExpression>
+
+class Q_JSONSERIALIZER_EXPORT QJsonLazyConverter : public QJsonTypeConverter
+{
+public:
+	bool canConvert(int metaTypeId) const override;
+	QList<QJsonValue::Type> jsonTypes() const override;
+	QJsonValue serialize(int propertyType, const QVariant &value, const SerializationHelper *helper) const override;
+	QVariant deserialize(int propertyType, const QJsonValue &value, QObject *parent, const SerializationHelper *helper) const override;
+
+private:
+	static const QRegularExpression lazyTypeRegex;
+
+	int getValueType(int metaType) const;
+};
+
+#endif // QJSONLAZYCONVERTER_P_H
@@ -1,7 +1,50 @@
 #include "qjsonlistconverter_p.h"
 #include "qjsonserializerexception.h"
+#include "qjsonserializer_p.h"
+#include "qjsonfieldselector_p.h"
+#include "qjsonexceptioncontext_p.h"
+#include "qjsonasync_p.h"
+#include "qjsoncolumnreader_p.h"
 
 #include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QScopedPointer>
+
+namespace {
+
+const QLatin1String ColumnsKey{"@columns"};
+const QLatin1String RowsKey{"@rows"};
+
+// the elements of a list, or only the selected ones of them
+class ListFrame : public QJsonValueProducer::Frame
+{
+public:
+	ListFrame(int metaType, const QVariantList &list, const QVector<int> &selected, bool isFiltered) :
+		Frame{false, isFiltered ? selected.size() : list.size()},
+		_metaType{metaType},
+		_list{list},
+		_selected{selected},
+		_isFiltered{isFiltered}
+	{
+		_hint.reserve(16);
+	}
+
+	void produce(QJsonValueProducer *producer, int index) override {
+		const auto element = _isFiltered ? _selected[index] : index;
+		QJsonFieldSelectorContext::Step step{element};
+		QJsonExceptionContext::indexHint(_hint, element, '[', ']');
+		producer->produceSubtype(_metaType, _list.at(element), _hint);
+	}
+
+private:
+	const int _metaType;
+	const QVariantList _list;
+	const QVector<int> _selected;
+	const bool _isFiltered;
+	QByteArray _hint;
+};
+
+}
 
 const QRegularExpression QJsonListConverter::listTypeRegex(QStringLiteral(R"__(^(?:QList|QLinkedList|QVector|QStack|QQueue|QSet)<\s*(.*?)\s*>$)__"));
 
@@ -21,17 +64,19 @@ QJsonValue QJsonListConverter::serialize(int propertyType, const QVariant &value
 {
 	auto metaType = getSubtype(propertyType);
 
-	auto cValue = value;
-	if(!cValue.convert(QVariant::List)) {
-		throw QJsonSerializationException(QByteArray("Failed to convert type ") +
-										  QMetaType::typeName(propertyType) +
-										  QByteArray(" to a variant list. Make shure to register list types via QJsonSerializer::registerListConverters (or QJsonSerializer::registerSetConverters)"));
-	}
-
 	QJsonArray array;
+	QByteArray hint;
+	hint.reserve(16);
 	auto index = 0;
-	for(const auto &element : cValue.toList())
-		array.append(helper->serializeSubtype(metaType, element, "[" + QByteArray::number(index++) + "]"));
+	for(const auto &element : toList(propertyType, value)) {
+		QJsonFieldSelectorContext::Step step{index};
+		if(step.isSelected()) {
+			QJsonExceptionContext::indexHint(hint, index, '[', ']');
+			array.append(helper->serializeSubtype(metaType, element, hint));
+		}
+		++index;
+	}
+
 	return array;
 }
 
@@ -40,13 +85,40 @@ QVariant QJsonListConverter::deserialize(int propertyType, const QJsonValue &val
 	auto metaType = getSubtype(propertyType);
 
 	//generate the list
+	const auto array = value.toArray();
 	QVariantList list;
+	list.reserve(array.size());
+	QByteArray hint;
+	hint.reserve(16);
 	auto index = 0;
-	for(auto element : value.toArray())
-		list.append(helper->deserializeSubtype(metaType, element, parent, "[" + QByteArray::number(index++) + "]"));
+	for(auto element : array) {
+		QJsonFieldSelectorContext::Step step{index};
+		if(step.isSelected()) {
+			QJsonExceptionContext::indexHint(hint, index, '[', ']');
+			list.append(helper->deserializeSubtype(metaType, element, parent, hint));
+		}
+		++index;
+	}
 	return list;
 }
 
+QJsonValueProducer::Frame *QJsonListConverter::createFrame(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
+{
+	Q_UNUSED(helper)
+	auto metaType = getSubtype(propertyType);
+	const auto list = toList(propertyType, value);
+	QVector<int> selected;
+	if(QJsonFieldSelectorContext::hasSelection()) {
+		for(auto index = 0; index < list.size(); ++index) {
+			QJsonFieldSelectorContext::Step step{index};
+			if(step.isSelected())
+				selected.append(index);
+		}
+		return new ListFrame{metaType, list, selected, true};
+	} else
+		return new ListFrame{metaType, list, selected, false};
+}
+
 int QJsonListConverter::getSubtype(int listType) const
 {
 	int metaType = QMetaType::UnknownType;
@@ -60,3 +132,205 @@ int QJsonListConverter::getSubtype(int listType) const
 
 	return metaType;
 }
+
+QVariantList QJsonListConverter::toList(int propertyType, const QVariant &value) const
+{
+	const auto cValue = convertedValue(value, QMetaType::QVariantList);
+	if(!cValue.isValid()) {
+		throw QJsonSerializationException(QByteArray("Failed to convert type ") +
+										  QMetaType::typeName(propertyType) +
+										  QByteArray(" to a variant list. Make shure to register list types via QJsonSerializer::registerListConverters (or QJsonSerializer::registerSetConverters)"));
+	}
+	return cValue.toList();
+}
+
+
+
+bool QJsonColumnListConverter::canConvert(int metaTypeId) const
+{
+	if(!QJsonListConverter::canConvert(metaTypeId))
+		return false;
+	const auto flags = QMetaType::typeFlags(getSubtype(metaTypeId));
+	return flags.testFlag(QMetaType::IsGadget) ||
+			flags.testFlag(QMetaType::PointerToGadget) ||
+			flags.testFlag(QMetaType::PointerToQObject);
+}
+
+QList<QJsonValue::Type> QJsonColumnListConverter::jsonTypes() const
+{
+	return {QJsonValue::Array, QJsonValue::Object};
+}
+
+QJsonValue QJsonColumnListConverter::serialize(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
+{
+	if(!QJsonSerializerPrivate::callOptions(helper).columnarLists())
+		return QJsonListConverter::serialize(propertyType, value, helper);
+
+	QJsonValue json;
+	if(writeColumns(getSubtype(propertyType), toList(propertyType, value), helper, json))
+		return json;
+
+	// elements that are not written by a column writer are transposed from their json objects
+	const auto array = QJsonListConverter::serialize(propertyType, value, helper).toArray();
+	QJsonObject columnObject;
+	if(toColumns(array, columnObject))
+		return columnObject;
+	return array;
+}
+
+QVariant QJsonColumnListConverter::deserialize(int propertyType, const QJsonValue &value, QObject *parent, const QJsonTypeConverter::SerializationHelper *helper) const
+{
+	if(value.isObject())
+		return fromColumns(getSubtype(propertyType), value.toObject(), parent, helper);
+	return QJsonListConverter::deserialize(propertyType, value, parent, helper);
+}
+
+QJsonValueProducer::Frame *QJsonColumnListConverter::createFrame(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
+{
+	// columnar lists are written as a whole
+	if(QJsonSerializerPrivate::callOptions(helper).columnarLists())
+		return nullptr;
+	return QJsonListConverter::createFrame(propertyType, value, helper);
+}
+
+bool QJsonColumnListConverter::writeColumns(int metaType, const QVariantList &list, const QJsonTypeConverter::SerializationHelper *helper, QJsonValue &json) const
+{
+	QScopedPointer<QJsonColumnWriter> writer{QJsonColumnWriter::create(metaType, helper)};
+	if(!writer)
+		return false;
+
+	QJsonArray rows;
+	auto hasRow = false;
+	QByteArray hint;
+	hint.reserve(16);
+	auto index = 0;
+	for(const auto &element : list) {
+		QJsonExceptionContext::indexHint(hint, index++, '[', ']');
+		QJsonExceptionContext context{metaType, hint};
+		QJsonAsyncContext::checkpoint();
+		QJsonValue row;
+		if(!writer->write(element, row))
+			return false;
+		hasRow = hasRow || !row.isNull();
+		rows.append(row);
+	}
+
+	// without a single element, there are no columns - a list of nulls stays an array
+	if(hasRow) {
+		json = QJsonObject {
+			{ColumnsKey, QJsonArray::fromStringList(writer->columns())},
+			{RowsKey, rows}
+		};
+	} else
+		json = rows;
+	return true;
+}
+
+bool QJsonColumnListConverter::toColumns(const QJsonArray &array, QJsonObject &columnObject) const
+{
+	// all elements must be objects with exactly the same keys (or null). As QJsonObject keeps its keys
+	// sorted, the keys of all elements are then iterated in the same order
+	QStringList columns;
+	auto hasColumns = false;
+	for(const auto element : array) {
+		if(element.isNull())
+			continue;
+		if(!element.isObject())
+			return false;
+		const auto object = element.toObject();
+		if(!hasColumns) {
+			columns = object.keys();
+			hasColumns = true;
+		} else {
+			if(object.size() != columns.size())
+				return false;
+			auto cIt = columns.constBegin();
+			for(auto it = object.constBegin(); it != object.constEnd(); ++it, ++cIt) {
+				if(it.key() != *cIt)
+					return false;
+			}
+		}
+	}
+	if(!hasColumns)
+		return false;
+
+	QJsonArray rows;
+	for(const auto element : array) {
+		if(element.isNull())
+			rows.append(QJsonValue::Null);
+		else {
+			const auto object = element.toObject();
+			QJsonArray row;
+			for(auto it = object.constBegin(); it != object.constEnd(); ++it)
+				row.append(it.value());
+			rows.append(row);
+		}
+	}
+
+	columnObject = QJsonObject {
+		{ColumnsKey, QJsonArray::fromStringList(columns)},
+		{RowsKey, rows}
+	};
+	return true;
+}
+
+QVariantList QJsonColumnListConverter::fromColumns(int metaType, const QJsonObject &columnObject, QObject *parent, const QJsonTypeConverter::SerializationHelper *helper) const
+{
+	const auto cIt = columnObject.constFind(ColumnsKey);
+	const auto rIt = columnObject.constFind(RowsKey);
+	if(columnObject.size() != 2 ||
+	   cIt == columnObject.constEnd() || !cIt->isArray() ||
+	   rIt == columnObject.constEnd() || !rIt->isArray())
+		throw QJsonDeserializationException("Json object for a list must be a columnar list with exactly the \"@columns\" and \"@rows\" keys");
+
+	QStringList columns;
+	for(const auto column : cIt->toArray()) {
+		if(!column.isString())
+			throw QJsonDeserializationException("The \"@columns\" of a columnar list must only contain strings");
+		columns.append(column.toString());
+	}
+
+	// the columns are resolved to properties once, with the first row - only if that is not possible, an object is created per row
+	QScopedPointer<QJsonColumnReader> reader;
+	auto hasReader = false;
+
+	const auto rows = rIt->toArray();
+	QVariantList list;
+	list.reserve(rows.size());
+	QByteArray hint;
+	hint.reserve(16);
+	auto index = 0;
+	for(const auto row : rows) {
+		QJsonFieldSelectorContext::Step step{index};
+		if(!step.isSelected()) {
+			++index;
+			continue;
+		}
+		QJsonExceptionContext::indexHint(hint, index++, '[', ']');
+
+		if(row.isNull()) {
+			list.append(helper->deserializeSubtype(metaType, QJsonValue::Null, parent, hint));
+			continue;
+		}
+
+		const auto values = row.toArray();
+		if(!row.isArray() || values.size() != columns.size())
+			throw QJsonDeserializationException("Each row of a columnar list must be null or an array with one value per column");
+		if(!hasReader) {
+			reader.reset(QJsonColumnReader::create(metaType, columns, helper));
+			hasReader = true;
+		}
+		if(reader) {
+			QJsonExceptionContext context{metaType, hint};
+			QJsonAsyncContext::checkpoint();
+			list.append(reader->read(values, parent));
+		} else {
+			QJsonObject object;
+			auto column = 0;
+			for(const auto &key : qAsConst(columns))
+				object.insert(key, values[column++]);
+			list.append(helper->deserializeSubtype(metaType, object, parent, hint));
+		}
+	}
+	return list;
+}
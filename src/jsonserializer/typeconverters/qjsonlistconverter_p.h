@@ -3,21 +3,43 @@
 
 #include "QtJsonSerializer/qtjsonserializer_global.h"
 #include "QtJsonSerializer/qjsontypeconverter.h"
+#include "qjsonvalueproducer_p.h"
 
 #include <QtCore/QRegularExpression>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
 
-class Q_JSONSERIALIZER_EXPORT QJsonListConverter : public QJsonTypeConverter
+class Q_JSONSERIALIZER_EXPORT QJsonListConverter : public QJsonTypeConverter, public QJsonMemberConverter
 {
 public:
 	bool canConvert(int metaTypeId) const override;
 	QList<QJsonValue::Type> jsonTypes() const override;
 	QJsonValue serialize(int propertyType, const QVariant &value, const SerializationHelper *helper) const override;
 	QVariant deserialize(int propertyType, const QJsonValue &value, QObject *parent, const SerializationHelper *helper) const override;
+	QJsonValueProducer::Frame *createFrame(int propertyType, const QVariant &value, const SerializationHelper *helper) const override;
+
+protected:
+	int getSubtype(int listType) const;
+	QVariantList toList(int propertyType, const QVariant &value) const;
 
 private:
 	static const QRegularExpression listTypeRegex;
+};
 
-	int getSubtype(int listType) const;
+// lists of gadgets and objects, which can be serialized as columnar lists
+class Q_JSONSERIALIZER_EXPORT QJsonColumnListConverter : public QJsonListConverter
+{
+public:
+	bool canConvert(int metaTypeId) const override;
+	QList<QJsonValue::Type> jsonTypes() const override;
+	QJsonValue serialize(int propertyType, const QVariant &value, const SerializationHelper *helper) const override;
+	QVariant deserialize(int propertyType, const QJsonValue &value, QObject *parent, const SerializationHelper *helper) const override;
+	QJsonValueProducer::Frame *createFrame(int propertyType, const QVariant &value, const SerializationHelper *helper) const override;
+
+private:
+	bool writeColumns(int metaType, const QVariantList &list, const SerializationHelper *helper, QJsonValue &json) const;
+	bool toColumns(const QJsonArray &array, QJsonObject &columnObject) const;
+	QVariantList fromColumns(int metaType, const QJsonObject &columnObject, QObject *parent, const SerializationHelper *helper) const;
 };
 
 #endif // QJSONLISTCONVERTER_P_H
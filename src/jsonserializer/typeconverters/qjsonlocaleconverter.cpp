@@ -1,5 +1,6 @@
 #include "qjsonlocaleconverter_p.h"
 #include "qjsonserializerexception.h"
+#include "qjsonserializer_p.h"
 
 #include <QtCore/QLocale>
 
@@ -17,7 +18,7 @@ QJsonValue QJsonLocaleConverter::serialize(int propertyType, const QVariant &val
 {
 	Q_UNUSED(propertyType)
 
-	if(helper->getProperty("useBcp47Locale").toBool())
+	if(QJsonSerializerPrivate::callOptions(helper).useBcp47Locale())
 		return value.toLocale().bcp47Name();
 	else
 		return value.toLocale().name();
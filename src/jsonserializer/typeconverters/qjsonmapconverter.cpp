@@ -1,8 +1,38 @@
 #include "qjsonmapconverter_p.h"
 #include "qjsonserializerexception.h"
+#include "qjsonfieldselector_p.h"
+#include "qjsonstringpool_p.h"
 
 #include <QtCore/QJsonObject>
 
+namespace {
+
+// the selected entries of a map. QVariantMap sorts its keys like a QJsonObject does
+class MapFrame : public QJsonValueProducer::Frame
+{
+public:
+	MapFrame(int metaType, const QVariantMap &map, const QStringList &keys) :
+		Frame{true, keys.size()},
+		_metaType{metaType},
+		_map{map},
+		_keys{keys}
+	{}
+
+	void produce(QJsonValueProducer *producer, int index) override {
+		const auto &key = _keys[index];
+		QJsonFieldSelectorContext::Step step{key};
+		producer->writeKey(key);
+		producer->produceSubtype(_metaType, _map.value(key), key.toUtf8());
+	}
+
+private:
+	const int _metaType;
+	const QVariantMap _map;
+	const QStringList _keys;
+};
+
+}
+
 const QRegularExpression QJsonMapConverter::mapTypeRegex(QStringLiteral(R"__(^(?:QMap|QHash)<\s*QString\s*,\s*(.*?)\s*>$)__"));
 
 bool QJsonMapConverter::canConvert(int metaTypeId) const
@@ -20,18 +50,14 @@ QList<QJsonValue::Type> QJsonMapConverter::jsonTypes() const
 QJsonValue QJsonMapConverter::serialize(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
 {
 	auto metaType = getSubtype(propertyType);
-
-	auto cValue = value;
-	if(!cValue.convert(QVariant::Map)) {
-		throw QJsonSerializationException(QByteArray("Failed to convert type ") +
-										  QMetaType::typeName(propertyType) +
-										  QByteArray(" to a variant map. Make shure to register map types via QJsonSerializer::registerMapConverters"));
-	}
-	auto map = cValue.toMap();
+	auto map = toMap(propertyType, value);
 
 	QJsonObject object;
-	for(auto it = map.constBegin(); it != map.constEnd(); ++it)
-		object.insert(it.key(), helper->serializeSubtype(metaType, it.value(), it.key().toUtf8()));
+	for(auto it = map.constBegin(); it != map.constEnd(); ++it) {
+		QJsonFieldSelectorContext::Step step{it.key()};
+		if(step.isSelected())
+			object.insert(it.key(), helper->serializeSubtype(metaType, it.value(), it.key().toUtf8()));
+	}
 	return object;
 }
 
@@ -42,11 +68,27 @@ QVariant QJsonMapConverter::deserialize(int propertyType, const QJsonValue &valu
 	//generate the map
 	QVariantMap map;
 	auto object = value.toObject();
-	for(auto it = object.constBegin(); it != object.constEnd(); ++it)
-		map.insert(it.key(), helper->deserializeSubtype(metaType, it.value(), parent, it.key().toUtf8()));
+	for(auto it = object.constBegin(); it != object.constEnd(); ++it) {
+		QJsonFieldSelectorContext::Step step{it.key()};
+		if(step.isSelected())
+			map.insert(QJsonStringPool::intern(it.key()), helper->deserializeSubtype(metaType, it.value(), parent, it.key().toUtf8()));
+	}
 	return map;
 }
 
+QJsonValueProducer::Frame *QJsonMapConverter::createFrame(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
+{
+	Q_UNUSED(helper)
+	const auto map = toMap(propertyType, value);
+	QStringList keys;
+	keys.reserve(map.size());
+	for(auto it = map.constBegin(); it != map.constEnd(); ++it) {
+		if(QJsonFieldSelectorContext::isSelected(it.key()))
+			keys.append(it.key());
+	}
+	return new MapFrame{getSubtype(propertyType), map, keys};
+}
+
 int QJsonMapConverter::getSubtype(int mapType) const
 {
 	int metaType = QMetaType::UnknownType;
@@ -55,3 +97,14 @@ int QJsonMapConverter::getSubtype(int mapType) const
 		metaType = QMetaType::type(match.captured(1).toUtf8().trimmed());
 	return metaType;
 }
+
+QVariantMap QJsonMapConverter::toMap(int propertyType, const QVariant &value) const
+{
+	const auto cValue = convertedValue(value, QMetaType::QVariantMap);
+	if(!cValue.isValid()) {
+		throw QJsonSerializationException(QByteArray("Failed to convert type ") +
+										  QMetaType::typeName(propertyType) +
+										  QByteArray(" to a variant map. Make shure to register map types via QJsonSerializer::registerMapConverters"));
+	}
+	return cValue.toMap();
+}
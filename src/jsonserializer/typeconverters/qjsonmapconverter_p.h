@@ -3,21 +3,24 @@
 
 #include "qtjsonserializer_global.h"
 #include "qjsontypeconverter.h"
+#include "qjsonvalueproducer_p.h"
 
 #include <QtCore/QRegularExpression>
 
-class Q_JSONSERIALIZER_EXPORT QJsonMapConverter : public QJsonTypeConverter
+class Q_JSONSERIALIZER_EXPORT QJsonMapConverter : public QJsonTypeConverter, public QJsonMemberConverter
 {
 public:
 	bool canConvert(int metaTypeId) const override;
 	QList<QJsonValue::Type> jsonTypes() const override;
 	QJsonValue serialize(int propertyType, const QVariant &value, const SerializationHelper *helper) const override;
 	QVariant deserialize(int propertyType, const QJsonValue &value, QObject *parent, const SerializationHelper *helper) const override;
+	QJsonValueProducer::Frame *createFrame(int propertyType, const QVariant &value, const SerializationHelper *helper) const override;
 
 private:
 	static const QRegularExpression mapTypeRegex;
 
 	int getSubtype(int mapType) const;
+	QVariantMap toMap(int propertyType, const QVariant &value) const;
 };
 
 #endif // QJSONMAPCONVERTER_P_H
@@ -1,6 +1,8 @@
 #include "qjsonmultimapconverter_p.h"
 #include "qjsonserializerexception.h"
-#include "qjsonserializer.h"
+#include "qjsonserializer_p.h"
+#include "qjsonfieldselector_p.h"
+#include "qjsonstringpool_p.h"
 
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonArray>
@@ -21,18 +23,21 @@ QJsonValue QJsonMultiMapConverter::serialize(int propertyType, const QVariant &v
 {
 	const auto metaType = getSubtype(propertyType);
 
-	auto cValue = value;
-	if(!cValue.convert(QVariant::Map)) {
+	const auto cValue = convertedValue(value, QMetaType::QVariantMap);
+	if(!cValue.isValid()) {
 		throw QJsonSerializationException(QByteArray("Failed to convert type ") +
 										  QMetaType::typeName(propertyType) +
 										  QByteArray(" to a variant map. Make shure to register map types via QJsonSerializer::registerMapConverters"));
 	}
 	const auto map = cValue.toMap();
 
-	switch (helper->getProperty("multiMapMode").value<QJsonSerializer::MultiMapMode>()) {
+	switch (QJsonSerializerPrivate::callOptions(helper).multiMapMode()) {
 	case QJsonSerializer::MultiMapMode::Map: {
 		QJsonObject object;
 		for(auto it = map.constBegin(); it != map.constEnd(); ++it) {
+			QJsonFieldSelectorContext::Step step{it.key()};
+			if(!step.isSelected())
+				continue;
 			auto vArray = object.value(it.key()).toArray();
 			vArray.append(helper->serializeSubtype(metaType, it.value(), it.key().toUtf8()));
 			object.insert(it.key(), vArray);
@@ -41,8 +46,11 @@ QJsonValue QJsonMultiMapConverter::serialize(int propertyType, const QVariant &v
 	}
 	case QJsonSerializer::MultiMapMode::List: {
 		QJsonArray array;
-		for(auto it = map.constBegin(); it != map.constEnd(); ++it)
-			array.append(QJsonArray {it.key(), helper->serializeSubtype(metaType, it.value(), it.key().toUtf8())});
+		for(auto it = map.constBegin(); it != map.constEnd(); ++it) {
+			QJsonFieldSelectorContext::Step step{it.key()};
+			if(step.isSelected())
+				array.append(QJsonArray {it.key(), helper->serializeSubtype(metaType, it.value(), it.key().toUtf8())});
+		}
 		return array;
 	}
 	default:
@@ -60,11 +68,15 @@ QVariant QJsonMultiMapConverter::deserialize(int propertyType, const QJsonValue
 		QVariantMap map;
 		const auto object = value.toObject();
 		for(auto it = object.constBegin(); it != object.constEnd(); ++it) {
+			QJsonFieldSelectorContext::Step step{it.key()};
+			if(!step.isSelected())
+				continue;
+			const auto key = QJsonStringPool::intern(it.key());
 			if(it->isArray()) {
 				for(const auto aValue : it->toArray())
-					map.insertMulti(it.key(), helper->deserializeSubtype(metaType, aValue, parent, it.key().toUtf8()));
+					map.insertMulti(key, helper->deserializeSubtype(metaType, aValue, parent, key.toUtf8()));
 			} else
-				map.insertMulti(it.key(), helper->deserializeSubtype(metaType, it.value(), parent, it.key().toUtf8()));
+				map.insertMulti(key, helper->deserializeSubtype(metaType, it.value(), parent, key.toUtf8()));
 		}
 		return map;
 	}
@@ -74,7 +86,11 @@ QVariant QJsonMultiMapConverter::deserialize(int propertyType, const QJsonValue
 			auto vPair = aValue.toArray();
 			if(vPair.size() != 2)
 				throw QJsonDeserializationException("Json array must have exactly 2 elements to be read as a value of a multi map");
-			map.insertMulti(vPair[0].toString(), helper->deserializeSubtype(metaType, vPair[1], parent, vPair[0].toString().toUtf8()));
+			const auto key = QJsonStringPool::intern(vPair[0].toString());
+			QJsonFieldSelectorContext::Step step{key};
+			if(!step.isSelected())
+				continue;
+			map.insertMulti(key, helper->deserializeSubtype(metaType, vPair[1], parent, key.toUtf8()));
 		}
 		return map;
 	}
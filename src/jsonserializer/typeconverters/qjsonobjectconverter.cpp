@@ -1,12 +1,92 @@
 #include "qjsonobjectconverter_p.h"
 #include "qjsonserializerexception.h"
 #include "qjsonserializer_p.h"
+#include "qjsonfieldselector_p.h"
+#include "qjsonreferencecontext_p.h"
+
+#include <algorithm>
 
 #include <QtCore/QPointer>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QRegularExpression>
+#include <QtCore/QVarLengthArray>
+#include <QtCore/QVector>
 #include <QtCore/QDebug>
 
+namespace {
+
+// keeps the value alive while its properties are produced, and detects if the object is deleted meanwhile
+class ObjectFrame : public QJsonPropertyFrame
+{
+public:
+	ObjectFrame(const QVariant &value, QObject *object, const QMetaObject *metaObject, const QMap<QString, Member> &members) :
+		QJsonPropertyFrame{metaObject, members},
+		_value{value},
+		_object{object}
+	{}
+
+protected:
+	QVariant read(const QMetaProperty &property) const override {
+		if(!_object)
+			throw QJsonSerializationException("The object was destroyed before all of its properties were serialized");
+		return property.read(_object);
+	}
+
+private:
+	const QVariant _value;
+	const QPointer<QObject> _object;
+};
+
+QObject *construct(const QMetaObject *metaObject, QObject *parent)
+{
+	auto object = metaObject->newInstance(Q_ARG(QObject*, parent));
+	if(!object) {
+		throw QJsonDeserializationException(QByteArray("Failed to construct object of type ") +
+											metaObject->className() +
+											QByteArray(" (Does the constructor \"Q_INVOKABLE class(QObject*);\" exist?)"));
+	}
+	return object;
+}
+
+// sets the values of a row as the properties the columns were resolved to
+class ObjectColumnReader : public QJsonColumnReader
+{
+public:
+	ObjectColumnReader(int propertyType, const QMetaObject *metaObject, const QByteArrayList &keys, const QVector<QMetaProperty> &properties, const QJsonTypeConverter::SerializationHelper *helper) :
+		_propertyType{propertyType},
+		_metaObject{metaObject},
+		_keys{keys},
+		_properties{properties},
+		_helper{helper}
+	{}
+
+	QVariant read(const QJsonArray &row, QObject *parent) const override {
+		auto object = construct(_metaObject, parent);
+		for(auto i = 0; i < _keys.size(); ++i) {
+			const auto &property = _properties[i];
+			const auto subValue = property.isValid() ?
+									  _helper->deserializeSubtype(property, row[i], object) :
+									  _helper->deserializeSubtype(QMetaType::UnknownType, row[i], object, _keys[i]);
+			object->setProperty(_keys[i].constData(), subValue);
+		}
+
+		// the same conversion the serializer applies to the result of deserialize
+		auto variant = QVariant::fromValue(object);
+		variant.convert(_propertyType);
+		return variant;
+	}
+
+private:
+	const int _propertyType;
+	const QMetaObject * const _metaObject;
+	const QByteArrayList _keys;
+	// invalid for extra columns, which become dynamic properties
+	const QVector<QMetaProperty> _properties;
+	const QJsonTypeConverter::SerializationHelper * const _helper;
+};
+
+}
+
 const QRegularExpression QJsonObjectConverter::sharedTypeRegex(QStringLiteral(R"__(^QSharedPointer<\s*(.*?)\s*>$)__"));
 const QRegularExpression QJsonObjectConverter::trackingTypeRegex(QStringLiteral(R"__(^QPointer<\s*(.*?)\s*>$)__"));
 
@@ -28,56 +108,21 @@ QList<QJsonValue::Type> QJsonObjectConverter::jsonTypes() const
 
 QJsonValue QJsonObjectConverter::serialize(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
 {
-	QObject *object = nullptr;
-	auto flags = QMetaType::typeFlags(propertyType);
-	if(flags.testFlag(QMetaType::PointerToQObject))
-	  object = extract<QObject*>(value);
-	else if(flags.testFlag(QMetaType::SharedPointerToQObject))
-	  object = extract<QSharedPointer<QObject>>(value).data();
-	else if(flags.testFlag(QMetaType::TrackingPointerToQObject))
-	  object = extract<QPointer<QObject>>(value).data();
-	else
-	  Q_UNREACHABLE();
-
-	if(!object)
-		return QJsonValue();
-
-	//get the metaobject, based on polymorphism
-	const QMetaObject *meta = nullptr;
-	auto poly = static_cast<QJsonSerializer::Polymorphing>(helper->getProperty("polymorphing").toInt());
-	auto isPoly = false;
-	switch (poly) {
-	case QJsonSerializer::Disabled:
-		isPoly = false;
-		break;
-	case QJsonSerializer::Enabled:
-		isPoly = polyMetaObject(object);
-		break;
-	case QJsonSerializer::Forced:
-		isPoly = true;
-		break;
-	default:
-		Q_UNREACHABLE();
-		break;
-	}
-
 	QJsonObject jsonObject;
-
-	if(isPoly) {
-		meta = object->metaObject();
-		//first: pass the class name
-		jsonObject[QStringLiteral("@class")] = QString::fromUtf8(meta->className());
-	} else
-		meta = getMetaObject(propertyType);
+	const QMetaObject *meta = nullptr;
+	auto i = 0;
+	const auto object = prepare(propertyType, value, helper, jsonObject, meta, i);
+	if(!object)
+		return jsonObject.isEmpty() ? QJsonValue() : QJsonValue(jsonObject);
 
 	//go through all properties and try to serialize them
-	auto keepObjectName = helper->getProperty("keepObjectName").toBool();
-	auto i = QObject::staticMetaObject.indexOfProperty("objectName");
-	if(!keepObjectName)
-	   i++;
 	for(; i < meta->propertyCount(); i++) {
 		auto property = meta->property(i);
-		if(property.isStored())
+		if(!property.isStored())
+			continue;
+		// unselected properties are not even read
+		QJsonFieldSelectorContext::Step step{property.name()};
+		if(step.isSelected())
 			jsonObject[QString::fromUtf8(property.name())] = helper->serializeSubtype(property, property.read(object));
 	}
 
@@ -89,16 +134,42 @@ QVariant QJsonObjectConverter::deserialize(int propertyType, const QJsonValue &v
 	if(value.isNull())
 		return toVariant(nullptr, QMetaType::typeFlags(propertyType));
 
-	auto validationFlags = helper->getProperty("validationFlags").value<QJsonSerializer::ValidationFlags>();
-	auto keepObjectName = helper->getProperty("keepObjectName").toBool();
-	auto poly = static_cast<QJsonSerializer::Polymorphing>(helper->getProperty("polymorphing").toInt());
+	const auto options = QJsonSerializerPrivate::callOptions(helper);
+	auto validationFlags = options.validationFlags();
+	auto keepObjectName = options.keepObjectName();
+	auto poly = options.polymorphing();
 
 	auto metaObject = getMetaObject(propertyType);
 	if(!metaObject)
 		throw QJsonDeserializationException(QByteArray("Unable to get metaobject for type ") + QMetaType::typeName(propertyType));
 
-	//try to get the polymorphic metatype (if allowed)
+	//resolve references to shared objects
 	auto jsonObject = value.toObject();
+	const auto references = QJsonReferenceContext::current();
+	auto objectId = -1;
+	if(references) {
+		QObject *object = nullptr;
+		if(jsonObject.contains(QStringLiteral("$ref")))
+			object = references->resolve(jsonObject[QStringLiteral("$ref")].toInt(-1), propertyType, parent, helper);
+		else {
+			objectId = jsonObject[QStringLiteral("$id")].toInt(-1);
+			//already created, because a previous reference was resolved to it
+			if(objectId != -1)
+				object = references->object(objectId);
+		}
+
+		if(object) {
+			if(!object->metaObject()->inherits(metaObject)) {
+				throw QJsonDeserializationException(QByteArray("Referenced object of type ") +
+													object->metaObject()->className() +
+													QByteArray(" does not inhert the property type ") +
+													QMetaType::typeName(propertyType));
+			}
+			return toVariant(object, QMetaType::typeFlags(propertyType));
+		}
+	}
+
+	//try to get the polymorphic metatype (if allowed)
 	auto isPoly = false;
 	if(poly != QJsonSerializer::Disabled) {
 		if(jsonObject.contains(QStringLiteral("@class"))) {
@@ -120,23 +191,21 @@ QVariant QJsonObjectConverter::deserialize(int propertyType, const QJsonValue &v
 	}
 
 	//try to construct the object
-	auto object = metaObject->newInstance(Q_ARG(QObject*, parent));
-	if(!object) {
-		throw QJsonDeserializationException(QByteArray("Failed to construct object of type ") +
-											metaObject->className() +
-											QByteArray(" (Does the constructor \"Q_INVOKABLE class(QObject*);\" exist?)"));
-	}
+	auto object = construct(metaObject, parent);
+	if(objectId != -1)
+		references->addObject(objectId, object);
 
-	//collect required properties, if set
-	QSet<QByteArray> reqProps;
+	//collect required properties, if set (flags by property index, to avoid allocations)
+	QVarLengthArray<bool, 64> reqProps;
 	if(validationFlags.testFlag(QJsonSerializer::AllProperties)) {
+		reqProps.resize(metaObject->propertyCount());
+		std::fill(reqProps.begin(), reqProps.end(), false);
 		auto i = QObject::staticMetaObject.indexOfProperty("objectName");
 		if(!keepObjectName)
 		   i++;
 		for(; i < metaObject->propertyCount(); i++) {
 			auto property = metaObject->property(i);
-			if(property.isStored())
-				reqProps.insert(property.name());
+			reqProps[i] = property.isStored() && QJsonFieldSelectorContext::isSelected(property.name());
 		}
 	}
 
@@ -144,33 +213,169 @@ QVariant QJsonObjectConverter::deserialize(int propertyType, const QJsonValue &v
 	for(auto it = jsonObject.constBegin(); it != jsonObject.constEnd(); it++) {
 		if(isPoly && it.key() == QStringLiteral("@class"))
 			continue;
+		if(objectId != -1 && it.key() == QStringLiteral("$id"))
+			continue;
+		//skip fields that are not selected, without deserializing them
+		QJsonFieldSelectorContext::Step step{it.key()};
+		if(!step.isSelected())
+			continue;
 
-		auto propIndex = metaObject->indexOfProperty(qUtf8Printable(it.key()));
+		const auto key = it.key().toUtf8();
+		auto propIndex = metaObject->indexOfProperty(key.constData());
 		QVariant subValue;
 		if(propIndex != -1) {
 			auto property = metaObject->property(propIndex);
 			subValue = helper->deserializeSubtype(property, it.value(), object);
-			reqProps.remove(property.name());
+			if(propIndex < reqProps.size())
+				reqProps[propIndex] = false;
 		} else if(validationFlags.testFlag(QJsonSerializer::NoExtraProperties)) {
 			throw QJsonDeserializationException("Found extra property " +
-												it.key().toUtf8() +
+												key +
 												" but extra properties are not allowed");
 		} else
-			subValue = helper->deserializeSubtype(QMetaType::UnknownType, it.value(), object, it.key().toUtf8());
-		object->setProperty(qUtf8Printable(it.key()), subValue);
+			subValue = helper->deserializeSubtype(QMetaType::UnknownType, it.value(), object, key);
+		object->setProperty(key.constData(), subValue);
 	}
 
 	//make shure all required properties have been read
-	if(validationFlags.testFlag(QJsonSerializer::AllProperties) && !reqProps.isEmpty()) {
-		throw QJsonDeserializationException(QByteArray("Not all properties for ") +
-											metaObject->className() +
-											QByteArray(" are present in the json object Missing properties: ") +
-											reqProps.toList().join(", "));
+	if(validationFlags.testFlag(QJsonSerializer::AllProperties)) {
+		QByteArrayList missing;
+		for(auto i = 0; i < reqProps.size(); i++) {
+			if(reqProps[i])
+				missing.append(metaObject->property(i).name());
+		}
+		if(!missing.isEmpty()) {
+			throw QJsonDeserializationException(QByteArray("Not all properties for ") +
+												metaObject->className() +
+												QByteArray(" are present in the json object Missing properties: ") +
+												missing.join(", "));
+		}
 	}
 
 	return toVariant(object, QMetaType::typeFlags(propertyType));
 }
 
+QJsonValueProducer::Frame *QJsonObjectConverter::createFrame(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper) const
+{
+	QJsonObject header;
+	const QMetaObject *meta = nullptr;
+	auto i = 0;
+	const auto object = prepare(propertyType, value, helper, header, meta, i);
+	if(!object)
+		return nullptr;
+
+	QMap<QString, QJsonPropertyFrame::Member> members;
+	for(auto it = header.constBegin(); it != header.constEnd(); ++it)
+		members.insert(it.key(), {-1, it.value()});
+	for(; i < meta->propertyCount(); i++) {
+		auto property = meta->property(i);
+		if(property.isStored() && QJsonFieldSelectorContext::isSelected(property.name()))
+			members.insert(QString::fromUtf8(property.name()), {i, {}});
+	}
+	return new ObjectFrame{value, object, meta, members};
+}
+
+QJsonColumnReader *QJsonObjectConverter::createColumnReader(int propertyType, const QStringList &columns, const QJsonTypeConverter::SerializationHelper *helper) const
+{
+	// references and polymorphism depend on the values of each row
+	const auto options = QJsonSerializerPrivate::callOptions(helper);
+	const auto poly = options.polymorphing();
+	if(!QMetaType::typeFlags(propertyType).testFlag(QMetaType::PointerToQObject) ||
+	   QJsonReferenceContext::current() ||
+	   poly == QJsonSerializer::Forced ||
+	   (poly != QJsonSerializer::Disabled && columns.contains(QStringLiteral("@class"))))
+		return nullptr;
+
+	auto metaObject = getMetaObject(propertyType);
+	if(!metaObject)
+		return nullptr;
+	auto validationFlags = options.validationFlags();
+	auto keepObjectName = options.keepObjectName();
+
+	// the same validation as for each object, but only once for all rows
+	QByteArrayList keys;
+	QVector<QMetaProperty> properties;
+	keys.reserve(columns.size());
+	properties.reserve(columns.size());
+	for(const auto &column : columns) {
+		const auto key = column.toUtf8();
+		auto propIndex = metaObject->indexOfProperty(key.constData());
+		if(propIndex != -1)
+			properties.append(metaObject->property(propIndex));
+		else if(validationFlags.testFlag(QJsonSerializer::NoExtraProperties)) {
+			throw QJsonDeserializationException("Found extra property " +
+												key +
+												" but extra properties are not allowed");
+		} else
+			properties.append(QMetaProperty{});
+		keys.append(key);
+	}
+
+	if(validationFlags.testFlag(QJsonSerializer::AllProperties)) {
+		QByteArrayList missing;
+		auto i = QObject::staticMetaObject.indexOfProperty("objectName");
+		if(!keepObjectName)
+		   i++;
+		for(; i < metaObject->propertyCount(); i++) {
+			auto property = metaObject->property(i);
+			if(property.isStored() && !keys.contains(property.name()))
+				missing.append(property.name());
+		}
+		if(!missing.isEmpty()) {
+			throw QJsonDeserializationException(QByteArray("Not all properties for ") +
+												metaObject->className() +
+												QByteArray(" are present in the json object Missing properties: ") +
+												missing.join(", "));
+		}
+	}
+
+	return new ObjectColumnReader{propertyType, metaObject, keys, properties, helper};
+}
+
+bool QJsonObjectConverter::columnProperties(int propertyType, const QJsonTypeConverter::SerializationHelper *helper, QVector<QMetaProperty> &properties) const
+{
+	// references and forced polymorphism add keys to every object
+	const auto options = QJsonSerializerPrivate::callOptions(helper);
+	if(!QMetaType::typeFlags(propertyType).testFlag(QMetaType::PointerToQObject) ||
+	   QJsonReferenceContext::current() ||
+	   options.polymorphing() == QJsonSerializer::Forced)
+		return false;
+
+	auto metaObject = getMetaObject(propertyType);
+	if(!metaObject)
+		return false;
+	auto i = QObject::staticMetaObject.indexOfProperty("objectName");
+	if(!options.keepObjectName())
+	   i++;
+	for(; i < metaObject->propertyCount(); i++) {
+		auto property = metaObject->property(i);
+		if(property.isStored())
+			properties.append(property);
+	}
+	return true;
+}
+
+bool QJsonObjectConverter::writeRow(int propertyType, const QVariant &value, const QVector<QMetaProperty> &properties, const QJsonTypeConverter::SerializationHelper *helper, QJsonValue &row) const
+{
+	QJsonObject header;
+	const QMetaObject *meta = nullptr;
+	auto i = 0;
+	const auto object = prepare(propertyType, value, helper, header, meta, i);
+	// polymorphic objects are written with their class, and thus need an object
+	if(!header.isEmpty())
+		return false;
+	if(!object) {
+		row = QJsonValue::Null;
+		return true;
+	}
+
+	QJsonArray values;
+	for(const auto &property : properties)
+		values.append(helper->serializeSubtype(property, property.read(object)));
+	row = values;
+	return true;
+}
+
 const QMetaObject *QJsonObjectConverter::getMetaObject(int typeId) const
 {
 	auto flags = QMetaType::typeFlags(typeId);
@@ -197,12 +402,74 @@ const QMetaObject *QJsonObjectConverter::getMetaObject(int typeId) const
 	}
 }
 
+QObject *QJsonObjectConverter::prepare(int propertyType, const QVariant &value, const QJsonTypeConverter::SerializationHelper *helper, QJsonObject &header, const QMetaObject *&meta, int &firstProperty) const
+{
+	QObject *object = nullptr;
+	auto flags = QMetaType::typeFlags(propertyType);
+	if(flags.testFlag(QMetaType::PointerToQObject))
+	  object = extract<QObject*>(value);
+	else if(flags.testFlag(QMetaType::SharedPointerToQObject))
+	  object = extract<QSharedPointer<QObject>>(value).data();
+	else if(flags.testFlag(QMetaType::TrackingPointerToQObject))
+	  object = extract<QPointer<QObject>>(value).data();
+	else
+	  Q_UNREACHABLE();
+
+	if(!object)
+		return nullptr;
+
+	//only the first occurence of a shared object is written, all others reference it
+	const auto references = QJsonReferenceContext::current();
+	if(references) {
+		auto known = false;
+		const auto id = references->objectId(object, known);
+		if(known) {
+			header = QJsonObject{{QStringLiteral("$ref"), id}};
+			return nullptr;
+		}
+		header[QStringLiteral("$id")] = id;
+	}
+
+	//get the metaobject, based on polymorphism
+	const auto options = QJsonSerializerPrivate::callOptions(helper);
+	auto poly = options.polymorphing();
+	auto isPoly = false;
+	switch (poly) {
+	case QJsonSerializer::Disabled:
+		isPoly = false;
+		break;
+	case QJsonSerializer::Enabled:
+		isPoly = polyMetaObject(object);
+		break;
+	case QJsonSerializer::Forced:
+		isPoly = true;
+		break;
+	default:
+		Q_UNREACHABLE();
+		break;
+	}
+
+	if(isPoly) {
+		meta = object->metaObject();
+		//first: pass the class name
+		header[QStringLiteral("@class")] = QString::fromUtf8(meta->className());
+	} else
+		meta = getMetaObject(propertyType);
+
+	auto keepObjectName = options.keepObjectName();
+	firstProperty = QObject::staticMetaObject.indexOfProperty("objectName");
+	if(!keepObjectName)
+	   firstProperty++;
+	return object;
+}
+
 template<typename T>
-T QJsonObjectConverter::extract(QVariant variant) const
+T QJsonObjectConverter::extract(const QVariant &variant) const
 {
 	auto id = qMetaTypeId<T>();
-	if(variant.canConvert(id) && variant.convert(id))
-		return variant.value<T>();
+	const auto cValue = convertedValue(variant, id);
+	if(cValue.isValid())
+		return cValue.value<T>();
 	else {
 		throw QJsonSerializationException(QByteArray("unable to get QObject pointer from type ") +
 										  QMetaType::typeName(id) +
@@ -218,6 +485,10 @@ QVariant QJsonObjectConverter::toVariant(QObject *object, QMetaType::TypeFlags f
 		//remove parent, as shared pointers and object tree exclude each other
 		if(object)
 			object->setParent(nullptr);
+		//referenced objects must be owned by a single shared pointer
+		const auto references = QJsonReferenceContext::current();
+		if(object && references)
+			return QVariant::fromValue(references->sharedPointer(object));
 		return QVariant::fromValue(QSharedPointer<QObject>(object));
 	} else if(flags.testFlag(QMetaType::TrackingPointerToQObject))
 		return QVariant::fromValue<QPointer<QObject>>(object);
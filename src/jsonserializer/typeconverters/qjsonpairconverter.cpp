@@ -19,8 +19,8 @@ QJsonValue QJsonPairConverter::serialize(int propertyType, const QVariant &value
 {
 	auto types = getPairTypes(propertyType);
 	auto targetType = qMetaTypeId<QPair<QVariant, QVariant>>();
-	auto cValue = value;
-	if(!cValue.canConvert(targetType) || !cValue.convert(targetType)) {
+	const auto cValue = convertedValue(value, targetType);
+	if(!cValue.isValid()) {
 		throw QJsonSerializationException(QByteArray("Failed to convert type ") +
 										  QMetaType::typeName(propertyType) +
 										  QByteArray(" to QPair<QVariant, QVariant>. Make shure to register pair types via QJsonSerializer::registerPairConverters"));
@@ -28,8 +28,8 @@ QJsonValue QJsonPairConverter::serialize(int propertyType, const QVariant &value
 
 	auto variant = cValue.value<QPair<QVariant, QVariant>>();
 	QJsonArray array;
-	array.append(helper->serializeSubtype(types.first, variant.first, "pair.first"));
-	array.append(helper->serializeSubtype(types.second, variant.second, "pair.second"));
+	array.append(helper->serializeSubtype(types.first, variant.first, QByteArrayLiteral("pair.first")));
+	array.append(helper->serializeSubtype(types.second, variant.second, QByteArrayLiteral("pair.second")));
 	return array;
 }
 
@@ -41,8 +41,8 @@ QVariant QJsonPairConverter::deserialize(int propertyType, const QJsonValue &val
 		throw QJsonDeserializationException("Json array must have exactly 2 elements to be read as a pair");
 
 	QPair<QVariant, QVariant> vPair;
-	vPair.first = helper->deserializeSubtype(types.first, array[0], parent, "pair.first");
-	vPair.second = helper->deserializeSubtype(types.second, array[1], parent, "pair.second");
+	vPair.first = helper->deserializeSubtype(types.first, array[0], parent, QByteArrayLiteral("pair.first"));
+	vPair.second = helper->deserializeSubtype(types.second, array[1], parent, QByteArrayLiteral("pair.second"));
 	return QVariant::fromValue(vPair);
 }
 
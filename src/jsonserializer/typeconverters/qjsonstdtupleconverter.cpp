@@ -3,6 +3,7 @@
 #include <QtCore/QJsonArray>
 
 #include "qjsonserializerexception.h"
+#include "qjsonexceptioncontext_p.h"
 
 const QRegularExpression QJsonStdTupleConverter::tupleTypeRegex(QStringLiteral(R"__(^std::tuple<(\s*.*?\s*(?:,\s*.*?\s*)*)>$)__"));
 
@@ -22,8 +23,8 @@ QJsonValue QJsonStdTupleConverter::serialize(int propertyType, const QVariant &v
 	if(types.isEmpty())
 		throw QJsonSerializationException{QByteArray{"Failed to extract element types from "} + QMetaType::typeName(propertyType)};
 
-	auto cValue = value;
-	if(!cValue.canConvert(QMetaType::QVariantList) || !cValue.convert(QMetaType::QVariantList)) {
+	const auto cValue = convertedValue(value, QMetaType::QVariantList);
+	if(!cValue.isValid()) {
 		throw QJsonSerializationException {
 			QByteArray{"Failed to convert type "} +
 			QMetaType::typeName(propertyType) +
@@ -42,8 +43,12 @@ QJsonValue QJsonStdTupleConverter::serialize(int propertyType, const QVariant &v
 	}
 
 	QJsonArray array;
-	for(auto i = 0, max = vList.size(); i < max; ++i)
-		array.append(helper->serializeSubtype(types[i], vList[i], "<" + QByteArray::number(i) + ">"));
+	QByteArray hint;
+	hint.reserve(16);
+	for(auto i = 0, max = vList.size(); i < max; ++i) {
+		QJsonExceptionContext::indexHint(hint, i, '<', '>');
+		array.append(helper->serializeSubtype(types[i], vList[i], hint));
+	}
 	return array;
 }
 
@@ -65,8 +70,12 @@ QVariant QJsonStdTupleConverter::deserialize(int propertyType, const QJsonValue
 
 	QVariantList list;
 	list.reserve(array.size());
-	for(auto i = 0, max = array.size(); i < max; ++i)
-		list.append(helper->deserializeSubtype(types[i], array[i], parent, "<" + QByteArray::number(i) + ">"));
+	QByteArray hint;
+	hint.reserve(16);
+	for(auto i = 0, max = array.size(); i < max; ++i) {
+		QJsonExceptionContext::indexHint(hint, i, '<', '>');
+		list.append(helper->deserializeSubtype(types[i], array[i], parent, hint));
+	}
 	return list;
 }
 
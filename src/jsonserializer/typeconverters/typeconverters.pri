@@ -11,7 +11,9 @@ HEADERS += \
     $$PWD/qjsonlocaleconverter_p.h \
     $$PWD/qjsonregularexpressionconverter_p.h \
     $$PWD/qjsonstdtupleconverter_p.h \
-    $$PWD/qjsonmultimapconverter_p.h
+    $$PWD/qjsonmultimapconverter_p.h \
+    $$PWD/qjsondatetimeconverter_p.h \
+    $$PWD/qjsonlazyconverter_p.h
 
 SOURCES += \
 	$$PWD/qjsonlistconverter.cpp \
@@ -26,4 +28,6 @@ SOURCES += \
     $$PWD/qjsonlocaleconverter.cpp \
     $$PWD/qjsonregularexpressionconverter.cpp \
     $$PWD/qjsonstdtupleconverter.cpp \
-    $$PWD/qjsonmultimapconverter.cpp
+    $$PWD/qjsonmultimapconverter.cpp \
+    $$PWD/qjsondatetimeconverter.cpp \
+    $$PWD/qjsonlazyconverter.cpp
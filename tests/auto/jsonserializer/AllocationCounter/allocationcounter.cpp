@@ -0,0 +1,93 @@
+#include "allocationcounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<qint64> allocCount{0};
+std::atomic<qint64> allocBytes{0};
+
+inline void countAllocation(std::size_t size)
+{
+	allocCount.fetch_add(1, std::memory_order_relaxed);
+	allocBytes.fetch_add(static_cast<qint64>(size), std::memory_order_relaxed);
+}
+
+}
+
+#ifdef __GLIBC__
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *ptr, std::size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(std::size_t size)
+{
+	countAllocation(size);
+	return __libc_malloc(size);
+}
+
+void *calloc(std::size_t count, std::size_t size)
+{
+	countAllocation(count * size);
+	return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, std::size_t size)
+{
+	countAllocation(size);
+	return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+	__libc_free(ptr);
+}
+}
+
+void *operator new(std::size_t size)
+{
+	// counted by malloc
+	if(auto ptr = std::malloc(size))
+		return ptr;
+	throw std::bad_alloc{};
+}
+#else
+void *operator new(std::size_t size)
+{
+	countAllocation(size);
+	if(auto ptr = std::malloc(size))
+		return ptr;
+	throw std::bad_alloc{};
+}
+#endif
+
+void operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+bool AllocationCounter::countsMalloc()
+{
+#ifdef __GLIBC__
+	return true;
+#else
+	return false;
+#endif
+}
+
+AllocationCounter::Snapshot AllocationCounter::snapshot()
+{
+	Snapshot snapshot;
+	snapshot.count = allocCount.load();
+	snapshot.bytes = allocBytes.load();
+	return snapshot;
+}
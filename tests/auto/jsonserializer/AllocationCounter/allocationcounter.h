@@ -0,0 +1,22 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtCore/QtGlobal>
+
+// Counts all heap allocations of the process. The sources must be compiled into the executable itself, as they
+// replace the global allocation functions. Qt containers allocate via malloc, so with glibc the malloc family is
+// interposed as well - elsewhere only operator new is counted
+class AllocationCounter
+{
+public:
+	struct Snapshot {
+		qint64 count = 0;
+		qint64 bytes = 0;
+	};
+
+	// true, if allocations via malloc are counted as well
+	static bool countsMalloc();
+	static Snapshot snapshot();
+};
+
+#endif // ALLOCATIONCOUNTER_H
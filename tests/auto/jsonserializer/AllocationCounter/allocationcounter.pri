@@ -0,0 +1,8 @@
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+HEADERS += \
+	$$PWD/allocationcounter.h
+
+SOURCES += \
+	$$PWD/allocationcounter.cpp
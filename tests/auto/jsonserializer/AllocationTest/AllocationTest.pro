@@ -0,0 +1,21 @@
+TEMPLATE = app
+
+QT = core testlib jsonserializer
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = tst_allocation
+
+include(../AllocationCounter/allocationcounter.pri)
+
+HEADERS += \
+	allocationmodel.h
+
+SOURCES += \
+	tst_allocation.cpp \
+	allocationmodel.cpp
+
+DISTFILES += \
+	thresholds.json
+
+include(../../testrun.pri)
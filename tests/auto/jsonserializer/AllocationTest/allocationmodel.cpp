@@ -0,0 +1,31 @@
+#include "allocationmodel.h"
+
+AllocGadget AllocGadget::create(int index)
+{
+	AllocGadget gadget;
+	gadget.id = index;
+	gadget.value = index * 0.5;
+	gadget.active = index % 2 == 0;
+	gadget.name = QStringLiteral("gadget-%1").arg(index);
+	gadget.tags = QStringList{QStringLiteral("alpha"), QStringLiteral("beta")};
+	return gadget;
+}
+
+AllocObject::AllocObject(QObject *parent) :
+	QObject{parent}
+{}
+
+AllocObject *AllocObject::create(int index, int depth, int width, QObject *parent)
+{
+	auto object = new AllocObject{parent};
+	object->id = index;
+	object->value = index * 0.5;
+	object->active = index % 2 == 0;
+	object->name = QStringLiteral("object-%1").arg(index);
+	object->tags = QStringList{QStringLiteral("alpha"), QStringLiteral("beta")};
+	if(depth > 0) {
+		for(auto i = 0; i < width; ++i)
+			object->children.append(create(index * width + i + 1, depth - 1, width, object));
+	}
+	return object;
+}
@@ -0,0 +1,54 @@
+#ifndef ALLOCATIONMODEL_H
+#define ALLOCATIONMODEL_H
+
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+
+class AllocGadget
+{
+	Q_GADGET
+
+	Q_PROPERTY(int id MEMBER id)
+	Q_PROPERTY(double value MEMBER value)
+	Q_PROPERTY(bool active MEMBER active)
+	Q_PROPERTY(QString name MEMBER name)
+	Q_PROPERTY(QStringList tags MEMBER tags)
+
+public:
+	int id = 0;
+	double value = 0.0;
+	bool active = false;
+	QString name;
+	QStringList tags;
+
+	static AllocGadget create(int index);
+};
+
+class AllocObject : public QObject
+{
+	Q_OBJECT
+
+	Q_PROPERTY(int id MEMBER id)
+	Q_PROPERTY(double value MEMBER value)
+	Q_PROPERTY(bool active MEMBER active)
+	Q_PROPERTY(QString name MEMBER name)
+	Q_PROPERTY(QStringList tags MEMBER tags)
+	Q_PROPERTY(QList<AllocObject*> children MEMBER children)
+
+public:
+	Q_INVOKABLE AllocObject(QObject *parent = nullptr);
+
+	int id = 0;
+	double value = 0.0;
+	bool active = false;
+	QString name;
+	QStringList tags;
+	QList<AllocObject*> children;
+
+	// a tree with width children per object, depth levels below this object
+	static AllocObject *create(int index, int depth = 0, int width = 0, QObject *parent = nullptr);
+};
+
+Q_DECLARE_METATYPE(AllocGadget)
+
+#endif // ALLOCATIONMODEL_H
@@ -0,0 +1,209 @@
+#include <QtTest>
+#include <QtJsonSerializer>
+
+#include "allocationcounter.h"
+#include "allocationmodel.h"
+
+// Fails if a de/serialization of one of the canonical shapes allocates more than recorded in thresholds.json.
+// Run with QJSONSERIALIZER_RECORD_ALLOCATIONS=1 to write the measured values to that file instead, i.e. after
+// an intended change of the allocation behaviour
+class AllocationTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	enum Shape {
+		Gadget,
+		GadgetList,
+		Object,
+		ObjectTree,
+		IntList,
+		StringMap
+	};
+	Q_ENUM(Shape)
+
+private Q_SLOTS:
+	void initTestCase();
+	void cleanupTestCase();
+
+	void testAllocations_data();
+	void testAllocations();
+
+private:
+	static const int Iterations = 10;
+
+	QJsonSerializer *serializer = nullptr;
+	QString thresholdsPath;
+	double tolerance = 0.0;
+	QJsonObject thresholds;
+	bool record = false;
+	QJsonObject recorded;
+
+	static QVariant createData(Shape shape);
+	static void destroyData(QVariant &data);
+	AllocationCounter::Snapshot measure(Shape shape, bool deserialize);
+};
+
+void AllocationTest::initTestCase()
+{
+	QJsonSerializer::registerListConverters<AllocGadget>();
+	QJsonSerializer::registerListConverters<AllocObject*>();
+	QJsonSerializer::registerMapConverters<QString>();
+	serializer = new QJsonSerializer{this};
+
+	thresholdsPath = QFINDTESTDATA("thresholds.json");
+	QVERIFY(!thresholdsPath.isEmpty());
+	QFile file{thresholdsPath};
+	QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+	QJsonParseError error;
+	const auto root = QJsonDocument::fromJson(file.readAll(), &error).object();
+	QVERIFY2(error.error == QJsonParseError::NoError, qUtf8Printable(error.errorString()));
+	tolerance = root[QStringLiteral("tolerance")].toDouble();
+	thresholds = root[QStringLiteral("thresholds")].toObject();
+
+	record = qEnvironmentVariableIntValue("QJSONSERIALIZER_RECORD_ALLOCATIONS") != 0;
+}
+
+void AllocationTest::cleanupTestCase()
+{
+	if(record && !recorded.isEmpty()) {
+		QFile file{thresholdsPath};
+		QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate));
+		file.write(QJsonDocument{QJsonObject {
+							 {QStringLiteral("tolerance"), tolerance},
+							 {QStringLiteral("thresholds"), recorded}
+						 }}.toJson(QJsonDocument::Indented));
+		qInfo("Recorded the allocation thresholds to %s", qUtf8Printable(thresholdsPath));
+	}
+
+	delete serializer;
+	serializer = nullptr;
+}
+
+void AllocationTest::testAllocations_data()
+{
+	QTest::addColumn<Shape>("shape");
+	QTest::addColumn<bool>("deserialize");
+
+	const auto metaEnum = QMetaEnum::fromType<Shape>();
+	for(auto i = 0; i < metaEnum.keyCount(); ++i) {
+		const auto shape = static_cast<Shape>(metaEnum.value(i));
+		const QByteArray name = metaEnum.key(i);
+		QTest::newRow(("serialize/" + name).constData()) << shape << false;
+		QTest::newRow(("deserialize/" + name).constData()) << shape << true;
+	}
+}
+
+void AllocationTest::testAllocations()
+{
+	QFETCH(Shape, shape);
+	QFETCH(bool, deserialize);
+
+	if(!AllocationCounter::countsMalloc())
+		QSKIP("The thresholds are only valid if malloc is counted as well (glibc only)");
+
+	const auto key = QString::fromUtf8(QTest::currentDataTag());
+	AllocationCounter::Snapshot allocations;
+	try {
+		allocations = measure(shape, deserialize);
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+
+	if(record) {
+		recorded[key] = QJsonObject {
+			{QStringLiteral("allocations"), allocations.count},
+			{QStringLiteral("bytes"), allocations.bytes}
+		};
+		return;
+	}
+
+	const auto threshold = thresholds[key].toObject();
+	if(threshold.isEmpty()) {
+		QSKIP(qUtf8Printable(QStringLiteral("No threshold recorded - measured %1 allocations with %2 bytes")
+							 .arg(allocations.count)
+							 .arg(allocations.bytes)));
+	}
+
+	const auto maxCount = threshold[QStringLiteral("allocations")].toDouble() * (1.0 + tolerance);
+	const auto maxBytes = threshold[QStringLiteral("bytes")].toDouble() * (1.0 + tolerance);
+	QVERIFY2(allocations.count <= maxCount,
+			 qUtf8Printable(QStringLiteral("%1 allocations, but only %2 are allowed")
+							.arg(allocations.count)
+							.arg(qFloor(maxCount))));
+	QVERIFY2(allocations.bytes <= maxBytes,
+			 qUtf8Printable(QStringLiteral("%1 bytes allocated, but only %2 are allowed")
+							.arg(allocations.bytes)
+							.arg(qFloor(maxBytes))));
+}
+
+QVariant AllocationTest::createData(Shape shape)
+{
+	switch(shape) {
+	case Gadget:
+		return QVariant::fromValue(AllocGadget::create(1));
+	case GadgetList: {
+		QList<AllocGadget> list;
+		for(auto i = 0; i < 50; ++i)
+			list.append(AllocGadget::create(i));
+		return QVariant::fromValue(list);
+	}
+	case Object:
+		return QVariant::fromValue(AllocObject::create(1));
+	case ObjectTree:
+		return QVariant::fromValue(AllocObject::create(1, 2, 4));
+	case IntList: {
+		QList<int> list;
+		for(auto i = 0; i < 100; ++i)
+			list.append(i);
+		return QVariant::fromValue(list);
+	}
+	case StringMap: {
+		QMap<QString, QString> map;
+		for(auto i = 0; i < 50; ++i)
+			map.insert(QStringLiteral("key-%1").arg(i), QStringLiteral("value-%1").arg(i));
+		return QVariant::fromValue(map);
+	}
+	default:
+		Q_UNREACHABLE();
+		return {};
+	}
+}
+
+void AllocationTest::destroyData(QVariant &data)
+{
+	if(data.userType() == qMetaTypeId<AllocObject*>())
+		delete data.value<AllocObject*>();
+	data.clear();
+}
+
+AllocationCounter::Snapshot AllocationTest::measure(Shape shape, bool deserialize)
+{
+	auto data = createData(shape);
+	const auto typeId = data.userType();
+	const auto json = serializer->serialize(data);
+	const auto operation = [&]() {
+		if(deserialize) {
+			auto result = serializer->deserialize(json, typeId);
+			destroyData(result);
+		} else
+			serializer->serialize(data);
+	};
+
+	// warm up caches (converters, metatypes, thread storage) outside of the measurement
+	operation();
+	const auto start = AllocationCounter::snapshot();
+	for(auto i = 0; i < Iterations; ++i)
+		operation();
+	const auto end = AllocationCounter::snapshot();
+	destroyData(data);
+
+	AllocationCounter::Snapshot result;
+	result.count = (end.count - start.count) / Iterations;
+	result.bytes = (end.bytes - start.bytes) / Iterations;
+	return result;
+}
+
+QTEST_MAIN(AllocationTest)
+
+#include "tst_allocation.moc"
@@ -28,7 +28,7 @@ QJsonTypeConverter *BytearrayConverterTest::converter()
 void BytearrayConverterTest::addConverterData()
 {
 	QTest::newRow("bytearray") << static_cast<int>(QJsonTypeConverter::Standard)
-							   << QList<QJsonValue::Type>{QJsonValue::String};
+							   << QList<QJsonValue::Type>{QJsonValue::String, QJsonValue::Object};
 }
 
 void BytearrayConverterTest::addMetaData()
@@ -0,0 +1,14 @@
+TEMPLATE = app
+
+QT = core testlib jsonserializer
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = tst_columnlistconverter
+
+include(../convlib.pri)
+
+SOURCES += \
+	tst_columnlistconverter.cpp
+
+include(../../testrun.pri)
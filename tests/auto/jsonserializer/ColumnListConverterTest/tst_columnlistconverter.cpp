@@ -0,0 +1,141 @@
+#include <QtTest>
+#include <QtJsonSerializer>
+
+#include "typeconvertertestbase.h"
+
+#include <QtJsonSerializer/private/qjsonlistconverter_p.h>
+
+class ColumnListConverterTest : public TypeConverterTestBase
+{
+	Q_OBJECT
+
+protected:
+	void initTest() override;
+	QJsonTypeConverter *converter() override;
+	void addConverterData() override;
+	void addMetaData() override;
+	void addCommonSerData() override;
+	void addSerData() override;
+	void addDeserData() override;
+
+private:
+	QJsonColumnListConverter _converter;
+};
+
+void ColumnListConverterTest::initTest()
+{
+	QMetaType::registerEqualsComparator<QList<QObject*>>();
+}
+
+QJsonTypeConverter *ColumnListConverterTest::converter()
+{
+	return &_converter;
+}
+
+void ColumnListConverterTest::addConverterData()
+{
+	QTest::newRow("columns") << static_cast<int>(QJsonTypeConverter::Standard)
+							 << QList<QJsonValue::Type>{QJsonValue::Array, QJsonValue::Object};
+}
+
+void ColumnListConverterTest::addMetaData()
+{
+	QTest::newRow("object") << qMetaTypeId<QList<QObject*>>()
+							<< true;
+	QTest::newRow("vector") << qMetaTypeId<QVector<QObject*>>()
+							<< true;
+
+	QTest::newRow("int") << qMetaTypeId<QList<int>>()
+						 << false;
+	QTest::newRow("variant") << static_cast<int>(QMetaType::QVariantList)
+							 << false;
+	QTest::newRow("invalid") << qMetaTypeId<QPair<int, int>>()
+							 << false;
+}
+
+void ColumnListConverterTest::addCommonSerData()
+{
+	QTest::newRow("empty") << QVariantHash{}
+						   << TestQ{}
+						   << static_cast<QObject*>(nullptr)
+						   << qMetaTypeId<QList<QObject*>>()
+						   << QVariant::fromValue(QList<QObject*>{})
+						   << QJsonValue{QJsonArray{}};
+	QTest::newRow("columns") << QVariantHash{{QStringLiteral("columnarLists"), true}}
+							 << TestQ{
+									{QMetaType::QObjectStar, QVariant::fromValue<QObject*>(this), QJsonObject{{QStringLiteral("a"), 1}, {QStringLiteral("b"), true}}},
+									{QMetaType::QObjectStar, QVariant::fromValue<QObject*>(nullptr), QJsonValue::Null},
+									{QMetaType::QObjectStar, QVariant::fromValue<QObject*>(this), QJsonObject{{QStringLiteral("a"), 2}, {QStringLiteral("b"), false}}}
+								}
+							 << static_cast<QObject*>(this)
+							 << qMetaTypeId<QList<QObject*>>()
+							 << QVariant::fromValue(QList<QObject*>{this, nullptr, this})
+							 << QJsonValue{QJsonObject{
+									{QStringLiteral("@columns"), QJsonArray{QStringLiteral("a"), QStringLiteral("b")}},
+									{QStringLiteral("@rows"), QJsonArray{
+										QJsonArray{1, true},
+										QJsonValue::Null,
+										QJsonArray{2, false}
+									}}
+								}};
+}
+
+void ColumnListConverterTest::addSerData()
+{
+	QTest::newRow("columns.disabled") << QVariantHash{}
+									  << TestQ{{QMetaType::QObjectStar, QVariant::fromValue<QObject*>(this), QJsonObject{{QStringLiteral("a"), 1}}}}
+									  << static_cast<QObject*>(nullptr)
+									  << qMetaTypeId<QList<QObject*>>()
+									  << QVariant::fromValue(QList<QObject*>{this})
+									  << QJsonValue{QJsonArray{QJsonObject{{QStringLiteral("a"), 1}}}};
+	QTest::newRow("columns.mismatch") << QVariantHash{{QStringLiteral("columnarLists"), true}}
+									  << TestQ{
+											{QMetaType::QObjectStar, QVariant::fromValue<QObject*>(this), QJsonObject{{QStringLiteral("a"), 1}}},
+											{QMetaType::QObjectStar, QVariant::fromValue<QObject*>(this), QJsonObject{{QStringLiteral("b"), 2}}}
+										}
+									  << static_cast<QObject*>(nullptr)
+									  << qMetaTypeId<QList<QObject*>>()
+									  << QVariant::fromValue(QList<QObject*>{this, this})
+									  << QJsonValue{QJsonArray{
+											QJsonObject{{QStringLiteral("a"), 1}},
+											QJsonObject{{QStringLiteral("b"), 2}}
+										}};
+	QTest::newRow("columns.null") << QVariantHash{{QStringLiteral("columnarLists"), true}}
+								  << TestQ{{QMetaType::QObjectStar, QVariant::fromValue<QObject*>(nullptr), QJsonValue::Null}}
+								  << static_cast<QObject*>(nullptr)
+								  << qMetaTypeId<QList<QObject*>>()
+								  << QVariant::fromValue(QList<QObject*>{nullptr})
+								  << QJsonValue{QJsonArray{QJsonValue::Null}};
+}
+
+void ColumnListConverterTest::addDeserData()
+{
+	QTest::newRow("object") << QVariantHash{}
+							<< TestQ{}
+							<< static_cast<QObject*>(nullptr)
+							<< qMetaTypeId<QList<QObject*>>()
+							<< QVariant{}
+							<< QJsonValue{QJsonObject{{QStringLiteral("a"), 1}}};
+	QTest::newRow("columns.invalidColumn") << QVariantHash{}
+										   << TestQ{}
+										   << static_cast<QObject*>(nullptr)
+										   << qMetaTypeId<QList<QObject*>>()
+										   << QVariant{}
+										   << QJsonValue{QJsonObject{
+												  {QStringLiteral("@columns"), QJsonArray{1}},
+												  {QStringLiteral("@rows"), QJsonArray{}}
+											  }};
+	QTest::newRow("columns.invalidRow") << QVariantHash{}
+										<< TestQ{}
+										<< static_cast<QObject*>(nullptr)
+										<< qMetaTypeId<QList<QObject*>>()
+										<< QVariant{}
+										<< QJsonValue{QJsonObject{
+											   {QStringLiteral("@columns"), QJsonArray{QStringLiteral("a")}},
+											   {QStringLiteral("@rows"), QJsonArray{QJsonArray{1, 2}}}
+										   }};
+}
+
+QTEST_MAIN(ColumnListConverterTest)
+
+#include "tst_columnlistconverter.moc"
@@ -0,0 +1,183 @@
+#include <QtTest>
+#include <QtJsonSerializer>
+
+#include "typeconvertertestbase.h"
+
+#include <QtJsonSerializer/private/qjsondatetimeconverter_p.h>
+
+class DateTimeConverterTest : public TypeConverterTestBase
+{
+	Q_OBJECT
+
+protected:
+	QJsonTypeConverter *converter() override;
+	void addConverterData() override;
+	void addMetaData() override;
+	void addCommonSerData() override;
+	void addSerData() override;
+	void addDeserData() override;
+
+private:
+	QJsonDateTimeConverter _converter;
+};
+
+QJsonTypeConverter *DateTimeConverterTest::converter()
+{
+	return &_converter;
+}
+
+void DateTimeConverterTest::addConverterData()
+{
+	QTest::newRow("datetime") << static_cast<int>(QJsonTypeConverter::Standard)
+							  << QList<QJsonValue::Type>{QJsonValue::String, QJsonValue::Double, QJsonValue::Null};
+}
+
+void DateTimeConverterTest::addMetaData()
+{
+	QTest::newRow("date") << static_cast<int>(QMetaType::QDate)
+						  << true;
+	QTest::newRow("time") << static_cast<int>(QMetaType::QTime)
+						  << true;
+	QTest::newRow("datetime") << static_cast<int>(QMetaType::QDateTime)
+							  << true;
+	QTest::newRow("invalid.string") << static_cast<int>(QMetaType::QString)
+									<< false;
+	QTest::newRow("invalid.longlong") << static_cast<int>(QMetaType::LongLong)
+									  << false;
+}
+
+void DateTimeConverterTest::addCommonSerData()
+{
+	QTest::newRow("date.valid") << QVariantHash{}
+								<< TestQ{}
+								<< static_cast<QObject*>(nullptr)
+								<< static_cast<int>(QMetaType::QDate)
+								<< QVariant{QDate{2010, 10, 20}}
+								<< QJsonValue{QStringLiteral("2010-10-20")};
+	QTest::newRow("date.invalid") << QVariantHash{}
+								  << TestQ{}
+								  << static_cast<QObject*>(nullptr)
+								  << static_cast<int>(QMetaType::QDate)
+								  << QVariant{QDate{}}
+								  << QJsonValue{QString{}};
+	QTest::newRow("time.valid") << QVariantHash{}
+								<< TestQ{}
+								<< static_cast<QObject*>(nullptr)
+								<< static_cast<int>(QMetaType::QTime)
+								<< QVariant{QTime{4, 3, 5, 12}}
+								<< QJsonValue{QStringLiteral("04:03:05.012")};
+	QTest::newRow("time.invalid") << QVariantHash{}
+								  << TestQ{}
+								  << static_cast<QObject*>(nullptr)
+								  << static_cast<int>(QMetaType::QTime)
+								  << QVariant{QTime{}}
+								  << QJsonValue{QString{}};
+	QTest::newRow("datetime.local") << QVariantHash{}
+									<< TestQ{}
+									<< static_cast<QObject*>(nullptr)
+									<< static_cast<int>(QMetaType::QDateTime)
+									<< QVariant{QDateTime{QDate{2010, 10, 20}, QTime{14, 30}}}
+									<< QJsonValue{QStringLiteral("2010-10-20T14:30:00.000")};
+	QTest::newRow("datetime.utc") << QVariantHash{}
+								  << TestQ{}
+								  << static_cast<QObject*>(nullptr)
+								  << static_cast<int>(QMetaType::QDateTime)
+								  << QVariant{QDateTime{QDate{2010, 10, 20}, QTime{14, 30, 15, 123}, Qt::UTC}}
+								  << QJsonValue{QStringLiteral("2010-10-20T14:30:15.123Z")};
+	QTest::newRow("datetime.offset") << QVariantHash{}
+									 << TestQ{}
+									 << static_cast<QObject*>(nullptr)
+									 << static_cast<int>(QMetaType::QDateTime)
+									 << QVariant{QDateTime{QDate{2010, 10, 20}, QTime{14, 30}, Qt::OffsetFromUTC, -5400}}
+									 << QJsonValue{QStringLiteral("2010-10-20T14:30:00.000-01:30")};
+	QTest::newRow("datetime.invalid") << QVariantHash{}
+									  << TestQ{}
+									  << static_cast<QObject*>(nullptr)
+									  << static_cast<int>(QMetaType::QDateTime)
+									  << QVariant{QDateTime{}}
+									  << QJsonValue{QString{}};
+	QTest::newRow("epoch.valid") << QVariantHash{{QStringLiteral("dateTimeAsEpoch"), true}}
+								 << TestQ{}
+								 << static_cast<QObject*>(nullptr)
+								 << static_cast<int>(QMetaType::QDateTime)
+								 << QVariant{QDateTime{QDate{2010, 10, 20}, QTime{14, 30}, Qt::UTC}}
+								 << QJsonValue{1287585000000.0};
+	QTest::newRow("epoch.invalid") << QVariantHash{{QStringLiteral("dateTimeAsEpoch"), true}}
+								   << TestQ{}
+								   << static_cast<QObject*>(nullptr)
+								   << static_cast<int>(QMetaType::QDateTime)
+								   << QVariant{QDateTime{}}
+								   << QJsonValue{QJsonValue::Null};
+}
+
+void DateTimeConverterTest::addSerData()
+{
+	QTest::newRow("epoch.date") << QVariantHash{{QStringLiteral("dateTimeAsEpoch"), true}}
+								<< TestQ{}
+								<< static_cast<QObject*>(nullptr)
+								<< static_cast<int>(QMetaType::QDate)
+								<< QVariant{QDate{2010, 10, 20}}
+								<< QJsonValue{QStringLiteral("2010-10-20")};
+}
+
+void DateTimeConverterTest::addDeserData()
+{
+	QTest::newRow("date.null") << QVariantHash{}
+							   << TestQ{}
+							   << static_cast<QObject*>(nullptr)
+							   << static_cast<int>(QMetaType::QDate)
+							   << QVariant{QDate{}}
+							   << QJsonValue{QJsonValue::Null};
+	QTest::newRow("date.number") << QVariantHash{}
+								 << TestQ{}
+								 << static_cast<QObject*>(nullptr)
+								 << static_cast<int>(QMetaType::QDate)
+								 << QVariant{QDate{}}
+								 << QJsonValue{42};
+	QTest::newRow("date.garbage") << QVariantHash{}
+								  << TestQ{}
+								  << static_cast<QObject*>(nullptr)
+								  << static_cast<int>(QMetaType::QDate)
+								  << QVariant{QDate{}}
+								  << QJsonValue{QStringLiteral("2010-13-20")};
+	QTest::newRow("time.short") << QVariantHash{}
+								<< TestQ{}
+								<< static_cast<QObject*>(nullptr)
+								<< static_cast<int>(QMetaType::QTime)
+								<< QVariant{QTime{14, 30}}
+								<< QJsonValue{QStringLiteral("14:30")};
+	QTest::newRow("time.fraction") << QVariantHash{}
+								   << TestQ{}
+								   << static_cast<QObject*>(nullptr)
+								   << static_cast<int>(QMetaType::QTime)
+								   << QVariant{QTime{14, 30, 15, 500}}
+								   << QJsonValue{QStringLiteral("14:30:15.5")};
+	QTest::newRow("datetime.noms") << QVariantHash{}
+								   << TestQ{}
+								   << static_cast<QObject*>(nullptr)
+								   << static_cast<int>(QMetaType::QDateTime)
+								   << QVariant{QDateTime{QDate{2010, 10, 20}, QTime{14, 30, 15}, Qt::UTC}}
+								   << QJsonValue{QStringLiteral("2010-10-20T14:30:15Z")};
+	QTest::newRow("datetime.qtfallback") << QVariantHash{}
+										 << TestQ{}
+										 << static_cast<QObject*>(nullptr)
+										 << static_cast<int>(QMetaType::QDateTime)
+										 << QVariant{QDateTime::fromString(QStringLiteral("2010-10-20T14:30:15+0200"), Qt::ISODate)}
+										 << QJsonValue{QStringLiteral("2010-10-20T14:30:15+0200")};
+	QTest::newRow("datetime.epoch") << QVariantHash{}
+									<< TestQ{}
+									<< static_cast<QObject*>(nullptr)
+									<< static_cast<int>(QMetaType::QDateTime)
+									<< QVariant{QDateTime{QDate{2010, 10, 20}, QTime{14, 30}, Qt::UTC}}
+									<< QJsonValue{1287585000000.0};
+	QTest::newRow("datetime.null") << QVariantHash{}
+								   << TestQ{}
+								   << static_cast<QObject*>(nullptr)
+								   << static_cast<int>(QMetaType::QDateTime)
+								   << QVariant{QDateTime{}}
+								   << QJsonValue{QJsonValue::Null};
+}
+
+QTEST_MAIN(DateTimeConverterTest)
+
+#include "tst_datetimeconverter.moc"
@@ -0,0 +1,19 @@
+TEMPLATE = app
+
+QT = core testlib jsonserializer
+CONFIG += console qjsonserializergen
+CONFIG -= app_bundle
+
+TARGET = tst_generatedconverter
+
+HEADERS += \
+	generatedgadget.h
+
+SOURCES += \
+	tst_generatedconverter.cpp \
+	generatedgadget.cpp
+
+JSON_SERIALIZERS += \
+	generatedgadget.h
+
+include(../../testrun.pri)
@@ -0,0 +1,23 @@
+#include "generatedgadget.h"
+
+QString Generated::GeneratedGadget::name() const
+{
+	return _name;
+}
+
+void Generated::GeneratedGadget::setName(const QString &name)
+{
+	_name = name;
+}
+
+bool Generated::GeneratedGadget::operator==(const GeneratedGadget &other) const
+{
+	// exclude unstored properties
+	return id == other.id &&
+			qFuzzyCompare(ratio, other.ratio) &&
+			active == other.active &&
+			_name == other._name &&
+			level == other.level &&
+			tags == other.tags &&
+			values == other.values;
+}
@@ -0,0 +1,80 @@
+#ifndef GENERATEDGADGET_H
+#define GENERATEDGADGET_H
+
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+
+namespace Generated {
+
+// properties of every kind the generator distinguishes: direct scalars, accessor functions, enums, containers
+// and properties that are not stored
+class GeneratedGadget
+{
+	Q_GADGET
+	Q_CLASSINFO("generatedConverter", "true")
+
+	Q_PROPERTY(int id MEMBER id)
+	Q_PROPERTY(double ratio MEMBER ratio)
+	Q_PROPERTY(bool active MEMBER active)
+	Q_PROPERTY(QString name READ name WRITE setName)
+	Q_PROPERTY(Level level MEMBER level)
+	Q_PROPERTY(QStringList tags MEMBER tags)
+	Q_PROPERTY(QList<int> values MEMBER values)
+	Q_PROPERTY(int hidden MEMBER hidden STORED false)
+
+public:
+	enum Level {
+		Low,
+		Medium,
+		High
+	};
+	Q_ENUM(Level)
+
+	int id = 0;
+	double ratio = 0.0;
+	bool active = false;
+	Level level = Low;
+	QStringList tags;
+	QList<int> values;
+	int hidden = 0;
+
+	QString name() const;
+	void setName(const QString &name);
+
+	bool operator==(const GeneratedGadget &other) const;
+
+private:
+	QString _name;
+};
+
+}
+
+// the same gadget without the annotation, to compare against the reflective gadget converter
+class ReflectedGadget
+{
+	Q_GADGET
+
+	Q_PROPERTY(int id MEMBER id)
+	Q_PROPERTY(double ratio MEMBER ratio)
+	Q_PROPERTY(bool active MEMBER active)
+	Q_PROPERTY(QString name MEMBER name)
+	Q_PROPERTY(Generated::GeneratedGadget::Level level MEMBER level)
+	Q_PROPERTY(QStringList tags MEMBER tags)
+	Q_PROPERTY(QList<int> values MEMBER values)
+	Q_PROPERTY(int hidden MEMBER hidden STORED false)
+
+public:
+	int id = 0;
+	double ratio = 0.0;
+	bool active = false;
+	QString name;
+	Generated::GeneratedGadget::Level level = Generated::GeneratedGadget::Low;
+	QStringList tags;
+	QList<int> values;
+	int hidden = 0;
+};
+
+Q_DECLARE_METATYPE(Generated::GeneratedGadget)
+Q_DECLARE_METATYPE(ReflectedGadget)
+
+#endif // GENERATEDGADGET_H
@@ -0,0 +1,244 @@
+#include <QtTest>
+#include <QtJsonSerializer>
+
+#include "generatedgadget.h"
+
+using Generated::GeneratedGadget;
+
+// writes ints as strings, to check that the generated converters do not bypass registered converters
+class IntStringConverter : public QJsonTypeConverter
+{
+public:
+	bool canConvert(int metaTypeId) const override {
+		return metaTypeId == QMetaType::Int;
+	}
+	QList<QJsonValue::Type> jsonTypes() const override {
+		return {QJsonValue::String};
+	}
+	QJsonValue serialize(int propertyType, const QVariant &value, const SerializationHelper *helper) const override {
+		Q_UNUSED(propertyType)
+		Q_UNUSED(helper)
+		return QString::number(value.toInt());
+	}
+	QVariant deserialize(int propertyType, const QJsonValue &value, QObject *parent, const SerializationHelper *helper) const override {
+		Q_UNUSED(propertyType)
+		Q_UNUSED(parent)
+		Q_UNUSED(helper)
+		return value.toString().toInt() * 2;
+	}
+};
+
+class CountingTracer : public QJsonSerializerTracer
+{
+public:
+	QByteArrayList names;
+
+	void traceEvent(const Event &event) override {
+		names.append(event.name);
+	}
+};
+
+class GeneratedConverterTest : public QObject
+{
+	Q_OBJECT
+
+private Q_SLOTS:
+	void initTestCase();
+	void cleanupTestCase();
+
+	void testSerialization();
+	void testDeserialization_data();
+	void testDeserialization();
+	void testValidation();
+	void testFieldSelector();
+	void testCustomConverter();
+	void testTracer();
+
+private:
+	QJsonSerializer *serializer;
+
+	static GeneratedGadget createGadget();
+	static ReflectedGadget reflect(const GeneratedGadget &gadget);
+};
+
+void GeneratedConverterTest::initTestCase()
+{
+	QJsonSerializer::registerListConverters<int>();
+	serializer = new QJsonSerializer{this};
+}
+
+void GeneratedConverterTest::cleanupTestCase()
+{
+	delete serializer;
+	serializer = nullptr;
+}
+
+void GeneratedConverterTest::testSerialization()
+{
+	const auto gadget = createGadget();
+	const auto generated = serializer->serialize(gadget);
+	QCOMPARE(generated, serializer->serialize(reflect(gadget)));
+	QVERIFY(!generated.contains(QStringLiteral("hidden")));
+
+	serializer->setEnumAsString(true);
+	QCOMPARE(serializer->serialize(gadget), serializer->serialize(reflect(gadget)));
+	serializer->setEnumAsString(false);
+}
+
+void GeneratedConverterTest::testDeserialization_data()
+{
+	QTest::addColumn<QJsonObject>("data");
+
+	const auto json = serializer->serialize(createGadget());
+	QTest::newRow("serialized") << json;
+
+	auto converted = json;
+	converted[QStringLiteral("id")] = QStringLiteral("42");
+	converted[QStringLiteral("ratio")] = 2;
+	converted[QStringLiteral("active")] = 1;
+	converted[QStringLiteral("name")] = 24;
+	QTest::newRow("converted") << converted;
+
+	auto fraction = json;
+	fraction[QStringLiteral("id")] = 4.5;
+	QTest::newRow("fraction") << fraction;
+
+	auto partial = json;
+	partial.remove(QStringLiteral("tags"));
+	partial.remove(QStringLiteral("name"));
+	partial[QStringLiteral("hidden")] = 13;
+	QTest::newRow("partial") << partial;
+}
+
+void GeneratedConverterTest::testDeserialization()
+{
+	QFETCH(QJsonObject, data);
+
+	try {
+		const auto generated = serializer->deserialize<GeneratedGadget>(data);
+		const auto reflected = serializer->deserialize<ReflectedGadget>(data);
+		QCOMPARE(generated.id, reflected.id);
+		QCOMPARE(generated.ratio, reflected.ratio);
+		QCOMPARE(generated.active, reflected.active);
+		QCOMPARE(generated.name(), reflected.name);
+		QCOMPARE(generated.level, reflected.level);
+		QCOMPARE(generated.tags, reflected.tags);
+		QCOMPARE(generated.values, reflected.values);
+		QCOMPARE(generated.hidden, reflected.hidden);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+void GeneratedConverterTest::testValidation()
+{
+	auto json = serializer->serialize(createGadget());
+	json[QStringLiteral("extra")] = true;
+
+	try {
+		serializer->setValidationFlags(QJsonSerializer::NoExtraProperties);
+		QVERIFY_EXCEPTION_THROWN(serializer->deserialize<GeneratedGadget>(json), QJsonDeserializationException);
+		json.remove(QStringLiteral("extra"));
+		QCOMPARE(serializer->deserialize<GeneratedGadget>(json), createGadget());
+
+		serializer->setValidationFlags(QJsonSerializer::AllProperties);
+		json.remove(QStringLiteral("ratio"));
+		QVERIFY_EXCEPTION_THROWN(serializer->deserialize<GeneratedGadget>(json), QJsonDeserializationException);
+		// unstored properties are never required
+		json[QStringLiteral("ratio")] = 0.5;
+		serializer->deserialize<GeneratedGadget>(json);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+	serializer->setValidationFlags(QJsonSerializer::StandardValidation);
+}
+
+void GeneratedConverterTest::testFieldSelector()
+{
+	const auto json = serializer->serialize(createGadget());
+
+	try {
+		const auto generated = serializer->deserialize<GeneratedGadget>(json, QJsonFieldSelector{
+																			 QStringLiteral("id"),
+																			 QStringLiteral("name")
+																		 });
+
+		GeneratedGadget expected;
+		expected.id = createGadget().id;
+		expected.setName(createGadget().name());
+		QCOMPARE(generated, expected);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+void GeneratedConverterTest::testCustomConverter()
+{
+	QJsonSerializer local;
+	local.addJsonTypeConverter<IntStringConverter>();
+
+	try {
+		const auto gadget = createGadget();
+		const auto json = local.serialize(gadget);
+		QCOMPARE(json, local.serialize(reflect(gadget)));
+		QCOMPARE(json[QStringLiteral("id")], QJsonValue{QStringLiteral("42")});
+
+		const auto generated = local.deserialize<GeneratedGadget>(json);
+		QCOMPARE(generated.id, local.deserialize<ReflectedGadget>(json).id);
+		QCOMPARE(generated.id, 84);
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+void GeneratedConverterTest::testTracer()
+{
+	QJsonSerializer local;
+	auto tracer = QSharedPointer<CountingTracer>::create();
+	local.setTracer(tracer);
+
+	try {
+		const auto json = local.serialize(createGadget());
+		QVERIFY(tracer->names.contains("id"));
+		QVERIFY(tracer->names.contains("name"));
+
+		tracer->names.clear();
+		local.deserialize<GeneratedGadget>(json);
+		QVERIFY(tracer->names.contains("active"));
+		QVERIFY(tracer->names.contains("ratio"));
+	} catch(QException &e) {
+		QFAIL(e.what());
+	}
+}
+
+GeneratedGadget GeneratedConverterTest::createGadget()
+{
+	GeneratedGadget gadget;
+	gadget.id = 42;
+	gadget.ratio = 0.5;
+	gadget.active = true;
+	gadget.setName(QStringLiteral("baum"));
+	gadget.level = GeneratedGadget::Medium;
+	gadget.tags = QStringList{QStringLiteral("a"), QStringLiteral("b")};
+	gadget.values = QList<int>{1, 2, 3};
+	gadget.hidden = 7;
+	return gadget;
+}
+
+ReflectedGadget GeneratedConverterTest::reflect(const GeneratedGadget &gadget)
+{
+	ReflectedGadget reflected;
+	reflected.id = gadget.id;
+	reflected.ratio = gadget.ratio;
+	reflected.active = gadget.active;
+	reflected.name = gadget.name();
+	reflected.level = gadget.level;
+	reflected.tags = gadget.tags;
+	reflected.values = gadget.values;
+	reflected.hidden = gadget.hidden;
+	return reflected;
+}
+
+QTEST_MAIN(GeneratedConverterTest)
+
+#include "tst_generatedconverter.moc"
@@ -40,19 +40,19 @@ void GeomConverterTest::addConverterData()
 {
 	QTest::newRow("size") << sizeConverter
 						  << static_cast<int>(QJsonTypeConverter::Standard)
-						  << QList<QJsonValue::Type>{QJsonValue::Object};
+						  << QList<QJsonValue::Type>{QJsonValue::Object, QJsonValue::Array};
 
 	QTest::newRow("point") << pointConverter
 						   << static_cast<int>(QJsonTypeConverter::Standard)
-						   << QList<QJsonValue::Type>{QJsonValue::Object};
+						   << QList<QJsonValue::Type>{QJsonValue::Object, QJsonValue::Array};
 
 	QTest::newRow("line") << lineConverter
 						  << static_cast<int>(QJsonTypeConverter::Standard)
-						  << QList<QJsonValue::Type>{QJsonValue::Object};
+						  << QList<QJsonValue::Type>{QJsonValue::Object, QJsonValue::Array};
 
 	QTest::newRow("rect") << rectConverter
 						  << static_cast<int>(QJsonTypeConverter::Standard)
-						  << QList<QJsonValue::Type>{QJsonValue::Object};
+						  << QList<QJsonValue::Type>{QJsonValue::Object, QJsonValue::Array};
 }
 
 void GeomConverterTest::addMetaData()
@@ -195,6 +195,63 @@ void GeomConverterTest::addCommonSerData()
 										{QStringLiteral("topLeft"), 42},
 										{QStringLiteral("bottomRight"), 42}
 									}};
+
+	QTest::newRow("size.int.array") << sizeConverter
+									<< QVariantHash{{QStringLiteral("geometryAsArray"), true}}
+									<< TestQ{}
+									<< static_cast<QObject*>(nullptr)
+									<< static_cast<int>(QMetaType::QSize)
+									<< QVariant{QSize{10, 20}}
+									<< QJsonValue{QJsonArray{10, 20}};
+	QTest::newRow("size.float.array") << sizeConverter
+									  << QVariantHash{{QStringLiteral("geometryAsArray"), true}}
+									  << TestQ{}
+									  << static_cast<QObject*>(nullptr)
+									  << static_cast<int>(QMetaType::QSizeF)
+									  << QVariant{QSizeF{10.1, 20.2}}
+									  << QJsonValue{QJsonArray{10.1, 20.2}};
+	QTest::newRow("point.int.array") << pointConverter
+									 << QVariantHash{{QStringLiteral("geometryAsArray"), true}}
+									 << TestQ{}
+									 << static_cast<QObject*>(nullptr)
+									 << static_cast<int>(QMetaType::QPoint)
+									 << QVariant{QPoint{10, 20}}
+									 << QJsonValue{QJsonArray{10, 20}};
+	QTest::newRow("point.float.array") << pointConverter
+									   << QVariantHash{{QStringLiteral("geometryAsArray"), true}}
+									   << TestQ{}
+									   << static_cast<QObject*>(nullptr)
+									   << static_cast<int>(QMetaType::QPointF)
+									   << QVariant{QPointF{10.1, 20.2}}
+									   << QJsonValue{QJsonArray{10.1, 20.2}};
+	QTest::newRow("line.int.array") << lineConverter
+									<< QVariantHash{{QStringLiteral("geometryAsArray"), true}}
+									<< TestQ{}
+									<< static_cast<QObject*>(nullptr)
+									<< static_cast<int>(QMetaType::QLine)
+									<< QVariant{QLine{10, 11, 20, 21}}
+									<< QJsonValue{QJsonArray{10, 11, 20, 21}};
+	QTest::newRow("line.float.array") << lineConverter
+									  << QVariantHash{{QStringLiteral("geometryAsArray"), true}}
+									  << TestQ{}
+									  << static_cast<QObject*>(nullptr)
+									  << static_cast<int>(QMetaType::QLineF)
+									  << QVariant{QLineF{10.1, 11.1, 20.2, 21.2}}
+									  << QJsonValue{QJsonArray{10.1, 11.1, 20.2, 21.2}};
+	QTest::newRow("rect.int.array") << rectConverter
+									<< QVariantHash{{QStringLiteral("geometryAsArray"), true}}
+									<< TestQ{}
+									<< static_cast<QObject*>(nullptr)
+									<< static_cast<int>(QMetaType::QRect)
+									<< QVariant{QRect{10, 11, 20, 21}}
+									<< QJsonValue{QJsonArray{10, 11, 20, 21}};
+	QTest::newRow("rect.float.array") << rectConverter
+									  << QVariantHash{{QStringLiteral("geometryAsArray"), true}}
+									  << TestQ{}
+									  << static_cast<QObject*>(nullptr)
+									  << static_cast<int>(QMetaType::QRectF)
+									  << QVariant{QRectF{10.1, 11.1, 20.2, 21.2}}
+									  << QJsonValue{QJsonArray{10.1, 11.1, 20.2, 21.2}};
 }
 
 void GeomConverterTest::addDeserData()
@@ -242,6 +299,46 @@ void GeomConverterTest::addDeserData()
 											{QStringLiteral("left"), 42},
 											{QStringLiteral("right"), 42}
 										}};
+
+	QTest::newRow("size.invalid.extra") << sizeConverter
+										<< QVariantHash{}
+										<< TestQ{}
+										<< static_cast<QObject*>(nullptr)
+										<< static_cast<int>(QMetaType::QSize)
+										<< QVariant{}
+										<< QJsonValue{QJsonObject{
+												{QStringLiteral("width"), 42},
+												{QStringLiteral("height"), 42},
+												{QStringLiteral("depth"), 42}
+											}};
+	QTest::newRow("size.array.implicit") << sizeConverter
+										 << QVariantHash{}
+										 << TestQ{}
+										 << static_cast<QObject*>(nullptr)
+										 << static_cast<int>(QMetaType::QSize)
+										 << QVariant{QSize{10, 20}}
+										 << QJsonValue{QJsonArray{10, 20}};
+	QTest::newRow("point.array.size") << pointConverter
+									  << QVariantHash{}
+									  << TestQ{}
+									  << static_cast<QObject*>(nullptr)
+									  << static_cast<int>(QMetaType::QPoint)
+									  << QVariant{}
+									  << QJsonValue{QJsonArray{10, 20, 30}};
+	QTest::newRow("line.array.type") << lineConverter
+									 << QVariantHash{}
+									 << TestQ{}
+									 << static_cast<QObject*>(nullptr)
+									 << static_cast<int>(QMetaType::QLine)
+									 << QVariant{}
+									 << QJsonValue{QJsonArray{10, 20, QStringLiteral("30"), 40}};
+	QTest::newRow("rect.array.size") << rectConverter
+									 << QVariantHash{}
+									 << TestQ{}
+									 << static_cast<QObject*>(nullptr)
+									 << static_cast<int>(QMetaType::QRectF)
+									 << QVariant{}
+									 << QJsonValue{QJsonArray{10.1, 20.2}};
 }
 
 QTEST_MAIN(GeomConverterTest)
@@ -0,0 +1,14 @@
+TEMPLATE = app
+
+QT = core testlib jsonserializer
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = tst_lazyconverter
+
+include(../convlib.pri)
+
+SOURCES += \
+	tst_lazyconverter.cpp
+
+include(../../testrun.pri)
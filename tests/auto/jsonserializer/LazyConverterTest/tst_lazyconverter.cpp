@@ -0,0 +1,209 @@
+#include <QtTest>
+#include <QtJsonSerializer>
+
+#include "typeconvertertestbase.h"
+
+#include <QtJsonSerializer/private/qjsonlazyconverter_p.h>
+
+class LazyConverterTest : public TypeConverterTestBase
+{
+	Q_OBJECT
+
+private Q_SLOTS:
+	void testLazyLoading();
+	void testDestroyedSerializer();
+	void testConcurrentLoading();
+
+protected:
+	void initTest() override;
+	QJsonTypeConverter *converter() override;
+	void addConverterData() override;
+	void addMetaData() override;
+	void addCommonSerData() override;
+	void addSerData() override;
+	void addDeserData() override;
+	bool compare(int type, QVariant &actual, QVariant &expected, const char *aName, const char *eName, const char *file, int line) override;
+
+private:
+	QJsonLazyConverter _converter;
+};
+
+void LazyConverterTest::testLazyLoading()
+{
+	const QJsonObject json {
+		{QStringLiteral("a"), 1}
+	};
+	const QVariantMap map {
+		{QStringLiteral("a"), 1}
+	};
+	helper->properties.clear();
+	helper->expectedParent = this;
+	helper->serData.clear();
+	helper->deserData = TestQ{{QMetaType::QVariantMap, map, json}};
+
+	try {
+		auto lazy = _converter.deserialize(qMetaTypeId<QJsonLazy<QVariantMap>>(), json, this, helper)
+				.value<QJsonLazy<QVariantMap>>();
+		QVERIFY(!lazy.isLoaded());
+		QCOMPARE(lazy.json(), QJsonValue{json});
+		QCOMPARE(helper->deserData.size(), 1);
+
+		// unloaded values are written back without being converted
+		QCOMPARE(_converter.serialize(qMetaTypeId<QJsonLazy<QVariantMap>>(), QVariant::fromValue(lazy), helper), QJsonValue{json});
+
+		// copies share the loaded value
+		const auto copy = lazy;
+		QCOMPARE(lazy.value(), map);
+		QVERIFY(lazy.isLoaded());
+		QVERIFY(copy.isLoaded());
+		QVERIFY(helper->deserData.isEmpty());
+		QCOMPARE(*copy, map);
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void LazyConverterTest::testDestroyedSerializer()
+{
+	QScopedPointer<DummySerializationHelper> tmpHelper{new DummySerializationHelper{}};
+	try {
+		auto lazy = _converter.deserialize(qMetaTypeId<QJsonLazy<QVariantMap>>(), QJsonObject{}, this, tmpHelper.data())
+				.value<QJsonLazy<QVariantMap>>();
+		QVERIFY(!lazy.isLoaded());
+		tmpHelper.reset();
+		QVERIFY_EXCEPTION_THROWN(lazy.value(), QJsonDeserializationException);
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void LazyConverterTest::testConcurrentLoading()
+{
+	const QJsonObject json {
+		{QStringLiteral("a"), 1}
+	};
+	const QVariantMap map {
+		{QStringLiteral("a"), 1}
+	};
+	helper->properties.clear();
+	helper->expectedParent = this;
+	helper->serData.clear();
+	helper->deserData = TestQ{{QMetaType::QVariantMap, map, json}};
+
+	try {
+		const auto lazy = _converter.deserialize(qMetaTypeId<QJsonLazy<QVariantMap>>(), json, this, helper)
+				.value<QJsonLazy<QVariantMap>>();
+
+		// the helper only has the data for one load, so a second one would fail
+		QAtomicInt failures;
+		QList<QThread*> threads;
+		for(auto i = 0; i < 4; ++i) {
+			const auto copy = lazy;
+			threads.append(QThread::create([copy, map, &failures]() {
+				try {
+					if(copy.value() != map)
+						failures.ref();
+				} catch(std::exception &) {
+					failures.ref();
+				}
+			}));
+		}
+		for(auto thread : threads)
+			thread->start();
+		for(auto thread : threads) {
+			QVERIFY(thread->wait(10000));
+			delete thread;
+		}
+		QCOMPARE(failures.load(), 0);
+		QVERIFY(helper->deserData.isEmpty());
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void LazyConverterTest::initTest()
+{
+	QJsonSerializer::registerLazyConverters<QVariantMap>();
+	QJsonSerializer::registerLazyConverters<QObject*>();
+}
+
+QJsonTypeConverter *LazyConverterTest::converter()
+{
+	return &_converter;
+}
+
+void LazyConverterTest::addConverterData()
+{
+	QTest::newRow("lazy") << static_cast<int>(QJsonTypeConverter::Standard)
+						  << QList<QJsonValue::Type>{
+								 QJsonValue::Null,
+								 QJsonValue::Bool,
+								 QJsonValue::Double,
+								 QJsonValue::String,
+								 QJsonValue::Array,
+								 QJsonValue::Object
+							 };
+}
+
+void LazyConverterTest::addMetaData()
+{
+	QTest::newRow("map") << qMetaTypeId<QJsonLazy<QVariantMap>>()
+						 << true;
+	QTest::newRow("object") << qMetaTypeId<QJsonLazy<QObject*>>()
+							<< true;
+	QTest::newRow("opaque") << qMetaTypeId<QJsonLazy<OpaqueDummy>>()
+							<< true;
+	QTest::newRow("invalid") << static_cast<int>(QMetaType::QVariantMap)
+							 << false;
+}
+
+void LazyConverterTest::addCommonSerData()
+{
+	QTest::newRow("map") << QVariantHash{}
+						 << TestQ{{QMetaType::QVariantMap, QVariantMap{{QStringLiteral("a"), 1}}, QJsonObject{{QStringLiteral("a"), 1}}}}
+						 << static_cast<QObject*>(this)
+						 << qMetaTypeId<QJsonLazy<QVariantMap>>()
+						 << QVariant::fromValue(QJsonLazy<QVariantMap>{QVariantMap{{QStringLiteral("a"), 1}}})
+						 << QJsonValue{QJsonObject{{QStringLiteral("a"), 1}}};
+	QTest::newRow("null") << QVariantHash{}
+						  << TestQ{{QMetaType::QObjectStar, QVariant::fromValue<QObject*>(nullptr), QJsonValue::Null}}
+						  << static_cast<QObject*>(this)
+						  << qMetaTypeId<QJsonLazy<QObject*>>()
+						  << QVariant::fromValue(QJsonLazy<QObject*>{})
+						  << QJsonValue{QJsonValue::Null};
+}
+
+void LazyConverterTest::addSerData()
+{
+	QTest::newRow("unregistered") << QVariantHash{}
+								  << TestQ{}
+								  << static_cast<QObject*>(nullptr)
+								  << qMetaTypeId<QJsonLazy<OpaqueDummy>>()
+								  << QVariant::fromValue(QJsonLazy<OpaqueDummy>{})
+								  << QJsonValue{QJsonValue::Undefined};
+}
+
+void LazyConverterTest::addDeserData()
+{
+	QTest::newRow("unregistered") << QVariantHash{}
+								  << TestQ{}
+								  << static_cast<QObject*>(nullptr)
+								  << qMetaTypeId<QJsonLazy<OpaqueDummy>>()
+								  << QVariant{}
+								  << QJsonValue{QJsonObject{}};
+}
+
+bool LazyConverterTest::compare(int type, QVariant &actual, QVariant &expected, const char *aName, const char *eName, const char *file, int line)
+{
+	// loads the deserialized value via the helper, to compare the contained values
+	if(_converter.canConvert(type)) {
+		auto actualValue = actual.value<QJsonLazyBase>().variant();
+		auto expectedValue = expected.value<QJsonLazyBase>().variant();
+		return QTest::qCompare(actualValue, expectedValue, aName, eName, file, line);
+	} else
+		return TypeConverterTestBase::compare(type, actual, expected, aName, eName, file, line);
+}
+
+QTEST_MAIN(LazyConverterTest)
+
+#include "tst_lazyconverter.moc"
@@ -161,6 +161,12 @@ void ListConverterTest::addSerData()
 								   << qMetaTypeId<QList<OpaqueDummy>>()
 								   << QVariant::fromValue(QList<OpaqueDummy>{{}, {}, {}})
 								   << QJsonValue{QJsonValue::Undefined};
+	QTest::newRow("columnarLists") << QVariantHash{{QStringLiteral("columnarLists"), true}}
+								   << TestQ{{QMetaType::Int, 1, 2}}
+								   << static_cast<QObject*>(nullptr)
+								   << qMetaTypeId<QList<int>>()
+								   << QVariant::fromValue(QList<int>{1})
+								   << QJsonValue{QJsonArray{2}};
 }
 
 QTEST_MAIN(ListConverterTest)
@@ -69,3 +69,9 @@ void EnumGadget::setFlagsProp(EnumFlags value)
 {
 	flagsProp = value;
 }
+
+
+
+VariantGadget::VariantGadget(const QVariant &value) :
+	value{value}
+{}
@@ -91,6 +91,18 @@ public:
 	void setFlagsProp(EnumFlags value);
 };
 
+struct VariantGadget
+{
+	Q_GADGET
+
+	Q_PROPERTY(QVariant value MEMBER value)
+
+public:
+	VariantGadget(const QVariant &value = {});
+
+	QVariant value;
+};
+
 Q_DECLARE_METATYPE(TestGadget)
 Q_DECLARE_TYPEINFO(TestGadget, Q_PRIMITIVE_TYPE);
 
@@ -104,4 +116,6 @@ Q_DECLARE_METATYPE(EnumGadget)
 Q_DECLARE_TYPEINFO(EnumGadget, Q_PRIMITIVE_TYPE);
 Q_DECLARE_OPERATORS_FOR_FLAGS(EnumGadget::EnumFlags)
 
+Q_DECLARE_METATYPE(VariantGadget)
+
 #endif // TESTGADGET_H
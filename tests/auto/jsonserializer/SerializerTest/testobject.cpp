@@ -1,15 +1,25 @@
 #include "testobject.h"
 
+QAtomicInt TestObject::instances;
+
 TestObject::TestObject(int data, QObject *parent) :
 	QObject{parent},
 	data{data}
 {
 	setObjectName(QStringLiteral("testname"));
+	instances.ref();
 }
 
 TestObject::TestObject(QObject *parent) :
 	QObject{parent}
-{}
+{
+	instances.ref();
+}
+
+TestObject::~TestObject()
+{
+	instances.deref();
+}
 
 bool TestObject::equals(const TestObject *lhs, const TestObject *rhs)
 {
@@ -20,3 +30,7 @@ bool TestObject::equals(const TestObject *lhs, const TestObject *rhs)
 	else
 		return lhs->data == rhs->data;
 }
+
+NodeObject::NodeObject(QObject *parent) :
+	QObject{parent}
+{}
@@ -2,6 +2,7 @@
 #define TESTOBJECT_H
 
 #include <QObject>
+#include <QAtomicInt>
 
 class TestObject : public QObject
 {
@@ -14,10 +15,31 @@ public:
 
 	explicit TestObject(int data, QObject *parent = nullptr);
 	Q_INVOKABLE TestObject(QObject *parent);
+	~TestObject() override;
+
+	// number of TestObjects that currently exist
+	static QAtomicInt instances;
 
 	static bool equals(const TestObject *lhs, const TestObject *rhs);
 };
 
+class NodeObject : public QObject
+{
+	Q_OBJECT
+
+	Q_PROPERTY(int data MEMBER data)
+	Q_PROPERTY(NodeObject* first MEMBER first)
+	Q_PROPERTY(NodeObject* second MEMBER second)
+
+public:
+	int data = 0;
+	NodeObject *first = nullptr;
+	NodeObject *second = nullptr;
+
+	Q_INVOKABLE NodeObject(QObject *parent = nullptr);
+};
+
 Q_DECLARE_METATYPE(TestObject*)
+Q_DECLARE_METATYPE(NodeObject*)
 
 #endif // TESTOBJECT_H
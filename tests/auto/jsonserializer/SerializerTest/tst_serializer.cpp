@@ -9,6 +9,125 @@ using TestPair = std::pair<bool, int>;
 Q_DECLARE_METATYPE(TestTuple)
 Q_DECLARE_METATYPE(TestPair)
 
+struct CachedValue {
+	int value;
+};
+Q_DECLARE_METATYPE(CachedValue)
+
+struct TypedPoint {
+	int x;
+	int y;
+
+	inline bool operator==(const TypedPoint &other) const {
+		return x == other.x && y == other.y;
+	}
+};
+Q_DECLARE_METATYPE(TypedPoint)
+
+class RecordingTracer : public QJsonSerializerTracer
+{
+public:
+	QList<Event> events;
+
+	void traceEvent(const Event &event) override {
+		events.append(event);
+	}
+};
+
+// removes itself from the serializer with the first event
+class SwappingTracer : public QJsonSerializerTracer
+{
+public:
+	QJsonSerializer *serializer;
+	int &count;
+
+	SwappingTracer(QJsonSerializer *serializer, int &count) :
+		serializer{serializer},
+		count{count}
+	{}
+
+	void traceEvent(const Event &event) override {
+		Q_UNUSED(event)
+		++count;
+		serializer->setTracer({});
+	}
+};
+
+class TypedPointConverter : public QJsonTypedConverter<TypedPoint, QJsonValue::Array>
+{
+public:
+	QJsonValue serialize(const TypedPoint &value, const SerializationHelper *helper) const override {
+		Q_UNUSED(helper)
+		return QJsonArray{value.x, value.y};
+	}
+
+	TypedPoint deserialize(const QJsonValue &value, QObject *parent, const SerializationHelper *helper) const override {
+		Q_UNUSED(parent)
+		Q_UNUSED(helper)
+		const auto array = value.toArray();
+		if(array.size() != 2)
+			throw QJsonDeserializationException("A point must have exactly 2 coordinates");
+		return {array[0].toInt(), array[1].toInt()};
+	}
+};
+
+class CachedValueConverter : public QJsonTypeConverter
+{
+public:
+	CachedValueConverter(int offset = 0) :
+		offset{offset}
+	{}
+
+	bool canConvert(int metaTypeId) const override {
+		return metaTypeId == qMetaTypeId<CachedValue>();
+	}
+
+	QList<QJsonValue::Type> jsonTypes() const override {
+		return {QJsonValue::Double};
+	}
+
+	QJsonValue serialize(int propertyType, const QVariant &value, const SerializationHelper *helper) const override {
+		Q_UNUSED(propertyType)
+		Q_UNUSED(helper)
+		return value.value<CachedValue>().value + offset;
+	}
+
+	QVariant deserialize(int propertyType, const QJsonValue &value, QObject *parent, const SerializationHelper *helper) const override {
+		Q_UNUSED(propertyType)
+		Q_UNUSED(parent)
+		Q_UNUSED(helper)
+		return QVariant::fromValue(CachedValue{value.toInt() - offset});
+	}
+
+private:
+	int offset;
+};
+
+class HexConverter : public QJsonTypeConverter
+{
+public:
+	bool canConvert(int metaTypeId) const override {
+		return metaTypeId == QMetaType::QByteArray;
+	}
+
+	QList<QJsonValue::Type> jsonTypes() const override {
+		return {QJsonValue::String};
+	}
+
+	QJsonValue serialize(int propertyType, const QVariant &value, const SerializationHelper *helper) const override {
+		Q_UNUSED(propertyType)
+		Q_UNUSED(helper)
+		return QString::fromUtf8(value.toByteArray().toHex());
+	}
+
+	QVariant deserialize(int propertyType, const QJsonValue &value, QObject *parent, const SerializationHelper *helper) const override {
+		Q_UNUSED(propertyType)
+		Q_UNUSED(parent)
+		Q_UNUSED(helper)
+		return QByteArray::fromHex(value.toString().toUtf8());
+	}
+};
+
 class SerializerTest : public QObject
 {
 	Q_OBJECT
@@ -26,8 +145,32 @@ private Q_SLOTS:
 	void testDeserialization();
 
 	void testDeviceSerialization();
+	void testConverterCache();
+	void testCompressedSerialization();
+	void testWriteJob();
+	void testWriteJobWatermark();
+	void testAsync();
+	void testAsyncCancel();
+	void testParallelDeserialization();
+	void testReadPipeline();
+	void testOptions();
+	void testFieldSelector();
+	void testFieldSelectorSerialization();
+	void testLazyParent();
+	void testObjectReferences();
+	void testAttachments();
+	void testStringPool();
+	void testLazyOptions();
+	void testTypedConverter();
+	void testTracer();
 	void testExceptionTrace();
 
+	void testMsgPackSerialization_data();
+	void testMsgPackSerialization();
+	void testMsgPackRoundTrip_data();
+	void testMsgPackRoundTrip();
+	void testMsgPackCustomConverter();
+
 private:
 	QJsonSerializer *serializer = nullptr;
 
@@ -42,7 +185,9 @@ void SerializerTest::initTestCase()
 	qRegisterMetaType<EnumGadget>();
 	qRegisterMetaType<CustomGadget>();
 	qRegisterMetaType<AliasGadget>();
+	qRegisterMetaType<VariantGadget>();
 	qRegisterMetaType<TestObject*>();
+	qRegisterMetaType<NodeObject*>();
 
 	//aliases
 	qRegisterMetaType<IntAlias>("IntAlias");
@@ -57,13 +202,17 @@ void SerializerTest::initTestCase()
 	QJsonSerializer::registerListConverters<TestGadget>();
 	QJsonSerializer::registerMapConverters<TestGadget>();
 	QJsonSerializer::registerListConverters<CustomGadget>();
+	QJsonSerializer::registerListConverters<TypedPoint>();
 	QJsonSerializer::registerListConverters<QList<TestGadget>>();
 	QJsonSerializer::registerMapConverters<QMap<QString, TestGadget>>();
+	QJsonSerializer::registerLazyConverters<TestGadget>();
+	QJsonSerializer::registerLazyConverters<TestObject*>();
 
 	QJsonSerializer::registerAllConverters<TestObject*>();
 	QJsonSerializer::registerListConverters<QList<TestObject*>>();
 	QJsonSerializer::registerMapConverters<QMap<QString, TestObject*>>();
 	QJsonSerializer::registerPointerConverters<TestObject>();
+	QJsonSerializer::registerListConverters<QSharedPointer<TestObject>>();
 
 	QJsonSerializer::registerPairConverters<int, QString>();
 	QJsonSerializer::registerPairConverters<bool, bool>();
@@ -251,6 +400,23 @@ void SerializerTest::testSerialization_data()
 	QTest::addColumn<QVariantHash>("extraProps");
 
 	addCommonData();
+
+	// columnar lists, written from the properties of the elements
+	QTest::newRow("columns.gadget") << QVariant::fromValue<QList<TestGadget>>({1, 2, 3})
+									<< QJsonValue{QJsonObject{
+											{QStringLiteral("@columns"), QJsonArray{QStringLiteral("data")}},
+											{QStringLiteral("@rows"), QJsonArray{QJsonArray{1}, QJsonArray{2}, QJsonArray{3}}}
+										}}
+									<< true
+									<< QVariantHash{{QStringLiteral("columnarLists"), true}};
+	QTest::newRow("columns.gadget.empty") << QVariant::fromValue<QList<TestGadget>>({})
+										  << QJsonValue{QJsonArray{}}
+										  << true
+										  << QVariantHash{{QStringLiteral("columnarLists"), true}};
+	QTest::newRow("columns.scalar") << QVariant::fromValue<QList<int>>({1, 2})
+									<< QJsonValue{QJsonArray{1, 2}}
+									<< true
+									<< QVariantHash{{QStringLiteral("columnarLists"), true}};
 }
 
 void SerializerTest::testSerialization()
@@ -284,6 +450,15 @@ void SerializerTest::testDeserialization_data()
 
 	addCommonData();
 
+	QTest::newRow("double.rounded") << QVariant{42}
+									<< QJsonValue{41.6}
+									<< true
+									<< QVariantHash{};
+	QTest::newRow("char.invalid") << QVariant{QChar{QLatin1Char('x')}}
+								  << QJsonValue{QStringLiteral("xy")}
+								  << false
+								  << QVariantHash{};
+
 	QTest::newRow("null.invalid.bool") << QVariant{false}
 									   << QJsonValue{QJsonValue::Null}
 									   << false
@@ -325,6 +500,43 @@ void SerializerTest::testDeserialization_data()
 									   << QJsonValue{QJsonValue::Null}
 									   << true
 									   << QVariantHash{{QStringLiteral("allowDefaultNull"), true}};
+
+	// columnar lists
+	QTest::newRow("columns.gadget") << QVariant::fromValue<QList<TestGadget>>({1, 2, 3})
+									<< QJsonValue{QJsonObject{
+											{QStringLiteral("@columns"), QJsonArray{QStringLiteral("data")}},
+											{QStringLiteral("@rows"), QJsonArray{QJsonArray{1}, QJsonArray{2}, QJsonArray{3}}}
+										}}
+									<< true
+									<< QVariantHash{};
+	QTest::newRow("columns.gadget.extra") << QVariant::fromValue<QList<TestGadget>>({4, 5})
+										  << QJsonValue{QJsonObject{
+												  {QStringLiteral("@columns"), QJsonArray{QStringLiteral("data"), QStringLiteral("extra")}},
+												  {QStringLiteral("@rows"), QJsonArray{QJsonArray{4, true}, QJsonArray{5, false}}}
+											  }}
+										  << true
+										  << QVariantHash{};
+	QTest::newRow("columns.gadget.extra.invalid") << QVariant::fromValue<QList<TestGadget>>({4, 5})
+												  << QJsonValue{QJsonObject{
+														  {QStringLiteral("@columns"), QJsonArray{QStringLiteral("data"), QStringLiteral("extra")}},
+														  {QStringLiteral("@rows"), QJsonArray{QJsonArray{4, true}, QJsonArray{5, false}}}
+													  }}
+												  << false
+												  << QVariantHash{{QStringLiteral("validationFlags"), QVariant::fromValue<QJsonSerializer::ValidationFlags>(QJsonSerializer::NoExtraProperties)}};
+	QTest::newRow("columns.gadget.missing") << QVariant::fromValue<QList<TestGadget>>({})
+											<< QJsonValue{QJsonObject{
+													{QStringLiteral("@columns"), QJsonArray{QStringLiteral("other")}},
+													{QStringLiteral("@rows"), QJsonArray{QJsonArray{1}}}
+												}}
+											<< false
+											<< QVariantHash{{QStringLiteral("validationFlags"), QVariant::fromValue<QJsonSerializer::ValidationFlags>(QJsonSerializer::AllProperties)}};
+	QTest::newRow("columns.gadget.row") << QVariant::fromValue<QList<TestGadget>>({6})
+										<< QJsonValue{QJsonObject{
+												{QStringLiteral("@columns"), QJsonArray{QStringLiteral("data")}},
+												{QStringLiteral("@rows"), QJsonArray{QJsonArray{6, 7}}}
+											}}
+										<< false
+										<< QVariantHash{};
 }
 
 void SerializerTest::testDeserialization()
@@ -379,6 +591,947 @@ void SerializerTest::testDeviceSerialization()
 	QVERIFY_EXCEPTION_THROWN(serializer->serializeTo(42), QJsonSerializationException);
 }
 
+void SerializerTest::testConverterCache()
+{
+	const auto value = QVariant::fromValue(CachedValue{42});
+	const auto typeId = qMetaTypeId<CachedValue>();
+
+	// no converter so far - that result is cached as well
+	QVERIFY_EXCEPTION_THROWN(serializer->serialize(value), QJsonSerializationException);
+
+	try {
+		// converters added to one serializer are not seen by others
+		QJsonSerializer local;
+		local.addJsonTypeConverter(QSharedPointer<CachedValueConverter>::create(100));
+		QCOMPARE(local.serialize(value), QJsonValue{142});
+		QVERIFY_EXCEPTION_THROWN(serializer->serialize(value), QJsonSerializationException);
+		QJsonSerializer other;
+		QVERIFY_EXCEPTION_THROWN(other.serialize(value), QJsonSerializationException);
+
+		// a factory registered after a lookup is used by all serializers, including those that cached the miss
+		QJsonSerializer::addJsonTypeConverterFactory<CachedValueConverter>();
+		QCOMPARE(serializer->serialize(value), QJsonValue{42});
+		QCOMPARE(other.serialize(value), QJsonValue{42});
+		QCOMPARE(QJsonSerializer{}.deserialize(QJsonValue{7}, typeId).value<CachedValue>().value, 7);
+		// explicitly added converters still take precedence
+		QCOMPARE(local.serialize(value), QJsonValue{142});
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void SerializerTest::testCompressedSerialization()
+{
+	QList<TestGadget> gadgets;
+	for(auto i = 0; i < 100; ++i)
+		gadgets.append(TestGadget{i});
+	const auto plain = serializer->serializeTo(gadgets, QJsonDocument::Compact);
+
+	try {
+		// gzip
+		QByteArray gzip;
+		QBuffer buffer{&gzip};
+		QVERIFY(buffer.open(QIODevice::WriteOnly));
+		serializer->serializeToCompressed(&buffer, gadgets);
+		buffer.close();
+		QVERIFY(gzip.startsWith("\x1f\x8b"));
+		QVERIFY(gzip.size() < plain.size());
+		QVERIFY(buffer.open(QIODevice::ReadOnly));
+		QCOMPARE(serializer->deserializeFromCompressed<QList<TestGadget>>(&buffer), gadgets);
+		buffer.close();
+
+		// deflate, must be compatible to qUncompress (which expects a size prefix)
+		QByteArray deflate;
+		buffer.setBuffer(&deflate);
+		QVERIFY(buffer.open(QIODevice::WriteOnly));
+		serializer->serializeToCompressed(&buffer, gadgets, QJsonSerializer::Compression::Deflate, 9);
+		buffer.close();
+		QByteArray sizePrefix(4, '\0');
+		qToBigEndian<quint32>(static_cast<quint32>(plain.size()), sizePrefix.data());
+		QCOMPARE(qUncompress(sizePrefix + deflate), plain);
+		QVERIFY(buffer.open(QIODevice::ReadOnly));
+		QCOMPARE(serializer->deserializeFromCompressed<QList<TestGadget>>(&buffer), gadgets);
+		buffer.close();
+
+		// invalid data
+		QByteArray invalid = plain;
+		buffer.setBuffer(&invalid);
+		QVERIFY(buffer.open(QIODevice::ReadOnly));
+		QVERIFY_EXCEPTION_THROWN(serializer->deserializeFromCompressed<QList<TestGadget>>(&buffer), QJsonDeserializationException);
+		buffer.close();
+
+		QByteArray truncated = gzip.left(gzip.size() / 2);
+		buffer.setBuffer(&truncated);
+		QVERIFY(buffer.open(QIODevice::ReadOnly));
+		QVERIFY_EXCEPTION_THROWN(serializer->deserializeFromCompressed<QList<TestGadget>>(&buffer), QJsonDeserializationException);
+		buffer.close();
+
+		// a sequential source that ends before the stream does, even though the json is complete
+		class SequentialBuffer : public QBuffer
+		{
+		public:
+			using QBuffer::QBuffer;
+			bool isSequential() const override {
+				return true;
+			}
+		};
+		QByteArray noTrailer = gzip.left(gzip.size() - 4);
+		SequentialBuffer sequential{&noTrailer};
+		QVERIFY(sequential.open(QIODevice::ReadOnly));
+		QVERIFY_EXCEPTION_THROWN(serializer->deserializeFromCompressed<QList<TestGadget>>(&sequential), QJsonDeserializationException);
+		sequential.close();
+
+		// indented json is compressed byte for byte as well
+		QByteArray indented;
+		buffer.setBuffer(&indented);
+		QVERIFY(buffer.open(QIODevice::WriteOnly));
+		serializer->serializeToCompressed(&buffer, gadgets, QJsonSerializer::Compression::Deflate, 9, QJsonDocument::Indented);
+		buffer.close();
+		const auto plainIndented = serializer->serializeTo(gadgets, QJsonDocument::Indented);
+		qToBigEndian<quint32>(static_cast<quint32>(plainIndented.size()), sizePrefix.data());
+		QCOMPARE(qUncompress(sizePrefix + indented), plainIndented);
+		QVERIFY(buffer.open(QIODevice::ReadOnly));
+		QCOMPARE(serializer->deserializeFromCompressed<QList<TestGadget>>(&buffer), gadgets);
+		buffer.close();
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void SerializerTest::testWriteJob()
+{
+	const QVariantMap data {
+		{QStringLiteral("text"), QStringLiteral("a\"b\\c\nd\te\u0001\u00e4")},
+		{QStringLiteral("number"), 4.25},
+		{QStringLiteral("int"), 42},
+		{QStringLiteral("big"), 1e20},
+		{QStringLiteral("numbers"), QVariantList{1e6, -3.0, 0.1, 1e-7, 123456789012.0, 18446744073709551616.0, -0.0}},
+		{QStringLiteral("unicode"), QString{QStringLiteral("\U0001F600\u20ac") + QChar{0xd800} + QStringLiteral("x")}},
+		{QStringLiteral("flag"), true},
+		{QStringLiteral("null"), QVariant::fromValue(QJsonValue{})},
+		{QStringLiteral("list"), QVariantList{1, QStringLiteral("two"), QVariantList{}, QVariantMap{}}},
+		{QStringLiteral("map"), QVariantMap{{QStringLiteral("a"), QVariantList{QVariantMap{{QStringLiteral("b"), 1}}}}}}
+	};
+
+	try {
+		QByteArray result;
+		QBuffer buffer{&result};
+		QVERIFY(buffer.open(QIODevice::WriteOnly));
+		QScopedPointer<QJsonWriteJob> job{serializer->createWriteJob(&buffer, data)};
+		QSignalSpy finishedSpy{job.data(), &QJsonWriteJob::finished};
+		job->start();
+		QCOMPARE(finishedSpy.size(), 1);
+		QVERIFY(job->isFinished());
+		QCOMPARE(job->bytesGenerated(), static_cast<qint64>(result.size()));
+		buffer.close();
+		QCOMPARE(result, serializer->serializeTo(data, QJsonDocument::Compact));
+
+		// json data is written byte for byte like QJsonDocument does
+		const auto json = serializer->serialize(data);
+		result.clear();
+		QVERIFY(buffer.open(QIODevice::WriteOnly));
+		QJsonWriteJob jsonJob{json, &buffer};
+		jsonJob.setWatermark(8);
+		jsonJob.start();
+		QVERIFY(jsonJob.isFinished());
+		buffer.close();
+		QCOMPARE(result, QJsonDocument{json.toObject()}.toJson(QJsonDocument::Compact));
+
+		QVERIFY_EXCEPTION_THROWN(serializer->createWriteJob(&buffer, 42), QJsonSerializationException);
+
+		// json that is no object or array fails once the job runs
+		QVERIFY(buffer.open(QIODevice::WriteOnly));
+		QJsonWriteJob scalarJob{QJsonValue{42}, &buffer};
+		QSignalSpy errorSpy{&scalarJob, &QJsonWriteJob::error};
+		scalarJob.start();
+		QCOMPARE(errorSpy.size(), 1);
+		buffer.close();
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void SerializerTest::testWriteJobWatermark()
+{
+	// a device that keeps everything pending, until it is drained
+	class SlowDevice : public QIODevice
+	{
+	public:
+		QByteArray pending;
+
+		qint64 bytesToWrite() const override {
+			return pending.size();
+		}
+
+		QByteArray drain(int size) {
+			const auto data = pending.left(size);
+			pending.remove(0, data.size());
+			emit bytesWritten(data.size());
+			return data;
+		}
+
+	protected:
+		qint64 readData(char *, qint64) override {
+			return -1;
+		}
+		qint64 writeData(const char *data, qint64 len) override {
+			pending.append(data, static_cast<int>(len));
+			return len;
+		}
+	};
+
+	QList<TestGadget> gadgets;
+	for(auto i = 0; i < 1000; ++i)
+		gadgets.append(TestGadget{i});
+	const auto expected = serializer->serializeTo(gadgets, QJsonDocument::Compact);
+
+	SlowDevice device;
+	QVERIFY(device.open(QIODevice::WriteOnly | QIODevice::Unbuffered));
+	QScopedPointer<QJsonWriteJob> job{serializer->createWriteJob(&device, gadgets)};
+	job->setWatermark(100);
+	job->start();
+
+	QByteArray result;
+	while(!job->isFinished()) {
+		QVERIFY(!device.pending.isEmpty());
+		QVERIFY(device.pending.size() < 2 * job->watermark() + 32);
+		result += device.drain(50);
+	}
+	result += device.pending;
+	QCOMPARE(result, expected);
+
+	// closing the device aborts the job
+	SlowDevice closedDevice;
+	QVERIFY(closedDevice.open(QIODevice::WriteOnly | QIODevice::Unbuffered));
+	job.reset(serializer->createWriteJob(&closedDevice, gadgets));
+	job->setWatermark(100);
+	QSignalSpy errorSpy{job.data(), &QJsonWriteJob::error};
+	job->start();
+	closedDevice.close();
+	QCOMPARE(errorSpy.size(), 1);
+	closedDevice.drain(50);
+	QVERIFY(!job->isFinished());
+}
+
+void SerializerTest::testAsync()
+{
+	QList<TestObject*> objects;
+	for(auto i = 0; i < 10; ++i)
+		objects.append(new TestObject{i, this});
+
+	try {
+		auto serFuture = serializer->serializeAsync(objects);
+		const auto data = serFuture.result();
+		QCOMPARE(data, serializer->serializeTo(objects, QJsonDocument::Compact));
+		// the progress is counted in bytes
+		QCOMPARE(serFuture.progressValue(), data.size());
+
+		auto deserFuture = serializer->deserializeAsync(data, qMetaTypeId<QList<TestObject*>>());
+		const auto result = deserFuture.result().value<QList<TestObject*>>();
+		QCOMPARE(result.size(), objects.size());
+		for(auto i = 0; i < result.size(); ++i) {
+			QVERIFY(TestObject::equals(result[i], objects[i]));
+			QCOMPARE(result[i]->thread(), thread());
+			QVERIFY(!result[i]->parent());
+		}
+		qDeleteAll(result);
+		QCOMPARE(deserFuture.progressMaximum(), data.size());
+		QCOMPARE(deserFuture.progressValue(), data.size());
+
+		// devices
+		QBuffer buffer;
+		QVERIFY(buffer.open(QIODevice::WriteOnly));
+		auto devSerFuture = serializer->serializeAsync(objects, &buffer);
+		QCOMPARE(devSerFuture.result(), static_cast<qint64>(data.size()));
+		buffer.close();
+		QCOMPARE(buffer.data(), data);
+
+		QVERIFY(buffer.open(QIODevice::ReadOnly));
+		auto devDeserFuture = serializer->deserializeAsync(&buffer, qMetaTypeId<QList<TestObject*>>());
+		const auto devResult = devDeserFuture.result().value<QList<TestObject*>>();
+		buffer.close();
+		QCOMPARE(devResult.size(), objects.size());
+		for(auto i = 0; i < devResult.size(); ++i)
+			QVERIFY(TestObject::equals(devResult[i], objects[i]));
+		qDeleteAll(devResult);
+		QCOMPARE(devDeserFuture.progressValue(), data.size());
+
+		auto errorFuture = serializer->deserializeAsync(R"__([{"data":"text"}])__", qMetaTypeId<QList<TestObject*>>());
+		QVERIFY_EXCEPTION_THROWN(errorFuture.result(), QJsonDeserializationException);
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+
+	qDeleteAll(objects);
+}
+
+void SerializerTest::testAsyncCancel()
+{
+	class Blocker : public QRunnable
+	{
+	public:
+		Blocker(QSemaphore *semaphore) :
+			_semaphore{semaphore}
+		{}
+
+		void run() override {
+			_semaphore->acquire();
+		}
+
+	private:
+		QSemaphore *_semaphore;
+	};
+
+	// block the only thread of the pool, so the job cannot start before it is canceled
+	QThreadPool pool;
+	pool.setMaxThreadCount(1);
+	QSemaphore semaphore;
+	pool.start(new Blocker{&semaphore});
+
+	auto future = serializer->serializeAsync(TestGadget{42}, QJsonDocument::Compact, &pool);
+	future.cancel();
+	semaphore.release();
+	future.waitForFinished();
+	QVERIFY(future.isCanceled());
+	QCOMPARE(future.resultCount(), 0);
+	QVERIFY(pool.waitForDone());
+
+	// jobs of a destroyed serializer fail instead of starting
+	QScopedPointer<QJsonSerializer> tmpSerializer{new QJsonSerializer{}};
+	pool.start(new Blocker{&semaphore});
+	auto orphanFuture = tmpSerializer->serializeAsync(TestGadget{42}, QJsonDocument::Compact, &pool);
+	tmpSerializer.reset();
+	semaphore.release();
+	QVERIFY_EXCEPTION_THROWN(orphanFuture.result(), QJsonSerializationException);
+	QVERIFY(pool.waitForDone());
+}
+
+void SerializerTest::testParallelDeserialization()
+{
+	QThreadPool pool;
+	pool.setMaxThreadCount(3);
+
+	QList<TestObject*> objects;
+	for(auto i = 0; i < 100; ++i)
+		objects.append(new TestObject{i, this});
+
+	try {
+		const auto data = serializer->serializeTo(objects, QJsonDocument::Indented);
+		const auto result = serializer->deserializeParallel<TestObject*>(data, this, &pool);
+		QCOMPARE(result.size(), objects.size());
+		for(auto i = 0; i < result.size(); ++i) {
+			QVERIFY(TestObject::equals(result[i], objects[i]));
+			QCOMPARE(result[i]->thread(), thread());
+			QCOMPARE(result[i]->parent(), this);
+		}
+		qDeleteAll(result);
+
+		QList<TestGadget> gadgets;
+		for(auto i = 0; i < 10; ++i)
+			gadgets.append(TestGadget{i});
+		QCOMPARE(serializer->deserializeParallel<TestGadget>(serializer->serializeTo(gadgets), nullptr, &pool), gadgets);
+		QCOMPARE(serializer->deserializeParallel<int>(" [ ] "), QList<int>{});
+		QCOMPARE(serializer->deserializeParallel<QString>(R"__(["a,]", "b\"]", "c"])__", nullptr, &pool),
+				 (QList<QString>{QStringLiteral("a,]"), QStringLiteral("b\"]"), QStringLiteral("c")}));
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+
+	QVERIFY_EXCEPTION_THROWN(serializer->deserializeParallel<int>(R"__({"a": 1})__"), QJsonDeserializationException);
+	QVERIFY_EXCEPTION_THROWN(serializer->deserializeParallel<int>("[1, 2,]"), QJsonDeserializationException);
+	QVERIFY_EXCEPTION_THROWN(serializer->deserializeParallel<int>("[1, 2"), QJsonDeserializationException);
+	QVERIFY_EXCEPTION_THROWN(serializer->deserializeParallel<TestObject*>(R"__([{"data":1}, {"data":"text"}, {"data":3}])__", this, &pool),
+							 QJsonDeserializationException);
+	QVERIFY(pool.waitForDone());
+
+	// the elements deserialized before a failing one, within its chunk and in other chunks, must not leak
+	const auto liveObjects = TestObject::instances.load();
+	QByteArray failing = "[";
+	for(auto i = 0; i < 40; ++i)
+		failing += (i == 0 ? "" : ", ") + (i % 10 == 6 ? QByteArray{"42"} : "{\"data\":" + QByteArray::number(i) + "}");
+	failing += "]";
+	QVERIFY_EXCEPTION_THROWN(serializer->deserializeParallel<TestObject*>(failing, nullptr, &pool), QJsonDeserializationException);
+	QVERIFY(pool.waitForDone());
+	QCOMPARE(TestObject::instances.load(), liveObjects);
+
+	qDeleteAll(objects);
+}
+
+void SerializerTest::testReadPipeline()
+{
+	QByteArray data;
+	for(auto i = 0; i < 200; ++i) {
+		data += serializer->serializeTo(TestGadget{i}, i % 2 == 0 ? QJsonDocument::Compact : QJsonDocument::Indented);
+		data += i % 3 == 0 ? "\n" : " ";
+	}
+
+	QBuffer buffer{&data};
+	QVERIFY(buffer.open(QIODevice::ReadOnly));
+	QScopedPointer<QJsonReadPipeline> pipeline{serializer->createReadPipeline(&buffer, qMetaTypeId<TestGadget>())};
+	pipeline->setParserCount(3);
+	pipeline->setCapacity(4);
+	QList<TestGadget> records;
+	connect(pipeline.data(), &QJsonReadPipeline::recordReady,
+			this, [&](const QVariant &record) {
+		records.append(record.value<TestGadget>());
+	});
+	QSignalSpy finishedSpy{pipeline.data(), &QJsonReadPipeline::finished};
+	QSignalSpy errorSpy{pipeline.data(), &QJsonReadPipeline::error};
+	pipeline->start();
+	QVERIFY(finishedSpy.wait());
+	QVERIFY(errorSpy.isEmpty());
+	QVERIFY(pipeline->isFinished());
+	QCOMPARE(pipeline->recordCount(), static_cast<qint64>(200));
+	QCOMPARE(buffer.thread(), thread());
+	QCOMPARE(records.size(), 200);
+	for(auto i = 0; i < records.size(); ++i)
+		QCOMPARE(records[i], TestGadget{i});
+
+	// errors are reported in order, after all records before them
+	QByteArray errorData = R"__({"data": 1} {"data": "text"} {"data": 3})__";
+	QBuffer errorBuffer{&errorData};
+	QVERIFY(errorBuffer.open(QIODevice::ReadOnly));
+	QScopedPointer<QJsonReadPipeline> errorPipeline{serializer->createReadPipeline(&errorBuffer, qMetaTypeId<TestObject*>())};
+	QList<TestObject*> objects;
+	connect(errorPipeline.data(), &QJsonReadPipeline::recordReady,
+			this, [&](const QVariant &record) {
+		objects.append(record.value<TestObject*>());
+	});
+	QSignalSpy errorFinishedSpy{errorPipeline.data(), &QJsonReadPipeline::finished};
+	QSignalSpy errorErrorSpy{errorPipeline.data(), &QJsonReadPipeline::error};
+	errorPipeline->start();
+	QVERIFY(errorErrorSpy.wait());
+	QVERIFY(errorFinishedSpy.isEmpty());
+	QCOMPARE(objects.size(), 1);
+	QCOMPARE(objects[0]->data, 1);
+	QCOMPARE(objects[0]->thread(), thread());
+	qDeleteAll(objects);
+
+	QByteArray invalidData = R"__({"data": 1}, {"data": 2})__";
+	QBuffer invalidBuffer{&invalidData};
+	QVERIFY(invalidBuffer.open(QIODevice::ReadOnly));
+	QScopedPointer<QJsonReadPipeline> invalidPipeline{serializer->createReadPipeline(&invalidBuffer, qMetaTypeId<TestGadget>())};
+	QSignalSpy invalidSpy{invalidPipeline.data(), &QJsonReadPipeline::error};
+	invalidPipeline->start();
+	QVERIFY(invalidSpy.wait());
+	QCOMPARE(invalidPipeline->recordCount(), static_cast<qint64>(1));
+
+	// random access devices are not moved, so they can have a parent
+	auto childBuffer = new QBuffer{&data, this};
+	QVERIFY(childBuffer->open(QIODevice::ReadOnly));
+	QScopedPointer<QJsonReadPipeline> childPipeline{serializer->createReadPipeline(childBuffer, qMetaTypeId<TestGadget>())};
+	QSignalSpy childSpy{childPipeline.data(), &QJsonReadPipeline::finished};
+	childPipeline->start();
+	QVERIFY(childSpy.wait());
+	QCOMPARE(childPipeline->recordCount(), static_cast<qint64>(200));
+	delete childBuffer;
+
+	// sequential devices that cannot wait for data are polled until their read channel finishes
+	class SequentialBuffer : public QBuffer
+	{
+	public:
+		using QBuffer::QBuffer;
+		bool isSequential() const override {
+			return true;
+		}
+	};
+	SequentialBuffer sequential{&data};
+	QVERIFY(sequential.open(QIODevice::ReadOnly));
+	QScopedPointer<QJsonReadPipeline> sequentialPipeline{serializer->createReadPipeline(&sequential, qMetaTypeId<TestGadget>())};
+	QSignalSpy sequentialSpy{sequentialPipeline.data(), &QJsonReadPipeline::finished};
+	sequentialPipeline->start();
+	QTRY_COMPARE(sequentialPipeline->recordCount(), static_cast<qint64>(200));
+	QTest::qWait(300);
+	QVERIFY(sequentialSpy.isEmpty());
+	emit sequential.readChannelFinished();
+	QVERIFY(sequentialSpy.wait());
+	QCOMPARE(sequential.thread(), thread());
+
+	SequentialBuffer sequentialChild{&data, this};
+	QVERIFY(sequentialChild.open(QIODevice::ReadOnly));
+	QScopedPointer<QJsonReadPipeline> sequentialChildPipeline{serializer->createReadPipeline(&sequentialChild, qMetaTypeId<TestGadget>())};
+	QSignalSpy sequentialChildSpy{sequentialChildPipeline.data(), &QJsonReadPipeline::error};
+	sequentialChildPipeline->start();
+	QCOMPARE(sequentialChildSpy.size(), 1);
+}
+
+void SerializerTest::testOptions()
+{
+	const QJsonSerializerOptions defaults;
+	QCOMPARE(serializer->options(), defaults);
+	QVERIFY(!defaults.enumAsString());
+	QCOMPARE(defaults.attachmentThreshold(), 1024);
+
+	auto options = serializer->options();
+	options.setEnumAsString(true)
+			.setValidationFlags(QJsonSerializer::NoExtraProperties);
+	QVERIFY(options != defaults);
+	QVERIFY(!serializer->options().enumAsString());
+
+	QSignalSpy enumSpy{serializer, &QJsonSerializer::enumAsStringChanged};
+	QSignalSpy validationSpy{serializer, &QJsonSerializer::validationFlagsChanged};
+	QSignalSpy nullSpy{serializer, &QJsonSerializer::allowDefaultNullChanged};
+	try {
+		// per call options leave the serializer untouched
+		const EnumGadget gadget{EnumGadget::Normal2};
+		const auto json = serializer->serialize(gadget, options);
+		QCOMPARE(json.value(QStringLiteral("enumProp")), QJsonValue{QStringLiteral("Normal2")});
+		QCOMPARE(serializer->serialize(gadget).value(QStringLiteral("enumProp")), QJsonValue{static_cast<int>(EnumGadget::Normal2)});
+		QVERIFY(!serializer->enumAsString());
+
+		const QJsonObject extra {
+			{QStringLiteral("data"), 42},
+			{QStringLiteral("extra"), true}
+		};
+		QCOMPARE(serializer->deserialize<TestGadget>(extra), TestGadget{42});
+		QVERIFY_EXCEPTION_THROWN(serializer->deserialize<TestGadget>(extra, options), QJsonDeserializationException);
+		QVERIFY(enumSpy.isEmpty());
+		QVERIFY(validationSpy.isEmpty());
+
+		// a snapshot is not affected by later changes
+		const auto snapshot = serializer->options();
+		serializer->setOptions(options);
+		QCOMPARE(serializer->options(), options);
+		QVERIFY(serializer->enumAsString());
+		QCOMPARE(serializer->validationFlags(), QJsonSerializer::ValidationFlags{QJsonSerializer::NoExtraProperties});
+		QVERIFY(!snapshot.enumAsString());
+		QCOMPARE(enumSpy.size(), 1);
+		QCOMPARE(validationSpy.size(), 1);
+		QVERIFY(nullSpy.isEmpty());
+		QCOMPARE(serializer->serialize(gadget, snapshot).value(QStringLiteral("enumProp")), QJsonValue{static_cast<int>(EnumGadget::Normal2)});
+
+		serializer->setEnumAsString(false);
+		QVERIFY(serializer->options().enumAsString() != options.enumAsString());
+		QCOMPARE(enumSpy.size(), 2);
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+
+	resetProps();
+}
+
+void SerializerTest::testFieldSelector()
+{
+	QJsonFieldSelector selector {
+		QStringLiteral("/a/b"),
+		QStringLiteral("/c"),
+		QStringLiteral("/list/*/data"),
+		QStringLiteral("/x~1y")
+	};
+	QVERIFY(!selector.isEmpty());
+	QCOMPARE(selector.paths().size(), 4);
+	QVERIFY(selector.isSelected(QString{}));
+	QVERIFY(selector.isSelected(QStringLiteral("/a")));
+	QVERIFY(selector.isSelected(QStringLiteral("/a/b/z")));
+	QVERIFY(!selector.isSelected(QStringLiteral("/a/z")));
+	QVERIFY(selector.isSelected(QStringLiteral("/c/d/e")));
+	QVERIFY(selector.isSelected(QStringLiteral("/list/5/data")));
+	QVERIFY(!selector.isSelected(QStringLiteral("/list/5/other")));
+	QVERIFY(selector.isSelected(QStringLiteral("/x~1y")));
+	QVERIFY(!selector.isSelected(QStringLiteral("/x")));
+	QVERIFY(!selector.isSelected(QStringLiteral("/d")));
+	QVERIFY(QJsonFieldSelector{}.isEmpty());
+	QVERIFY(QJsonFieldSelector{}.isSelected(QStringLiteral("/any/path")));
+
+	try {
+		// unselected properties are neither deserialized nor added as dynamic properties
+		const QJsonObject objectJson {
+			{QStringLiteral("data"), 5},
+			{QStringLiteral("extra"), QStringLiteral("value")}
+		};
+		serializer->setValidationFlags(QJsonSerializer::FullValidation);
+		QScopedPointer<TestObject> object{serializer->deserialize<TestObject*>(objectJson, {QStringLiteral("/data")}, this)};
+		QCOMPARE(object->data, 5);
+		QVERIFY(object->dynamicPropertyNames().isEmpty());
+		QVERIFY_EXCEPTION_THROWN(serializer->deserialize<TestObject*>(objectJson, {QStringLiteral("/extra")}, this), QJsonDeserializationException);
+		serializer->setValidationFlags(QJsonSerializer::StandardValidation);
+		object.reset(serializer->deserialize<TestObject*>(objectJson, {QStringLiteral("/extra")}, this));
+		QCOMPARE(object->data, 0);
+		QCOMPARE(object->property("extra").toString(), QStringLiteral("value"));
+
+		// unselected list elements are omitted
+		const QJsonArray listJson {
+			QJsonObject{{QStringLiteral("data"), 1}},
+			QJsonObject{{QStringLiteral("data"), 2}},
+			QJsonObject{{QStringLiteral("data"), 3}}
+		};
+		QCOMPARE(serializer->deserialize<QList<TestGadget>>(listJson, {QStringLiteral("/1")}),
+				 QList<TestGadget>{TestGadget{2}});
+		QCOMPARE(serializer->deserialize<QList<TestGadget>>(listJson, {QStringLiteral("/*/none")}),
+				 (QList<TestGadget>{TestGadget{}, TestGadget{}, TestGadget{}}));
+		const QJsonObject columnsJson {
+			{QStringLiteral("@columns"), QJsonArray{QStringLiteral("data")}},
+			{QStringLiteral("@rows"), QJsonArray{QJsonArray{1}, QJsonArray{2}, QJsonArray{3}}}
+		};
+		QCOMPARE(serializer->deserialize<QList<TestGadget>>(columnsJson, {QStringLiteral("/1")}),
+				 QList<TestGadget>{TestGadget{2}});
+		QCOMPARE(serializer->deserialize<QList<TestGadget>>(columnsJson, {QStringLiteral("/*/none")}),
+				 (QList<TestGadget>{TestGadget{}, TestGadget{}, TestGadget{}}));
+
+		// maps and the byte array overloads
+		const QJsonObject mapJson {
+			{QStringLiteral("a"), QJsonObject{{QStringLiteral("data"), 1}}},
+			{QStringLiteral("b"), QJsonObject{{QStringLiteral("data"), 2}}}
+		};
+		const auto mapData = QJsonDocument{mapJson}.toJson(QJsonDocument::Compact);
+		QCOMPARE(serializer->deserializeFrom<QMap<QString, TestGadget>>(mapData, {QStringLiteral("/b/data")}),
+				 (QMap<QString, TestGadget>{{QStringLiteral("b"), TestGadget{2}}}));
+		QCOMPARE(serializer->deserializeFrom<QMap<QString, TestGadget>>(mapData, QJsonFieldSelector{}),
+				 (QMap<QString, TestGadget>{{QStringLiteral("a"), TestGadget{1}}, {QStringLiteral("b"), TestGadget{2}}}));
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void SerializerTest::testFieldSelectorSerialization()
+{
+	const QJsonFieldSelector selector {
+		QStringLiteral("/data"),
+		QStringLiteral("/first/data")
+	};
+
+	try {
+		// nested objects only contain the selected properties
+		NodeObject root;
+		root.data = 1;
+		root.first = new NodeObject{&root};
+		root.first->data = 2;
+		root.first->second = new NodeObject{&root};
+		root.second = new NodeObject{&root};
+		QCOMPARE(serializer->serialize(&root, selector), (QJsonObject {
+			{QStringLiteral("data"), 1},
+			{QStringLiteral("first"), QJsonObject{{QStringLiteral("data"), 2}}}
+		}));
+		QCOMPARE(serializer->serialize(&root, QJsonFieldSelector{}).size(), 3);
+
+		// list wildcards and indexes
+		const QList<TestGadget> list {TestGadget{1}, TestGadget{2}, TestGadget{3}};
+		QCOMPARE(serializer->serialize(list, {QStringLiteral("/*/data")}), (QJsonArray {
+			QJsonObject{{QStringLiteral("data"), 1}},
+			QJsonObject{{QStringLiteral("data"), 2}},
+			QJsonObject{{QStringLiteral("data"), 3}}
+		}));
+		QCOMPARE(serializer->serialize(list, {QStringLiteral("/1")}), (QJsonArray {
+			QJsonObject{{QStringLiteral("data"), 2}}
+		}));
+		QCOMPARE(serializer->serialize(list, {QStringLiteral("/*/none")}), (QJsonArray {
+			QJsonObject{},
+			QJsonObject{},
+			QJsonObject{}
+		}));
+
+		// maps and the byte array overloads
+		const QMap<QString, TestGadget> map {
+			{QStringLiteral("a"), TestGadget{1}},
+			{QStringLiteral("b"), TestGadget{2}}
+		};
+		QCOMPARE(serializer->serializeTo(map, {QStringLiteral("/b")}, QJsonDocument::Compact),
+				 QByteArrayLiteral("{\"b\":{\"data\":2}}"));
+
+		// the selector is only active during the call
+		QCOMPARE(serializer->serialize(&root).size(), 3);
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void SerializerTest::testLazyParent()
+{
+	try {
+		// values that would be created without their parent are not loaded at all
+		QScopedPointer<QObject> parent{new QObject{}};
+		auto orphan = serializer->deserialize(QJsonObject{{QStringLiteral("data"), 1}}, qMetaTypeId<QJsonLazy<TestObject*>>(), parent.data()).value<QJsonLazy<TestObject*>>();
+		QVERIFY(!orphan.isLoaded());
+		parent.reset();
+		QVERIFY_EXCEPTION_THROWN(orphan.value(), QJsonDeserializationException);
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void SerializerTest::testObjectReferences()
+{
+	try {
+		// shared objects are written once and referenced afterwards
+		NodeObject shared;
+		shared.data = 42;
+		NodeObject root;
+		root.first = &shared;
+		root.second = &shared;
+
+		auto json = serializer->serialize(&root);
+		QVERIFY(!json.contains(QStringLiteral("$id")));
+		QCOMPARE(json[QStringLiteral("second")].toObject()[QStringLiteral("data")].toInt(), 42);
+
+		serializer->setObjectReferences(true);
+		json = serializer->serialize(&root);
+		QCOMPARE(json[QStringLiteral("$id")].toInt(), 1);
+		QCOMPARE(json[QStringLiteral("first")].toObject()[QStringLiteral("$id")].toInt(), 2);
+		QCOMPARE(json.value(QStringLiteral("second")), QJsonValue{QJsonObject{{QStringLiteral("$ref"), 2}}});
+
+		auto result = serializer->deserialize<NodeObject*>(json, this);
+		QVERIFY(result);
+		QVERIFY(result->dynamicPropertyNames().isEmpty());
+		QVERIFY(result->first);
+		QCOMPARE(result->first, result->second);
+		QCOMPARE(result->first->data, 42);
+
+		// MessagePack keeps the references of the whole value, while it is written member by member
+		result = serializer->deserializeFromMsgPack<NodeObject*>(serializer->serializeToMsgPack(&root), this);
+		QVERIFY(result->first);
+		QCOMPARE(result->first, result->second);
+
+		// cycles
+		NodeObject child;
+		child.first = &root;
+		root.second = &child;
+		json = serializer->serialize(&root);
+		QCOMPARE(json.value(QStringLiteral("second")).toObject().value(QStringLiteral("first")), QJsonValue{QJsonObject{{QStringLiteral("$ref"), 1}}});
+		result = serializer->deserialize<NodeObject*>(json, this);
+		QVERIFY(result->second);
+		QCOMPARE(result->second->first, result);
+
+		// references before the definition
+		const QJsonObject forwardJson {
+			{QStringLiteral("first"), QJsonObject{{QStringLiteral("$ref"), 5}}},
+			{QStringLiteral("second"), QJsonObject{{QStringLiteral("$id"), 5}, {QStringLiteral("data"), 7}}}
+		};
+		result = serializer->deserialize<NodeObject*>(forwardJson, this);
+		QVERIFY(result->first);
+		QCOMPARE(result->first, result->second);
+		QCOMPARE(result->first->data, 7);
+
+		const QJsonObject invalidJson {
+			{QStringLiteral("first"), QJsonObject{{QStringLiteral("$ref"), 9}}}
+		};
+		QVERIFY_EXCEPTION_THROWN(serializer->deserialize<NodeObject*>(invalidJson, this), QJsonDeserializationException);
+
+		// shared pointers to one object share their reference count
+		const auto sharedObject = QSharedPointer<TestObject>::create(3);
+		const QList<QSharedPointer<TestObject>> sharedList {sharedObject, sharedObject};
+		const auto listJson = serializer->serialize(sharedList);
+		QCOMPARE(listJson[1], QJsonValue{QJsonObject{{QStringLiteral("$ref"), 1}}});
+		const auto sharedResult = serializer->deserialize<QList<QSharedPointer<TestObject>>>(listJson);
+		QCOMPARE(sharedResult.size(), 2);
+		QVERIFY(sharedResult[0]);
+		QCOMPARE(sharedResult[0], sharedResult[1]);
+		QCOMPARE(sharedResult[0]->data, 3);
+
+		serializer->setObjectReferences(false);
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void SerializerTest::testAttachments()
+{
+	try {
+		const auto small = QByteArrayLiteral("small");
+		const auto large = QByteArray(2048, 'x');
+		const QList<QByteArray> data {small, large};
+
+		// large byte arrays are passed to the caller, instead of being base64 encoded
+		QByteArrayList attachments;
+		const auto json = serializer->serializeWithAttachments(QVariant::fromValue(data), attachments);
+		QCOMPARE(attachments.size(), 1);
+		QCOMPARE(attachments[0], large);
+		QCOMPARE(json.toArray()[0], QJsonValue{QString::fromUtf8(small.toBase64())});
+		const auto marker = json.toArray()[1].toObject();
+		QCOMPARE(marker[QStringLiteral("@attachment")].toInt(), 0);
+		QCOMPARE(marker[QStringLiteral("offset")].toInt(), 0);
+		QCOMPARE(marker[QStringLiteral("length")].toInt(), large.size());
+
+		auto result = serializer->deserializeWithAttachments(json, qMetaTypeId<QList<QByteArray>>(), attachments);
+		QCOMPARE(result.value<QList<QByteArray>>(), data);
+		QVERIFY_EXCEPTION_THROWN(serializer->deserialize<QList<QByteArray>>(json.toArray()), QJsonDeserializationException);
+		QVERIFY_EXCEPTION_THROWN(serializer->deserializeWithAttachments(json, qMetaTypeId<QList<QByteArray>>(), {}), QJsonDeserializationException);
+
+		// attachment container
+		serializer->setAttachmentThreshold(0);
+		const auto container = serializer->serializeWithAttachments(data);
+		QVERIFY(container.startsWith("QJSA"));
+		QVERIFY(container.endsWith(small + large));
+		QCOMPARE(serializer->deserializeWithAttachments<QList<QByteArray>>(container), data);
+		QVERIFY_EXCEPTION_THROWN(serializer->deserializeWithAttachments<QList<QByteArray>>(container.left(container.size() - 1)), QJsonDeserializationException);
+
+		// sizes that exceed the data are rejected before anything is allocated
+		const auto header = [](quint32 size) {
+			const auto value = qToBigEndian(size);
+			return QByteArray{reinterpret_cast<const char*>(&value), sizeof(value)};
+		};
+		const QByteArray emptyJson{"[]"};
+		const auto oversized = QByteArrayLiteral("QJSA") + header(static_cast<quint32>(emptyJson.size())) + emptyJson +
+							   header(1) + header(0x7fffffff) + small;
+		QVERIFY_EXCEPTION_THROWN(serializer->deserializeWithAttachments<QList<QByteArray>>(oversized), QJsonDeserializationException);
+
+		// offsets must match the sizes of the previous attachments
+		auto moved = json.toArray();
+		auto movedMarker = moved[1].toObject();
+		movedMarker[QStringLiteral("offset")] = 10;
+		moved[1] = movedMarker;
+		QVERIFY_EXCEPTION_THROWN(serializer->deserializeWithAttachments(moved, qMetaTypeId<QList<QByteArray>>(), attachments), QJsonDeserializationException);
+
+		serializer->setAttachmentThreshold(1024);
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void SerializerTest::testStringPool()
+{
+	try {
+		const QJsonArray array {
+			QStringLiteral("ok"),
+			QStringLiteral("failed"),
+			QStringLiteral("ok"),
+			QStringLiteral("failed")
+		};
+		const QJsonObject object {
+			{QStringLiteral("a"), QJsonObject{{QStringLiteral("code"), 1}}},
+			{QStringLiteral("b"), QJsonObject{{QStringLiteral("code"), 2}}}
+		};
+
+		auto list = serializer->deserialize<QStringList>(array);
+		QCOMPARE(list.size(), 4);
+		QVERIFY(list[0].constData() != list[2].constData());
+
+		// equal values share one string
+		serializer->setStringPoolSize(100);
+		list = serializer->deserialize<QStringList>(array);
+		QCOMPARE(list, (QStringList{QStringLiteral("ok"), QStringLiteral("failed"), QStringLiteral("ok"), QStringLiteral("failed")}));
+		QCOMPARE(list[0].constData(), list[2].constData());
+		QCOMPARE(list[1].constData(), list[3].constData());
+
+		const auto map = serializer->deserialize<QMap<QString, QMap<QString, int>>>(object);
+		QCOMPARE(map.size(), 2);
+		QCOMPARE(map[QStringLiteral("a")].firstKey().constData(), map[QStringLiteral("b")].firstKey().constData());
+
+		// once full, new strings are not shared anymore
+		serializer->setStringPoolSize(1);
+		list = serializer->deserialize<QStringList>(array);
+		QCOMPARE(list[0].constData(), list[2].constData());
+		QVERIFY(list[1].constData() != list[3].constData());
+
+		serializer->setStringPoolSize(0);
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void SerializerTest::testLazyOptions()
+{
+	resetProps();
+	try {
+		const QJsonObject json {
+			{QStringLiteral("data"), 42},
+			{QStringLiteral("extra"), true}
+		};
+		auto lazy = serializer->deserialize(json, qMetaTypeId<QJsonLazy<TestGadget>>(), this).value<QJsonLazy<TestGadget>>();
+		QVERIFY(!lazy.isLoaded());
+
+		// the value is loaded with the options of the deserialization, not the current ones
+		serializer->setValidationFlags(QJsonSerializer::NoExtraProperties);
+		QCOMPARE(lazy.value(), TestGadget{42});
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+	resetProps();
+}
+
+void SerializerTest::testTypedConverter()
+{
+	serializer->addJsonTypeConverter<TypedPointConverter>();
+
+	try {
+		const TypedPoint point{3, 4};
+		const QJsonArray json{3, 4};
+
+		// templated methods call the typed methods directly
+		QCOMPARE(serializer->serialize(point), QJsonValue{json});
+		QCOMPARE(serializer->deserialize<TypedPoint>(json), point);
+		QVERIFY_EXCEPTION_THROWN(serializer->deserialize<TypedPoint>(QJsonArray{1}), QJsonDeserializationException);
+
+		// nested and untyped values go through the QVariant overloads
+		QCOMPARE(serializer->serialize(QVariant::fromValue(point)), QJsonValue{json});
+		QCOMPARE(serializer->deserialize(json, qMetaTypeId<TypedPoint>()).value<TypedPoint>(), point);
+		const QList<TypedPoint> points{point, {5, 6}};
+		const QJsonArray pointsJson{json, QJsonArray{5, 6}};
+		QCOMPARE(serializer->serialize(points), pointsJson);
+		QCOMPARE(serializer->deserialize<QList<TypedPoint>>(pointsJson), points);
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void SerializerTest::testTracer()
+{
+	auto tracer = QSharedPointer<RecordingTracer>::create();
+	serializer->setTracer(tracer);
+
+	try {
+		const QList<TestGadget> list{1, 2};
+		const auto json = serializer->serialize(list);
+		QCOMPARE(tracer->events.size(), 4);
+		// nested values finish first
+		QCOMPARE(tracer->events[0].name, QByteArray{"data"});
+		QCOMPARE(tracer->events[0].typeName, QByteArray{"int"});
+		QCOMPARE(tracer->events[0].converter, QByteArray{"default"});
+		QCOMPARE(tracer->events[1].name, QByteArray{"[0]"});
+		QCOMPARE(tracer->events[1].typeName, QByteArray{"TestGadget"});
+		QVERIFY(tracer->events[1].converter.contains("QJsonGadgetConverter"));
+		QCOMPARE(tracer->events[3].name, QByteArray{"[1]"});
+		for(const auto &event : qAsConst(tracer->events)) {
+			QCOMPARE(event.operation, QJsonSerializerTracer::Operation::Serialize);
+			QVERIFY(event.duration >= 0);
+		}
+		QVERIFY(tracer->events[1].start <= tracer->events[0].start);
+		QVERIFY(tracer->events[1].start + tracer->events[1].duration >= tracer->events[0].start + tracer->events[0].duration);
+
+		tracer->events.clear();
+		serializer->deserialize<QList<TestGadget>>(json);
+		QCOMPARE(tracer->events.size(), 4);
+		QCOMPARE(tracer->events[1].operation, QJsonSerializerTracer::Operation::Deserialize);
+		QCOMPARE(tracer->events[1].name, QByteArray{"[0]"});
+
+		// the chrome sink writes one complete event per conversion
+		QTemporaryDir dir;
+		QVERIFY(dir.isValid());
+		const auto path = dir.filePath(QStringLiteral("trace.json"));
+		{
+			auto sink = QSharedPointer<QJsonChromeTraceSink>::create(path);
+			QVERIFY(sink->isValid());
+			serializer->setTracer(sink);
+			serializer->serialize(list);
+			serializer->setTracer({});
+		}
+		QFile file{path};
+		QVERIFY(file.open(QIODevice::ReadOnly));
+		const auto trace = QJsonDocument::fromJson(file.readAll()).array();
+		QCOMPARE(trace.size(), 4);
+		const auto event = trace[1].toObject();
+		QCOMPARE(event[QStringLiteral("name")].toString(), QStringLiteral("[0]"));
+		QCOMPARE(event[QStringLiteral("cat")].toString(), QStringLiteral("serialize"));
+		QCOMPARE(event[QStringLiteral("ph")].toString(), QStringLiteral("X"));
+		QCOMPARE(event[QStringLiteral("args")].toObject()[QStringLiteral("type")].toString(), QStringLiteral("TestGadget"));
+
+		// a running call keeps the tracer it started with, even if it is replaced meanwhile
+		auto count = 0;
+		QWeakPointer<QJsonSerializerTracer> swapping;
+		{
+			auto swappingTracer = QSharedPointer<SwappingTracer>::create(serializer, count);
+			swapping = swappingTracer;
+			serializer->setTracer(swappingTracer);
+		}
+		serializer->serialize(list);
+		QCOMPARE(count, 4);
+		QVERIFY(!serializer->tracer());
+		QVERIFY(swapping.isNull());
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+	serializer->setTracer({});
+}
+
 void SerializerTest::testExceptionTrace()
 {
 	try {
@@ -396,6 +1549,148 @@ void SerializerTest::testExceptionTrace()
 		QCOMPARE(trace[1].first, QByteArray{"data"});
 		QCOMPARE(trace[1].second, QByteArray{"int"});
 	}
+
+	// index hints reuse one buffer for all elements
+	QJsonArray array;
+	for(auto i = 0; i < 12; ++i)
+		array.append(QJsonObject{{QStringLiteral("data"), i}});
+	array.append(QJsonObject{{QStringLiteral("data"), QStringLiteral("test")}});
+	try {
+		serializer->deserialize<QList<TestGadget>>(array);
+		QFAIL("No exception thrown");
+	} catch (QJsonSerializerException &e) {
+		auto trace = e.propertyTrace();
+		QCOMPARE(trace.size(), 2);
+		QCOMPARE(trace[0].first, QByteArray{"[12]"});
+		QCOMPARE(trace[1].first, QByteArray{"data"});
+	}
+}
+
+void SerializerTest::testMsgPackSerialization_data()
+{
+	QTest::addColumn<QVariant>("data");
+	QTest::addColumn<QByteArray>("result");
+
+	QTest::newRow("null") << QVariant::fromValue(nullptr)
+						  << QByteArray::fromHex("c0");
+	QTest::newRow("bool") << QVariant{true}
+						  << QByteArray::fromHex("c3");
+	QTest::newRow("int.fix") << QVariant{42}
+							 << QByteArray::fromHex("2a");
+	QTest::newRow("int.negative") << QVariant{-1}
+								  << QByteArray::fromHex("ff");
+	QTest::newRow("int.16") << QVariant{300}
+							<< QByteArray::fromHex("cd012c");
+	QTest::newRow("int.negative16") << QVariant{-200}
+									<< QByteArray::fromHex("d1ff38");
+	QTest::newRow("int.64") << QVariant{Q_INT64_C(9007199254740993)}
+							<< QByteArray::fromHex("d30020000000000001");
+	QTest::newRow("double") << QVariant{4.5}
+							<< QByteArray::fromHex("cb4012000000000000");
+	QTest::newRow("string") << QVariant{QStringLiteral("baum")}
+							<< QByteArray::fromHex("a46261756d");
+	QTest::newRow("bytearray") << QVariant{QByteArrayLiteral("abc")}
+							   << QByteArray::fromHex("c403616263");
+	QTest::newRow("list") << QVariant::fromValue<QList<int>>({1, 2, 3})
+						  << QByteArray::fromHex("93010203");
+	QTest::newRow("gadget") << QVariant::fromValue<TestGadget>(42)
+							<< QByteArray::fromHex("81a4646174612a");
+}
+
+void SerializerTest::testMsgPackSerialization()
+{
+	QFETCH(QVariant, data);
+	QFETCH(QByteArray, result);
+
+	resetProps();
+	try {
+		QCOMPARE(serializer->serializeToMsgPack(data), result);
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void SerializerTest::testMsgPackRoundTrip_data()
+{
+	QTest::addColumn<QVariant>("data");
+	QTest::addColumn<QJsonValue>("result");
+	QTest::addColumn<bool>("works");
+	QTest::addColumn<QVariantHash>("extraProps");
+
+	addCommonData();
+
+	QTest::newRow("bytearray") << QVariant{QByteArray::fromHex("00016263ff")}
+							   << QJsonValue{}
+							   << true
+							   << QVariantHash{};
+	QTest::newRow("qint64.large") << QVariant{Q_INT64_C(-9007199254740993)}
+								  << QJsonValue{}
+								  << true
+								  << QVariantHash{};
+	QTest::newRow("quint64.large") << QVariant{Q_UINT64_C(18446744073709551615)}
+								   << QJsonValue{}
+								   << true
+								   << QVariantHash{};
+	QTest::newRow("list.bytearray") << QVariant::fromValue<QList<QByteArray>>({QByteArrayLiteral("a"), QByteArrayLiteral("b")})
+									<< QJsonValue{}
+									<< true
+									<< QVariantHash{};
+	QTest::newRow("json.marker") << QVariant{QJsonObject{{QStringLiteral("@msgpack"), 0}}}
+								 << QJsonValue{}
+								 << true
+								 << QVariantHash{};
+	QTest::newRow("map.marker") << QVariant{QVariantMap{{QStringLiteral("@msgpack"), QStringLiteral("baum")}}}
+								<< QJsonValue{}
+								<< true
+								<< QVariantHash{};
+}
+
+void SerializerTest::testMsgPackRoundTrip()
+{
+	QFETCH(QVariant, data);
+	QFETCH(bool, works);
+	QFETCH(QVariantHash, extraProps);
+
+	if(!works)
+		return;
+
+	resetProps();
+	for(auto it = extraProps.constBegin(); it != extraProps.constEnd(); it++)
+		serializer->setProperty(qUtf8Printable(it.key()), it.value());
+
+	try {
+		const auto msgPack = serializer->serializeToMsgPack(data);
+		auto res = serializer->deserializeFromMsgPack(msgPack, data.userType(), this);
+		if(data.userType() == qMetaTypeId<TestObject*>())
+			QVERIFY(TestObject::equals(res.value<TestObject*>(), data.value<TestObject*>()));
+		else
+			QCOMPARE(res, data);
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void SerializerTest::testMsgPackCustomConverter()
+{
+	QJsonSerializer local;
+	local.addJsonTypeConverter<HexConverter>();
+
+	try {
+		// the converter takes precedence over the native binary type
+		const auto data = QByteArray::fromHex("00ff");
+		const auto msgPack = local.serializeToMsgPack(QVariant{data});
+		QCOMPARE(msgPack, QByteArray::fromHex("a430306666"));
+		QCOMPARE(local.deserializeFromMsgPack(msgPack, QMetaType::QByteArray).toByteArray(), data);
+
+		// also for properties of type QVariant, that contain the type
+		const auto gadgetMsgPack = local.serializeToMsgPack(QVariant::fromValue(VariantGadget{data}));
+		QCOMPARE(gadgetMsgPack, QByteArray::fromHex("81a576616c7565a430306666"));
+		// and for the elements of variant lists
+		const auto listMsgPack = local.serializeToMsgPack(QVariantList{data});
+		QCOMPARE(listMsgPack, QByteArray::fromHex("91a430306666"));
+	} catch(std::exception &e) {
+		QFAIL(e.what());
+	}
 }
 
 void SerializerTest::addCommonData()
@@ -413,6 +1708,22 @@ void SerializerTest::addCommonData()
 							<< QJsonValue{4.2}
 							<< true
 							<< QVariantHash{};
+	QTest::newRow("uint") << QVariant{42u}
+						  << QJsonValue{42}
+						  << true
+						  << QVariantHash{};
+	QTest::newRow("qint64") << QVariant{Q_INT64_C(4200000000)}
+							<< QJsonValue{4200000000.0}
+							<< true
+							<< QVariantHash{};
+	QTest::newRow("float") << QVariant{4.5f}
+						   << QJsonValue{4.5}
+						   << true
+						   << QVariantHash{};
+	QTest::newRow("char") << QVariant{QChar{QLatin1Char('x')}}
+						  << QJsonValue{QStringLiteral("x")}
+						  << true
+						  << QVariantHash{};
 	QTest::newRow("string.normal") << QVariant{QStringLiteral("baum")}
 								   << QJsonValue{QStringLiteral("baum")}
 								   << true
@@ -554,6 +1865,12 @@ void SerializerTest::resetProps()
 	serializer->setUseBcp47Locale(true);
 	serializer->setValidationFlags(QJsonSerializer::StandardValidation);
 	serializer->setPolymorphing(QJsonSerializer::Enabled);
+	serializer->setDateTimeAsEpoch(false);
+	serializer->setGeometryAsArray(false);
+	serializer->setColumnarLists(false);
+	serializer->setObjectReferences(false);
+	serializer->setAttachmentThreshold(1024);
+	serializer->setStringPoolSize(0);
 }
 
 namespace  {
@@ -5,10 +5,12 @@ SUBDIRS += \
 
 CONVERTER_TESTS = \
 	BytearrayConverterTest \
+	DateTimeConverterTest \
 	GadgetConverterTest \
 	GeomConverterTest \
 	JsonConverterTest \
 	ListConverterTest \
+	ColumnListConverterTest \
 	LocaleConverterTest \
 	MapConverterTest \
 	ObjectConverterTest \
@@ -16,7 +18,8 @@ CONVERTER_TESTS = \
 	RegexConverterTest \
 	TupleConverterTest \
 	VersionConverterTest \
-	MultiMapConverterTest
+	MultiMapConverterTest \
+	LazyConverterTest
 
 for(test, CONVERTER_TESTS) {
 	SUBDIRS += $$test
@@ -24,7 +27,9 @@ for(test, CONVERTER_TESTS) {
 }
 
 SUBDIRS += \
-	SerializerTest
+	SerializerTest \
+	GeneratedConverterTest \
+	AllocationTest
 
 prepareRecursiveTarget(run-tests)
 QMAKE_EXTRA_TARGETS += run-tests
@@ -0,0 +1,13 @@
+TEMPLATE = app
+
+QT = core jsonserializer
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = AllocationBenchmark
+
+include(../BenchmarkModel/benchmodel.pri)
+include(../../../auto/jsonserializer/AllocationCounter/allocationcounter.pri)
+
+SOURCES += \
+	main.cpp
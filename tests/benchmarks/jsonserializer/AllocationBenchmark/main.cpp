@@ -0,0 +1,143 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QTextStream>
+#include <QtJsonSerializer/QJsonSerializer>
+
+#include <functional>
+
+#include "allocationcounter.h"
+#include "benchobject.h"
+
+namespace {
+
+struct Config {
+	int iterations = 20;
+	BenchObject::Shape shape;
+};
+
+struct Result {
+	QString name;
+	qint64 count = 0;
+	qint64 bytes = 0;
+};
+
+Result measure(const QString &name, int iterations, const std::function<void()> &operation)
+{
+	// warm up caches (converters, metatypes, thread storage) outside of the measurement
+	operation();
+
+	const auto start = AllocationCounter::snapshot();
+	for(auto i = 0; i < iterations; ++i)
+		operation();
+	const auto end = AllocationCounter::snapshot();
+
+	Result result;
+	result.name = name;
+	result.count = (end.count - start.count) / iterations;
+	result.bytes = (end.bytes - start.bytes) / iterations;
+	return result;
+}
+
+void printResults(QTextStream &out, const QList<Result> &results, int objects)
+{
+	out << QStringLiteral("%1 %2 %3 %4\n")
+		   .arg(QStringLiteral("operation"), 18)
+		   .arg(QStringLiteral("allocs"), 12)
+		   .arg(QStringLiteral("bytes"), 12)
+		   .arg(QStringLiteral("allocs/obj"), 12);
+	for(const auto &result : results) {
+		out << QStringLiteral("%1 %2 %3 %4\n")
+			   .arg(result.name, 18)
+			   .arg(result.count, 12)
+			   .arg(result.bytes, 12)
+			   .arg(static_cast<double>(result.count) / objects, 12, 'f', 1);
+	}
+	out << QLatin1Char('\n');
+	out.flush();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app{argc, argv};
+	BenchObject::registerTypes();
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(QStringLiteral("Counts the heap allocations per serialize/deserialize call of QJsonSerializer"));
+	parser.addHelpOption();
+	parser.addOption({
+						 {QStringLiteral("i"), QStringLiteral("iterations")},
+						 QStringLiteral("The number of calls to average over"),
+						 QStringLiteral("count"),
+						 QStringLiteral("20")
+					 });
+	parser.addOption({
+						 {QStringLiteral("d"), QStringLiteral("depth")},
+						 QStringLiteral("The depth of the generated object graph"),
+						 QStringLiteral("levels"),
+						 QStringLiteral("2")
+					 });
+	parser.addOption({
+						 {QStringLiteral("w"), QStringLiteral("width")},
+						 QStringLiteral("The number of children per object"),
+						 QStringLiteral("count"),
+						 QStringLiteral("4")
+					 });
+	parser.addOption({
+						 {QStringLiteral("n"), QStringLiteral("items")},
+						 QStringLiteral("The number of list elements per object"),
+						 QStringLiteral("count"),
+						 QStringLiteral("16")
+					 });
+	parser.addOption({
+						 {QStringLiteral("p"), QStringLiteral("payload")},
+						 QStringLiteral("The size of the binary payload per object"),
+						 QStringLiteral("bytes"),
+						 QStringLiteral("64")
+					 });
+	parser.process(app);
+
+	Config config;
+	config.iterations = qMax(1, parser.value(QStringLiteral("iterations")).toInt());
+	config.shape.depth = qMax(0, parser.value(QStringLiteral("depth")).toInt());
+	config.shape.width = qMax(0, parser.value(QStringLiteral("width")).toInt());
+	config.shape.items = qMax(0, parser.value(QStringLiteral("items")).toInt());
+	config.shape.payload = qMax(0, parser.value(QStringLiteral("payload")).toInt());
+
+	QScopedPointer<BenchObject> root{BenchObject::createGraph(config.shape)};
+	const auto objects = BenchObject::countObjects(root.data());
+	QTextStream out{stdout};
+	out << QStringLiteral("Object graph: %1 objects, averaged over %2 calls\n\n")
+		   .arg(objects)
+		   .arg(config.iterations);
+
+	QJsonSerializer serializer;
+	QList<Result> results;
+	try {
+		const auto json = serializer.serialize(root.data());
+		const auto data = serializer.serializeTo(root.data(), QJsonDocument::Compact);
+		results.append(measure(QStringLiteral("serialize"), config.iterations, [&]() {
+			serializer.serialize(root.data());
+		}));
+		results.append(measure(QStringLiteral("deserialize"), config.iterations, [&]() {
+			delete serializer.deserialize<BenchObject*>(json);
+		}));
+		results.append(measure(QStringLiteral("serializeTo"), config.iterations, [&]() {
+			serializer.serializeTo(root.data(), QJsonDocument::Compact);
+		}));
+		results.append(measure(QStringLiteral("deserializeFrom"), config.iterations, [&]() {
+			delete serializer.deserializeFrom<BenchObject*>(data);
+		}));
+
+		serializer.setValidationFlags(QJsonSerializer::FullValidation);
+		results.append(measure(QStringLiteral("deserialize[full]"), config.iterations, [&]() {
+			delete serializer.deserialize<BenchObject*>(json);
+		}));
+	} catch(QJsonSerializerException &e) {
+		qFatal("Benchmark failed with exception: %s", e.what());
+	}
+
+	printResults(out, results, objects);
+	return EXIT_SUCCESS;
+}
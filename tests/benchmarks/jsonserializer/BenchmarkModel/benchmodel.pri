@@ -0,0 +1,8 @@
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+HEADERS += \
+	$$PWD/benchobject.h
+
+SOURCES += \
+	$$PWD/benchobject.cpp
@@ -0,0 +1,78 @@
+#include "benchobject.h"
+#include <QtJsonSerializer/QJsonSerializer>
+
+bool BenchGadget::operator==(const BenchGadget &other) const
+{
+	return id == other.id &&
+			label == other.label &&
+			qFuzzyCompare(weight, other.weight) &&
+			active == other.active;
+}
+
+BenchObject::BenchObject(QObject *parent) :
+	QObject{parent}
+{}
+
+void BenchObject::registerTypes()
+{
+	qRegisterMetaType<BenchGadget>();
+	qRegisterMetaType<BenchObject*>();
+	QJsonSerializer::registerListConverters<BenchGadget>();
+	QJsonSerializer::registerListConverters<BenchObject*>();
+}
+
+BenchObject *BenchObject::createGraph(const Shape &shape, int seed, QObject *parent)
+{
+	auto counter = seed * 100000;
+	return createNode(shape, 0, counter, parent);
+}
+
+int BenchObject::countObjects(const BenchObject *root)
+{
+	if(!root)
+		return 0;
+	auto count = 1;
+	for(const auto child : root->children)
+		count += countObjects(child);
+	return count;
+}
+
+BenchObject *BenchObject::createNode(const Shape &shape, int level, int &counter, QObject *parent)
+{
+	static const QStringList categories {
+		QStringLiteral("alpha"),
+		QStringLiteral("beta"),
+		QStringLiteral("gamma"),
+		QStringLiteral("delta")
+	};
+
+	auto object = new BenchObject{parent};
+	object->id = counter++;
+	object->name = QStringLiteral("object-%1").arg(object->id);
+	object->category = categories[object->id % categories.size()];
+	object->score = object->id * 0.25;
+	object->timestamp = QDateTime::fromMSecsSinceEpoch(1500000000000ll + object->id * 1000ll, Qt::UTC);
+	object->values.reserve(shape.items);
+	for(auto i = 0; i < shape.items; ++i)
+		object->values.append(object->id * i);
+	object->tags = QStringList{object->category, QStringLiteral("level-%1").arg(level)};
+	object->payload.resize(shape.payload);
+	for(auto i = 0; i < shape.payload; ++i)
+		object->payload[i] = static_cast<char>((object->id + i) % 256);
+	object->items.reserve(shape.items);
+	for(auto i = 0; i < shape.items; ++i) {
+		BenchGadget gadget;
+		gadget.id = i;
+		gadget.label = QStringLiteral("item-%1").arg(i);
+		gadget.weight = i * 1.5;
+		gadget.active = (i % 2) == 0;
+		object->items.append(gadget);
+	}
+
+	if(level < shape.depth) {
+		object->children.reserve(shape.width);
+		for(auto i = 0; i < shape.width; ++i)
+			object->children.append(createNode(shape, level + 1, counter, object));
+	}
+	return object;
+}
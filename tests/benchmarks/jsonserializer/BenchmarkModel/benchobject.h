@@ -0,0 +1,78 @@
+#ifndef BENCHOBJECT_H
+#define BENCHOBJECT_H
+
+#include <QtCore/QObject>
+#include <QtCore/QByteArray>
+#include <QtCore/QDateTime>
+#include <QtCore/QList>
+#include <QtCore/QStringList>
+
+struct BenchGadget
+{
+	Q_GADGET
+
+	Q_PROPERTY(int id MEMBER id)
+	Q_PROPERTY(QString label MEMBER label)
+	Q_PROPERTY(double weight MEMBER weight)
+	Q_PROPERTY(bool active MEMBER active)
+
+public:
+	int id = 0;
+	QString label;
+	double weight = 0.0;
+	bool active = false;
+
+	bool operator==(const BenchGadget &other) const;
+};
+
+class BenchObject : public QObject
+{
+	Q_OBJECT
+
+	Q_PROPERTY(int id MEMBER id)
+	Q_PROPERTY(QString name MEMBER name)
+	Q_PROPERTY(QString category MEMBER category)
+	Q_PROPERTY(double score MEMBER score)
+	Q_PROPERTY(QDateTime timestamp MEMBER timestamp)
+	Q_PROPERTY(QList<int> values MEMBER values)
+	Q_PROPERTY(QStringList tags MEMBER tags)
+	Q_PROPERTY(QList<BenchGadget> items MEMBER items)
+	Q_PROPERTY(QList<BenchObject*> children MEMBER children)
+	Q_PROPERTY(QByteArray payload MEMBER payload)
+
+public:
+	//! The shape of a generated object graph
+	struct Shape {
+		int depth = 2;
+		int width = 4;
+		int items = 16;
+		int payload = 64;
+	};
+
+	Q_INVOKABLE explicit BenchObject(QObject *parent = nullptr);
+
+	//! Registers all metatypes and converters required to de/serialize the model
+	static void registerTypes();
+	//! Creates a deterministic tree of objects, owned by the returned root
+	static BenchObject *createGraph(const Shape &shape, int seed = 0, QObject *parent = nullptr);
+	//! Counts the objects of the tree, including the root
+	static int countObjects(const BenchObject *root);
+
+	int id = 0;
+	QString name;
+	QString category;
+	double score = 0.0;
+	QDateTime timestamp;
+	QList<int> values;
+	QStringList tags;
+	QList<BenchGadget> items;
+	QList<BenchObject*> children;
+	QByteArray payload;
+
+private:
+	static BenchObject *createNode(const Shape &shape, int level, int &counter, QObject *parent);
+};
+
+Q_DECLARE_METATYPE(BenchGadget)
+
+#endif // BENCHOBJECT_H
@@ -0,0 +1,12 @@
+TEMPLATE = app
+
+QT = core jsonserializer
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = MsgPackBenchmark
+
+include(../BenchmarkModel/benchmodel.pri)
+
+SOURCES += \
+	main.cpp
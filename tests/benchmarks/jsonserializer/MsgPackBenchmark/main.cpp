@@ -0,0 +1,160 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTextStream>
+#include <QtCore/QVector>
+#include <QtJsonSerializer/QJsonSerializer>
+
+#include <algorithm>
+#include <functional>
+
+#include "benchobject.h"
+
+namespace {
+
+struct Config {
+	int iterations = 200;
+	BenchObject::Shape shape;
+};
+
+struct Result {
+	QString format;
+	int size = 0;
+	QVector<qint64> serLatencies;
+	QVector<qint64> deserLatencies;
+};
+
+qint64 median(QVector<qint64> values)
+{
+	if(values.isEmpty())
+		return 0;
+	std::sort(values.begin(), values.end());
+	return values[values.size() / 2];
+}
+
+Result runBenchmark(const QString &format,
+					const Config &config,
+					BenchObject *root,
+					const std::function<QByteArray(BenchObject*)> &serialize,
+					const std::function<BenchObject*(const QByteArray&)> &deserialize)
+{
+	Result result;
+	result.format = format;
+	result.serLatencies.reserve(config.iterations);
+	result.deserLatencies.reserve(config.iterations);
+
+	// warm up caches outside of the measurement
+	const auto encoded = serialize(root);
+	result.size = encoded.size();
+	delete deserialize(encoded);
+
+	QElapsedTimer timer;
+	for(auto i = 0; i < config.iterations; ++i) {
+		timer.start();
+		const auto data = serialize(root);
+		result.serLatencies.append(timer.nsecsElapsed());
+
+		timer.start();
+		delete deserialize(data);
+		result.deserLatencies.append(timer.nsecsElapsed());
+	}
+	return result;
+}
+
+void printResults(QTextStream &out, const QList<Result> &results)
+{
+	out << QStringLiteral("%1 %2 %3 %4\n")
+		   .arg(QStringLiteral("format"), 10)
+		   .arg(QStringLiteral("size[B]"), 12)
+		   .arg(QStringLiteral("ser p50[us]"), 12)
+		   .arg(QStringLiteral("des p50[us]"), 12);
+	for(const auto &result : results) {
+		out << QStringLiteral("%1 %2 %3 %4\n")
+			   .arg(result.format, 10)
+			   .arg(result.size, 12)
+			   .arg(median(result.serLatencies) / 1000.0, 12, 'f', 1)
+			   .arg(median(result.deserLatencies) / 1000.0, 12, 'f', 1);
+	}
+	out << QLatin1Char('\n');
+	out.flush();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app{argc, argv};
+	BenchObject::registerTypes();
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(QStringLiteral("Compares the json and the MessagePack format of QJsonSerializer"));
+	parser.addHelpOption();
+	parser.addOption({
+						 {QStringLiteral("i"), QStringLiteral("iterations")},
+						 QStringLiteral("The number of serialize/deserialize round trips per format"),
+						 QStringLiteral("count"),
+						 QStringLiteral("200")
+					 });
+	parser.addOption({
+						 {QStringLiteral("d"), QStringLiteral("depth")},
+						 QStringLiteral("The depth of the generated object graph"),
+						 QStringLiteral("levels"),
+						 QStringLiteral("2")
+					 });
+	parser.addOption({
+						 {QStringLiteral("w"), QStringLiteral("width")},
+						 QStringLiteral("The number of children per object"),
+						 QStringLiteral("count"),
+						 QStringLiteral("4")
+					 });
+	parser.addOption({
+						 {QStringLiteral("n"), QStringLiteral("items")},
+						 QStringLiteral("The number of list elements per object"),
+						 QStringLiteral("count"),
+						 QStringLiteral("16")
+					 });
+	parser.addOption({
+						 {QStringLiteral("p"), QStringLiteral("payload")},
+						 QStringLiteral("The size of the binary payload per object"),
+						 QStringLiteral("bytes"),
+						 QStringLiteral("64")
+					 });
+	parser.process(app);
+
+	Config config;
+	config.iterations = qMax(1, parser.value(QStringLiteral("iterations")).toInt());
+	config.shape.depth = qMax(0, parser.value(QStringLiteral("depth")).toInt());
+	config.shape.width = qMax(0, parser.value(QStringLiteral("width")).toInt());
+	config.shape.items = qMax(0, parser.value(QStringLiteral("items")).toInt());
+	config.shape.payload = qMax(0, parser.value(QStringLiteral("payload")).toInt());
+
+	QScopedPointer<BenchObject> root{BenchObject::createGraph(config.shape)};
+	QTextStream out{stdout};
+	out << QStringLiteral("Object graph: %1 objects, %2 iterations per format\n\n")
+		   .arg(BenchObject::countObjects(root.data()))
+		   .arg(config.iterations);
+
+	QJsonSerializer serializer;
+	QList<Result> results;
+	try {
+		results.append(runBenchmark(QStringLiteral("json"), config, root.data(),
+									[&](BenchObject *object) {
+										return serializer.serializeTo(object, QJsonDocument::Compact);
+									},
+									[&](const QByteArray &data) {
+										return serializer.deserializeFrom<BenchObject*>(data);
+									}));
+		results.append(runBenchmark(QStringLiteral("msgpack"), config, root.data(),
+									[&](BenchObject *object) {
+										return serializer.serializeToMsgPack(object);
+									},
+									[&](const QByteArray &data) {
+										return serializer.deserializeFromMsgPack<BenchObject*>(data);
+									}));
+	} catch(QJsonSerializerException &e) {
+		qFatal("Benchmark failed with exception: %s", e.what());
+	}
+
+	printResults(out, results);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,10 @@
+TEMPLATE = app
+
+QT = core jsonserializer
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = StringPoolBenchmark
+
+SOURCES += \
+	main.cpp
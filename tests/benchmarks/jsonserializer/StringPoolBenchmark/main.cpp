@@ -0,0 +1,186 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QSet>
+#include <QtCore/QTextStream>
+#include <QtJsonSerializer/QJsonSerializer>
+
+// A record of a repetitive corpus: most values are taken from small sets
+class Record
+{
+	Q_GADGET
+
+	Q_PROPERTY(int id MEMBER id)
+	Q_PROPERTY(QString status MEMBER status)
+	Q_PROPERTY(QString category MEMBER category)
+	Q_PROPERTY(QString country MEMBER country)
+	Q_PROPERTY(QStringList tags MEMBER tags)
+	Q_PROPERTY(QVariantMap attributes MEMBER attributes)
+
+public:
+	int id = 0;
+	QString status;
+	QString category;
+	QString country;
+	QStringList tags;
+	QVariantMap attributes;
+};
+
+Q_DECLARE_METATYPE(Record)
+
+namespace {
+
+struct Config {
+	int records = 10000;
+	int distinct = 50;
+	int poolSize = 4096;
+};
+
+struct Result {
+	QString name;
+	qint64 strings = 0;
+	qint64 buffers = 0;
+	qint64 bytes = 0;
+	qint64 time = 0;
+};
+
+QJsonArray createCorpus(const Config &config)
+{
+	const auto value = [&](const QString &prefix, int index) {
+		return QStringLiteral("%1-%2").arg(prefix).arg(index % config.distinct);
+	};
+
+	QJsonArray corpus;
+	for(auto i = 0; i < config.records; ++i) {
+		corpus.append(QJsonObject {
+						  {QStringLiteral("id"), i},
+						  {QStringLiteral("status"), value(QStringLiteral("status"), i % 5)},
+						  {QStringLiteral("category"), value(QStringLiteral("category"), i * 7)},
+						  {QStringLiteral("country"), value(QStringLiteral("country"), i * 13)},
+						  {QStringLiteral("tags"), QJsonArray {
+							   value(QStringLiteral("tag"), i),
+							   value(QStringLiteral("tag"), i + 1),
+							   value(QStringLiteral("tag"), i + 2)
+						   }},
+						  {QStringLiteral("attributes"), QJsonObject {
+							   {QStringLiteral("source"), value(QStringLiteral("source"), i * 3)},
+							   {QStringLiteral("channel"), value(QStringLiteral("channel"), i * 11)}
+						   }}
+					  });
+	}
+	return corpus;
+}
+
+// counts the strings of the result, and the memory of the distinct string buffers they reference
+Result measure(const QString &name, const QJsonSerializer &serializer, const QJsonArray &corpus)
+{
+	QElapsedTimer timer;
+	timer.start();
+	const auto records = serializer.deserialize<QList<Record>>(corpus);
+
+	Result result;
+	result.name = name;
+	result.time = timer.nsecsElapsed();
+
+	QSet<const QChar*> buffers;
+	const auto count = [&](const QString &string) {
+		++result.strings;
+		if(!buffers.contains(string.constData())) {
+			buffers.insert(string.constData());
+			result.bytes += static_cast<qint64>(sizeof(QString::Data)) + (string.size() + 1) * static_cast<qint64>(sizeof(QChar));
+		}
+	};
+	for(const auto &record : records) {
+		count(record.status);
+		count(record.category);
+		count(record.country);
+		for(const auto &tag : record.tags)
+			count(tag);
+		for(auto it = record.attributes.constBegin(); it != record.attributes.constEnd(); ++it) {
+			count(it.key());
+			count(it.value().toString());
+		}
+	}
+	result.buffers = buffers.size();
+	return result;
+}
+
+void printResults(QTextStream &out, const QList<Result> &results)
+{
+	out << QStringLiteral("%1 %2 %3 %4 %5\n")
+		   .arg(QStringLiteral("mode"), 10)
+		   .arg(QStringLiteral("strings"), 12)
+		   .arg(QStringLiteral("buffers"), 12)
+		   .arg(QStringLiteral("bytes"), 12)
+		   .arg(QStringLiteral("time[ms]"), 12);
+	for(const auto &result : results) {
+		out << QStringLiteral("%1 %2 %3 %4 %5\n")
+			   .arg(result.name, 10)
+			   .arg(result.strings, 12)
+			   .arg(result.buffers, 12)
+			   .arg(result.bytes, 12)
+			   .arg(result.time / 1000000.0, 12, 'f', 1);
+	}
+	out << QLatin1Char('\n');
+	out.flush();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app{argc, argv};
+	QJsonSerializer::registerListConverters<Record>();
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(QStringLiteral("Measures the string memory of deserialized repetitive data, with and without the string pool of QJsonSerializer"));
+	parser.addHelpOption();
+	parser.addOption({
+						 {QStringLiteral("r"), QStringLiteral("records")},
+						 QStringLiteral("The number of records in the corpus"),
+						 QStringLiteral("count"),
+						 QStringLiteral("10000")
+					 });
+	parser.addOption({
+						 {QStringLiteral("v"), QStringLiteral("distinct")},
+						 QStringLiteral("The number of distinct values per field"),
+						 QStringLiteral("count"),
+						 QStringLiteral("50")
+					 });
+	parser.addOption({
+						 {QStringLiteral("s"), QStringLiteral("pool-size")},
+						 QStringLiteral("The string pool size to compare with"),
+						 QStringLiteral("count"),
+						 QStringLiteral("4096")
+					 });
+	parser.process(app);
+
+	Config config;
+	config.records = qMax(1, parser.value(QStringLiteral("records")).toInt());
+	config.distinct = qMax(1, parser.value(QStringLiteral("distinct")).toInt());
+	config.poolSize = qMax(1, parser.value(QStringLiteral("pool-size")).toInt());
+
+	const auto corpus = createCorpus(config);
+	QTextStream out{stdout};
+	out << QStringLiteral("Corpus: %1 records with %2 distinct values per field\n\n")
+		   .arg(config.records)
+		   .arg(config.distinct);
+
+	QJsonSerializer serializer;
+	QList<Result> results;
+	try {
+		// warm up caches outside of the measurement
+		serializer.deserialize<QList<Record>>(corpus);
+
+		results.append(measure(QStringLiteral("no pool"), serializer, corpus));
+		serializer.setStringPoolSize(config.poolSize);
+		results.append(measure(QStringLiteral("pool"), serializer, corpus));
+	} catch(QJsonSerializerException &e) {
+		qFatal("Benchmark failed with exception: %s", e.what());
+	}
+
+	printResults(out, results);
+	return EXIT_SUCCESS;
+}
+
+#include "main.moc"
@@ -0,0 +1,260 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QSemaphore>
+#include <QtCore/QTextStream>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <QtCore/QtMath>
+#include <QtJsonSerializer/QJsonSerializer>
+
+#include <algorithm>
+
+#include "benchobject.h"
+
+namespace {
+
+struct Config {
+	int maxThreads = 1;
+	int iterations = 200;
+	BenchObject::Shape shape;
+};
+
+struct Sample {
+	QVector<qint64> serLatencies;
+	QVector<qint64> deserLatencies;
+	QByteArray error;
+};
+
+struct Result {
+	int threads = 0;
+	qint64 operations = 0;
+	qint64 wallNs = 0;
+	QVector<qint64> serLatencies;
+	QVector<qint64> deserLatencies;
+
+	double throughput() const {
+		return wallNs > 0 ? (operations * 1e9) / wallNs : 0.0;
+	}
+};
+
+class BenchThread : public QThread
+{
+public:
+	BenchThread(const QJsonSerializer *sharedSerializer,
+				const Config &config,
+				int seed,
+				QSemaphore *ready,
+				QSemaphore *start) :
+		_sharedSerializer{sharedSerializer},
+		_config{config},
+		_seed{seed},
+		_ready{ready},
+		_start{start}
+	{}
+
+	Sample sample;
+
+protected:
+	void run() override {
+		// per thread mode: each thread owns its serializer
+		QScopedPointer<QJsonSerializer> ownSerializer;
+		auto serializer = _sharedSerializer;
+		if(!serializer) {
+			ownSerializer.reset(new QJsonSerializer{});
+			serializer = ownSerializer.data();
+		}
+
+		QScopedPointer<BenchObject> root{BenchObject::createGraph(_config.shape, _seed)};
+		sample.serLatencies.reserve(_config.iterations);
+		sample.deserLatencies.reserve(_config.iterations);
+
+		// warm up caches outside of the measurement
+		try {
+			delete serializer->deserialize<BenchObject*>(serializer->serialize(root.data()));
+		} catch(QJsonSerializerException &e) {
+			sample.error = e.what();
+		}
+
+		_ready->release();
+		_start->acquire();
+		if(!sample.error.isNull())
+			return;
+
+		QElapsedTimer timer;
+		try {
+			for(auto i = 0; i < _config.iterations; ++i) {
+				timer.start();
+				const auto json = serializer->serialize(root.data());
+				sample.serLatencies.append(timer.nsecsElapsed());
+
+				timer.start();
+				delete serializer->deserialize<BenchObject*>(json);
+				sample.deserLatencies.append(timer.nsecsElapsed());
+			}
+		} catch(QJsonSerializerException &e) {
+			sample.error = e.what();
+		}
+	}
+
+private:
+	const QJsonSerializer *_sharedSerializer;
+	const Config _config;
+	const int _seed;
+	QSemaphore *_ready;
+	QSemaphore *_start;
+};
+
+qint64 percentile(const QVector<qint64> &sortedValues, double p)
+{
+	if(sortedValues.isEmpty())
+		return 0;
+	const auto index = qBound(0, qCeil(p * sortedValues.size()) - 1, sortedValues.size() - 1);
+	return sortedValues[index];
+}
+
+Result runBenchmark(const QJsonSerializer *sharedSerializer, const Config &config, int threadCount)
+{
+	QSemaphore ready;
+	QSemaphore start;
+	QList<BenchThread*> threads;
+	threads.reserve(threadCount);
+	for(auto i = 0; i < threadCount; ++i) {
+		auto thread = new BenchThread{sharedSerializer, config, i, &ready, &start};
+		threads.append(thread);
+		thread->start();
+	}
+
+	// release all threads at once, after they have finished their setup
+	ready.acquire(threadCount);
+	QElapsedTimer wallTimer;
+	wallTimer.start();
+	start.release(threadCount);
+	for(auto thread : threads)
+		thread->wait();
+
+	Result result;
+	result.threads = threadCount;
+	result.wallNs = wallTimer.nsecsElapsed();
+	for(auto thread : threads) {
+		if(!thread->sample.error.isNull())
+			qFatal("Benchmark failed with exception: %s", thread->sample.error.constData());
+		result.operations += thread->sample.serLatencies.size() + thread->sample.deserLatencies.size();
+		result.serLatencies.append(thread->sample.serLatencies);
+		result.deserLatencies.append(thread->sample.deserLatencies);
+	}
+	qDeleteAll(threads);
+
+	std::sort(result.serLatencies.begin(), result.serLatencies.end());
+	std::sort(result.deserLatencies.begin(), result.deserLatencies.end());
+	return result;
+}
+
+QList<int> threadCounts(int maxThreads)
+{
+	QList<int> counts;
+	for(auto count = 1; count < maxThreads; count *= 2)
+		counts.append(count);
+	counts.append(maxThreads);
+	return counts;
+}
+
+void printResults(QTextStream &out, const QString &mode, const QList<Result> &results)
+{
+	out << mode << QLatin1Char('\n');
+	out << QStringLiteral("%1 %2 %3 %4 %5 %6 %7\n")
+		   .arg(QStringLiteral("threads"), 8)
+		   .arg(QStringLiteral("ops/s"), 12)
+		   .arg(QStringLiteral("ser p50[us]"), 12)
+		   .arg(QStringLiteral("ser p99[us]"), 12)
+		   .arg(QStringLiteral("des p50[us]"), 12)
+		   .arg(QStringLiteral("des p99[us]"), 12)
+		   .arg(QStringLiteral("efficiency"), 11);
+
+	const auto baseline = results.isEmpty() ? 0.0 : results.first().throughput();
+	for(const auto &result : results) {
+		const auto efficiency = baseline > 0.0 ?
+									result.throughput() / (baseline * result.threads) :
+									0.0;
+		out << QStringLiteral("%1 %2 %3 %4 %5 %6 %7%\n")
+			   .arg(result.threads, 8)
+			   .arg(result.throughput(), 12, 'f', 1)
+			   .arg(percentile(result.serLatencies, 0.50) / 1000.0, 12, 'f', 1)
+			   .arg(percentile(result.serLatencies, 0.99) / 1000.0, 12, 'f', 1)
+			   .arg(percentile(result.deserLatencies, 0.50) / 1000.0, 12, 'f', 1)
+			   .arg(percentile(result.deserLatencies, 0.99) / 1000.0, 12, 'f', 1)
+			   .arg(efficiency * 100.0, 10, 'f', 1);
+	}
+	out << QLatin1Char('\n');
+	out.flush();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app{argc, argv};
+	BenchObject::registerTypes();
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(QStringLiteral("Measures how QJsonSerializer scales when used from multiple threads"));
+	parser.addHelpOption();
+	parser.addOption({
+						 {QStringLiteral("t"), QStringLiteral("threads")},
+						 QStringLiteral("The maximum number of threads to run with"),
+						 QStringLiteral("count"),
+						 QString::number(QThread::idealThreadCount())
+					 });
+	parser.addOption({
+						 {QStringLiteral("i"), QStringLiteral("iterations")},
+						 QStringLiteral("The number of serialize/deserialize round trips per thread"),
+						 QStringLiteral("count"),
+						 QStringLiteral("200")
+					 });
+	parser.addOption({
+						 {QStringLiteral("d"), QStringLiteral("depth")},
+						 QStringLiteral("The depth of the generated object graph"),
+						 QStringLiteral("levels"),
+						 QStringLiteral("2")
+					 });
+	parser.addOption({
+						 {QStringLiteral("w"), QStringLiteral("width")},
+						 QStringLiteral("The number of children per object"),
+						 QStringLiteral("count"),
+						 QStringLiteral("4")
+					 });
+	parser.addOption({
+						 {QStringLiteral("n"), QStringLiteral("items")},
+						 QStringLiteral("The number of list elements per object"),
+						 QStringLiteral("count"),
+						 QStringLiteral("16")
+					 });
+	parser.process(app);
+
+	Config config;
+	config.maxThreads = qMax(1, parser.value(QStringLiteral("threads")).toInt());
+	config.iterations = qMax(1, parser.value(QStringLiteral("iterations")).toInt());
+	config.shape.depth = qMax(0, parser.value(QStringLiteral("depth")).toInt());
+	config.shape.width = qMax(0, parser.value(QStringLiteral("width")).toInt());
+	config.shape.items = qMax(0, parser.value(QStringLiteral("items")).toInt());
+
+	QTextStream out{stdout};
+	{
+		QScopedPointer<BenchObject> probe{BenchObject::createGraph(config.shape)};
+		out << QStringLiteral("Object graph: %1 objects, %2 iterations per thread\n\n")
+			   .arg(BenchObject::countObjects(probe.data()))
+			   .arg(config.iterations);
+	}
+
+	QJsonSerializer sharedSerializer;
+	QList<Result> sharedResults;
+	QList<Result> ownResults;
+	for(auto count : threadCounts(config.maxThreads)) {
+		sharedResults.append(runBenchmark(&sharedSerializer, config, count));
+		ownResults.append(runBenchmark(nullptr, config, count));
+	}
+
+	printResults(out, QStringLiteral("Shared serializer"), sharedResults);
+	printResults(out, QStringLiteral("Serializer per thread"), ownResults);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,7 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+	ThreadScalingBenchmark \
+	MsgPackBenchmark \
+	AllocationBenchmark \
+	StringPoolBenchmark
@@ -2,7 +2,9 @@ TEMPLATE = subdirs
 
 CONFIG += no_docs_target
 
-SUBDIRS += auto
+SUBDIRS += auto \
+	benchmarks
 
+benchmarks.CONFIG += no_run-tests_target
 prepareRecursiveTarget(run-tests)
 QMAKE_EXTRA_TARGETS += run-tests
@@ -0,0 +1,296 @@
+#include "convertergenerator.h"
+
+ConverterGenerator::ConverterGenerator(QTextStream &out, const QByteArray &include, const QByteArray &hookName) :
+	_out{out},
+	_include{include},
+	_hookName{hookName}
+{}
+
+void ConverterGenerator::generate(const QList<HeaderParser::ClassInfo> &classes)
+{
+	writeHeader();
+	if(classes.isEmpty())
+		return;
+
+	_out << "namespace {\n\n";
+	for(const auto &info : classes)
+		writeConverter(info);
+	_out << "}\n\n";
+	writeRegistration(classes);
+}
+
+ConverterGenerator::ScalarType ConverterGenerator::scalarType(const QByteArray &type)
+{
+	// only types that map to exactly one json type without any conversion are accessed directly
+	if(type == "bool")
+		return ScalarType::Bool;
+	else if(type == "int")
+		return ScalarType::Int;
+	else if(type == "double" || type == "qreal")
+		return ScalarType::Double;
+	else if(type == "QString")
+		return ScalarType::String;
+	else
+		return ScalarType::None;
+}
+
+QByteArray ConverterGenerator::converterName(const HeaderParser::ClassInfo &info)
+{
+	return "QJsonGenerated" + QByteArray{info.name}.replace("::", "_") + "Converter";
+}
+
+QByteArray ConverterGenerator::readExpression(const HeaderParser::PropertyInfo &property)
+{
+	if(!property.read.isEmpty())
+		return "gadget." + property.read + "()";
+	else
+		return "gadget." + property.member;
+}
+
+QByteArray ConverterGenerator::writeStatement(const HeaderParser::PropertyInfo &property, const QByteArray &value)
+{
+	if(!property.write.isEmpty())
+		return "gadget." + property.write + "(" + value + ");";
+	else if(!property.member.isEmpty())
+		return "gadget." + property.member + " = " + value + ";";
+	else
+		return {};
+}
+
+QByteArray ConverterGenerator::directFlag(ScalarType type)
+{
+	switch(type) {
+	case ScalarType::Bool:
+		return "directBool";
+	case ScalarType::Int:
+		return "directInt";
+	case ScalarType::Double:
+		return "directDouble";
+	case ScalarType::String:
+		return "directString";
+	case ScalarType::None:
+		break;
+	}
+	return {};
+}
+
+void ConverterGenerator::writeDirectFlags(const QList<ScalarType> &types)
+{
+	// the direct access bypasses the helper, so it is only used where the helper would do the same
+	static const QList<QPair<ScalarType, QByteArray>> metaTypes = {
+		{ScalarType::Bool, "QMetaType::Bool"},
+		{ScalarType::Int, "QMetaType::Int"},
+		{ScalarType::Double, "QMetaType::Double"},
+		{ScalarType::String, "QMetaType::QString"}
+	};
+	for(const auto &metaType : metaTypes) {
+		if(types.contains(metaType.first))
+			_out << "\t\tconst auto " << directFlag(metaType.first) << " = canAccessDirectly(" << metaType.second << ", helper);\n";
+	}
+	if(!types.isEmpty())
+		_out << "\n";
+}
+
+void ConverterGenerator::writeHeader()
+{
+	_out << "/****************************************************************************\n"
+		 << "** JSON converters generated from reading the header " << _include << "\n"
+		 << "**\n"
+		 << "** Created by: qjsonserializergen\n"
+		 << "**\n"
+		 << "** WARNING! All changes made in this file will be lost!\n"
+		 << "*****************************************************************************/\n\n"
+		 << "#include \"" << _include << "\"\n\n"
+		 << "#include <QtCore/QCoreApplication>\n"
+		 << "#include <QtCore/QMetaProperty>\n"
+		 << "#include <QtJsonSerializer/QJsonSerializer>\n"
+		 << "#include <QtJsonSerializer/QJsonGeneratedConverter>\n\n";
+}
+
+void ConverterGenerator::writeConverter(const HeaderParser::ClassInfo &info)
+{
+	const auto name = converterName(info);
+	_out << "class " << name << " : public QJsonGeneratedConverter\n"
+		 << "{\n"
+		 << "public:\n"
+		 << "\tstatic const int PropertyCount = " << info.properties.size() << ";\n\n"
+		 << "\t// the property indexes, in declaration order. Valid as long as the gadget was not changed since generation\n"
+		 << "\tstatic QMetaProperty metaProperty(int index) {\n"
+		 << "\t\tstatic const int indexes[PropertyCount] = {\n";
+	for(auto i = 0; i < info.properties.size(); ++i) {
+		_out << "\t\t\t" << info.name << "::staticMetaObject.indexOfProperty(\"" << info.properties[i].name << "\")"
+			 << (i + 1 < info.properties.size() ? "," : "") << "\n";
+	}
+	_out << "\t\t};\n"
+		 << "\t\treturn " << info.name << "::staticMetaObject.property(indexes[index]);\n"
+		 << "\t}\n\n"
+		 << "\tbool canConvert(int metaTypeId) const override {\n"
+		 << "\t\treturn metaTypeId == qMetaTypeId<" << info.name << ">();\n"
+		 << "\t}\n\n"
+		 << "\tQList<QJsonValue::Type> jsonTypes() const override {\n"
+		 << "\t\treturn {QJsonValue::Object};\n"
+		 << "\t}\n\n";
+	writeSerialize(info);
+	writeDeserialize(info);
+	_out << "};\n\n";
+}
+
+void ConverterGenerator::writeSerialize(const HeaderParser::ClassInfo &info)
+{
+	QList<ScalarType> directTypes;
+	for(const auto &property : info.properties) {
+		const auto type = scalarType(property.type);
+		if(property.stored && type != ScalarType::None && !directTypes.contains(type))
+			directTypes.append(type);
+	}
+
+	_out << "\tQJsonValue serialize(int propertyType, const QVariant &value, const SerializationHelper *helper) const override {\n"
+		 << "\t\tconst auto gValue = convertedValue(value, propertyType);\n"
+		 << "\t\tif(!gValue.isValid())\n"
+		 << "\t\t\tthrow QJsonSerializationException(QByteArray(\"Data is not of the required gadget type \") + QMetaType::typeName(propertyType));\n"
+		 << "\t\tconst auto &gadget = *reinterpret_cast<const " << info.name << "*>(gValue.constData());\n\n";
+	writeDirectFlags(directTypes);
+	_out << "\t\tQJsonObject jsonObject;\n";
+	for(auto i = 0; i < info.properties.size(); ++i) {
+		const auto &property = info.properties[i];
+		if(!property.stored)
+			continue;
+		const auto type = scalarType(property.type);
+		_out << "\t\t{\n"
+			 << "\t\t\tFieldStep step{\"" << property.name << "\"};\n"
+			 << "\t\t\tif(step.isSelected()) {\n";
+		if(type != ScalarType::None) {
+			_out << "\t\t\t\tif(" << directFlag(type) << ")\n"
+				 << "\t\t\t\t\tjsonObject.insert(QStringLiteral(\"" << property.name << "\"), " << readExpression(property) << ");\n"
+				 << "\t\t\t\telse\n"
+				 << "\t";
+		}
+		_out << "\t\t\t\tjsonObject.insert(QStringLiteral(\"" << property.name << "\"), "
+			 << "helper->serializeSubtype(metaProperty(" << i << "), metaProperty(" << i << ").readOnGadget(&gadget)));\n"
+			 << "\t\t\t}\n"
+			 << "\t\t}\n";
+	}
+	_out << "\t\treturn jsonObject;\n"
+		 << "\t}\n\n";
+}
+
+void ConverterGenerator::writeDeserialize(const HeaderParser::ClassInfo &info)
+{
+	QList<ScalarType> directTypes;
+	for(const auto &property : info.properties) {
+		const auto type = scalarType(property.type);
+		if(type != ScalarType::None && !writeStatement(property, {}).isEmpty() && !directTypes.contains(type))
+			directTypes.append(type);
+	}
+
+	_out << "\tQVariant deserialize(int propertyType, const QJsonValue &value, QObject *parent, const SerializationHelper *helper) const override {\n"
+		 << "\t\tQ_UNUSED(parent)\n"
+		 << "\t\tQ_UNUSED(propertyType)\n"
+		 << "\t\tif(value.isNull())\n"
+		 << "\t\t\treturn QVariant{};\n\n"
+		 << "\t\t" << info.name << " gadget;\n"
+		 << "\t\tconst auto jsonObject = value.toObject();\n"
+		 << "\t\tconst auto validationFlags = options(helper).validationFlags();\n";
+	writeDirectFlags(directTypes);
+	_out << "\t\tbool reqProps[PropertyCount + 1] = {};\n"
+		 << "\t\tif(validationFlags.testFlag(QJsonSerializer::AllProperties)) {\n"
+		 << "\t\t\tfor(auto i = 0; i < PropertyCount; i++)\n"
+		 << "\t\t\t\treqProps[i] = metaProperty(i).isStored() && isSelected(metaProperty(i).name());\n"
+		 << "\t\t}\n\n"
+		 << "\t\tfor(auto it = jsonObject.constBegin(); it != jsonObject.constEnd(); it++) {\n"
+		 << "\t\t\tFieldStep step{it.key()};\n"
+		 << "\t\t\tif(!step.isSelected())\n"
+		 << "\t\t\t\tcontinue;\n"
+		 << "\t\t\tconst auto key = it.key();\n"
+		 << "\t\t\tconst auto json = it.value();\n"
+		 << "\t\t\tauto index = -1;\n";
+
+	for(auto i = 0; i < info.properties.size(); ++i) {
+		const auto &property = info.properties[i];
+		_out << "\t\t\t" << (i == 0 ? "if" : "else if") << "(key == QLatin1String(\"" << property.name << "\")) {\n"
+			 << "\t\t\t\tindex = " << i << ";\n";
+		const auto directWrite = writeStatement(property, "direct");
+		QByteArray check;
+		QByteArray direct;
+		switch(scalarType(property.type)) {
+		case ScalarType::Bool:
+			check = "json.isBool()";
+			direct = "json.toBool()";
+			break;
+		case ScalarType::Int:
+			// only integral values are taken as they are, everything else is converted the usual way
+			check = "json.isDouble() && json.toInt() == json.toDouble()";
+			direct = "json.toInt()";
+			break;
+		case ScalarType::Double:
+			check = "json.isDouble()";
+			direct = "json.toDouble()";
+			break;
+		case ScalarType::String:
+			check = "json.isString()";
+			direct = "intern(json.toString())";
+			break;
+		case ScalarType::None:
+			break;
+		}
+
+		if(!check.isEmpty() && !directWrite.isEmpty()) {
+			_out << "\t\t\t\tif(" << directFlag(scalarType(property.type)) << " && " << check << ") {\n"
+				 << "\t\t\t\t\tconst auto direct = " << direct << ";\n"
+				 << "\t\t\t\t\t" << directWrite << "\n"
+				 << "\t\t\t\t} else\n"
+				 << "\t\t\t\t\tmetaProperty(" << i << ").writeOnGadget(&gadget, helper->deserializeSubtype(metaProperty(" << i << "), json, nullptr));\n";
+		} else
+			_out << "\t\t\t\tmetaProperty(" << i << ").writeOnGadget(&gadget, helper->deserializeSubtype(metaProperty(" << i << "), json, nullptr));\n";
+		_out << "\t\t\t}";
+		_out << (i + 1 < info.properties.size() ? "\n" : "");
+	}
+	if(!info.properties.isEmpty())
+		_out << " else if(validationFlags.testFlag(QJsonSerializer::NoExtraProperties)) {\n";
+	else
+		_out << "\t\t\tif(validationFlags.testFlag(QJsonSerializer::NoExtraProperties)) {\n";
+	_out << "\t\t\t\tthrow QJsonDeserializationException(\"Found extra property \" +\n"
+		 << "\t\t\t\t\t\t\t\t\t\t\t\t\tkey.toUtf8() +\n"
+		 << "\t\t\t\t\t\t\t\t\t\t\t\t\t\" but extra properties are not allowed\");\n"
+		 << "\t\t\t}\n"
+		 << "\t\t\tif(index != -1)\n"
+		 << "\t\t\t\treqProps[index] = false;\n"
+		 << "\t\t}\n\n"
+		 << "\t\tif(validationFlags.testFlag(QJsonSerializer::AllProperties)) {\n"
+		 << "\t\t\tQByteArrayList missing;\n"
+		 << "\t\t\tfor(auto i = 0; i < PropertyCount; i++) {\n"
+		 << "\t\t\t\tif(reqProps[i])\n"
+		 << "\t\t\t\t\tmissing.append(metaProperty(i).name());\n"
+		 << "\t\t\t}\n"
+		 << "\t\t\tif(!missing.isEmpty()) {\n"
+		 << "\t\t\t\tthrow QJsonDeserializationException(QByteArray(\"Not all properties for " << info.name << "\") +\n"
+		 << "\t\t\t\t\t\t\t\t\t\t\t\t\tQByteArray(\" are present in the json object. Missing properties: \") +\n"
+		 << "\t\t\t\t\t\t\t\t\t\t\t\t\tmissing.join(\", \"));\n"
+		 << "\t\t\t}\n"
+		 << "\t\t}\n\n"
+		 << "\t\treturn QVariant::fromValue(gadget);\n"
+		 << "\t}\n";
+}
+
+void ConverterGenerator::writeRegistration(const QList<HeaderParser::ClassInfo> &classes)
+{
+	// a converter is only used if the gadget still matches the header it was generated from
+	_out << "template <typename TConverter, typename TGadget>\n"
+		 << "static void qtJsonSerializerGenRegister(const char *name)\n"
+		 << "{\n"
+		 << "\tauto valid = TGadget::staticMetaObject.superClass() == nullptr &&\n"
+		 << "\t\t\tTGadget::staticMetaObject.propertyCount() == TConverter::PropertyCount;\n"
+		 << "\tfor(auto i = 0; valid && i < TConverter::PropertyCount; i++)\n"
+		 << "\t\tvalid = TConverter::metaProperty(i).isValid();\n"
+		 << "\tif(valid)\n"
+		 << "\t\tQJsonSerializer::addJsonTypeConverterFactory<TConverter, QJsonTypeConverter::High>();\n"
+		 << "\telse\n"
+		 << "\t\tqWarning(\"Generated JSON converter for %s is out of date - using the reflective converter instead\", name);\n"
+		 << "}\n\n"
+		 << "static void " << _hookName << "()\n"
+		 << "{\n";
+	for(const auto &info : classes)
+		_out << "\tqtJsonSerializerGenRegister<" << converterName(info) << ", " << info.name << ">(\"" << info.name << "\");\n";
+	_out << "}\n"
+		 << "Q_COREAPP_STARTUP_FUNCTION(" << _hookName << ")\n";
+}
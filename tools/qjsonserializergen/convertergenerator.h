@@ -0,0 +1,44 @@
+#ifndef CONVERTERGENERATOR_H
+#define CONVERTERGENERATOR_H
+
+#include <QtCore/QTextStream>
+
+#include "headerparser.h"
+
+// Writes a source file with one QJsonTypeConverter per class, that accesses the properties directly
+class ConverterGenerator
+{
+public:
+	ConverterGenerator(QTextStream &out, const QByteArray &include, const QByteArray &hookName);
+
+	void generate(const QList<HeaderParser::ClassInfo> &classes);
+
+private:
+	enum class ScalarType {
+		None,
+		Bool,
+		Int,
+		Double,
+		String
+	};
+
+	QTextStream &_out;
+	QByteArray _include;
+	QByteArray _hookName;
+
+	static ScalarType scalarType(const QByteArray &type);
+	static QByteArray converterName(const HeaderParser::ClassInfo &info);
+	static QByteArray readExpression(const HeaderParser::PropertyInfo &property);
+	static QByteArray writeStatement(const HeaderParser::PropertyInfo &property, const QByteArray &value);
+	static QByteArray directFlag(ScalarType type);
+
+	void writeDirectFlags(const QList<ScalarType> &types);
+
+	void writeHeader();
+	void writeConverter(const HeaderParser::ClassInfo &info);
+	void writeSerialize(const HeaderParser::ClassInfo &info);
+	void writeDeserialize(const HeaderParser::ClassInfo &info);
+	void writeRegistration(const QList<HeaderParser::ClassInfo> &classes);
+};
+
+#endif // CONVERTERGENERATOR_H
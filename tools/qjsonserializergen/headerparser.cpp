@@ -0,0 +1,306 @@
+#include "headerparser.h"
+
+#include <QtCore/QRegularExpression>
+
+QByteArray HeaderParser::ClassInfo::classInfo(const QByteArray &key) const
+{
+	for(const auto &info : classInfos) {
+		if(info.first == key)
+			return info.second;
+	}
+	return {};
+}
+
+QList<HeaderParser::ClassInfo> HeaderParser::parse(const QByteArray &source)
+{
+	_source = stripComments(source);
+	_pos = 0;
+	_scopes.clear();
+	_classes.clear();
+	_error.clear();
+
+	auto lastIdentifier = QByteArray{};
+	while(_pos < _source.size() && _error.isEmpty()) {
+		const auto c = _source[_pos];
+		if(isIdentifierChar(c)) {
+			const auto identifier = readIdentifier();
+			if(identifier == "namespace")
+				parseNamespace();
+			else if((identifier == "class" || identifier == "struct") && lastIdentifier != "enum")
+				parseClass();
+			else if(identifier.startsWith("Q_"))
+				parseMacro(identifier);
+			lastIdentifier = identifier;
+			continue;
+		}
+
+		switch(c) {
+		case '"':
+		case '\'':
+			skipLiteral();
+			continue;
+		case '{':
+			_scopes.append({Scope::Block, {}, -1});
+			break;
+		case '}':
+			if(_scopes.isEmpty()) {
+				_error = "Unbalanced closing brace";
+				return {};
+			}
+			_scopes.removeLast();
+			break;
+		case ' ':
+		case '\t':
+		case '\r':
+		case '\n':
+			++_pos;
+			continue;
+		case '#': // preprocessor lines are ignored
+			while(_pos < _source.size() && _source[_pos] != '\n') {
+				if(_source[_pos] == '\\')
+					++_pos;
+				++_pos;
+			}
+			continue;
+		default:
+			break;
+		}
+		lastIdentifier.clear();
+		++_pos;
+	}
+
+	if(!_error.isEmpty())
+		return {};
+	return _classes;
+}
+
+QByteArray HeaderParser::errorString() const
+{
+	return _error;
+}
+
+QByteArray HeaderParser::stripComments(const QByteArray &source)
+{
+	// comments are replaced by spaces, keeping the line breaks. Literals are kept as they are
+	QByteArray result;
+	result.reserve(source.size());
+	for(auto i = 0; i < source.size(); ++i) {
+		const auto c = source[i];
+		if(c == '"' || c == '\'') {
+			result.append(c);
+			for(++i; i < source.size() && source[i] != c; ++i) {
+				result.append(source[i]);
+				if(source[i] == '\\' && i + 1 < source.size())
+					result.append(source[++i]);
+			}
+			if(i < source.size())
+				result.append(c);
+		} else if(c == '/' && i + 1 < source.size() && source[i + 1] == '/') {
+			while(i < source.size() && source[i] != '\n')
+				++i;
+			result.append('\n');
+		} else if(c == '/' && i + 1 < source.size() && source[i + 1] == '*') {
+			for(i += 2; i + 1 < source.size() && !(source[i] == '*' && source[i + 1] == '/'); ++i) {
+				if(source[i] == '\n')
+					result.append('\n');
+			}
+			++i;
+			result.append(' ');
+		} else
+			result.append(c);
+	}
+	return result;
+}
+
+bool HeaderParser::isIdentifierChar(char c)
+{
+	return (c >= 'a' && c <= 'z') ||
+			(c >= 'A' && c <= 'Z') ||
+			(c >= '0' && c <= '9') ||
+			c == '_';
+}
+
+void HeaderParser::skipSpace()
+{
+	while(_pos < _source.size() && QChar::isSpace(static_cast<uchar>(_source[_pos])))
+		++_pos;
+}
+
+void HeaderParser::skipLiteral()
+{
+	const auto quote = _source[_pos++];
+	while(_pos < _source.size() && _source[_pos] != quote) {
+		if(_source[_pos] == '\\')
+			++_pos;
+		++_pos;
+	}
+	++_pos;
+}
+
+QByteArray HeaderParser::readIdentifier()
+{
+	const auto start = _pos;
+	while(_pos < _source.size() && isIdentifierChar(_source[_pos]))
+		++_pos;
+	return _source.mid(start, _pos - start);
+}
+
+QByteArray HeaderParser::readArguments()
+{
+	skipSpace();
+	if(_pos >= _source.size() || _source[_pos] != '(')
+		return {};
+
+	const auto start = ++_pos;
+	auto depth = 1;
+	while(_pos < _source.size()) {
+		switch(_source[_pos]) {
+		case '"':
+		case '\'':
+			skipLiteral();
+			continue;
+		case '(':
+			++depth;
+			break;
+		case ')':
+			if(--depth == 0)
+				return _source.mid(start, _pos++ - start).simplified();
+			break;
+		default:
+			break;
+		}
+		++_pos;
+	}
+	_error = "Unterminated macro arguments";
+	return {};
+}
+
+QByteArray HeaderParser::qualifiedName(const QByteArray &name) const
+{
+	QByteArrayList names;
+	for(const auto &scope : _scopes) {
+		if(scope.type != Scope::Block && !scope.name.isEmpty())
+			names.append(scope.name);
+	}
+	names.append(name);
+	return names.join("::");
+}
+
+void HeaderParser::parseNamespace()
+{
+	// namespace A::B { or namespace { - aliases (namespace A = B;) are skipped
+	QByteArrayList names;
+	forever {
+		skipSpace();
+		if(_pos >= _source.size())
+			return;
+		const auto c = _source[_pos];
+		if(isIdentifierChar(c))
+			names.append(readIdentifier());
+		else if(c == ':')
+			++_pos;
+		else if(c == '{') {
+			++_pos;
+			_scopes.append({Scope::Namespace, names.join("::"), -1});
+			return;
+		} else
+			return;
+	}
+}
+
+void HeaderParser::parseClass()
+{
+	// class [EXPORT_MACRO] Name [final] [: bases] { - everything else is a forward declaration, a template
+	// parameter or an elaborated type specifier
+	QByteArray name;
+	auto hasBase = false;
+	forever {
+		skipSpace();
+		if(_pos >= _source.size())
+			return;
+		const auto c = _source[_pos];
+		if(isIdentifierChar(c)) {
+			const auto identifier = readIdentifier();
+			if(!hasBase && identifier != "final")
+				name = identifier;
+		} else if(c == ':' && !hasBase) {
+			hasBase = true;
+			++_pos;
+		} else if(c == '{') {
+			++_pos;
+			if(name.isEmpty()) {
+				_scopes.append({Scope::Block, {}, -1});
+				return;
+			}
+			ClassInfo info;
+			info.name = qualifiedName(name);
+			info.hasBase = hasBase;
+			_classes.append(info);
+			_scopes.append({Scope::Class, name, _classes.size() - 1});
+			return;
+		} else if(hasBase && c != ';')
+			++_pos;
+		else
+			return;
+	}
+}
+
+void HeaderParser::parseMacro(const QByteArray &macro)
+{
+	if(_scopes.isEmpty() || _scopes.last().type != Scope::Class)
+		return;
+	auto &info = _classes[_scopes.last().classIndex];
+
+	if(macro == "Q_GADGET")
+		info.isGadget = true;
+	else if(macro == "Q_CLASSINFO") {
+		static const QRegularExpression regex{QStringLiteral(R"__(^"([^"]*)"\s*,\s*"([^"]*)"$)__")};
+		const auto match = regex.match(QString::fromUtf8(readArguments()));
+		if(match.hasMatch())
+			info.classInfos.append({match.captured(1).toUtf8(), match.captured(2).toUtf8()});
+	} else if(macro == "Q_PROPERTY") {
+		const auto arguments = readArguments();
+		PropertyInfo property;
+		if(parseProperty(arguments, property))
+			info.properties.append(property);
+		else if(_error.isEmpty())
+			_error = "Unable to parse Q_PROPERTY(" + arguments + ") of class " + info.name;
+	}
+}
+
+bool HeaderParser::parseProperty(const QByteArray &arguments, PropertyInfo &property)
+{
+	// "type name" up to the first READ or MEMBER, then keyword/value pairs
+	static const QRegularExpression headRegex{QStringLiteral(R"__(^(.*?)\s*\b(\w+)\s+(?=(?:READ|MEMBER)\b))__")};
+	const auto text = QString::fromUtf8(arguments);
+	const auto match = headRegex.match(text);
+	if(!match.hasMatch())
+		return false;
+
+	property.type = match.captured(1).toUtf8().trimmed();
+	property.name = match.captured(2).toUtf8();
+	// pointer and reference markers belong to the type
+	property.type.replace(" *", "*");
+	property.type.replace(" &", "&");
+	if(property.type.isEmpty())
+		return false;
+
+	const auto attributes = text.mid(match.capturedEnd()).toUtf8().split(' ');
+	for(auto i = 0; i < attributes.size(); ++i) {
+		const auto &keyword = attributes[i];
+		if(keyword == "CONSTANT" || keyword == "FINAL")
+			continue;
+		if(i + 1 >= attributes.size())
+			return false;
+		const auto value = attributes[++i];
+		if(keyword == "READ")
+			property.read = value;
+		else if(keyword == "WRITE")
+			property.write = value;
+		else if(keyword == "MEMBER")
+			property.member = value;
+		else if(keyword == "STORED")
+			property.stored = value != "false";
+	}
+	return true;
+}
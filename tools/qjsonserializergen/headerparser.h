@@ -0,0 +1,67 @@
+#ifndef HEADERPARSER_H
+#define HEADERPARSER_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+
+// Finds the Q_GADGET classes of a header, together with their classinfos and properties. Only the subset of C++
+// needed to locate classes is understood - the header must be valid for moc
+class HeaderParser
+{
+public:
+	struct PropertyInfo {
+		QByteArray type;
+		QByteArray name;
+		QByteArray read;
+		QByteArray write;
+		QByteArray member;
+		bool stored = true;
+	};
+
+	struct ClassInfo {
+		QByteArray name;
+		bool isGadget = false;
+		bool hasBase = false;
+		QList<QPair<QByteArray, QByteArray>> classInfos;
+		QList<PropertyInfo> properties;
+
+		QByteArray classInfo(const QByteArray &key) const;
+	};
+
+	QList<ClassInfo> parse(const QByteArray &source);
+	QByteArray errorString() const;
+
+private:
+	struct Scope {
+		enum Type {
+			Namespace,
+			Class,
+			Block
+		} type;
+		QByteArray name;
+		int classIndex;
+	};
+
+	QByteArray _source;
+	int _pos = 0;
+	QList<Scope> _scopes;
+	QList<ClassInfo> _classes;
+	QByteArray _error;
+
+	static QByteArray stripComments(const QByteArray &source);
+	static bool isIdentifierChar(char c);
+
+	void skipSpace();
+	void skipLiteral();
+	QByteArray readIdentifier();
+	QByteArray readArguments();
+	QByteArray qualifiedName(const QByteArray &name) const;
+
+	void parseNamespace();
+	void parseClass();
+	void parseMacro(const QByteArray &macro);
+	bool parseProperty(const QByteArray &arguments, PropertyInfo &property);
+};
+
+#endif // HEADERPARSER_H
@@ -0,0 +1,106 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTextStream>
+
+#include "headerparser.h"
+#include "convertergenerator.h"
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app{argc, argv};
+	QCoreApplication::setApplicationName(QStringLiteral(TARGET));
+	QCoreApplication::setApplicationVersion(QStringLiteral(VERSION));
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(QStringLiteral("Generates QJsonTypeConverters for the gadgets of a header that are "
+													"marked with Q_CLASSINFO(\"generatedConverter\", \"true\")"));
+	parser.addHelpOption();
+	parser.addVersionOption();
+	parser.addOption({
+						 {QStringLiteral("o"), QStringLiteral("output")},
+						 QStringLiteral("The <file> to write the generated source to. If not set, it is written to stdout"),
+						 QStringLiteral("file")
+					 });
+	parser.addOption({
+						 {QStringLiteral("i"), QStringLiteral("include")},
+						 QStringLiteral("The <name> the generated source uses to include the header. Defaults to the file name of the header"),
+						 QStringLiteral("name")
+					 });
+	parser.addPositionalArgument(QStringLiteral("header"),
+								 QStringLiteral("The header file to generate the converters for"));
+	parser.process(app);
+
+	if(parser.positionalArguments().size() != 1)
+		parser.showHelp(EXIT_FAILURE);
+
+	const QFileInfo headerInfo{parser.positionalArguments().first()};
+	QFile header{headerInfo.filePath()};
+	if(!header.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		qCritical("Failed to open %s: %s",
+				  qUtf8Printable(header.fileName()),
+				  qUtf8Printable(header.errorString()));
+		return EXIT_FAILURE;
+	}
+
+	HeaderParser headerParser;
+	const auto classes = headerParser.parse(header.readAll());
+	if(!headerParser.errorString().isEmpty()) {
+		qCritical("%s: %s",
+				  qUtf8Printable(header.fileName()),
+				  headerParser.errorString().constData());
+		return EXIT_FAILURE;
+	}
+
+	QList<HeaderParser::ClassInfo> generated;
+	for(const auto &info : classes) {
+		if(info.classInfo("generatedConverter") != "true")
+			continue;
+		if(!info.isGadget) {
+			qWarning("%s: Skipping %s - converters can only be generated for Q_GADGET classes",
+					 qUtf8Printable(header.fileName()),
+					 info.name.constData());
+		} else if(info.hasBase) {
+			qWarning("%s: Skipping %s - converters can only be generated for gadgets without base classes",
+					 qUtf8Printable(header.fileName()),
+					 info.name.constData());
+		} else
+			generated.append(info);
+	}
+
+	auto include = parser.value(QStringLiteral("include")).toUtf8();
+	if(include.isEmpty())
+		include = headerInfo.fileName().toUtf8();
+	// the startup function must be unique per generated file
+	auto hookName = "qtJsonSerializerGen_" + headerInfo.completeBaseName().toUtf8();
+	for(auto &c : hookName) {
+		if(!QChar::isLetterOrNumber(static_cast<uchar>(c)))
+			c = '_';
+	}
+
+	if(parser.isSet(QStringLiteral("output"))) {
+		QSaveFile out{parser.value(QStringLiteral("output"))};
+		if(!out.open(QIODevice::WriteOnly | QIODevice::Text)) {
+			qCritical("Failed to open %s: %s",
+					  qUtf8Printable(out.fileName()),
+					  qUtf8Printable(out.errorString()));
+			return EXIT_FAILURE;
+		}
+		QTextStream stream{&out};
+		ConverterGenerator{stream, include, hookName}.generate(generated);
+		stream.flush();
+		if(!out.commit()) {
+			qCritical("Failed to write %s: %s",
+					  qUtf8Printable(out.fileName()),
+					  qUtf8Printable(out.errorString()));
+			return EXIT_FAILURE;
+		}
+	} else {
+		QTextStream stream{stdout};
+		ConverterGenerator{stream, include, hookName}.generate(generated);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,32 @@
+option(host_build)
+
+QT = core
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = qjsonserializergen
+VERSION = $$MODULE_VERSION
+
+DEFINES += "TARGET=\\\"$$TARGET\\\""
+DEFINES += "VERSION=\\\"$$VERSION\\\""
+
+QMAKE_TARGET_DESCRIPTION = "QtJsonSerializer Converter Generator"
+
+HEADERS += \
+	headerparser.h \
+	convertergenerator.h
+
+SOURCES += \
+	main.cpp \
+	headerparser.cpp \
+	convertergenerator.cpp
+
+load(qt_tool)
+
+win32 {
+	QMAKE_TARGET_COMPANY = "Skycoder42"
+	QMAKE_TARGET_PRODUCT = "qjsonserializergen"
+	QMAKE_TARGET_COPYRIGHT = "Felix Barz"
+} else:mac {
+	QMAKE_TARGET_BUNDLE_PREFIX = "de.skycoder42."
+}